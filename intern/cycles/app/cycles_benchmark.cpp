@@ -0,0 +1,210 @@
+/* SPDX-FileCopyrightText: 2011-2024 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include <stdio.h>
+
+#include "app/cycles_benchmark.h"
+
+#include "session/session.h"
+
+#include "util/algorithm.h"
+#include "util/path.h"
+#include "util/profiling.h"
+
+CCL_NAMESPACE_BEGIN
+
+static string json_string(const string &str)
+{
+  string result = "\"";
+  for (const char c : str) {
+    switch (c) {
+      case '"':
+        result += "\\\"";
+        break;
+      case '\\':
+        result += "\\\\";
+        break;
+      case '\n':
+        result += "\\n";
+        break;
+      case '\t':
+        result += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          result += string_printf("\\u%04x", c);
+        }
+        else {
+          result += c;
+        }
+        break;
+    }
+  }
+  return result + "\"";
+}
+
+static string json_number(const double value)
+{
+  /* JSON has no representation of infinity and NaN. */
+  if (!isfinite_safe(value)) {
+    return "null";
+  }
+  return string_printf("%.6f", value);
+}
+
+static double samples_per_second(const BenchmarkRun &run, const double num_pixels)
+{
+  if (run.render_time <= 0.0 || num_pixels <= 0.0) {
+    return 0.0;
+  }
+  return run.pixel_samples / num_pixels / run.render_time;
+}
+
+static double median(vector<double> values)
+{
+  if (values.empty()) {
+    return 0.0;
+  }
+
+  sort(values.begin(), values.end());
+
+  const size_t middle = values.size() / 2;
+  if (values.size() % 2) {
+    return values[middle];
+  }
+  return 0.5 * (values[middle - 1] + values[middle]);
+}
+
+static string kernel_stats_to_json(const NamedNestedSampleStats &stats, const int indent_level)
+{
+  const string indent(indent_level * 2, ' ');
+
+  string result = "{\n";
+  result += indent + "  \"name\": " + json_string(stats.name) + ",\n";
+  result += indent + "  \"time\": " + json_number(Profiler::samples_to_seconds(stats.sum_samples));
+  result += ",\n";
+  result += indent + "  \"self_time\": " +
+            json_number(Profiler::samples_to_seconds(stats.self_samples));
+
+  if (!stats.entries.empty()) {
+    result += ",\n" + indent + "  \"entries\": [";
+    for (size_t i = 0; i < stats.entries.size(); i++) {
+      result += (i == 0) ? "\n" : ",\n";
+      result += indent + "    " + kernel_stats_to_json(stats.entries[i], indent_level + 2);
+    }
+    result += "\n" + indent + "  ]";
+  }
+
+  return result + "\n" + indent + "}";
+}
+
+void BenchmarkReport::add_run(Session *session, const double load_time)
+{
+  BenchmarkRun run;
+
+  run.load_time = load_time;
+
+  session->progress.get_time(run.total_time, run.render_time);
+  run.pixel_samples = session->progress.get_pixel_samples();
+  run.peak_memory = session->stats.mem_peak;
+
+  const SceneUpdateStats *update_stats = session->scene->update_stats;
+  if (update_stats) {
+    run.sync_time = update_stats->scene.times.total_time;
+    for (const NamedTimeEntry &entry : update_stats->geometry.times.entries) {
+      if (entry.name.find("BVH") != string::npos) {
+        run.bvh_build_time += entry.time;
+      }
+    }
+  }
+
+  RenderStats stats;
+  session->collect_statistics(&stats);
+  if (stats.has_profiling) {
+    run.has_kernel_stats = true;
+    run.kernel_stats = stats.kernel;
+    run.kernel_stats.update_sum();
+  }
+
+  runs.push_back(std::move(run));
+}
+
+string BenchmarkReport::to_json() const
+{
+  const double num_pixels = double(width) * height;
+
+  string result = "{\n";
+  result += "  \"scene\": " + json_string(scene_filepath) + ",\n";
+  result += "  \"device\": " + json_string(device) + ",\n";
+  result += string_printf("  \"width\": %d,\n", width);
+  result += string_printf("  \"height\": %d,\n", height);
+  result += string_printf("  \"samples\": %d,\n", samples);
+
+  result += "  \"runs\": [";
+  for (size_t i = 0; i < runs.size(); i++) {
+    const BenchmarkRun &run = runs[i];
+
+    result += (i == 0) ? "\n" : ",\n";
+    result += "    {\n";
+    result += "      \"load_time\": " + json_number(run.load_time) + ",\n";
+    result += "      \"sync_time\": " + json_number(run.sync_time) + ",\n";
+    result += "      \"bvh_build_time\": " + json_number(run.bvh_build_time) + ",\n";
+    result += "      \"total_time\": " + json_number(run.total_time) + ",\n";
+    result += "      \"render_time\": " + json_number(run.render_time) + ",\n";
+    result += string_printf("      \"pixel_samples\": %llu,\n",
+                            static_cast<unsigned long long>(run.pixel_samples));
+    result += "      \"samples_per_second\": " +
+              json_number(samples_per_second(run, num_pixels)) + ",\n";
+    result += string_printf("      \"peak_memory\": %llu",
+                            static_cast<unsigned long long>(run.peak_memory));
+    if (run.has_kernel_stats) {
+      result += ",\n      \"kernel\": " + kernel_stats_to_json(run.kernel_stats, 3);
+    }
+    result += "\n    }";
+  }
+  result += runs.empty() ? "],\n" : "\n  ],\n";
+
+  /* Median over the runs, which is robust against outliers caused by other processes. */
+  vector<double> sync_times, bvh_build_times, render_times, sample_rates;
+  size_t peak_memory = 0;
+  for (const BenchmarkRun &run : runs) {
+    sync_times.push_back(run.sync_time);
+    bvh_build_times.push_back(run.bvh_build_time);
+    render_times.push_back(run.render_time);
+    sample_rates.push_back(samples_per_second(run, num_pixels));
+    peak_memory = max(peak_memory, run.peak_memory);
+  }
+
+  result += "  \"median\": {\n";
+  result += "    \"sync_time\": " + json_number(median(sync_times)) + ",\n";
+  result += "    \"bvh_build_time\": " + json_number(median(bvh_build_times)) + ",\n";
+  result += "    \"render_time\": " + json_number(median(render_times)) + ",\n";
+  result += "    \"samples_per_second\": " + json_number(median(sample_rates)) + "\n";
+  result += "  },\n";
+  result += string_printf("  \"peak_memory\": %llu\n",
+                          static_cast<unsigned long long>(peak_memory));
+
+  return result + "}\n";
+}
+
+bool BenchmarkReport::write(const string &filepath) const
+{
+  const string json = to_json();
+
+  if (filepath.empty()) {
+    fputs(json.c_str(), stdout);
+    fflush(stdout);
+    return true;
+  }
+
+  FILE *file = path_fopen(filepath, "w");
+  if (file == nullptr) {
+    return false;
+  }
+
+  const bool success = fputs(json.c_str(), file) >= 0;
+  return (fclose(file) == 0) && success;
+}
+
+CCL_NAMESPACE_END
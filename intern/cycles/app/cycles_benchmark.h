@@ -0,0 +1,61 @@
+/* SPDX-FileCopyrightText: 2011-2024 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#ifndef __CYCLES_BENCHMARK_H__
+#define __CYCLES_BENCHMARK_H__
+
+#include "scene/stats.h"
+
+#include "util/string.h"
+#include "util/types.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+class Session;
+
+/* Measurements of rendering the scene once. */
+struct BenchmarkRun {
+  /* Time in seconds to read the scene file. */
+  double load_time = 0.0;
+  /* Time in seconds to synchronize the scene to the device, and the part of it spent on building
+   * BVHs. */
+  double sync_time = 0.0;
+  double bvh_build_time = 0.0;
+  /* Time in seconds from the start of the session, and from the start of path tracing. */
+  double total_time = 0.0;
+  double render_time = 0.0;
+
+  uint64_t pixel_samples = 0;
+  size_t peak_memory = 0;
+
+  /* Time spent in kernel events, sampled by the profiler. Only available on the CPU. */
+  bool has_kernel_stats = false;
+  NamedNestedSampleStats kernel_stats;
+};
+
+/* Report of rendering a scene a number of times, written as JSON for tracking performance. */
+class BenchmarkReport {
+ public:
+  /* Collect measurements of the finished render of the session. */
+  void add_run(Session *session, double load_time);
+
+  string to_json() const;
+
+  /* Write the JSON report to the file, or to the standard output if no file path is given.
+   * Returns true on success. */
+  bool write(const string &filepath) const;
+
+  string scene_filepath;
+  string device;
+  int width = 0;
+  int height = 0;
+  int samples = 0;
+
+  vector<BenchmarkRun> runs;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __CYCLES_BENCHMARK_H__ */
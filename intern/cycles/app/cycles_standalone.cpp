@@ -28,6 +28,7 @@
 #  include "hydra/file_reader.h"
 #endif
 
+#include "app/cycles_benchmark.h"
 #include "app/cycles_xml.h"
 #include "app/oiio_output_driver.h"
 
@@ -49,6 +50,11 @@ struct Options {
   bool show_help, interactive, pause;
   string output_filepath;
   string output_pass;
+  OIIOOutputDriver *output_driver;
+  vector<string> full_buffer_files;
+  int benchmark_runs;
+  string benchmark_output;
+  double scene_load_time;
 } options;
 
 static void session_print(const string &str)
@@ -69,6 +75,17 @@ static void session_print(const string &str)
   fflush(stdout);
 }
 
+static void output_driver_print(const string &str)
+{
+  /* Keep the standard output for the benchmark report. */
+  if (options.benchmark_runs > 0) {
+    fprintf(stderr, "%s\n", str.c_str());
+    return;
+  }
+
+  session_print(str);
+}
+
 static void session_print_status()
 {
   string status, substatus;
@@ -138,11 +155,18 @@ static void session_init()
   }
 #endif
 
+  options.output_driver = nullptr;
   if (!options.output_filepath.empty()) {
-    options.session->set_output_driver(make_unique<OIIOOutputDriver>(
-        options.output_filepath, options.output_pass, session_print));
+    unique_ptr<OIIOOutputDriver> output_driver = make_unique<OIIOOutputDriver>(
+        options.output_filepath, options.output_pass, output_driver_print);
+    options.output_driver = output_driver.get();
+    options.session->set_output_driver(std::move(output_driver));
   }
 
+  options.session->full_buffer_written_cb = [](string_view filename) {
+    options.full_buffer_files.emplace_back(filename);
+  };
+
   if (options.session_params.background && !options.quiet) {
     options.session->progress.set_update_callback(function_bind(&session_print_status));
   }
@@ -152,7 +176,14 @@ static void session_init()
 #endif
 
   /* load scene */
+  const double scene_load_start_time = time_dt();
   scene_init();
+  options.scene_load_time = time_dt() - scene_load_start_time;
+
+  if (options.benchmark_runs > 0) {
+    /* Only collect the statistics for the report, printing them would mix with it. */
+    options.scene->enable_update_stats(false);
+  }
 
   /* add pass for output. */
   Pass *pass = options.scene->create_node<Pass>();
@@ -163,11 +194,34 @@ static void session_init()
   options.session->start();
 }
 
+static void session_process_full_buffers()
+{
+  if (options.full_buffer_files.empty()) {
+    return;
+  }
+
+  /* Free scene memory before processing the full frame tiles file. */
+  options.session->device_free();
+
+  /* The full frame is written tile by tile when the tiles are streamed from the file. */
+  if (options.output_driver) {
+    options.output_driver->set_write_partial_tiles(true);
+  }
+
+  for (const string &filename : options.full_buffer_files) {
+    options.session->process_full_buffer_from_disk(filename);
+    path_remove(filename);
+  }
+
+  options.full_buffer_files.clear();
+}
+
 static void session_exit()
 {
   if (options.session) {
     delete options.session;
     options.session = NULL;
+    options.output_driver = nullptr;
   }
 
   if (options.session_params.background && !options.quiet) {
@@ -176,6 +230,43 @@ static void session_exit()
   }
 }
 
+static void benchmark_run()
+{
+  BenchmarkReport report;
+  report.scene_filepath = options.filepath;
+  report.device = options.session_params.device.description;
+  report.samples = options.session_params.samples;
+
+  /* Render with a new session every time, so that scene loading and synchronization are measured
+   * as well. */
+  for (int i = 0; i < options.benchmark_runs; i++) {
+    session_init();
+    options.session->wait();
+
+    if (options.session->progress.get_error()) {
+      fprintf(stderr,
+              "Error rendering scene: %s\n",
+              options.session->progress.get_error_message().c_str());
+      session_exit();
+      exit(EXIT_FAILURE);
+    }
+
+    report.add_run(options.session, options.scene_load_time);
+
+    session_process_full_buffers();
+    session_exit();
+  }
+
+  /* Resolution is known once the scene is loaded, when it is not given on the command line. */
+  report.width = options.width;
+  report.height = options.height;
+
+  if (!report.write(options.benchmark_output)) {
+    fprintf(stderr, "Failed to write benchmark report to %s\n", options.benchmark_output.c_str());
+    exit(EXIT_FAILURE);
+  }
+}
+
 #ifdef WITH_CYCLES_STANDALONE_GUI
 static void display_info(Progress &progress)
 {
@@ -366,6 +457,8 @@ static void options_parse(int argc, const char **argv)
   options.quiet = false;
   options.session_params.use_auto_tile = false;
   options.session_params.tile_size = 0;
+  options.benchmark_runs = 0;
+  options.scene_load_time = 0.0;
 
   /* device names */
   string device_names = "";
@@ -426,6 +519,16 @@ static void options_parse(int argc, const char **argv)
              "--tile-size %d",
              &options.session_params.tile_size,
              "Tile size in pixels",
+             "--stream-tiles",
+             &options.session_params.use_tile_streaming,
+             "Denoise and write tiles of the output pass one by one after rendering, to reduce "
+             "memory usage",
+             "--benchmark %d",
+             &options.benchmark_runs,
+             "Render the scene the given number of times and report performance as JSON",
+             "--benchmark-output %s",
+             &options.benchmark_output,
+             "File path to write the benchmark report to, instead of the standard output",
              "--list-devices",
              &list,
              "List information about all available devices",
@@ -494,6 +597,15 @@ static void options_parse(int argc, const char **argv)
   options.session_params.background = true;
 #endif
 
+  if (options.benchmark_runs > 0) {
+    /* Benchmarks run without a display and never print progress, so that the report can be
+     * written to the standard output. */
+    options.session_params.background = true;
+    options.session_params.headless = true;
+    options.session_params.use_profiling = true;
+    options.quiet = true;
+  }
+
   if (options.session_params.tile_size > 0) {
     options.session_params.use_auto_tile = true;
   }
@@ -545,11 +657,17 @@ int main(int argc, const char **argv)
   path_init();
   options_parse(argc, argv);
 
+  if (options.benchmark_runs > 0) {
+    benchmark_run();
+    return 0;
+  }
+
 #ifdef WITH_CYCLES_STANDALONE_GUI
   if (options.session_params.background) {
 #endif
     session_init();
     options.session->wait();
+    session_process_full_buffers();
     session_exit();
 #ifdef WITH_CYCLES_STANDALONE_GUI
   }
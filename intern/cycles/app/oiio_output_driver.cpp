@@ -6,11 +6,30 @@
 
 #include "scene/colorspace.h"
 
+#include <numeric>
+
 #include <OpenImageIO/imagebuf.h>
 #include <OpenImageIO/imagebufalgo.h>
 
 CCL_NAMESPACE_BEGIN
 
+/* Maximum size of tiles in the output image file. */
+static const int OUTPUT_IMAGE_TILE_SIZE = 128;
+
+static bool use_gamma_for_format(const ImageOutput *image_output)
+{
+  return ColorSpaceManager::detect_known_colorspace(
+             u_colorspace_auto, "", image_output->format_name(), true) == u_colorspace_srgb;
+}
+
+static void apply_gamma(ImageBuf &image_buffer)
+{
+  /* Apply gamma correction for (some) non-linear file formats.
+   * TODO: use OpenColorIO view transform if available. */
+  const float g = 1.0f / 2.2f;
+  ImageBufAlgo::pow(image_buffer, image_buffer, {g, g, g, 1.0f});
+}
+
 OIIOOutputDriver::OIIOOutputDriver(const string_view filepath,
                                    const string_view pass,
                                    LogFunction log)
@@ -18,52 +37,58 @@ OIIOOutputDriver::OIIOOutputDriver(const string_view filepath,
 {
 }
 
-OIIOOutputDriver::~OIIOOutputDriver() {}
+OIIOOutputDriver::~OIIOOutputDriver()
+{
+  close_tiled_output();
+}
 
 void OIIOOutputDriver::write_render_tile(const Tile &tile)
 {
-  /* Only write the full buffer, no intermediate tiles. */
+  /* Tiles of a full frame which is output tile by tile. */
   if (!(tile.size == tile.full_size)) {
+    if (write_partial_tiles_) {
+      write_partial_tile(tile);
+    }
     return;
   }
 
   log_(string_printf("Writing image %s", filepath_.c_str()));
 
+  const int width = tile.size.x;
+  const int height = tile.size.y;
+
+  vector<float> pixels(width * height * 4);
+  if (!tile.get_pass_pixels(pass_, 4, pixels.data())) {
+    log_("Failed to read render pass pixels");
+    return;
+  }
+
+  write_image(width, height, pixels.data());
+}
+
+void OIIOOutputDriver::write_image(const int width, const int height, float *pixels)
+{
   unique_ptr<ImageOutput> image_output(ImageOutput::create(filepath_));
   if (image_output == nullptr) {
     log_("Failed to create image file");
     return;
   }
 
-  const int width = tile.size.x;
-  const int height = tile.size.y;
-
   ImageSpec spec(width, height, 4, TypeDesc::FLOAT);
   if (!image_output->open(filepath_, spec)) {
     log_("Failed to create image file");
     return;
   }
 
-  vector<float> pixels(width * height * 4);
-  if (!tile.get_pass_pixels(pass_, 4, pixels.data())) {
-    log_("Failed to read render pass pixels");
-    return;
-  }
-
   /* Manipulate offset and stride to convert from bottom-up to top-down convention. */
   ImageBuf image_buffer(spec,
-                        pixels.data() + (height - 1) * width * 4,
+                        pixels + (height - 1) * width * 4,
                         AutoStride,
                         -width * 4 * sizeof(float),
                         AutoStride);
 
-  /* Apply gamma correction for (some) non-linear file formats.
-   * TODO: use OpenColorIO view transform if available. */
-  if (ColorSpaceManager::detect_known_colorspace(
-          u_colorspace_auto, "", image_output->format_name(), true) == u_colorspace_srgb)
-  {
-    const float g = 1.0f / 2.2f;
-    ImageBufAlgo::pow(image_buffer, image_buffer, {g, g, g, 1.0f});
+  if (use_gamma_for_format(image_output.get())) {
+    apply_gamma(image_buffer);
   }
 
   /* Write to disk and close */
@@ -72,4 +97,149 @@ void OIIOOutputDriver::write_render_tile(const Tile &tile)
   image_output->close();
 }
 
+void OIIOOutputDriver::write_partial_tile(const Tile &tile)
+{
+  if (tiled_state_.num_pixels_written == 0) {
+    open_tiled_output(tile);
+  }
+
+  const int width = tile.size.x;
+  const int height = tile.size.y;
+
+  /* Convert from bottom-up to top-down convention. */
+  const int x = tile.offset.x;
+  const int y = tile.full_size.y - tile.offset.y - height;
+
+  /* Tiles at the top of the image are padded with empty rows above them. */
+  const int pad_height = (y == 0) ? tiled_state_.pad_height : 0;
+
+  vector<float> pixels(static_cast<size_t>(width) * (height + pad_height) * 4, 0.0f);
+  if (!tile.get_pass_pixels(pass_, 4, pixels.data())) {
+    log_("Failed to read render pass pixels");
+    memset(pixels.data(), 0, pixels.size() * sizeof(float));
+  }
+
+  if (tiled_state_.image_output) {
+    float *top_row = pixels.data() + static_cast<size_t>(height + pad_height - 1) * width * 4;
+    const stride_t ystride = -static_cast<stride_t>(width * 4 * sizeof(float));
+
+    if (tiled_state_.use_gamma) {
+      ImageBuf image_buffer(ImageSpec(width, height + pad_height, 4, TypeDesc::FLOAT),
+                            top_row,
+                            AutoStride,
+                            ystride,
+                            AutoStride);
+      apply_gamma(image_buffer);
+    }
+
+    if (!tiled_state_.image_output->write_tiles(x,
+                                                x + width,
+                                                y - pad_height,
+                                                y + height,
+                                                0,
+                                                1,
+                                                TypeDesc::FLOAT,
+                                                top_row,
+                                                AutoStride,
+                                                ystride,
+                                                AutoStride))
+    {
+      log_("Failed to write image tile: " + tiled_state_.image_output->geterror());
+    }
+  }
+  else if (!tiled_state_.pixels.empty()) {
+    const int full_width = tiled_state_.full_size.x;
+    for (int i = 0; i < height; ++i) {
+      memcpy(tiled_state_.pixels.data() +
+                 (static_cast<size_t>(tile.offset.y + i) * full_width + tile.offset.x) * 4,
+             pixels.data() + static_cast<size_t>(i) * width * 4,
+             sizeof(float) * width * 4);
+    }
+  }
+
+  tiled_state_.num_pixels_written += static_cast<int64_t>(width) * height;
+
+  if (tiled_state_.num_pixels_written >=
+      static_cast<int64_t>(tiled_state_.full_size.x) * tiled_state_.full_size.y)
+  {
+    close_tiled_output();
+  }
+}
+
+bool OIIOOutputDriver::open_tiled_output(const Tile &tile)
+{
+  log_(string_printf("Writing image %s", filepath_.c_str()));
+
+  tiled_state_.full_size = tile.full_size;
+  tiled_state_.num_pixels_written = 0;
+
+  unique_ptr<ImageOutput> image_output(ImageOutput::create(filepath_));
+  if (image_output == nullptr) {
+    log_("Failed to create image file");
+    return false;
+  }
+
+  /* Image tiles have to be aligned with the received tiles, which come in a regular grid starting
+   * at the bottom left of the image. The image tile size divides the received tile size, unless
+   * there is a single received tile in that direction. */
+  const int2 tile_size = make_int2(
+      (tile.size.x < tile.full_size.x) ? std::gcd(tile.size.x, OUTPUT_IMAGE_TILE_SIZE) :
+                                         min(tile.full_size.x, OUTPUT_IMAGE_TILE_SIZE),
+      (tile.size.y < tile.full_size.y) ? std::gcd(tile.size.y, OUTPUT_IMAGE_TILE_SIZE) :
+                                         min(tile.full_size.y, OUTPUT_IMAGE_TILE_SIZE));
+
+  /* As the image is flipped vertically, the grid is only aligned with the top of the image when
+   * its height is a multiple of the tile height. Otherwise pad the image at the top, outside of
+   * its display window. */
+  const int pad_height = (tile.size.y < tile.full_size.y) ?
+                             int(align_up(tile.full_size.y, tile_size.y)) - tile.full_size.y :
+                             0;
+
+  if (!image_output->supports("tiles") ||
+      (pad_height != 0 &&
+       !(image_output->supports("displaywindow") && image_output->supports("negativeorigin"))))
+  {
+    tiled_state_.pixels.resize(static_cast<size_t>(tile.full_size.x) * tile.full_size.y * 4);
+    return true;
+  }
+
+  ImageSpec spec(tile.full_size.x, tile.full_size.y + pad_height, 4, TypeDesc::FLOAT);
+  spec.y = -pad_height;
+  spec.full_y = 0;
+  spec.full_height = tile.full_size.y;
+  spec.tile_width = tile_size.x;
+  spec.tile_height = tile_size.y;
+
+  /* Tiles are written as they are received, so that they do not need to be kept in memory. */
+  spec.attribute("openexr:lineOrder", "randomY");
+
+  if (!image_output->open(filepath_, spec)) {
+    log_("Failed to create image file");
+    return false;
+  }
+
+  tiled_state_.use_gamma = use_gamma_for_format(image_output.get());
+  tiled_state_.pad_height = pad_height;
+  tiled_state_.image_output = std::move(image_output);
+
+  return true;
+}
+
+void OIIOOutputDriver::close_tiled_output()
+{
+  if (tiled_state_.image_output) {
+    tiled_state_.image_output->close();
+  }
+  else if (!tiled_state_.pixels.empty()) {
+    write_image(tiled_state_.full_size.x, tiled_state_.full_size.y, tiled_state_.pixels.data());
+  }
+
+  tiled_state_.image_output = nullptr;
+  tiled_state_.pixels.clear();
+  tiled_state_.pixels.shrink_to_fit();
+  tiled_state_.full_size = make_int2(0, 0);
+  tiled_state_.num_pixels_written = 0;
+  tiled_state_.pad_height = 0;
+}
+
 CCL_NAMESPACE_END
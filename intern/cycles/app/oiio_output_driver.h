@@ -21,10 +21,47 @@ class OIIOOutputDriver : public OutputDriver {
 
   void write_render_tile(const Tile &tile) override;
 
+  /* Write tiles which are only a part of the full frame. Enabled while the full frame is read
+   * from the tiles file tile by tile after rendering. Tiles received before are ignored, as the
+   * full frame is written from the tiles file either way. */
+  void set_write_partial_tiles(const bool write_partial_tiles)
+  {
+    write_partial_tiles_ = write_partial_tiles;
+  }
+
  protected:
+  /* Write tile of a full frame which is output tile by tile into a tiled image file, without
+   * keeping the full image in memory. Formats without tiles support get the pixels accumulated
+   * and written once all tiles are received. */
+  void write_partial_tile(const Tile &tile);
+
+  bool open_tiled_output(const Tile &tile);
+  void close_tiled_output();
+
+  /* Write full image given in bottom-up order. */
+  void write_image(const int width, const int height, float *pixels);
+
   string filepath_;
   string pass_;
   LogFunction log_;
+
+  bool write_partial_tiles_ = false;
+
+  /* State of writing an image tile by tile. */
+  struct {
+    unique_ptr<ImageOutput> image_output;
+    bool use_gamma = false;
+
+    /* Full image pixels when the file format does not support tiles. */
+    vector<float> pixels;
+
+    int2 full_size = make_int2(0, 0);
+    int64_t num_pixels_written = 0;
+
+    /* Rows above the image, outside of its display window, which align the image tiles with the
+     * received tiles. */
+    int pad_height = 0;
+  } tiled_state_;
 };
 
 CCL_NAMESPACE_END
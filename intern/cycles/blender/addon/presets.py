@@ -52,6 +52,7 @@ class AddPresetSampling(AddPresetBase, Operator):
         "cycles.adaptive_threshold",
         "cycles.adaptive_min_samples",
         "cycles.time_limit",
+        "cycles.time_budget",
         "cycles.use_denoising",
         "cycles.denoiser",
         "cycles.denoising_input_passes",
@@ -108,6 +109,7 @@ class AddPresetPerformance(AddPresetBase, Operator):
         "cycles.debug_bvh_time_steps",
         "cycles.use_auto_tile",
         "cycles.tile_size",
+        "cycles.use_tile_streaming",
     ]
 
     preset_subdir = "cycles/performance"
@@ -505,6 +505,17 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         unit='TIME_ABSOLUTE',
     )
 
+    time_budget: FloatProperty(
+        name="Time Budget",
+        description="Limit the total render time of all frames of an animation, or of a single frame render "
+        "(excluding synchronization time). "
+        "Frames which took longer to converge before get more of the time. Zero disables the budget",
+        min=0.0,
+        default=0.0,
+        step=100.0,
+        unit='TIME_ABSOLUTE',
+    )
+
     sampling_pattern: EnumProperty(
         name="Sampling Pattern",
         description="Random sampling pattern used by the integrator",
@@ -1040,6 +1051,21 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         description="",
         min=8, max=8192,
     )
+    use_tile_streaming: BoolProperty(
+        name="Stream Tiles",
+        description="Denoise and output the cached tiles one by one after rendering, instead of loading the full "
+                    "image into Cycles. The render result still holds the full image. Tiles are denoised with an "
+                    "overlap to avoid visible seams",
+        default=False,
+    )
+    texture_cache_size: IntProperty(
+        name="Texture Cache Size",
+        description="Memory limit in megabytes for tiled image textures (such as .tx files) that are loaded on demand "
+                    "while rendering. Reduces memory usage and the time until rendering starts. 0 loads all image "
+                    "textures in full. Only supported on the CPU with SVM shading",
+        default=0,
+        min=0, soft_max=16384,
+    )
 
     # Various fine-tuning debug flags
 
@@ -1055,6 +1081,11 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         items=enum_bvh_layouts,
         default='EMBREE',
     )
+    debug_use_cpu_wavefront: BoolProperty(
+        name="Wavefront",
+        description="Render blocks of pixels by executing each kernel for all their paths at once, sorted by shader, instead of tracing paths one by one",
+        default=False,
+    )
 
     debug_use_cuda_adaptive_compile: BoolProperty(name="Adaptive Compile", default=False)
 
@@ -308,6 +308,7 @@ class CYCLES_RENDER_PT_sampling_render(CyclesButtonsPanel, Panel):
         else:
             col.prop(cscene, "samples", text="Samples")
         col.prop(cscene, "time_limit")
+        col.prop(cscene, "time_budget")
 
 
 class CYCLES_RENDER_PT_sampling_render_denoise(CyclesButtonsPanel, Panel):
@@ -828,6 +829,11 @@ class CYCLES_RENDER_PT_performance_memory(CyclesButtonsPanel, Panel):
         sub = col.column()
         sub.active = cscene.use_auto_tile
         sub.prop(cscene, "tile_size")
+        sub.prop(cscene, "use_tile_streaming")
+
+        sub = col.column()
+        sub.active = use_cpu(context) and not cscene.shading_system
+        sub.prop(cscene, "texture_cache_size")
 
 
 class CYCLES_RENDER_PT_performance_acceleration_structure(CyclesButtonsPanel, Panel):
@@ -2269,6 +2275,7 @@ class CYCLES_RENDER_PT_debug(CyclesDebugButtonsPanel, Panel):
         row.prop(cscene, "debug_use_cpu_sse42", toggle=True)
         row.prop(cscene, "debug_use_cpu_avx2", toggle=True)
         col.prop(cscene, "debug_bvh_layout", text="BVH")
+        col.prop(cscene, "debug_use_cpu_wavefront")
 
         col.separator()
 
@@ -41,6 +41,7 @@ CCL_NAMESPACE_BEGIN
 DeviceTypeMask BlenderSession::device_override = DEVICE_MASK_ALL;
 bool BlenderSession::headless = false;
 bool BlenderSession::print_render_stats = false;
+RenderTimeBudget BlenderSession::render_time_budget;
 
 BlenderSession::BlenderSession(BL::RenderEngine &b_engine,
                                BL::Preferences &b_userpref,
@@ -377,6 +378,29 @@ void BlenderSession::render(BL::Depsgraph &b_depsgraph_)
     num_views++;
   }
 
+  /* Distribute the time budget over all frames of the animation, with a separate render for
+   * every view layer and view. */
+  PointerRNA cscene = RNA_pointer_get(&b_scene.ptr, "cycles");
+  const double time_budget = (background && !b_engine.is_preview()) ?
+                                 get_float(cscene, "time_budget") :
+                                 0.0;
+  if (time_budget > 0.0) {
+    /* A single frame render gets the whole budget. */
+    int num_frames = 1;
+    if (b_engine.is_animation()) {
+      num_frames = max(
+          (b_scene.frame_end() - b_scene.frame_start()) / max(b_scene.frame_step(), 1) + 1, 1);
+    }
+
+    int num_view_layers = 0;
+    for (BL::ViewLayer &b_layer : b_scene.view_layers) {
+      num_view_layers += b_layer.use();
+    }
+
+    render_time_budget.set_sequence(
+        time_budget, num_frames, max(num_view_layers, 1) * num_views);
+  }
+
   int view_index = 0;
   for (b_rr.views.begin(b_view_iter); b_view_iter != b_rr.views.end(); ++b_view_iter, ++view_index)
   {
@@ -441,6 +465,11 @@ void BlenderSession::render(BL::Depsgraph &b_depsgraph_)
       effective_session_params.samples = samples;
     }
 
+    if (time_budget > 0.0) {
+      effective_session_params.frame_time_limit = render_time_budget.begin_render(
+          b_scene.frame_current());
+    }
+
     /* Update session itself. */
     session->reset(effective_session_params, buffer_params);
 
@@ -461,6 +490,12 @@ void BlenderSession::render(BL::Depsgraph &b_depsgraph_)
     if (session->progress.get_cancel()) {
       break;
     }
+
+    if (time_budget > 0.0) {
+      double render_time, converge_time;
+      session->get_render_time_estimate(render_time, converge_time);
+      render_time_budget.end_render(render_time, converge_time);
+    }
   }
 
   /* add metadata */
@@ -11,6 +11,8 @@
 
 #include "device/device.h"
 
+#include "integrator/render_budget.h"
+
 #include "scene/bake.h"
 #include "scene/scene.h"
 #include "session/session.h"
@@ -120,6 +122,9 @@ class BlenderSession {
 
   static bool print_render_stats;
 
+  /* Time budget for rendering an animation, shared by the sessions of its frames. */
+  static RenderTimeBudget render_time_budget;
+
  protected:
   void stamp_view_layer_metadata(Scene *scene, const string &view_layer_name);
 
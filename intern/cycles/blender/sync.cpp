@@ -859,6 +859,10 @@ SceneParams BlenderSync::get_scene_params(BL::Scene &b_scene,
   params.use_bvh_spatial_split = RNA_boolean_get(&cscene, "debug_use_spatial_splits");
   params.use_bvh_compact_structure = RNA_boolean_get(&cscene, "debug_use_compact_bvh");
   params.use_bvh_unaligned_nodes = RNA_boolean_get(&cscene, "debug_use_hair_bvh");
+  /* The scene is kept between updates in the viewport, and between frames of an animation
+   * render with persistent data. */
+  params.use_bvh_refit = !background || b_scene.render().use_persistent_data();
+  params.use_geometry_update_hash = background && b_scene.render().use_persistent_data();
   params.num_bvh_time_steps = RNA_int_get(&cscene, "debug_bvh_time_steps");
 
   PointerRNA csscene = RNA_pointer_get(&b_scene.ptr, "cycles_curves");
@@ -879,6 +883,7 @@ SceneParams BlenderSync::get_scene_params(BL::Scene &b_scene,
   else {
     params.texture_limit = 0;
   }
+  params.texture_cache_size = get_int(cscene, "texture_cache_size");
 
   params.bvh_layout = DebugFlags().cpu.bvh_layout;
 
@@ -982,9 +987,11 @@ SessionParams BlenderSync::get_session_params(BL::RenderEngine &b_engine,
   if (background) {
     params.use_auto_tile = RNA_boolean_get(&cscene, "use_auto_tile");
     params.tile_size = max(get_int(cscene, "tile_size"), 8);
+    params.use_tile_streaming = RNA_boolean_get(&cscene, "use_tile_streaming");
   }
   else {
     params.use_auto_tile = false;
+    params.use_tile_streaming = false;
   }
 
   return params;
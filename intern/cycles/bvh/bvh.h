@@ -69,6 +69,10 @@ class BVH {
   vector<Geometry *> geometry;
   vector<Object *> objects;
 
+  /* Set by the device when a refit was requested but not possible, and the BVH was built
+   * again instead. */
+  bool refit_failed = false;
+
   static BVH *create(const BVHParams &params,
                      const vector<Geometry *> &geometry,
                      const vector<Object *> &objects,
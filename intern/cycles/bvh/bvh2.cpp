@@ -17,6 +17,7 @@
 #include "bvh/unaligned.h"
 
 #include "util/foreach.h"
+#include "util/log.h"
 #include "util/progress.h"
 
 CCL_NAMESPACE_BEGIN
@@ -56,6 +57,10 @@ void BVH2::build(Progress &progress, Stats *)
     return;
   }
 
+  /* Remember quality of the built tree, to compare against when refitting. */
+  build_sah_cost = bvh2_root->computeSubtreeSAHCost(params);
+  own_prims_size = pack.prim_index.size();
+
   /* BVH builder returns tree in a binary mode (with two children per inner
    * node. Need to adopt that for a wider BVH implementations. */
   BVHNode *root = widen_children_nodes(bvh2_root);
@@ -87,17 +92,34 @@ void BVH2::build(Progress &progress, Stats *)
   root->deleteSubtree();
 }
 
-void BVH2::refit(Progress &progress)
+bool BVH2::refit(Progress &progress)
 {
+  if (params.top_level) {
+    /* Instanced BVHs were refit on their own, merge them again after the top level nodes. */
+    progress.set_substatus("Packing BVH instances");
+    if (!merge_instances()) {
+      VLOG_WORK << "Size of instanced BVHs changed, rebuilding instead of refitting.";
+      return false;
+    }
+  }
+
   progress.set_substatus("Packing BVH primitives");
-  pack_primitives();
+  pack_primitive_visibility();
 
   if (progress.get_cancel()) {
-    return;
+    return true;
   }
 
   progress.set_substatus("Refitting BVH nodes");
-  refit_nodes();
+  const float sah_cost = refit_nodes();
+
+  if (sah_cost > build_sah_cost * params.refit_sah_cost_threshold) {
+    VLOG_WORK << "Refitting increased BVH SAH cost from " << build_sah_cost << " to " << sah_cost
+              << ", rebuilding.";
+    return false;
+  }
+
+  return true;
 }
 
 BVHNode *BVH2::widen_children_nodes(const BVHNode *root)
@@ -245,6 +267,9 @@ void BVH2::pack_nodes(const BVHNode *root)
   else {
     node_size = num_inner_nodes * BVH_NODE_SIZE;
   }
+  own_nodes_size = node_size;
+  own_leaf_nodes_size = num_leaf_nodes * BVH_NODE_LEAF_SIZE;
+
   /* Resize arrays */
   pack.nodes.clear();
   pack.leaf_nodes.clear();
@@ -303,16 +328,20 @@ void BVH2::pack_nodes(const BVHNode *root)
   pack.root_index = (root->is_leaf()) ? -1 : 0;
 }
 
-void BVH2::refit_nodes()
+float BVH2::refit_nodes()
 {
-  assert(!params.top_level);
-
   BoundBox bbox = BoundBox::empty;
   uint visibility = 0;
-  refit_node(0, (pack.root_index == -1) ? true : false, bbox, visibility);
+  float cost = 0.0f;
+  refit_node(0, (pack.root_index == -1) ? true : false, bbox, visibility, cost);
+
+  /* Same as BVHNode::computeSubtreeSAHCost(), with node costs weighted by area relative to
+   * the root. */
+  const float area = bbox.safe_area();
+  return (area > 0.0f) ? cost / area : 0.0f;
 }
 
-void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
+void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility, float &cost)
 {
   if (leaf) {
     /* refit leaf node */
@@ -321,7 +350,15 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
     const int c0 = data[0].x;
     const int c1 = data[0].y;
 
-    refit_primitives(c0, c1, bbox, visibility);
+    if (c0 < 0) {
+      /* Object instance in the top level BVH, see pack_leaf(). */
+      refit_primitives(~c0, ~c0 + 1, bbox, visibility);
+      cost += bbox.safe_area() * params.primitive_cost(1);
+    }
+    else {
+      refit_primitives(c0, c1, bbox, visibility);
+      cost += bbox.safe_area() * params.primitive_cost(c1 - c0);
+    }
 
     /* TODO(sergey): De-duplicate with pack_leaf(). */
     float4 leaf_data[BVH_NODE_LEAF_SIZE];
@@ -342,8 +379,8 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
     BoundBox bbox0 = BoundBox::empty, bbox1 = BoundBox::empty;
     uint visibility0 = 0, visibility1 = 0;
 
-    refit_node((c0 < 0) ? -c0 - 1 : c0, (c0 < 0), bbox0, visibility0);
-    refit_node((c1 < 0) ? -c1 - 1 : c1, (c1 < 0), bbox1, visibility1);
+    refit_node((c0 < 0) ? -c0 - 1 : c0, (c0 < 0), bbox0, visibility0, cost);
+    refit_node((c1 < 0) ? -c1 - 1 : c1, (c1 < 0), bbox1, visibility1, cost);
 
     if (is_unaligned) {
       Transform aligned_space = transform_identity();
@@ -357,6 +394,7 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
     bbox.grow(bbox0);
     bbox.grow(bbox1);
     visibility = visibility0 | visibility1;
+    cost += bbox.safe_area() * params.node_cost(2);
   }
 }
 
@@ -458,12 +496,18 @@ void BVH2::refit_primitives(int start, int end, BoundBox &bbox, uint &visibility
 
 void BVH2::pack_primitives()
 {
-  const size_t tidx_size = pack.prim_index.size();
   /* Reserve size for arrays. */
   pack.prim_visibility.clear();
-  pack.prim_visibility.resize(tidx_size);
+  pack.prim_visibility.resize(pack.prim_index.size());
   /* Fill in all the arrays. */
-  for (unsigned int i = 0; i < tidx_size; i++) {
+  pack_primitive_visibility();
+}
+
+void BVH2::pack_primitive_visibility()
+{
+  /* Primitives of instanced BVHs merged into the top level come after its own primitives,
+   * and get their visibility from the instanced BVH. */
+  for (size_t i = 0; i < own_prims_size; i++) {
     if (pack.prim_index[i] != -1) {
       int tob = pack.prim_object[i];
       Object *ob = objects[tob];
@@ -488,22 +532,9 @@ void BVH2::pack_instances(size_t nodes_size, size_t leaf_nodes_size)
     }
   }
 
-  /* track offsets of instanced BVH data in global array */
-  size_t prim_offset = pack.prim_index.size();
-  size_t nodes_offset = nodes_size;
-  size_t nodes_leaf_offset = leaf_nodes_size;
-
-  /* clear array that gives the node indexes for instanced objects */
-  pack.object_node.clear();
-
   /* reserve */
   size_t prim_index_size = pack.prim_index.size();
 
-  size_t pack_prim_index_offset = prim_index_size;
-  size_t pack_nodes_offset = nodes_size;
-  size_t pack_leaf_nodes_offset = leaf_nodes_size;
-  size_t object_offset = 0;
-
   foreach (Geometry *geom, geometry) {
     BVH2 *bvh = static_cast<BVH2 *>(geom->bvh);
 
@@ -520,7 +551,6 @@ void BVH2::pack_instances(size_t nodes_size, size_t leaf_nodes_size)
   pack.prim_visibility.resize(prim_index_size);
   pack.nodes.resize(nodes_size);
   pack.leaf_nodes.resize(leaf_nodes_size);
-  pack.object_node.resize(objects.size());
 
   if (params.num_motion_curve_steps > 0 || params.num_motion_triangle_steps > 0 ||
       params.num_motion_point_steps > 0)
@@ -528,6 +558,47 @@ void BVH2::pack_instances(size_t nodes_size, size_t leaf_nodes_size)
     pack.prim_time.resize(prim_index_size);
   }
 
+  merge_instances();
+}
+
+bool BVH2::merge_instances()
+{
+  /* track offsets of instanced BVH data in global array */
+  size_t prim_offset = own_prims_size;
+  size_t nodes_offset = own_nodes_size;
+  size_t nodes_leaf_offset = own_leaf_nodes_size;
+
+  size_t pack_prim_index_offset = own_prims_size;
+  size_t pack_nodes_offset = own_nodes_size;
+  size_t pack_leaf_nodes_offset = own_leaf_nodes_size;
+  size_t object_offset = 0;
+
+  /* Instanced BVHs may have been rebuilt since the top level was packed, in which case their
+   * data does not fit anymore. */
+  size_t prim_index_size = own_prims_size;
+  size_t nodes_size = own_nodes_size;
+  size_t leaf_nodes_size = own_leaf_nodes_size;
+
+  foreach (Geometry *geom, geometry) {
+    BVH2 *bvh = static_cast<BVH2 *>(geom->bvh);
+
+    if (geom->need_build_bvh(params.bvh_layout)) {
+      prim_index_size += bvh->pack.prim_index.size();
+      nodes_size += bvh->pack.nodes.size();
+      leaf_nodes_size += bvh->pack.leaf_nodes.size();
+    }
+  }
+
+  if (prim_index_size != pack.prim_index.size() || nodes_size != pack.nodes.size() ||
+      leaf_nodes_size != pack.leaf_nodes.size())
+  {
+    return false;
+  }
+
+  /* clear array that gives the node indexes for instanced objects */
+  pack.object_node.clear();
+  pack.object_node.resize(objects.size());
+
   int *pack_prim_index = (pack.prim_index.size()) ? &pack.prim_index[0] : NULL;
   int *pack_prim_type = (pack.prim_type.size()) ? &pack.prim_type[0] : NULL;
   int *pack_prim_object = (pack.prim_object.size()) ? &pack.prim_object[0] : NULL;
@@ -651,6 +722,8 @@ void BVH2::pack_instances(size_t nodes_size, size_t leaf_nodes_size)
     nodes_leaf_offset += bvh->pack.leaf_nodes.size();
     prim_offset += bvh->pack.prim_index.size();
   }
+
+  return true;
 }
 
 CCL_NAMESPACE_END
@@ -36,7 +36,10 @@ struct BVHStackEntry {
 class BVH2 : public BVH {
  public:
   void build(Progress &progress, Stats *stats);
-  void refit(Progress &progress);
+  /* Update bounds of the nodes for deformed geometry. Returns false when the BVH needs to be
+   * built again instead, because the refit degraded its SAH cost too much or the instanced
+   * BVHs to merge into the top level changed size. */
+  bool refit(Progress &progress);
 
   PackedBVH pack;
 
@@ -80,19 +83,30 @@ class BVH2 : public BVH {
                            uint visibility0,
                            uint visibility1);
 
-  /* refit */
-  void refit_nodes();
-  void refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility);
+  /* refit, returns the SAH cost of the refit nodes */
+  float refit_nodes();
+  void refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility, float &cost);
 
   /* Refit range of primitives. */
   void refit_primitives(int start, int end, BoundBox &bbox, uint &visibility);
 
   /* triangles and strands */
   void pack_primitives();
+  void pack_primitive_visibility();
   void pack_triangle(int idx, float4 storage[3]);
 
   /* merge instance BVH's */
   void pack_instances(size_t nodes_size, size_t leaf_nodes_size);
+  bool merge_instances();
+
+  /* SAH cost of the nodes after the last build, to detect when refitting degrades them. */
+  float build_sah_cost = 0.0f;
+
+  /* Size of the arrays used by the nodes and primitives of this BVH itself, for the top level
+   * the instanced BVHs are merged after them. */
+  size_t own_nodes_size = 0;
+  size_t own_leaf_nodes_size = 0;
+  size_t own_prims_size = 0;
 };
 
 CCL_NAMESPACE_END
@@ -100,7 +100,9 @@ BVHEmbree::BVHEmbree(const BVHParams &params_,
     : BVH(params_, geometry_, objects_),
       scene(NULL),
       rtc_device(NULL),
-      build_quality(RTC_BUILD_QUALITY_REFIT)
+      build_quality(RTC_BUILD_QUALITY_REFIT),
+      geometry_build_quality(RTC_BUILD_QUALITY_REFIT),
+      build_bounds_area(0.0f)
 {
   SIMD_SET_FLUSH_TO_ZERO;
 }
@@ -147,6 +149,11 @@ void BVHEmbree::build(Progress &progress,
                             (params.use_spatial_split ? RTC_BUILD_QUALITY_HIGH :
                                                         RTC_BUILD_QUALITY_MEDIUM);
   rtcSetSceneBuildQuality(scene, build_quality);
+  /* Refit quality makes updates of deforming geometry faster at the cost of ray tracing
+   * performance, which only pays off for interactive updates. Final renders with persistent
+   * data keep the regular quality, Embree builds the modified geometry again on commit. */
+  geometry_build_quality = (dynamic && params.use_refit) ? RTC_BUILD_QUALITY_REFIT :
+                                                            build_quality;
 
   int i = 0;
   foreach (Object *ob, objects) {
@@ -176,6 +183,8 @@ void BVHEmbree::build(Progress &progress,
 
   rtcSetSceneProgressMonitorFunction(scene, rtc_progress_func, &progress);
   rtcCommitScene(scene);
+
+  build_bounds_area = geometry_bounds_area();
 }
 
 const char *BVHEmbree::get_last_error_message()
@@ -260,7 +269,24 @@ void BVHEmbree::add_instance(Object *ob, int i)
   rtcSetGeometryInstancedScene(geom_id, instance_bvh->scene);
   rtcSetGeometryTimeStepCount(geom_id, num_motion_steps);
 
+  set_instance_transform(geom_id, ob);
+
+  rtcSetGeometryUserData(geom_id, (void *)instance_bvh->scene);
+  rtcSetGeometryMask(geom_id, ob->visibility_for_tracing());
+#  if EMBREE_MAJOR_VERSION >= 4
+  rtcSetGeometryEnableFilterFunctionFromArguments(geom_id, true);
+#  endif
+
+  rtcCommitGeometry(geom_id);
+  rtcAttachGeometryByID(scene, geom_id, i * 2);
+  rtcReleaseGeometry(geom_id);
+}
+
+void BVHEmbree::set_instance_transform(RTCGeometry geom_id, const Object *ob)
+{
   if (ob->use_motion()) {
+    const size_t num_motion_steps = min(ob->get_motion().size(),
+                                        (size_t)RTC_MAX_TIME_STEP_COUNT);
     array<DecomposedTransform> decomp(ob->get_motion().size());
     transform_motion_decompose(decomp.data(), ob->get_motion().data(), ob->get_motion().size());
     for (size_t step = 0; step < num_motion_steps; ++step) {
@@ -281,16 +307,6 @@ void BVHEmbree::add_instance(Object *ob, int i)
     rtcSetGeometryTransform(
         geom_id, 0, RTC_FORMAT_FLOAT3X4_ROW_MAJOR, (const float *)&ob->get_tfm());
   }
-
-  rtcSetGeometryUserData(geom_id, (void *)instance_bvh->scene);
-  rtcSetGeometryMask(geom_id, ob->visibility_for_tracing());
-#  if EMBREE_MAJOR_VERSION >= 4
-  rtcSetGeometryEnableFilterFunctionFromArguments(geom_id, true);
-#  endif
-
-  rtcCommitGeometry(geom_id);
-  rtcAttachGeometryByID(scene, geom_id, i * 2);
-  rtcReleaseGeometry(geom_id);
 }
 
 void BVHEmbree::add_triangles(const Object *ob, const Mesh *mesh, int i)
@@ -309,14 +325,34 @@ void BVHEmbree::add_triangles(const Object *ob, const Mesh *mesh, int i)
   assert(num_motion_steps <= RTC_MAX_TIME_STEP_COUNT);
   num_motion_steps = min(num_motion_steps, (size_t)RTC_MAX_TIME_STEP_COUNT);
 
-  const size_t num_triangles = mesh->num_triangles();
-
   RTCGeometry geom_id = rtcNewGeometry(rtc_device, RTC_GEOMETRY_TYPE_TRIANGLE);
-  rtcSetGeometryBuildQuality(geom_id, build_quality);
+  rtcSetGeometryBuildQuality(geom_id, geometry_build_quality);
   rtcSetGeometryTimeStepCount(geom_id, num_motion_steps);
 
+  set_tri_index_buffer(geom_id, mesh, false);
+  set_tri_vertex_buffer(geom_id, mesh, false);
+
+  rtcSetGeometryUserData(geom_id, (void *)prim_offset);
+  rtcSetGeometryMask(geom_id, ob->visibility_for_tracing());
+#  if EMBREE_MAJOR_VERSION >= 4
+  rtcSetGeometryEnableFilterFunctionFromArguments(geom_id, true);
+#  else
+  rtcSetGeometryOccludedFilterFunction(geom_id, kernel_embree_filter_occluded_func);
+  rtcSetGeometryIntersectFilterFunction(geom_id, kernel_embree_filter_intersection_func);
+#  endif
+
+  rtcCommitGeometry(geom_id);
+  rtcAttachGeometryByID(scene, geom_id, i * 2);
+  rtcReleaseGeometry(geom_id);
+}
+
+void BVHEmbree::set_tri_index_buffer(RTCGeometry geom_id, const Mesh *mesh, const bool update)
+{
+  const size_t num_triangles = mesh->num_triangles();
   const int *triangles = mesh->get_triangles().data();
+
   if (!rtc_device_is_sycl) {
+    /* Also shared again on update, as the triangles array may have been reallocated since. */
     rtcSetSharedGeometryBuffer(geom_id,
                                RTC_BUFFER_TYPE_INDEX,
                                0,
@@ -326,11 +362,11 @@ void BVHEmbree::add_triangles(const Object *ob, const Mesh *mesh, int i)
                                sizeof(int) * 3,
                                num_triangles);
   }
-  else {
+  else if (!update) {
     /* NOTE(sirgienko): If the Embree device is a SYCL device, then Embree execution will
      * happen on GPU, and we cannot use standard host pointers at this point. So instead
      * of making a shared geometry buffer - a new Embree buffer will be created and data
-     * will be copied. */
+     * will be copied. Triangles don't change when refitting, the copy stays valid. */
     int *triangles_buffer = (int *)rtcSetNewGeometryBuffer(
         geom_id, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3, sizeof(int) * 3, num_triangles);
     assert(triangles_buffer);
@@ -339,20 +375,6 @@ void BVHEmbree::add_triangles(const Object *ob, const Mesh *mesh, int i)
       std::memcpy(triangles_buffer, triangles, sizeof(int) * 3 * (num_triangles));
     }
   }
-  set_tri_vertex_buffer(geom_id, mesh, false);
-
-  rtcSetGeometryUserData(geom_id, (void *)prim_offset);
-  rtcSetGeometryMask(geom_id, ob->visibility_for_tracing());
-#  if EMBREE_MAJOR_VERSION >= 4
-  rtcSetGeometryEnableFilterFunctionFromArguments(geom_id, true);
-#  else
-  rtcSetGeometryOccludedFilterFunction(geom_id, kernel_embree_filter_occluded_func);
-  rtcSetGeometryIntersectFilterFunction(geom_id, kernel_embree_filter_intersection_func);
-#  endif
-
-  rtcCommitGeometry(geom_id);
-  rtcAttachGeometryByID(scene, geom_id, i * 2);
-  rtcReleaseGeometry(geom_id);
 }
 
 void BVHEmbree::set_tri_vertex_buffer(RTCGeometry geom_id, const Mesh *mesh, const bool update)
@@ -383,7 +405,9 @@ void BVHEmbree::set_tri_vertex_buffer(RTCGeometry geom_id, const Mesh *mesh, con
       verts = &attr_mP->data_float3()[t_ * num_verts];
     }
 
-    if (update) {
+    /* Shared buffers are also set again on update, as the vertex arrays may have been
+     * reallocated since. */
+    if (update && rtc_device_is_sycl) {
       rtcUpdateGeometryBuffer(geom_id, RTC_BUFFER_TYPE_VERTEX, t);
     }
     else {
@@ -591,7 +615,7 @@ void BVHEmbree::add_points(const Object *ob, const PointCloud *pointcloud, int i
 
   RTCGeometry geom_id = rtcNewGeometry(rtc_device, type);
 
-  rtcSetGeometryBuildQuality(geom_id, build_quality);
+  rtcSetGeometryBuildQuality(geom_id, geometry_build_quality);
   rtcSetGeometryTimeStepCount(geom_id, num_motion_steps);
 
   set_point_vertex_buffer(geom_id, pointcloud, false);
@@ -654,7 +678,7 @@ void BVHEmbree::add_curves(const Object *ob, const Hair *hair, int i)
     }
   }
 
-  rtcSetGeometryBuildQuality(geom_id, build_quality);
+  rtcSetGeometryBuildQuality(geom_id, geometry_build_quality);
   rtcSetGeometryTimeStepCount(geom_id, num_motion_steps);
 
   set_curve_vertex_buffer(geom_id, hair, false);
@@ -680,22 +704,34 @@ void BVHEmbree::add_curves(const Object *ob, const Hair *hair, int i)
   rtcReleaseGeometry(geom_id);
 }
 
-void BVHEmbree::refit(Progress &progress)
+bool BVHEmbree::refit(Progress &progress)
 {
   progress.set_substatus("Refitting BVH nodes");
 
   /* Update all vertex buffers, then tell Embree to rebuild/-fit the BVHs. */
   unsigned geom_id = 0;
   foreach (Object *ob, objects) {
-    if (!params.top_level || (ob->is_traceable() && !ob->get_geometry()->is_instanced())) {
+    if (params.top_level && ob->is_traceable() && ob->get_geometry()->is_instanced()) {
+      /* Instanced scene is refit on its own, but may have been rebuilt. */
+      BVHEmbree *instance_bvh = (BVHEmbree *)(ob->get_geometry()->bvh);
+      RTCGeometry geom = rtcGetGeometry(scene, geom_id);
+      rtcSetGeometryInstancedScene(geom, instance_bvh->scene);
+      set_instance_transform(geom, ob);
+      rtcSetGeometryUserData(geom, (void *)instance_bvh->scene);
+      rtcSetGeometryMask(geom, ob->visibility_for_tracing());
+      rtcCommitGeometry(geom);
+    }
+    else if (!params.top_level || ob->is_traceable()) {
       Geometry *geom = ob->get_geometry();
 
       if (geom->geometry_type == Geometry::MESH || geom->geometry_type == Geometry::VOLUME) {
         Mesh *mesh = static_cast<Mesh *>(geom);
         if (mesh->num_triangles() > 0) {
           RTCGeometry geom = rtcGetGeometry(scene, geom_id);
+          set_tri_index_buffer(geom, mesh, true);
           set_tri_vertex_buffer(geom, mesh, true);
           rtcSetGeometryUserData(geom, (void *)mesh->prim_offset);
+          rtcSetGeometryMask(geom, ob->visibility_for_tracing());
           rtcCommitGeometry(geom);
         }
       }
@@ -705,6 +741,7 @@ void BVHEmbree::refit(Progress &progress)
           RTCGeometry geom = rtcGetGeometry(scene, geom_id + 1);
           set_curve_vertex_buffer(geom, hair, true);
           rtcSetGeometryUserData(geom, (void *)hair->curve_segment_offset);
+          rtcSetGeometryMask(geom, ob->visibility_for_tracing());
           rtcCommitGeometry(geom);
         }
       }
@@ -713,6 +750,7 @@ void BVHEmbree::refit(Progress &progress)
         if (pointcloud->num_points() > 0) {
           RTCGeometry geom = rtcGetGeometry(scene, geom_id);
           set_point_vertex_buffer(geom, pointcloud, true);
+          rtcSetGeometryMask(geom, ob->visibility_for_tracing());
           rtcCommitGeometry(geom);
         }
       }
@@ -720,7 +758,33 @@ void BVHEmbree::refit(Progress &progress)
     geom_id += 2;
   }
 
+  const float bounds_area = geometry_bounds_area();
+  if (bounds_area > build_bounds_area * params.refit_sah_cost_threshold) {
+    VLOG_WORK << "Refitting increased geometry bounds area from " << build_bounds_area << " to "
+              << bounds_area << ", rebuilding.";
+    return false;
+  }
+
   rtcCommitScene(scene);
+  return true;
+}
+
+float BVHEmbree::geometry_bounds_area() const
+{
+  /* Objects in the top level are in world space, for instanced geometry only the geometry
+   * itself is in the BVH. */
+  float area = 0.0f;
+  foreach (const Object *ob, objects) {
+    if (params.top_level) {
+      if (ob->is_traceable()) {
+        area += ob->bounds.safe_area();
+      }
+    }
+    else {
+      area += ob->get_geometry()->bounds.safe_area();
+    }
+  }
+  return area;
 }
 
 CCL_NAMESPACE_END
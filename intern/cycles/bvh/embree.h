@@ -35,7 +35,9 @@ class BVHEmbree : public BVH {
              Stats *stats,
              RTCDevice rtc_device,
              const bool isSyclEmbreeDevice = false);
-  void refit(Progress &progress);
+  /* Update vertex buffers and instance transforms of deformed geometry, returns false when
+   * the BVH needs to be built again instead. */
+  bool refit(Progress &progress);
 
 #  if defined(WITH_EMBREE_GPU) && RTC_VERSION >= 40302
   bool offload_scenes_to_gpu(const vector<RTCScene> &scenes);
@@ -58,7 +60,14 @@ class BVHEmbree : public BVH {
   void add_points(const Object *ob, const PointCloud *pointcloud, int i);
   void add_triangles(const Object *ob, const Mesh *mesh, int i);
 
+  void set_instance_transform(RTCGeometry geom_id, const Object *ob);
+
+  /* Embree does not expose its nodes to estimate their SAH cost, use the surface area of the
+   * geometry bounds instead to detect when deformation degrades the refit BVH. */
+  float geometry_bounds_area() const;
+
  private:
+  void set_tri_index_buffer(RTCGeometry geom_id, const Mesh *mesh, const bool update);
   void set_tri_vertex_buffer(RTCGeometry geom_id, const Mesh *mesh, const bool update);
   void set_curve_vertex_buffer(RTCGeometry geom_id, const Hair *hair, const bool update);
   void set_point_vertex_buffer(RTCGeometry geom_id,
@@ -68,6 +77,8 @@ class BVHEmbree : public BVH {
   RTCDevice rtc_device;
   bool rtc_device_is_sycl;
   enum RTCBuildQuality build_quality;
+  enum RTCBuildQuality geometry_build_quality;
+  float build_bounds_area;
 };
 
 CCL_NAMESPACE_END
@@ -108,6 +108,14 @@ class BVHParams {
   /* These are needed for Embree. */
   int curve_subdivisions;
 
+  /* Geometry is expected to deform between updates of a persistent scene, so build the BVH
+   * in a way that it can be refit quickly instead of rebuilt. */
+  bool use_refit;
+
+  /* Refitting is abandoned for a full rebuild once the SAH cost of the refit BVH exceeds
+   * the cost after the last build by this factor. */
+  float refit_sah_cost_threshold;
+
   /* fixed parameters */
   enum { MAX_DEPTH = 64, MAX_SPATIAL_DEPTH = 48, NUM_SPATIAL_BINS = 32 };
 
@@ -143,6 +151,9 @@ class BVHParams {
     bvh_type = 0;
 
     curve_subdivisions = 4;
+
+    use_refit = false;
+    refit_sah_cost_threshold = 1.5f;
   }
 
   /* SAH costs */
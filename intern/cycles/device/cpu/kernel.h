@@ -42,6 +42,8 @@ class CPUKernels {
   IntegratorShadeFunction integrator_shade_volume;
   IntegratorShadeFunction integrator_shade_dedicated_light;
   IntegratorShadeFunction integrator_megakernel;
+  IntegratorShadeFunction integrator_megakernel_shadow_paths;
+  IntegratorShadeFunction integrator_megakernel_path;
 
   /* Shader evaluation. */
 
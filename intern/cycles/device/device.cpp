@@ -54,10 +54,8 @@ void Device::build_bvh(BVH *bvh, Progress &progress, bool refit)
   assert(bvh->params.bvh_layout == BVH_LAYOUT_BVH2);
 
   BVH2 *const bvh2 = static_cast<BVH2 *>(bvh);
-  if (refit) {
-    bvh2->refit(progress);
-  }
-  else {
+  bvh2->refit_failed = refit && !bvh2->refit(progress);
+  if (!refit || bvh2->refit_failed) {
     bvh2->build(progress, &stats);
   }
 }
@@ -165,6 +165,7 @@ device_texture::device_texture(Device *device,
       data_elements = 4;
       break;
     case IMAGE_DATA_TYPE_BYTE:
+    case IMAGE_DATA_TYPE_TILE_CACHE:
     case IMAGE_DATA_TYPE_NANOVDB_FLOAT:
     case IMAGE_DATA_TYPE_NANOVDB_FLOAT3:
     case IMAGE_DATA_TYPE_NANOVDB_FPN:
@@ -175,10 +175,8 @@ void OneapiDevice::build_bvh(BVH *bvh, Progress &progress, bool refit)
 {
   if (embree_device && bvh->params.bvh_layout == BVH_LAYOUT_EMBREEGPU) {
     BVHEmbree *const bvh_embree = static_cast<BVHEmbree *>(bvh);
-    if (refit) {
-      bvh_embree->refit(progress);
-    }
-    else {
+    bvh_embree->refit_failed = refit && !bvh_embree->refit(progress);
+    if (!refit || bvh_embree->refit_failed) {
       bvh_embree->build(progress, &stats, embree_device, true);
     }
 
@@ -454,6 +454,7 @@ void PathTrace::adaptive_sample(RenderWork &render_work)
 
     render_scheduler_.report_adaptive_filter_time(
         render_work, time_dt() - start_time, is_cancel_requested());
+    render_scheduler_.report_adaptive_filter_num_active_pixels(num_active_pixels);
 
     if (num_active_pixels == 0) {
       VLOG_WORK << "All pixels converged.";
@@ -985,26 +986,43 @@ bool PathTrace::copy_render_tile_from_device()
   return success;
 }
 
-static string get_layer_view_name(const RenderBuffers &buffers)
+static string get_layer_view_name(const BufferParams &params)
 {
   string result;
 
-  if (buffers.params.layer.size()) {
-    result += string(buffers.params.layer);
+  if (params.layer.size()) {
+    result += string(params.layer);
   }
 
-  if (buffers.params.view.size()) {
+  if (params.view.size()) {
     if (!result.empty()) {
       result += ", ";
     }
-    result += string(buffers.params.view);
+    result += string(params.view);
   }
 
   return result;
 }
 
-void PathTrace::process_full_buffer_from_disk(string_view filename)
+void PathTrace::full_buffer_read_error()
 {
+  const string error_message = "Error reading tiles from file";
+  if (progress_) {
+    progress_->set_error(error_message);
+    progress_->set_cancel(error_message);
+  }
+  else {
+    LOG(ERROR) << error_message;
+  }
+}
+
+void PathTrace::process_full_buffer_from_disk(string_view filename, const bool use_streaming)
+{
+  if (use_streaming) {
+    stream_full_buffer_from_disk(filename);
+    return;
+  }
+
   VLOG_WORK << "Processing full frame buffer file " << filename;
 
   progress_set_status("Reading full buffer from disk");
@@ -1013,18 +1031,11 @@ void PathTrace::process_full_buffer_from_disk(string_view filename)
 
   DenoiseParams denoise_params;
   if (!tile_manager_.read_full_buffer_from_disk(filename, &full_frame_buffers, &denoise_params)) {
-    const string error_message = "Error reading tiles from file";
-    if (progress_) {
-      progress_->set_error(error_message);
-      progress_->set_cancel(error_message);
-    }
-    else {
-      LOG(ERROR) << error_message;
-    }
+    full_buffer_read_error();
     return;
   }
 
-  const string layer_view_name = get_layer_view_name(full_frame_buffers);
+  const string layer_view_name = get_layer_view_name(full_frame_buffers.params);
 
   render_state_.has_denoised_result = false;
 
@@ -1059,6 +1070,95 @@ void PathTrace::process_full_buffer_from_disk(string_view filename)
   full_frame_state_.render_buffers = nullptr;
 }
 
+void PathTrace::stream_full_buffer_from_disk(string_view filename)
+{
+  VLOG_WORK << "Streaming full frame buffer file " << filename;
+
+  progress_set_status("Reading full buffer from disk");
+
+  BufferParams full_params;
+  DenoiseParams denoise_params;
+  int2 tile_size;
+  if (!tile_manager_.open_full_buffer_from_disk(
+          filename, &full_params, &denoise_params, &tile_size))
+  {
+    full_buffer_read_error();
+    return;
+  }
+
+  const string layer_view_name = get_layer_view_name(full_params);
+
+  if (denoise_params.use) {
+    /* If GPU should be used is not based on file metadata. */
+    denoise_params.use_gpu = render_scheduler_.is_denoiser_gpu_used();
+
+    /* Re-use the denoiser, same as for the full-frame processing. */
+    set_denoiser_params(denoise_params);
+  }
+
+  /* The denoiser needs to see pixels around the tile to give the same result at both sides of the
+   * tile border, so denoise tiles with an overlap and only write their window. */
+  const int overlap = denoise_params.use ? TileManager::DENOISE_TILE_OVERLAP : 0;
+
+  const int num_tiles_x = divide_up(full_params.width, tile_size.x);
+  const int num_tiles_y = divide_up(full_params.height, tile_size.y);
+  const int num_tiles = num_tiles_x * num_tiles_y;
+
+  RenderBuffers tile_buffers(cpu_device_.get());
+
+  full_frame_state_.full_params = &full_params;
+
+  for (int tile_index = 0; tile_index < num_tiles; ++tile_index) {
+    const Tile tile = TileManager::get_tile_for_index(
+        make_int2(full_params.width, full_params.height), tile_size, overlap, tile_index);
+
+    BufferParams tile_params = full_params;
+
+    tile_params.full_x = full_params.full_x + tile.x;
+    tile_params.full_y = full_params.full_y + tile.y;
+    tile_params.width = tile.width;
+    tile_params.height = tile.height;
+
+    tile_params.window_x = tile.window_x;
+    tile_params.window_y = tile.window_y;
+    tile_params.window_width = tile.window_width;
+    tile_params.window_height = tile.window_height;
+
+    tile_params.update_offset_stride();
+
+    tile_buffers.reset(tile_params);
+
+    if (!tile_manager_.read_tile_from_disk(&tile_buffers)) {
+      full_buffer_read_error();
+      break;
+    }
+
+    render_state_.has_denoised_result = false;
+
+    if (denoise_params.use) {
+      progress_set_status(layer_view_name,
+                          string_printf("Denoising tile %d/%d", tile_index + 1, num_tiles));
+
+      denoiser_->denoise_buffer(tile_params, &tile_buffers, 0, false);
+
+      render_state_.has_denoised_result = true;
+    }
+
+    progress_set_status(layer_view_name,
+                        string_printf("Finishing tile %d/%d", tile_index + 1, num_tiles));
+
+    full_frame_state_.render_buffers = &tile_buffers;
+
+    tile_buffer_write();
+
+    full_frame_state_.render_buffers = nullptr;
+  }
+
+  full_frame_state_.full_params = nullptr;
+
+  tile_manager_.close_full_buffer_from_disk();
+}
+
 int PathTrace::get_num_render_tile_samples() const
 {
   if (full_frame_state_.render_buffers) {
@@ -1129,6 +1229,11 @@ int2 PathTrace::get_render_tile_size() const
 int2 PathTrace::get_render_tile_offset() const
 {
   if (full_frame_state_.render_buffers) {
+    if (full_frame_state_.full_params) {
+      const BufferParams &params = full_frame_state_.render_buffers->params;
+      return make_int2(params.full_x - full_frame_state_.full_params->full_x + params.window_x,
+                       params.full_y - full_frame_state_.full_params->full_y + params.window_y);
+    }
     return make_int2(0, 0);
   }
 
@@ -1138,6 +1243,11 @@ int2 PathTrace::get_render_tile_offset() const
 
 int2 PathTrace::get_render_size() const
 {
+  if (full_frame_state_.full_params) {
+    return make_int2(full_frame_state_.full_params->width,
+                     full_frame_state_.full_params->height);
+  }
+
   return tile_manager_.get_size();
 }
 
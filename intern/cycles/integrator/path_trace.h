@@ -136,8 +136,12 @@ class PathTrace {
   bool copy_render_tile_from_device();
 
   /* Read given full-frame file from disk, perform needed processing and write it to the software
-   * via the write callback. */
-  void process_full_buffer_from_disk(string_view filename);
+   * via the write callback.
+   *
+   * With streaming the file is processed and written tile by tile, so that the full-frame render
+   * buffer is never in memory at once. Denoising then uses an overlap between the tiles. Whether
+   * the full frame is assembled from the written tiles is up to the output driver. */
+  void process_full_buffer_from_disk(string_view filename, bool use_streaming = false);
 
   /* Get number of samples in the current big tile render buffers. */
   int get_num_render_tile_samples() const;
@@ -161,7 +165,7 @@ class PathTrace {
    * In the case of tiled rendering this will return full-frame after all tiles has been rendered.
    *
    * NOTE: If the full-frame buffer processing is in progress, returns parameters of the full-frame
-   * instead. */
+   * instead, or of the currently processed tile of it when streaming. */
   int2 get_render_tile_size() const;
   int2 get_render_tile_offset() const;
   int2 get_render_size() const;
@@ -240,6 +244,12 @@ class PathTrace {
   /* Write current tile into the file on disk. */
   void tile_buffer_write_to_disk();
 
+  /* Read full-frame file from disk, denoise and write it tile by tile. */
+  void stream_full_buffer_from_disk(string_view filename);
+
+  /* Report error reading the full-frame file from disk. */
+  void full_buffer_read_error();
+
   /* Run the progress_update_cb callback if it is needed. */
   void progress_update_if_needed(const RenderWork &render_work);
 
@@ -354,6 +364,10 @@ class PathTrace {
   /* State of the full frame processing and writing to the software. */
   struct {
     RenderBuffers *render_buffers = nullptr;
+
+    /* Parameters of the full frame when its render buffers are processed tile by tile, in which
+     * case the render buffers are of the current tile. */
+    const BufferParams *full_params = nullptr;
   } full_frame_state_;
 };
 
@@ -16,7 +16,9 @@
 #include "scene/scene.h"
 #include "session/buffers.h"
 
+#include "util/algorithm.h"
 #include "util/atomic.h"
+#include "util/debug.h"
 #include "util/log.h"
 #include "util/tbb.h"
 
@@ -42,6 +44,9 @@ static inline CPUKernelThreadGlobals *kernel_thread_globals_get(
   return &kernel_thread_globals[thread_index];
 }
 
+/* Width and height of the pixel blocks rendered in wavefront mode. */
+static const int kWavefrontBlockSize = 8;
+
 PathTraceWorkCPU::PathTraceWorkCPU(Device *device,
                                    Film *film,
                                    DeviceScene *device_scene,
@@ -56,6 +61,25 @@ void PathTraceWorkCPU::init_execution()
 {
   /* Cache per-thread kernel globals. */
   device_->get_cpu_kernel_thread_globals(kernel_thread_globals_);
+
+  wavefront_thread_states_.resize(kernel_thread_globals_.size());
+}
+
+bool PathTraceWorkCPU::use_wavefront() const
+{
+  if (!DebugFlags().cpu.use_wavefront) {
+    return false;
+  }
+
+#ifdef WITH_PATH_GUIDING
+  /* Training data of a path is collected in the thread globals, so paths of the same thread
+   * can not be interleaved. */
+  if (device_scene_->data.integrator.train_guiding) {
+    return false;
+  }
+#endif
+
+  return true;
 }
 
 void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
@@ -74,31 +98,69 @@ void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
   }
 
   tbb::task_arena local_arena = local_tbb_arena_create(device_);
-  local_arena.execute([&]() {
-    parallel_for(int64_t(0), total_pixels_num, [&](int64_t work_index) {
-      if (is_cancel_requested()) {
-        return;
-      }
 
-      const int y = work_index / image_width;
-      const int x = work_index - y * image_width;
+  if (use_wavefront()) {
+    const int64_t num_blocks_x = divide_up(image_width, int64_t(kWavefrontBlockSize));
+    const int64_t num_blocks_y = divide_up(image_height, int64_t(kWavefrontBlockSize));
 
-      KernelWorkTile work_tile;
-      work_tile.x = effective_buffer_params_.full_x + x;
-      work_tile.y = effective_buffer_params_.full_y + y;
-      work_tile.w = 1;
-      work_tile.h = 1;
-      work_tile.start_sample = start_sample;
-      work_tile.sample_offset = sample_offset;
-      work_tile.num_samples = 1;
-      work_tile.offset = effective_buffer_params_.offset;
-      work_tile.stride = effective_buffer_params_.stride;
+    local_arena.execute([&]() {
+      parallel_for(int64_t(0), num_blocks_x * num_blocks_y, [&](int64_t block_index) {
+        if (is_cancel_requested()) {
+          return;
+        }
 
-      CPUKernelThreadGlobals *kernel_globals = kernel_thread_globals_get(kernel_thread_globals_);
+        const int block_y = block_index / num_blocks_x;
+        const int block_x = block_index - block_y * num_blocks_x;
+        const int x = block_x * kWavefrontBlockSize;
+        const int y = block_y * kWavefrontBlockSize;
+
+        KernelWorkTile work_tile;
+        work_tile.x = effective_buffer_params_.full_x + x;
+        work_tile.y = effective_buffer_params_.full_y + y;
+        work_tile.w = min(kWavefrontBlockSize, int(image_width) - x);
+        work_tile.h = min(kWavefrontBlockSize, int(image_height) - y);
+        work_tile.start_sample = start_sample;
+        work_tile.sample_offset = sample_offset;
+        work_tile.num_samples = 1;
+        work_tile.offset = effective_buffer_params_.offset;
+        work_tile.stride = effective_buffer_params_.stride;
+
+        const int thread_index = tbb::this_task_arena::current_thread_index();
+        CPUKernelThreadGlobals *kernel_globals = kernel_thread_globals_get(kernel_thread_globals_);
+
+        render_samples_wavefront(
+            kernel_globals, wavefront_thread_states_[thread_index], work_tile, samples_num);
+      });
+    });
+  }
+  else {
+    local_arena.execute([&]() {
+      parallel_for(int64_t(0), total_pixels_num, [&](int64_t work_index) {
+        if (is_cancel_requested()) {
+          return;
+        }
+
+        const int y = work_index / image_width;
+        const int x = work_index - y * image_width;
+
+        KernelWorkTile work_tile;
+        work_tile.x = effective_buffer_params_.full_x + x;
+        work_tile.y = effective_buffer_params_.full_y + y;
+        work_tile.w = 1;
+        work_tile.h = 1;
+        work_tile.start_sample = start_sample;
+        work_tile.sample_offset = sample_offset;
+        work_tile.num_samples = 1;
+        work_tile.offset = effective_buffer_params_.offset;
+        work_tile.stride = effective_buffer_params_.stride;
 
-      render_samples_full_pipeline(kernel_globals, work_tile, samples_num);
+        CPUKernelThreadGlobals *kernel_globals = kernel_thread_globals_get(kernel_thread_globals_);
+
+        render_samples_full_pipeline(kernel_globals, work_tile, samples_num);
+      });
     });
-  });
+  }
+
   if (device_->profiler.active()) {
     for (CPUKernelThreadGlobals &kernel_globals : kernel_thread_globals_) {
       kernel_globals.stop_profiling();
@@ -164,6 +226,107 @@ void PathTraceWorkCPU::render_samples_full_pipeline(KernelGlobalsCPU *kernel_glo
   }
 }
 
+void PathTraceWorkCPU::render_samples_wavefront(KernelGlobalsCPU *kernel_globals,
+                                                vector<IntegratorStateCPU> &states,
+                                                const KernelWorkTile &work_tile,
+                                                const int samples_num)
+{
+  const bool has_bake = device_scene_->data.bake.use;
+  const int num_pixels = work_tile.w * work_tile.h;
+
+  /* Each path is followed by the state it is split into when hitting a shadow catcher. */
+  states.resize(num_pixels * 2);
+  for (IntegratorStateCPU &state : states) {
+    path_state_init_queues(&state);
+  }
+
+  /* Pixels stop being sampled once they converged. */
+  vector<bool> pixel_active(num_pixels, true);
+  vector<IntegratorStateCPU *> queue;
+  queue.reserve(states.size());
+
+  KernelWorkTile pixel_work_tile = work_tile;
+  pixel_work_tile.w = 1;
+  pixel_work_tile.h = 1;
+
+  float *render_buffer = buffers_->buffer.data();
+
+  for (int sample = 0; sample < samples_num; ++sample) {
+    if (is_cancel_requested()) {
+      break;
+    }
+
+    /* Generate the camera rays of all pixels. */
+    int num_active_pixels = 0;
+    pixel_work_tile.start_sample = work_tile.start_sample + sample;
+
+    for (int i = 0; i < num_pixels; i++) {
+      if (!pixel_active[i]) {
+        continue;
+      }
+
+      pixel_work_tile.x = work_tile.x + i % work_tile.w;
+      pixel_work_tile.y = work_tile.y + i / work_tile.w;
+
+      IntegratorStateCPU *state = &states[i * 2];
+      bool active;
+      if (has_bake) {
+        active = kernels_.integrator_init_from_bake(
+            kernel_globals, state, &pixel_work_tile, render_buffer);
+      }
+      else {
+        active = kernels_.integrator_init_from_camera(
+            kernel_globals, state, &pixel_work_tile, render_buffer);
+      }
+
+      if (active) {
+        num_active_pixels++;
+      }
+      else {
+        pixel_active[i] = false;
+      }
+    }
+
+    if (num_active_pixels == 0) {
+      break;
+    }
+
+    /* Execute one kernel for every path at a time, until all paths are terminated. */
+    while (true) {
+      queue.clear();
+
+      for (IntegratorStateCPU &state : states) {
+        /* A path has room for one shadow path only, so finish those before continuing the main
+         * path, which may create new ones. */
+        if (state.shadow.shadow_path.queued_kernel || state.ao.shadow_path.queued_kernel) {
+          kernels_.integrator_megakernel_shadow_paths(kernel_globals, &state, render_buffer);
+        }
+        if (state.path.queued_kernel) {
+          queue.push_back(&state);
+        }
+      }
+
+      if (queue.empty()) {
+        break;
+      }
+
+      /* Group paths by kernel, and surface shading by shader. */
+      std::sort(queue.begin(),
+                queue.end(),
+                [](const IntegratorStateCPU *a, const IntegratorStateCPU *b) {
+                  if (a->path.queued_kernel != b->path.queued_kernel) {
+                    return a->path.queued_kernel < b->path.queued_kernel;
+                  }
+                  return a->path.shader_sort_key < b->path.shader_sort_key;
+                });
+
+      for (IntegratorStateCPU *state : queue) {
+        kernels_.integrator_megakernel_path(kernel_globals, state, render_buffer);
+      }
+    }
+  }
+}
+
 void PathTraceWorkCPU::copy_to_display(PathTraceDisplay *display,
                                        PassMode pass_mode,
                                        int num_samples)
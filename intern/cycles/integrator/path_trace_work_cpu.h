@@ -74,6 +74,19 @@ class PathTraceWorkCPU : public PathTraceWork {
                                     const KernelWorkTile &work_tile,
                                     const int samples_num);
 
+  /* Render a block of pixels by executing the same kernel for the paths of all its pixels one
+   * after the other, sorted by shader, rather than tracing each path to completion. Neighboring
+   * paths intersect similar parts of the BVH and evaluate the same shaders, so the memory they
+   * access is more likely to be in the cache.
+   *
+   * Rays are still intersected one at a time, there are no packet or stream BVH queries. */
+  void render_samples_wavefront(KernelGlobalsCPU *kernel_globals,
+                                vector<IntegratorStateCPU> &states,
+                                const KernelWorkTile &work_tile,
+                                const int samples_num);
+
+  bool use_wavefront() const;
+
   /* CPU kernels. */
   const CPUKernels &kernels_;
 
@@ -83,6 +96,9 @@ class PathTraceWorkCPU : public PathTraceWork {
    * accessing it, but some "localization" is required to decouple from kernel globals stored
    * on the device level. */
   vector<CPUKernelThreadGlobals> kernel_thread_globals_;
+
+  /* Path states of the pixel block rendered by each thread in wavefront mode. */
+  vector<vector<IntegratorStateCPU>> wavefront_thread_states_;
 };
 
 CCL_NAMESPACE_END
@@ -0,0 +1,114 @@
+/* SPDX-FileCopyrightText: 2011-2024 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "integrator/render_budget.h"
+
+#include "util/log.h"
+#include "util/math.h"
+
+CCL_NAMESPACE_BEGIN
+
+void RenderTimeBudget::set_sequence(double time_budget, int num_frames, int num_renders_per_frame)
+{
+  num_frames = max(num_frames, 1);
+  num_renders_per_frame = max(num_renders_per_frame, 1);
+
+  if (time_budget == time_budget_ && num_frames == num_frames_ &&
+      num_renders_per_frame == num_renders_per_frame_)
+  {
+    return;
+  }
+
+  time_budget_ = time_budget;
+  num_frames_ = num_frames;
+  num_renders_per_frame_ = num_renders_per_frame;
+
+  reset();
+}
+
+void RenderTimeBudget::reset()
+{
+  VLOG_INFO << "Render time budget of " << time_budget_ << " seconds for " << num_frames_
+            << " frames.";
+
+  used_time_ = 0.0;
+  num_rendered_ = 0;
+
+  current_frame_ = 0;
+  current_render_ = -1;
+
+  average_converge_time_ = 0.0;
+  last_converge_times_.clear();
+  last_converge_times_.resize(num_renders_per_frame_, 0.0);
+}
+
+double RenderTimeBudget::begin_render(int frame)
+{
+  const int num_renders = num_frames_ * num_renders_per_frame_;
+
+  /* Rendering an earlier frame, or the current frame once more than it has renders, means the
+   * sequence is rendered again. */
+  if (num_rendered_ >= num_renders ||
+      (current_render_ != -1 &&
+       (frame < current_frame_ ||
+        (frame == current_frame_ && current_render_ + 1 >= num_renders_per_frame_))))
+  {
+    reset();
+  }
+
+  if (current_render_ == -1 || frame != current_frame_) {
+    current_frame_ = frame;
+    current_render_ = 0;
+  }
+  else {
+    current_render_++;
+  }
+
+  const int num_remaining_renders = max(num_renders - num_rendered_, 1);
+  const double remaining_time = max(time_budget_ - used_time_, 0.0);
+
+  /* Weight the render by how long it is estimated to take to converge compared to the average
+   * of recent renders, and assume the renders after it are average. The last render gets all the
+   * remaining time. */
+  double weight = 1.0;
+  const double last_converge_time =
+      last_converge_times_[current_render_ % num_renders_per_frame_];
+  if (last_converge_time > 0.0 && average_converge_time_ > 0.0) {
+    weight = min(max(last_converge_time / average_converge_time_, MIN_WEIGHT), MAX_WEIGHT);
+  }
+
+  const double time_limit = max(remaining_time * weight / (weight + num_remaining_renders - 1),
+                               MIN_TIME_LIMIT);
+
+  VLOG_INFO << "Render time budget: frame " << frame << " render " << current_render_
+            << " time limit " << time_limit << " seconds, " << remaining_time
+            << " seconds remaining.";
+
+  return time_limit;
+}
+
+void RenderTimeBudget::end_render(double render_time, double converge_time)
+{
+  if (current_render_ == -1) {
+    return;
+  }
+
+  used_time_ += render_time;
+
+  if (num_rendered_ == 0) {
+    average_converge_time_ = converge_time;
+  }
+  else {
+    average_converge_time_ += AVERAGE_CONVERGE_TIME_SMOOTHING *
+                              (converge_time - average_converge_time_);
+  }
+  last_converge_times_[current_render_ % num_renders_per_frame_] = converge_time;
+
+  num_rendered_++;
+
+  VLOG_INFO << "Render time budget: rendered in " << render_time
+            << " seconds, estimated to converge in " << converge_time << " seconds.";
+}
+
+CCL_NAMESPACE_END
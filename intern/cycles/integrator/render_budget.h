@@ -0,0 +1,77 @@
+/* SPDX-FileCopyrightText: 2011-2024 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Render Time Budget
+ *
+ * Distributes a total render time over the frames of a sequence, so that the time it takes to
+ * render the whole sequence is predictable.
+ *
+ * Every frame gets its share of the remaining time, scaled by how long it is estimated to take
+ * to converge relative to recently rendered frames. The estimate is the convergence time of the
+ * previous frame, as consecutive frames tend to be similar. This gives more samples to harder
+ * frames, so that noise is even across the sequence. Time left over by frames which converged
+ * before their time limit goes to the following frames.
+ *
+ * A frame can consist of multiple renders, for example of view layers and stereo views. Each of
+ * them is estimated separately. */
+class RenderTimeBudget {
+ public:
+  /* Start a new sequence, unless it is the same as the current one. */
+  void set_sequence(double time_budget, int num_frames, int num_renders_per_frame);
+
+  /* Get the time limit in seconds for the next render of the given frame. Starts the sequence
+   * again when all its frames were rendered, or when an earlier frame is rendered. */
+  double begin_render(int frame);
+
+  /* Report time spent rendering, and the time the render is estimated to need to converge. */
+  void end_render(double render_time, double converge_time);
+
+  double get_time_budget() const
+  {
+    return time_budget_;
+  }
+
+  double get_remaining_time() const
+  {
+    return time_budget_ - used_time_;
+  }
+
+  /* Limit the weight of a render relative to the average render, so that outliers do not take
+   * up the budget of the frames after them. */
+  static constexpr double MIN_WEIGHT = 0.5;
+  static constexpr double MAX_WEIGHT = 2.0;
+
+  /* Weight of the latest render in the moving average of convergence times. */
+  static constexpr double AVERAGE_CONVERGE_TIME_SMOOTHING = 0.3;
+
+  /* Never give a render less time than this, to let it render at least a few samples. */
+  static constexpr double MIN_TIME_LIMIT = 0.1;
+
+ protected:
+  void reset();
+
+  double time_budget_ = 0.0;
+  int num_frames_ = 0;
+  int num_renders_per_frame_ = 0;
+
+  double used_time_ = 0.0;
+  int num_rendered_ = 0;
+
+  /* Frame and index of the current render within the frame. */
+  int current_frame_ = 0;
+  int current_render_ = -1;
+
+  /* Moving average of the estimated convergence times of all renders, and the latest one for
+   * every render within a frame. */
+  double average_converge_time_ = 0.0;
+  vector<double> last_converge_times_;
+};
+
+CCL_NAMESPACE_END
@@ -163,6 +163,7 @@ void RenderScheduler::reset(const BufferParams &buffer_params, int num_samples,
   state_.start_render_time = 0.0;
   state_.end_render_time = 0.0;
   state_.time_limit_reached = false;
+  state_.active_pixels_fraction = 1.0f;
 
   state_.occupancy_num_samples = 0;
   state_.occupancy = 1.0f;
@@ -176,11 +177,21 @@ void RenderScheduler::reset(const BufferParams &buffer_params, int num_samples,
   adaptive_filter_time_.reset();
   display_update_time_.reset();
   rebalance_time_.reset();
+
+  previous_tiles_render_time_ = 0.0;
+  previous_tiles_converge_time_ = 0.0;
 }
 
 void RenderScheduler::reset_for_next_tile()
 {
+  /* Keep the statistics of the tiles rendered so far. */
+  const double render_time = get_render_time();
+  const double converge_time = get_converge_time_estimate();
+
   reset(buffer_params_, num_samples_, sample_offset_);
+
+  previous_tiles_render_time_ = render_time;
+  previous_tiles_converge_time_ = converge_time;
 }
 
 bool RenderScheduler::render_work_reschedule_on_converge(RenderWork &render_work)
@@ -532,6 +543,16 @@ void RenderScheduler::report_adaptive_filter_time(const RenderWork &render_work,
             << " seconds.";
 }
 
+void RenderScheduler::report_adaptive_filter_num_active_pixels(int num_active_pixels)
+{
+  const Tile &tile = tile_manager_.get_current_tile();
+  const int num_pixels = tile.width * tile.height;
+
+  state_.active_pixels_fraction = (num_pixels > 0) ?
+                                      min(float(num_active_pixels) / num_pixels, 1.0f) :
+                                      1.0f;
+}
+
 void RenderScheduler::report_denoise_time(const RenderWork &render_work, double time)
 {
   denoise_time_.add_wall(time);
@@ -1204,6 +1225,40 @@ bool RenderScheduler::work_report_reset_average(const RenderWork &render_work)
   return render_work.resolution_divider != pixel_size_;
 }
 
+double RenderScheduler::get_render_time() const
+{
+  double render_time = 0.0;
+
+  if (state_.start_render_time != 0.0) {
+    const double end_render_time = (state_.end_render_time != 0.0) ? state_.end_render_time :
+                                                                     time_dt();
+    render_time = end_render_time - state_.start_render_time;
+  }
+
+  return previous_tiles_render_time_ + render_time;
+}
+
+double RenderScheduler::get_converge_time_estimate() const
+{
+  const double render_time = get_render_time() - previous_tiles_render_time_;
+  double converge_time = render_time;
+
+  const int num_rendered_samples = get_num_rendered_samples();
+  if (state_.time_limit_reached && num_rendered_samples > 0 &&
+      num_rendered_samples < num_samples_)
+  {
+    /* Assume the pixels which did not converge yet need all the remaining samples. */
+    const int num_remaining_samples = num_samples_ - num_rendered_samples;
+    const double active_pixels_fraction = adaptive_sampling_.use ?
+                                              state_.active_pixels_fraction :
+                                              1.0;
+    converge_time += render_time / num_rendered_samples * num_remaining_samples *
+                     active_pixels_fraction;
+  }
+
+  return previous_tiles_converge_time_ + converge_time;
+}
+
 void RenderScheduler::check_time_limit_reached()
 {
   if (time_limit_ == 0.0) {
@@ -181,6 +181,7 @@ class RenderScheduler {
   void report_path_trace_time(const RenderWork &render_work, double time, bool is_cancelled);
   void report_path_trace_occupancy(const RenderWork &render_work, float occupancy);
   void report_adaptive_filter_time(const RenderWork &render_work, double time, bool is_cancelled);
+  void report_adaptive_filter_num_active_pixels(int num_active_pixels);
   void report_denoise_time(const RenderWork &render_work, double time);
   void report_display_update_time(const RenderWork &render_work, double time);
   void report_rebalance_time(const RenderWork &render_work, double time, bool balance_changed);
@@ -189,6 +190,14 @@ class RenderScheduler {
    * times, and so on. */
   string full_report() const;
 
+  /* Time spent rendering all tiles so far, excluding synchronization like the time limit. */
+  double get_render_time() const;
+
+  /* Time the tiles rendered so far are estimated to need until all their pixels converged or all
+   * samples were rendered. When the time limit stopped rendering early, the time still needed is
+   * extrapolated from the time per sample and the number of pixels which did not converge. */
+  double get_converge_time_estimate() const;
+
   void set_limit_samples_per_update(const int limit_samples);
 
  protected:
@@ -389,6 +398,10 @@ class RenderScheduler {
     double start_render_time = 0.0;
     double end_render_time = 0.0;
 
+    /* Fraction of the pixels of the tile which did not converge yet, as reported by the latest
+     * adaptive sampling filter. */
+    float active_pixels_fraction = 1.0f;
+
     /* Measured occupancy of the render devices measured normalized to the number of samples.
      *
      * In a way it is "trailing": when scheduling new work this occupancy is measured when the
@@ -432,6 +445,10 @@ class RenderScheduler {
    * Zero means no limit is applied. */
   double time_limit_ = 0.0;
 
+  /* Render and estimated convergence time of the tiles rendered before the current one. */
+  double previous_tiles_render_time_ = 0.0;
+  double previous_tiles_converge_time_ = 0.0;
+
   /* Headless rendering without interface. */
   bool headless_;
 
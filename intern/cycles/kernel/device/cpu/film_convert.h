@@ -0,0 +1,200 @@
+/* SPDX-FileCopyrightText: 2011-2024 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+/* Film conversion of rows of pixels on the CPU.
+ *
+ * The common color passes are converted with all channels of a pixel at once in a SIMD register,
+ * and the decisions which are the same for all pixels of a row are made before the pixel loop.
+ * The result matches the per-pixel functions from kernel/film/read.h, which are used for all
+ * other passes. */
+
+#pragma once
+
+#include "kernel/film/read.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Destination of a converted row: either floats with the number of components of the pass, or
+ * half RGBA for display with overlays applied. */
+struct FilmConvertRowOutput {
+  float *pixel = nullptr;
+  int pixel_stride = 0;
+  int num_components = 0;
+
+  half4 *pixel_half_rgba = nullptr;
+  int pass_active_pixels = PASS_UNUSED;
+};
+
+ccl_device_inline FilmConvertRowOutput film_convert_row_output_float(
+    const KernelFilmConvert *kfilm_convert, float *pixel, const int pixel_stride)
+{
+  FilmConvertRowOutput output;
+  output.pixel = pixel;
+  output.pixel_stride = pixel_stride;
+  output.num_components = kfilm_convert->num_components;
+  return output;
+}
+
+ccl_device_inline FilmConvertRowOutput
+film_convert_row_output_half_rgba(const KernelFilmConvert *kfilm_convert, half4 *pixel)
+{
+  FilmConvertRowOutput output;
+  output.pixel_half_rgba = pixel;
+  if (kfilm_convert->show_active_pixels) {
+    output.pass_active_pixels = kfilm_convert->pass_adaptive_aux_buffer;
+  }
+  return output;
+}
+
+template<bool use_half_rgba>
+ccl_device_forceinline void film_convert_row_write_pixel(const FilmConvertRowOutput &output,
+                                                         const float *buffer,
+                                                         const int i,
+                                                         float4 f)
+{
+  if (use_half_rgba) {
+    /* Same as film_apply_pass_pixel_overlays_rgba. */
+    if (output.pass_active_pixels != PASS_UNUSED && buffer[output.pass_active_pixels + 3] == 0.0f)
+    {
+      const float4 active_rgba = make_float4(1.0f, 0.0f, 0.0f, 0.0f);
+      const float alpha = f.w;
+      f += 0.5f * (active_rgba - f);
+      f.w = alpha;
+    }
+    output.pixel_half_rgba[i] = float4_to_half4_display(f);
+    return;
+  }
+
+  float *pixel = output.pixel + i * output.pixel_stride;
+  if (output.num_components >= 4) {
+    store_float4(f, pixel);
+  }
+  else {
+    pixel[0] = f.x;
+    pixel[1] = f.y;
+    pixel[2] = f.z;
+  }
+}
+
+/* --------------------------------------------------------------------
+ * Float4 passes.
+ *
+ * Color is scaled by the sample scale and exposure and alpha by the sample scale only, which is
+ * a single multiplication with a per-channel scale. The scale only changes from pixel to pixel
+ * when the sample count pass is used. */
+
+template<bool is_combined, bool use_half_rgba>
+ccl_device_forceinline void film_convert_row_float4_impl(const KernelFilmConvert *kfilm_convert,
+                                                         const float *buffer,
+                                                         const FilmConvertRowOutput &output,
+                                                         const int width,
+                                                         const int buffer_stride)
+{
+  kernel_assert(kfilm_convert->num_components == 4);
+  kernel_assert(kfilm_convert->pass_offset != PASS_UNUSED);
+
+  const bool use_sample_count = kfilm_convert->pass_sample_count != PASS_UNUSED;
+  const float4 row_scale = make_float4(kfilm_convert->scale_exposure,
+                                       kfilm_convert->scale_exposure,
+                                       kfilm_convert->scale_exposure,
+                                       kfilm_convert->scale);
+
+  const float *in = buffer + kfilm_convert->pass_offset;
+
+  for (int i = 0; i < width; i++, buffer += buffer_stride, in += buffer_stride) {
+    float4 scale = row_scale;
+    if (use_sample_count) {
+      float scale_alpha, scale_exposure;
+      if (!film_get_scale_and_scale_exposure(kfilm_convert, buffer, &scale_alpha, &scale_exposure))
+      {
+        if (is_combined) {
+          film_convert_row_write_pixel<use_half_rgba>(output, buffer, i, zero_float4());
+          continue;
+        }
+      }
+      scale = make_float4(scale_exposure, scale_exposure, scale_exposure, scale_alpha);
+    }
+
+    float4 f = load_float4(in) * scale;
+    if (is_combined) {
+      /* 4th channel contains transparency = 1 - alpha for the combined pass. */
+      f.w = film_transparency_to_alpha(f.w);
+    }
+
+    film_convert_row_write_pixel<use_half_rgba>(output, buffer, i, f);
+  }
+}
+
+template<bool use_half_rgba>
+ccl_device_inline void film_convert_row_float4(const KernelFilmConvert *kfilm_convert,
+                                               const float *buffer,
+                                               const FilmConvertRowOutput &output,
+                                               const int width,
+                                               const int buffer_stride)
+{
+  film_convert_row_float4_impl<false, use_half_rgba>(
+      kfilm_convert, buffer, output, width, buffer_stride);
+}
+
+template<bool use_half_rgba>
+ccl_device_inline void film_convert_row_combined(const KernelFilmConvert *kfilm_convert,
+                                                 const float *buffer,
+                                                 const FilmConvertRowOutput &output,
+                                                 const int width,
+                                                 const int buffer_stride)
+{
+  film_convert_row_float4_impl<true, use_half_rgba>(
+      kfilm_convert, buffer, output, width, buffer_stride);
+}
+
+/* --------------------------------------------------------------------
+ * Float3 passes.
+ *
+ * The pass is read into the first three channels and the optional alpha from the combined pass
+ * into the fourth, so that color and alpha are scaled with a single multiplication. The pass is
+ * not loaded with a single unaligned load, as that could read past the end of the buffer. */
+
+template<bool use_half_rgba>
+ccl_device_inline void film_convert_row_float3(const KernelFilmConvert *kfilm_convert,
+                                               const float *buffer,
+                                               const FilmConvertRowOutput &output,
+                                               const int width,
+                                               const int buffer_stride)
+{
+  kernel_assert(kfilm_convert->num_components >= 3);
+  kernel_assert(kfilm_convert->pass_offset != PASS_UNUSED);
+
+  const bool use_sample_count = kfilm_convert->pass_sample_count != PASS_UNUSED;
+  const bool use_alpha = kfilm_convert->num_components >= 4 &&
+                         kfilm_convert->pass_combined != PASS_UNUSED;
+  const float4 row_scale = make_float4(kfilm_convert->scale_exposure,
+                                       kfilm_convert->scale_exposure,
+                                       kfilm_convert->scale_exposure,
+                                       kfilm_convert->scale);
+
+  const float *in = buffer + kfilm_convert->pass_offset;
+
+  for (int i = 0; i < width; i++, buffer += buffer_stride, in += buffer_stride) {
+    float4 scale = row_scale;
+    if (use_sample_count) {
+      const float scale_exposure = film_get_scale_exposure(kfilm_convert, buffer);
+      float scale_alpha = 0.0f;
+      if (use_alpha) {
+        float unused_scale_exposure;
+        film_get_scale_and_scale_exposure(
+            kfilm_convert, buffer, &scale_alpha, &unused_scale_exposure);
+      }
+      scale = make_float4(scale_exposure, scale_exposure, scale_exposure, scale_alpha);
+    }
+
+    const float transparency = (use_alpha) ? buffer[kfilm_convert->pass_combined + 3] :
+                                             0.0f;
+    float4 f = make_float4(in[0], in[1], in[2], transparency) * scale;
+    f.w = (use_alpha) ? film_transparency_to_alpha(f.w) : 1.0f;
+
+    film_convert_row_write_pixel<use_half_rgba>(output, buffer, i, f);
+  }
+}
+
+CCL_NAMESPACE_END
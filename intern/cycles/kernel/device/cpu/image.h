@@ -8,6 +8,8 @@
 #  include "kernel/util/nanovdb.h"
 #endif
 
+#include "util/texture_cache.h"
+
 CCL_NAMESPACE_BEGIN
 
 /* Make template functions private so symbols don't conflict between kernels with different
@@ -844,6 +846,8 @@ ccl_device float4 kernel_tex_image_interp(KernelGlobals kg, int id, float x, flo
       return TextureInterpolator<ushort4>::interp(info, x, y);
     case IMAGE_DATA_TYPE_FLOAT4:
       return TextureInterpolator<float4>::interp(info, x, y);
+    case IMAGE_DATA_TYPE_TILE_CACHE:
+      return (*(TextureCacheImage *const *)info.data)->lookup(x, y);
     default:
       assert(0);
       return make_float4(
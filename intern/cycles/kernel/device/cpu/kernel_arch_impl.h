@@ -40,6 +40,8 @@
 
 #    include "kernel/bake/bake.h"
 
+#    include "kernel/device/cpu/film_convert.h"
+
 #else
 #  define STUB_ASSERT(arch, name) \
     assert(!(#name " kernel stub for architecture " #arch " was called!"))
@@ -110,6 +112,8 @@ DEFINE_INTEGRATOR_SHADE_KERNEL(shade_surface)
 DEFINE_INTEGRATOR_SHADE_KERNEL(shade_volume)
 DEFINE_INTEGRATOR_SHADE_KERNEL(shade_dedicated_light)
 DEFINE_INTEGRATOR_SHADE_KERNEL(megakernel)
+DEFINE_INTEGRATOR_SHADE_KERNEL(megakernel_shadow_paths)
+DEFINE_INTEGRATOR_SHADE_KERNEL(megakernel_path)
 DEFINE_INTEGRATOR_SHADOW_KERNEL(intersect_shadow)
 DEFINE_INTEGRATOR_SHADOW_SHADE_KERNEL(shade_shadow)
 
@@ -248,6 +252,8 @@ void KERNEL_FUNCTION_FULL_NAME(cryptomatte_postprocess)(const KernelGlobalsCPU *
       STUB_ASSERT(KERNEL_ARCH, film_convert_##name); \
     }
 
+#  define KERNEL_FILM_CONVERT_ROW_FUNCTION(name) KERNEL_FILM_CONVERT_FUNCTION(name, false)
+
 #else
 
 #  define KERNEL_FILM_CONVERT_FUNCTION(name, is_float) \
@@ -282,6 +288,36 @@ void KERNEL_FUNCTION_FULL_NAME(cryptomatte_postprocess)(const KernelGlobalsCPU *
       } \
     }
 
+/* Passes with a vectorized conversion of rows, see film_convert.h. */
+#  define KERNEL_FILM_CONVERT_ROW_FUNCTION(name) \
+    void KERNEL_FUNCTION_FULL_NAME(film_convert_##name)(const KernelFilmConvert *kfilm_convert, \
+                                                        const float *buffer, \
+                                                        float *pixel, \
+                                                        const int width, \
+                                                        const int buffer_stride, \
+                                                        const int pixel_stride) \
+    { \
+      film_convert_row_##name<false>( \
+          kfilm_convert, \
+          buffer, \
+          film_convert_row_output_float(kfilm_convert, pixel, pixel_stride), \
+          width, \
+          buffer_stride); \
+    } \
+    void KERNEL_FUNCTION_FULL_NAME(film_convert_half_rgba_##name)( \
+        const KernelFilmConvert *kfilm_convert, \
+        const float *buffer, \
+        half4 *pixel, \
+        const int width, \
+        const int buffer_stride) \
+    { \
+      film_convert_row_##name<true>(kfilm_convert, \
+                                    buffer, \
+                                    film_convert_row_output_half_rgba(kfilm_convert, pixel), \
+                                    width, \
+                                    buffer_stride); \
+    }
+
 #endif
 
 KERNEL_FILM_CONVERT_FUNCTION(depth, true)
@@ -290,16 +326,17 @@ KERNEL_FILM_CONVERT_FUNCTION(sample_count, true)
 KERNEL_FILM_CONVERT_FUNCTION(float, true)
 
 KERNEL_FILM_CONVERT_FUNCTION(light_path, false)
-KERNEL_FILM_CONVERT_FUNCTION(float3, false)
+KERNEL_FILM_CONVERT_ROW_FUNCTION(float3)
 
 KERNEL_FILM_CONVERT_FUNCTION(motion, false)
 KERNEL_FILM_CONVERT_FUNCTION(cryptomatte, false)
 KERNEL_FILM_CONVERT_FUNCTION(shadow_catcher, false)
 KERNEL_FILM_CONVERT_FUNCTION(shadow_catcher_matte_with_shadow, false)
-KERNEL_FILM_CONVERT_FUNCTION(combined, false)
-KERNEL_FILM_CONVERT_FUNCTION(float4, false)
+KERNEL_FILM_CONVERT_ROW_FUNCTION(combined)
+KERNEL_FILM_CONVERT_ROW_FUNCTION(float4)
 
 #undef KERNEL_FILM_CONVERT_FUNCTION
+#undef KERNEL_FILM_CONVERT_ROW_FUNCTION
 
 #undef KERNEL_INVOKE
 #undef DEFINE_INTEGRATOR_KERNEL
@@ -31,8 +31,10 @@
 
 #include "util/foreach.h"
 #include "util/log.h"
+#include "util/md5.h"
 #include "util/progress.h"
 #include "util/task.h"
+#include "util/tbb.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -54,6 +56,7 @@ Geometry::Geometry(const NodeType *node_type, const Type type)
 {
   need_update_rebuild = false;
   need_update_bvh_for_offset = false;
+  need_update_light_tree = true;
 
   transform_applied = false;
   transform_negative_scaled = false;
@@ -86,6 +89,60 @@ void Geometry::clear(bool preserve_shaders)
   tag_modified();
 }
 
+static void md5_append_buffer(MD5Hash &md5, const void *data, size_t size)
+{
+  /* MD5Hash takes an int size, split large buffers. */
+  const uint8_t *bytes = static_cast<const uint8_t *>(data);
+  const size_t max_chunk_size = 1 << 30;
+  while (size > 0) {
+    const size_t chunk_size = min(size, max_chunk_size);
+    md5.append(bytes, int(chunk_size));
+    bytes += chunk_size;
+    size -= chunk_size;
+  }
+}
+
+string Geometry::content_hash()
+{
+  MD5Hash md5;
+  hash(md5);
+
+  foreach (const Attribute &attr, attributes.attributes) {
+    md5.append(attr.name.string());
+    md5.append(attr.type.c_str());
+    md5.append((const uint8_t *)&attr.std, sizeof(attr.std));
+    md5.append((const uint8_t *)&attr.element, sizeof(attr.element));
+    md5.append((const uint8_t *)&attr.flags, sizeof(attr.flags));
+    md5_append_buffer(md5, attr.buffer.data(), attr.buffer.size());
+  }
+
+  /* Vertices were transformed to world space. */
+  md5.append((const uint8_t *)&transform_applied, sizeof(transform_applied));
+  md5.append((const uint8_t *)&transform_negative_scaled, sizeof(transform_negative_scaled));
+  md5.append((const uint8_t *)&transform_normal, sizeof(transform_normal));
+
+  return md5.get_hex();
+}
+
+bool Geometry::device_update_hash_matches(string hash)
+{
+  if (!device_update_hash.empty() && hash == device_update_hash) {
+    device_update_pending_hash.clear();
+    return true;
+  }
+
+  /* The device data is about to change, it matches no hash until the update finished. */
+  device_update_hash.clear();
+  device_update_pending_hash = std::move(hash);
+  return false;
+}
+
+void Geometry::device_update_hash_commit()
+{
+  device_update_hash = std::move(device_update_pending_hash);
+  device_update_pending_hash.clear();
+}
+
 float Geometry::motion_time(int step) const
 {
   return (motion_steps > 1) ? 2.0f * step / (motion_steps - 1) - 1.0f : 0.0f;
@@ -707,6 +764,153 @@ void GeometryManager::device_update_volume_images(Device *device, Scene *scene,
   pool.wait_work();
 }
 
+template<typename T> static void clear_modified_unless_realloc(device_vector<T> &data)
+{
+  if (!data.need_realloc()) {
+    data.clear_modified();
+  }
+}
+
+size_t GeometryManager::skip_unchanged_geometry(DeviceScene *dscene,
+                                                Scene *scene,
+                                                Progress &progress)
+{
+  /* Geometry of which the device data is computed from more than its content can not be
+   * compared, the hash is forgotten so it is never compared against stale device data. */
+  vector<Geometry *> candidates;
+  foreach (Geometry *geom, scene->geometry) {
+    if (!geom->is_modified()) {
+      continue;
+    }
+
+    bool can_skip = !geom->need_update_rebuild && !geom->is_volume();
+    if (geom->is_mesh()) {
+      Mesh *mesh = static_cast<Mesh *>(geom);
+      can_skip = can_skip && !mesh->need_tesselation() && !mesh->has_true_displacement();
+    }
+    else if (geom->is_hair()) {
+      can_skip = can_skip && !static_cast<Hair *>(geom)->need_shadow_transparency();
+    }
+
+    if (can_skip) {
+      candidates.push_back(geom);
+    }
+    else {
+      geom->device_update_hash.clear();
+      geom->device_update_pending_hash.clear();
+    }
+  }
+
+  vector<string> hashes(candidates.size());
+  parallel_for(blocked_range<size_t>(0, candidates.size(), 1),
+               [&](const blocked_range<size_t> &r) {
+                 for (size_t i = r.begin(); i != r.end(); i++) {
+                   hashes[i] = candidates[i]->content_hash();
+                 }
+               });
+
+  if (progress.get_cancel()) {
+    return 0;
+  }
+
+  size_t num_skipped = 0;
+  for (size_t i = 0; i < candidates.size(); i++) {
+    Geometry *geom = candidates[i];
+    if (geom->device_update_hash_matches(std::move(hashes[i]))) {
+      geom->clear_modified();
+      geom->attributes.clear_modified();
+      num_skipped++;
+    }
+  }
+
+  if (num_skipped == 0) {
+    return 0;
+  }
+
+  /* Device arrays were tagged as modified for the geometry in device_update_preprocess(), don't
+   * copy them again if no geometry of their type is left to update. */
+  bool mesh_modified = false, hair_modified = false, pointcloud_modified = false;
+  bool attributes_modified[AttrKernelDataType::NUM] = {false};
+  foreach (Geometry *geom, scene->geometry) {
+    if (!geom->is_modified()) {
+      continue;
+    }
+    mesh_modified |= geom->is_mesh() || geom->is_volume();
+    hair_modified |= geom->is_hair();
+    pointcloud_modified |= geom->is_pointcloud();
+
+    foreach (const Attribute &attr, geom->attributes.attributes) {
+      if (attr.modified) {
+        attributes_modified[Attribute::kernel_type(attr)] = true;
+      }
+    }
+    if (geom->is_mesh()) {
+      foreach (const Attribute &attr, static_cast<Mesh *>(geom)->subd_attributes.attributes) {
+        if (attr.modified) {
+          attributes_modified[Attribute::kernel_type(attr)] = true;
+        }
+      }
+    }
+  }
+
+  if (!mesh_modified) {
+    clear_modified_unless_realloc(dscene->tri_verts);
+    clear_modified_unless_realloc(dscene->tri_vnormal);
+    clear_modified_unless_realloc(dscene->tri_shader);
+  }
+  if (!hair_modified) {
+    clear_modified_unless_realloc(dscene->curve_keys);
+    clear_modified_unless_realloc(dscene->curves);
+    clear_modified_unless_realloc(dscene->curve_segments);
+  }
+  if (!pointcloud_modified) {
+    clear_modified_unless_realloc(dscene->points);
+    clear_modified_unless_realloc(dscene->points_shader);
+  }
+  if (!attributes_modified[AttrKernelDataType::FLOAT]) {
+    clear_modified_unless_realloc(dscene->attributes_float);
+  }
+  if (!attributes_modified[AttrKernelDataType::FLOAT2]) {
+    clear_modified_unless_realloc(dscene->attributes_float2);
+  }
+  if (!attributes_modified[AttrKernelDataType::FLOAT3]) {
+    clear_modified_unless_realloc(dscene->attributes_float3);
+  }
+  if (!attributes_modified[AttrKernelDataType::FLOAT4]) {
+    clear_modified_unless_realloc(dscene->attributes_float4);
+  }
+  if (!attributes_modified[AttrKernelDataType::UCHAR4]) {
+    clear_modified_unless_realloc(dscene->attributes_uchar4);
+  }
+
+  return num_skipped;
+}
+
+/* Whether changes to the geometry mean the scene BVH has to be built again, instead of refit. */
+static bool geometry_need_rebuild_scene_bvh(const Geometry *geom)
+{
+  if (geom->need_update_rebuild) {
+    return true;
+  }
+
+  /* Attributes added or removed, like motion vertex positions. */
+  for (int type = 0; type < AttrKernelDataType::NUM; type++) {
+    if (geom->attributes.modified(AttrKernelDataType(type))) {
+      return true;
+    }
+  }
+
+  if (geom->is_mesh() || geom->is_volume()) {
+    const Mesh *mesh = static_cast<const Mesh *>(geom);
+    return mesh->triangles_is_modified();
+  }
+  if (geom->is_hair()) {
+    const Hair *hair = static_cast<const Hair *>(geom);
+    return hair->curve_first_key_is_modified();
+  }
+  return false;
+}
+
 void GeometryManager::device_update(Device *device,
                                     DeviceScene *dscene,
                                     Scene *scene,
@@ -770,6 +974,24 @@ void GeometryManager::device_update(Device *device,
     return;
   }
 
+  /* Geometry synchronized again with identical data, as happens for every frame of an animation
+   * rendered with persistent data, does not need its BVH built and data copied again. */
+  if (scene->params.use_geometry_update_hash) {
+    scoped_callback_timer timer([scene](double time) {
+      if (scene->update_stats) {
+        scene->update_stats->geometry.times.add_entry(
+            {"device_update (skip unchanged geometry)", time});
+      }
+    });
+
+    const size_t num_skipped = skip_unchanged_geometry(dscene, scene, progress);
+    VLOG_INFO << "Skipped update of " << num_skipped << " unchanged geometries.";
+
+    if (progress.get_cancel()) {
+      return;
+    }
+  }
+
   /* Tessellate meshes that are using subdivision */
   if (total_tess_needed) {
     scoped_callback_timer timer([scene](double time) {
@@ -933,6 +1155,18 @@ void GeometryManager::device_update(Device *device,
    * change. */
   bool need_update_scene_bvh = (scene->bvh == nullptr ||
                                 (update_flags & (TRANSFORM_MODIFIED | VISIBILITY_MODIFIED)) != 0);
+
+  /* The scene BVH can only be refit when the same geometry deformed. Checked before building the
+   * geometry BVHs clears the rebuild tags, and including added and removed geometry, as a new
+   * geometry may reuse the memory of a removed one with the same counts. */
+  bool need_rebuild_scene_bvh = (update_flags & (GEOMETRY_ADDED | GEOMETRY_REMOVED)) != 0;
+  foreach (Geometry *geom, scene->geometry) {
+    if (geom->is_modified() && geometry_need_rebuild_scene_bvh(geom)) {
+      need_rebuild_scene_bvh = true;
+      break;
+    }
+  }
+
   {
     scoped_callback_timer timer([scene](double time) {
       if (scene->update_stats) {
@@ -989,11 +1223,14 @@ void GeometryManager::device_update(Device *device,
         scene->update_stats->geometry.times.add_entry({"device_update (build scene BVH)", time});
       }
     });
-    device_update_bvh(device, dscene, scene, progress);
+    device_update_bvh(device, dscene, scene, need_rebuild_scene_bvh, progress);
     if (progress.get_cancel()) {
       return;
     }
   }
+  else {
+    VLOG_INFO << "Skipped scene BVH update, no geometry or transforms changed.";
+  }
 
   /* Always set BVH layout again after displacement where it was set to none,
    * to avoid ray-tracing at that stage. */
@@ -1016,6 +1253,10 @@ void GeometryManager::device_update(Device *device,
   /* unset flags */
 
   foreach (Geometry *geom, scene->geometry) {
+    if (geom->is_modified()) {
+      geom->need_update_light_tree = true;
+      geom->device_update_hash_commit();
+    }
     geom->clear_modified();
     geom->attributes.clear_modified();
 
@@ -13,6 +13,7 @@
 
 #include "util/boundbox.h"
 #include "util/set.h"
+#include "util/string.h"
 #include "util/transform.h"
 #include "util/types.h"
 #include "util/vector.h"
@@ -111,6 +112,15 @@ class Geometry : public Node {
   /* Update Flags */
   bool need_update_rebuild;
   bool need_update_bvh_for_offset;
+  /* Set when the geometry was modified, until the light tree was built with it. */
+  bool need_update_light_tree;
+
+  /* Hash of the data as it was last updated on the device, to detect when the geometry is
+   * synchronized again with identical data. Empty when not known. The hash of the data being
+   * updated is kept pending until the device update finished, so that a canceled or failed
+   * update is not mistaken for up to date device data. */
+  string device_update_hash;
+  string device_update_pending_hash;
 
   /* Index into scene->geometry (only valid during update) */
   size_t index;
@@ -133,6 +143,15 @@ class Geometry : public Node {
   /* UDIM */
   virtual void get_uv_tiles(ustring map, unordered_set<int> &tiles) = 0;
 
+  /* Hash of the socket values and attribute data. */
+  string content_hash();
+
+  /* Returns true when the content hash matches the device data, so the device update can be
+   * skipped. Otherwise the hash is kept pending until device_update_hash_commit(). */
+  bool device_update_hash_matches(string hash);
+  /* Store the pending hash, once the device data was updated successfully. */
+  void device_update_hash_commit();
+
   /* Convert between normalized -1..1 motion time and index in the
    * VERTEX_MOTION attribute. */
   float motion_time(int step) const;
@@ -271,7 +290,19 @@ class GeometryManager {
                                 Scene *scene,
                                 Progress &progress);
 
-  void device_update_bvh(Device *device, DeviceScene *dscene, Scene *scene, Progress &progress);
+  void device_update_bvh(Device *device,
+                         DeviceScene *dscene,
+                         Scene *scene,
+                         const bool need_rebuild,
+                         Progress &progress);
+
+  /* Clear modified flags of geometry with the same content as on the device, returns the
+   * number of geometries skipped. */
+  size_t skip_unchanged_geometry(DeviceScene *dscene, Scene *scene, Progress &progress);
+
+  /* Objects, primitive and vertex counts the scene BVH was built for, it can only be refit while
+   * they stay the same. */
+  vector<size_t> scene_bvh_topology;
 
   void device_update_displacement_images(Device *device, Scene *scene, Progress &progress);
 
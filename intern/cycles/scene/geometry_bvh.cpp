@@ -30,6 +30,7 @@
 #include "util/log.h"
 #include "util/progress.h"
 #include "util/task.h"
+#include "util/time.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -92,6 +93,7 @@ void Geometry::compute_bvh(Device *device,
       bparams.num_motion_point_steps = params->num_bvh_time_steps;
       bparams.bvh_type = params->bvh_type;
       bparams.curve_subdivisions = params->curve_subdivisions();
+      bparams.use_refit = params->use_bvh_refit;
 
       delete bvh;
       bvh = BVH::create(bparams, geometry, objects, device);
@@ -103,9 +105,45 @@ void Geometry::compute_bvh(Device *device,
   need_update_bvh_for_offset = false;
 }
 
+static void get_scene_bvh_topology(const Scene *scene, vector<size_t> &topology)
+{
+  topology.clear();
+  topology.reserve(scene->objects.size() * 4);
+
+  foreach (const Object *object, scene->objects) {
+    const Geometry *geom = object->get_geometry();
+
+    size_t num_primitives = 0;
+    size_t num_verts = 0;
+    if (geom->is_mesh() || geom->is_volume()) {
+      const Mesh *mesh = static_cast<const Mesh *>(geom);
+      num_primitives = mesh->num_triangles();
+      num_verts = mesh->get_verts().size();
+    }
+    else if (geom->is_hair()) {
+      const Hair *hair = static_cast<const Hair *>(geom);
+      num_primitives = hair->num_segments();
+      num_verts = hair->get_curve_keys().size();
+    }
+    else if (geom->is_pointcloud()) {
+      num_primitives = static_cast<const PointCloud *>(geom)->num_points();
+      num_verts = num_primitives;
+    }
+
+    topology.push_back(size_t(geom));
+    topology.push_back(size_t(object->is_traceable()) | (size_t(geom->is_instanced()) << 1) |
+                       (size_t(geom->has_motion_blur()) << 2));
+    topology.push_back(object->use_motion() ? object->get_motion().size() : 0);
+    topology.push_back(geom->prim_offset);
+    topology.push_back(num_primitives);
+    topology.push_back(num_verts);
+  }
+}
+
 void GeometryManager::device_update_bvh(Device *device,
                                         DeviceScene *dscene,
                                         Scene *scene,
+                                        const bool need_rebuild,
                                         Progress &progress)
 {
   /* bvh build */
@@ -123,25 +161,67 @@ void GeometryManager::device_update_bvh(Device *device,
   bparams.num_motion_point_steps = scene->params.num_bvh_time_steps;
   bparams.bvh_type = scene->params.bvh_type;
   bparams.curve_subdivisions = scene->params.curve_subdivisions();
+  bparams.use_refit = scene->params.use_bvh_refit;
 
   VLOG_INFO << "Using " << bvh_layout_name(bparams.bvh_layout) << " layout.";
 
-  const bool can_refit = scene->bvh != nullptr &&
-                         (bparams.bvh_layout == BVHLayout::BVH_LAYOUT_OPTIX ||
-                          bparams.bvh_layout == BVHLayout::BVH_LAYOUT_METAL);
+  const bool has_bvh2_layout = (bparams.bvh_layout == BVH_LAYOUT_BVH2);
+
+  /* BVH2 and Embree can only refit bounds of the same objects and primitives. */
+  const bool use_topology_refit = bparams.use_refit &&
+                                  (has_bvh2_layout || bparams.bvh_layout == BVH_LAYOUT_EMBREE);
+  vector<size_t> topology;
+  if (use_topology_refit) {
+    get_scene_bvh_topology(scene, topology);
+  }
+
+  bool can_refit = false;
+  if (scene->bvh != nullptr) {
+    can_refit = (bparams.bvh_layout == BVHLayout::BVH_LAYOUT_OPTIX ||
+                 bparams.bvh_layout == BVHLayout::BVH_LAYOUT_METAL) ||
+                (use_topology_refit && !need_rebuild && topology == scene_bvh_topology);
+  }
 
   BVH *bvh = scene->bvh;
   if (!scene->bvh) {
     bvh = scene->bvh = BVH::create(bparams, scene->geometry, scene->objects, device);
   }
+  else if (can_refit && use_topology_refit) {
+    bvh->replace_geometry(scene->geometry, scene->objects);
+
+    if (has_bvh2_layout) {
+      /* Take back the packed nodes and primitives that were moved to the device arrays. */
+      BVH2 *bvh2 = static_cast<BVH2 *>(bvh);
+      dscene->bvh_nodes.give_data(bvh2->pack.nodes);
+      dscene->bvh_leaf_nodes.give_data(bvh2->pack.leaf_nodes);
+      dscene->object_node.give_data(bvh2->pack.object_node);
+      dscene->prim_type.give_data(bvh2->pack.prim_type);
+      dscene->prim_visibility.give_data(bvh2->pack.prim_visibility);
+      dscene->prim_index.give_data(bvh2->pack.prim_index);
+      dscene->prim_object.give_data(bvh2->pack.prim_object);
+      dscene->prim_time.give_data(bvh2->pack.prim_time);
+    }
+  }
 
-  device->build_bvh(bvh, progress, can_refit);
+  {
+    const double start_time = time_dt();
+
+    device->build_bvh(bvh, progress, can_refit);
+
+    const double time = time_dt() - start_time;
+    const char *operation = (can_refit && !bvh->refit_failed) ? "refit" : "build";
+    VLOG_INFO << "Scene BVH " << operation << " time " << time << " seconds.";
+    if (scene->update_stats) {
+      scene->update_stats->geometry.times.add_entry(
+          {string_printf("device_update (scene BVH %s)", operation), time});
+    }
+  }
 
   if (progress.get_cancel()) {
     return;
   }
 
-  const bool has_bvh2_layout = (bparams.bvh_layout == BVH_LAYOUT_BVH2);
+  scene_bvh_topology = std::move(topology);
 
   PackedBVH pack;
   if (has_bvh2_layout) {
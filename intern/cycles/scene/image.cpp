@@ -5,6 +5,7 @@
 #include "scene/image.h"
 #include "device/device.h"
 #include "scene/colorspace.h"
+#include "scene/image_cache.h"
 #include "scene/image_oiio.h"
 #include "scene/image_vdb.h"
 #include "scene/scene.h"
@@ -55,6 +56,8 @@ const char *name_from_type(ImageDataType type)
       return "nanovdb_fpn";
     case IMAGE_DATA_TYPE_NANOVDB_FP16:
       return "nanovdb_fp16";
+    case IMAGE_DATA_TYPE_TILE_CACHE:
+      return "tile_cache";
     case IMAGE_DATA_NUM_TYPES:
       assert(!"System enumerator type, should never be used");
       return "";
@@ -312,6 +315,10 @@ ImageManager::ImageManager(const DeviceInfo &info)
 
   /* Set image limits */
   features.has_nanovdb = info.has_nanovdb;
+
+  if (info.type == DEVICE_CPU) {
+    tile_cache = make_unique<ImageTileCache>();
+  }
 }
 
 ImageManager::~ImageManager()
@@ -690,15 +697,31 @@ void ImageManager::device_load_image(Device *device, Scene *scene, size_t slot,
   load_image_metadata(img);
   ImageDataType type = img->metadata.type;
 
-  /* Name for debugging. */
-  img->mem_name = string_printf("tex_image_%s_%03d", name_from_type(type), (int)slot);
-
   /* Free previous texture in slot. */
   if (img->mem) {
     thread_scoped_lock device_lock(device_mutex);
     delete img->mem;
     img->mem = NULL;
   }
+  img->tile_cache_file.reset();
+
+  /* Tiled files are loaded on demand by the kernel, when a texture cache size is set. */
+  if (tile_cache && scene->params.texture_cache_size > 0 && !img->builtin &&
+      img->metadata.depth <= 1 && img->metadata.channels > 0 &&
+      !img->loader->osl_filepath().empty())
+  {
+    img->tile_cache_file = tile_cache->open_file(img->loader->osl_filepath().string(),
+                                                 img->metadata,
+                                                 img->params,
+                                                 image_associate_alpha(img),
+                                                 texture_limit);
+    if (img->tile_cache_file) {
+      type = IMAGE_DATA_TYPE_TILE_CACHE;
+    }
+  }
+
+  /* Name for debugging. */
+  img->mem_name = string_printf("tex_image_%s_%03d", name_from_type(type), (int)slot);
 
   img->mem = new device_texture(
       device, img->mem_name.c_str(), slot, type, img->params.interpolation, img->params.extension);
@@ -706,7 +729,16 @@ void ImageManager::device_load_image(Device *device, Scene *scene, size_t slot,
   img->mem->info.transform_3d = img->metadata.transform_3d;
 
   /* Create new texture. */
-  if (type == IMAGE_DATA_TYPE_FLOAT4) {
+  if (type == IMAGE_DATA_TYPE_TILE_CACHE) {
+    /* Only store the pointer the kernel looks up tiles through. */
+    thread_scoped_lock device_lock(device_mutex);
+    TextureCacheImage **data = (TextureCacheImage **)img->mem->alloc(
+        sizeof(TextureCacheImage *), 1);
+    *data = img->tile_cache_file.get();
+    img->mem->info.width = img->tile_cache_file->get_width();
+    img->mem->info.height = img->tile_cache_file->get_height();
+  }
+  else if (type == IMAGE_DATA_TYPE_FLOAT4) {
     if (!file_load_image<TypeDesc::FLOAT, float>(img, texture_limit)) {
       /* on failure to load, we set a 1x1 pixels pink image */
       thread_scoped_lock device_lock(device_mutex);
@@ -851,6 +883,10 @@ void ImageManager::device_update(Device *device, Scene *scene, Progress &progres
     }
   });
 
+  if (tile_cache) {
+    tile_cache->set_max_memory(size_t(scene->params.texture_cache_size) * 1024 * 1024);
+  }
+
   TaskPool pool;
   for (size_t slot = 0; slot < images.size(); slot++) {
     Image *img = images[slot];
@@ -932,6 +968,11 @@ void ImageManager::collect_statistics(RenderStats *stats)
     stats->image.textures.add_entry(
         NamedSizeEntry(image->loader->name(), image->mem->memory_size()));
   }
+
+  if (tile_cache && tile_cache->get_num_tiles_loaded() > 0) {
+    stats->image.textures.add_entry(
+        NamedSizeEntry("Tile cache (peak)", tile_cache->get_peak_memory()));
+  }
 }
 
 void ImageManager::tag_update()
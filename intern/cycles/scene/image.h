@@ -23,6 +23,8 @@ class ImageHandle;
 class ImageKey;
 class ImageMetaData;
 class ImageManager;
+class ImageTileCache;
+class ImageTileCacheFile;
 class Progress;
 class RenderStats;
 class Scene;
@@ -208,6 +210,9 @@ class ImageManager {
     string mem_name;
     device_texture *mem;
 
+    /* Pixels loaded on demand by the tile cache, instead of in full. */
+    unique_ptr<ImageTileCacheFile> tile_cache_file;
+
     int users;
     thread_mutex mutex;
   };
@@ -224,6 +229,9 @@ class ImageManager {
   vector<Image *> images;
   void *osl_texture_system;
 
+  /* Only supported on the CPU device, where the kernel can call back into it. */
+  unique_ptr<ImageTileCache> tile_cache;
+
   size_t add_image_slot(ImageLoader *loader, const ImageParams &params, const bool builtin);
   void add_image_user(size_t slot);
   void remove_image_user(size_t slot);
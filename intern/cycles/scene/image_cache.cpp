@@ -0,0 +1,535 @@
+/* SPDX-FileCopyrightText: 2011-2024 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "scene/image_cache.h"
+#include "scene/colorspace.h"
+#include "scene/image_oiio.h"
+
+#include "util/algorithm.h"
+#include "util/log.h"
+#include "util/path.h"
+
+CCL_NAMESPACE_BEGIN
+
+namespace {
+
+/* Same wrapping and interpolation as the CPU kernel image lookups, returning -1 for texels
+ * outside of the image with clip extension. */
+
+inline float texel_frac(const float x, int *ix)
+{
+  const int i = (int)x - ((x < 0.0f) ? 1 : 0);
+  *ix = i;
+  return x - (float)i;
+}
+
+inline int texel_wrap(int x, const int size, const ExtensionType extension)
+{
+  switch (extension) {
+    case EXTENSION_REPEAT:
+      x %= size;
+      return (x < 0) ? x + size : x;
+    case EXTENSION_EXTEND:
+      return clamp(x, 0, size - 1);
+    case EXTENSION_MIRROR: {
+      const int m = abs(x + (x < 0)) % (2 * size);
+      return (m >= size) ? 2 * size - m - 1 : m;
+    }
+    case EXTENSION_CLIP:
+    default:
+      return (x < 0 || x >= size) ? -1 : x;
+  }
+}
+
+/* Unique identifier of files, zero is never used. */
+std::atomic<uint64_t> next_file_id = 0;
+
+inline void cubic_spline_weights(float u[4], const float t)
+{
+  u[0] = (((-1.0f / 6.0f) * t + 0.5f) * t - 0.5f) * t + (1.0f / 6.0f);
+  u[1] = ((0.5f * t - 1.0f) * t) * t + (2.0f / 3.0f);
+  u[2] = ((-0.5f * t + 0.5f) * t + 0.5f) * t + (1.0f / 6.0f);
+  u[3] = (1.0f / 6.0f) * t * t * t;
+}
+
+}  // namespace
+
+/* Texel Accessor
+ *
+ * Lookups of nearby shading points nearly always read the same few tiles, so every thread keeps
+ * references to the tiles it read last. Only when a lookup needs another tile is the tiles lock
+ * taken and the tile pinned, other texel reads do not touch any shared state. */
+
+class ImageTileCacheFile::TexelAccessor {
+ public:
+  explicit TexelAccessor(ImageTileCacheFile &file)
+      : file(file), cache(thread_cache()), now(file.cache->clock.load(std::memory_order_relaxed))
+  {
+  }
+
+  float4 read(const int x, const int y)
+  {
+    if (x < 0 || y < 0) {
+      /* Single channel images have alpha one, also outside the image. */
+      return (file.channels == 1) ? make_float4(0.0f, 0.0f, 0.0f, 1.0f) : zero_float4();
+    }
+
+    /* Textures are stored bottom to top, files top to bottom. */
+    const int file_y = file.height - 1 - y;
+    const int tile_x = x / file.tile_width;
+    const int tile_y = file_y / file.tile_height;
+    const Tile &tile = find_tile(tile_y * file.num_tiles_x + tile_x);
+
+    const int local_x = x - tile_x * file.tile_width;
+    const int local_y = file_y - tile_y * file.tile_height;
+    const float *texel =
+        tile.pixels.data() + (size_t(local_y) * file.tile_width + local_x) * file.channels;
+    if (file.channels == 1) {
+      return make_float4(texel[0], texel[0], texel[0], 1.0f);
+    }
+    return make_float4(texel[0], texel[1], texel[2], texel[3]);
+  }
+
+ private:
+  /* A cubic lookup reads from at most four tiles. */
+  static constexpr int num_cached_tiles = 4;
+
+  /* Tiles stay referenced until the thread reads other tiles, so evicted tiles may be kept alive
+   * a little longer. Files are identified by their id, as a new file may reuse the memory of a
+   * freed one. */
+  struct ThreadCache {
+    uint64_t file_id[num_cached_tiles] = {0};
+    int index[num_cached_tiles] = {0};
+    std::shared_ptr<Tile> tiles[num_cached_tiles];
+    int next = 0;
+  };
+
+  static ThreadCache &thread_cache()
+  {
+    static thread_local ThreadCache cache;
+    return cache;
+  }
+
+  const Tile &find_tile(const int index)
+  {
+    for (int i = 0; i < num_cached_tiles; i++) {
+      if (cache.file_id[i] == file.id && cache.index[i] == index) {
+        Tile &tile = *cache.tiles[i];
+        file.touch_tile(tile, now);
+        return tile;
+      }
+    }
+
+    /* Replace the tile that was cached first. */
+    const int i = cache.next;
+    cache.next = (i + 1) % num_cached_tiles;
+    cache.tiles[i] = file.get_tile(index);
+    cache.file_id[i] = file.id;
+    cache.index[i] = index;
+    return *cache.tiles[i];
+  }
+
+  ImageTileCacheFile &file;
+  ThreadCache &cache;
+  uint64_t now;
+};
+
+/* Image Tile Cache File */
+
+ImageTileCacheFile::ImageTileCacheFile(ImageTileCache *cache, unique_ptr<ImageInput> in)
+    : id(++next_file_id), cache(cache), in(std::move(in))
+{
+}
+
+ImageTileCacheFile::~ImageTileCacheFile()
+{
+  cache->remove_file(this);
+
+  size_t size = 0;
+  for (const std::shared_ptr<Tile> &tile : tiles) {
+    if (tile) {
+      size += tile->pixels.size() * sizeof(float);
+    }
+  }
+  cache->memory_used -= size;
+
+  in->close();
+}
+
+float4 ImageTileCacheFile::lookup(const float x, const float y)
+{
+  TexelAccessor texels(*this);
+
+  if (interpolation == INTERPOLATION_CLOSEST) {
+    int ix, iy;
+    texel_frac(x * (float)width, &ix);
+    texel_frac(y * (float)height, &iy);
+    return texels.read(texel_wrap(ix, width, extension), texel_wrap(iy, height, extension));
+  }
+
+  /* A -0.5 offset is used to center the samples around the sample point. */
+  int ix, iy;
+  const float tx = texel_frac(x * (float)width - 0.5f, &ix);
+  const float ty = texel_frac(y * (float)height - 0.5f, &iy);
+
+  if (interpolation == INTERPOLATION_LINEAR) {
+    const int x0 = texel_wrap(ix, width, extension);
+    const int x1 = texel_wrap(ix + 1, width, extension);
+    const int y0 = texel_wrap(iy, height, extension);
+    const int y1 = texel_wrap(iy + 1, height, extension);
+    return (1.0f - ty) * (1.0f - tx) * texels.read(x0, y0) +
+           (1.0f - ty) * tx * texels.read(x1, y0) + ty * (1.0f - tx) * texels.read(x0, y1) +
+           ty * tx * texels.read(x1, y1);
+  }
+
+  /* Cubic and smart interpolation. */
+  float u[4], v[4];
+  cubic_spline_weights(u, tx);
+  cubic_spline_weights(v, ty);
+
+  int xc[4], yc[4];
+  for (int i = 0; i < 4; i++) {
+    xc[i] = texel_wrap(ix + i - 1, width, extension);
+    yc[i] = texel_wrap(iy + i - 1, height, extension);
+  }
+
+  float4 result = zero_float4();
+  for (int j = 0; j < 4; j++) {
+    float4 row = zero_float4();
+    for (int i = 0; i < 4; i++) {
+      row += u[i] * texels.read(xc[i], yc[j]);
+    }
+    result += v[j] * row;
+  }
+  return result;
+}
+
+std::shared_ptr<ImageTileCacheFile::Tile> ImageTileCacheFile::get_tile(const int index)
+{
+  const uint64_t now = cache->clock.load(std::memory_order_relaxed);
+
+  std::shared_ptr<Tile> tile;
+  {
+    thread_scoped_spin_lock lock(tiles_lock);
+    tile = tiles[index];
+  }
+
+  if (tile) {
+    touch_tile(*tile, now);
+    return tile;
+  }
+
+  /* Load outside of the lock, if another thread loaded the same tile in the meantime its
+   * tile is used and this one discarded. */
+  tile = load_tile(index);
+  size_t memory_used;
+  {
+    thread_scoped_spin_lock lock(tiles_lock);
+    if (tiles[index]) {
+      return tiles[index];
+    }
+    /* Account for the memory before eviction can find the tile, which subtracts its size. */
+    memory_used = (cache->memory_used += tile->pixels.size() * sizeof(float));
+    tiles[index] = tile;
+  }
+
+  cache->tile_added(memory_used);
+  return tile;
+}
+
+void ImageTileCacheFile::touch_tile(Tile &tile, const uint64_t now)
+{
+  /* Avoid writing to shared memory when nothing changed. */
+  if (tile.last_used.load(std::memory_order_relaxed) != now) {
+    tile.last_used.store(now, std::memory_order_relaxed);
+  }
+}
+
+std::shared_ptr<ImageTileCacheFile::Tile> ImageTileCacheFile::load_tile(const int index)
+{
+  std::shared_ptr<Tile> tile = std::make_shared<Tile>();
+  tile->last_used = cache->clock.load(std::memory_order_relaxed);
+
+  const int x_begin = (index % num_tiles_x) * tile_width;
+  const int y_begin = (index / num_tiles_x) * tile_height;
+  const int x_end = min(x_begin + tile_width, width);
+  const int y_end = min(y_begin + tile_height, height);
+  const size_t num_pixels = size_t(tile_width) * tile_height;
+
+  /* Read with the final tile layout, so the channels can be expanded in place. Reading with
+   * an explicit mipmap level is thread safe in OIIO. */
+  tile->pixels.resize(num_pixels * max(channels, file_channels));
+  float *pixels = tile->pixels.data();
+
+  const stride_t xstride = file_channels * sizeof(float);
+  if (!in->read_tiles(0,
+                      miplevel,
+                      origin_x + x_begin,
+                      origin_x + x_end,
+                      origin_y + y_begin,
+                      origin_y + y_end,
+                      0,
+                      1,
+                      0,
+                      file_channels,
+                      TypeDesc::FLOAT,
+                      pixels,
+                      xstride,
+                      xstride * tile_width,
+                      AutoStride))
+  {
+    VLOG_WARNING << "Failed to read tile of " << name << ": " << in->geterror();
+    for (size_t i = 0; i < num_pixels; i++) {
+      float *pixel = pixels + i * channels;
+      pixel[0] = TEX_IMAGE_MISSING_R;
+      if (channels == 4) {
+        pixel[1] = TEX_IMAGE_MISSING_G;
+        pixel[2] = TEX_IMAGE_MISSING_B;
+        pixel[3] = TEX_IMAGE_MISSING_A;
+      }
+    }
+    tile->pixels.resize(num_pixels * channels);
+    return tile;
+  }
+
+  /* Convert to the kernel layout, matching ImageManager::file_load_image. */
+  const bool is_rgba = (channels == 4);
+  if (is_rgba) {
+    for (size_t i = num_pixels - 1, pixel = 0; pixel < num_pixels; pixel++, i--) {
+      const float *in_pixel = pixels + i * file_channels;
+      float *out_pixel = pixels + i * 4;
+      float rgba[4];
+      switch (file_channels) {
+        case 1:
+          rgba[0] = rgba[1] = rgba[2] = in_pixel[0];
+          rgba[3] = 1.0f;
+          break;
+        case 2:
+          rgba[0] = rgba[1] = rgba[2] = in_pixel[0];
+          rgba[3] = in_pixel[1];
+          break;
+        case 3:
+          rgba[0] = in_pixel[0];
+          rgba[1] = in_pixel[1];
+          rgba[2] = in_pixel[2];
+          rgba[3] = 1.0f;
+          break;
+        default:
+          rgba[0] = in_pixel[0];
+          rgba[1] = in_pixel[1];
+          rgba[2] = in_pixel[2];
+          rgba[3] = in_pixel[3];
+          if (associate_alpha) {
+            rgba[0] *= rgba[3];
+            rgba[1] *= rgba[3];
+            rgba[2] *= rgba[3];
+          }
+          break;
+      }
+      if (alpha_type == IMAGE_ALPHA_IGNORE) {
+        rgba[3] = 1.0f;
+      }
+      out_pixel[0] = rgba[0];
+      out_pixel[1] = rgba[1];
+      out_pixel[2] = rgba[2];
+      out_pixel[3] = rgba[3];
+    }
+  }
+  tile->pixels.resize(num_pixels * channels);
+
+  if (colorspace != u_colorspace_raw && colorspace != u_colorspace_srgb) {
+    ColorSpaceManager::to_scene_linear(colorspace, pixels, num_pixels, is_rgba, compress_as_srgb);
+  }
+
+  /* Make sure we don't have buggy values, like file_load_image. */
+  for (size_t i = 0; i < num_pixels; i++) {
+    float *pixel = pixels + i * channels;
+    bool finite = true;
+    for (int c = 0; c < channels; c++) {
+      finite &= isfinite(pixel[c]);
+    }
+    if (!finite) {
+      for (int c = 0; c < channels; c++) {
+        pixel[c] = 0.0f;
+      }
+    }
+  }
+
+  return tile;
+}
+
+void ImageTileCacheFile::collect_tiles(vector<TileEntry> &entries)
+{
+  thread_scoped_spin_lock lock(tiles_lock);
+  for (int index = 0; index < tiles.size(); index++) {
+    if (tiles[index]) {
+      entries.push_back({tiles[index]->last_used.load(std::memory_order_relaxed), this, index});
+    }
+  }
+}
+
+size_t ImageTileCacheFile::free_tile(const int index)
+{
+  std::shared_ptr<Tile> tile;
+  {
+    thread_scoped_spin_lock lock(tiles_lock);
+    tile.swap(tiles[index]);
+  }
+
+  /* Lookups in other threads may still hold a reference, the memory is freed after. */
+  return (tile) ? tile->pixels.size() * sizeof(float) : 0;
+}
+
+/* Image Tile Cache */
+
+ImageTileCache::ImageTileCache()
+    : max_memory(0), memory_used(0), memory_peak(0), num_tiles_loaded(0), clock(0)
+{
+}
+
+ImageTileCache::~ImageTileCache()
+{
+  assert(files.empty());
+  if (num_tiles_loaded > 0) {
+    VLOG_INFO << "Image tile cache loaded " << num_tiles_loaded << " tiles, peak memory "
+              << string_human_readable_size(memory_peak) << ".";
+  }
+}
+
+unique_ptr<ImageTileCacheFile> ImageTileCache::open_file(const string &filepath,
+                                                         const ImageMetaData &metadata,
+                                                         const ImageParams &params,
+                                                         const bool associate_alpha,
+                                                         const int texture_limit)
+{
+  unique_ptr<ImageInput> in(ImageInput::create(filepath));
+  if (!in) {
+    return nullptr;
+  }
+
+  ImageSpec config;
+  config.attribute("oiio:UnassociatedAlpha", 1);
+
+  ImageSpec spec;
+  if (!in->open(filepath, spec, config)) {
+    return nullptr;
+  }
+
+  /* Only tiled 2D images benefit, others are loaded in full like before. */
+  if (spec.tile_width == 0 || spec.tile_height == 0 || spec.depth > 1 || spec.nchannels < 1) {
+    in->close();
+    return nullptr;
+  }
+
+  const bool do_associate_alpha = associate_alpha &&
+                                  OIIOImageLoader::file_has_unassociated_alpha(*in, spec);
+
+  /* Pick the mipmap level instead of resizing, when the texture size is limited. */
+  int miplevel = 0;
+  if (texture_limit > 0) {
+    while (max(spec.width, spec.height) > texture_limit && in->seek_subimage(0, miplevel + 1)) {
+      miplevel++;
+      spec = in->spec();
+    }
+    if (spec.tile_width == 0 || spec.tile_height == 0) {
+      in->close();
+      return nullptr;
+    }
+  }
+
+  unique_ptr<ImageTileCacheFile> file(new ImageTileCacheFile(this, std::move(in)));
+  file->miplevel = miplevel;
+  file->origin_x = spec.x;
+  file->origin_y = spec.y;
+  file->width = spec.width;
+  file->height = spec.height;
+  file->tile_width = spec.tile_width;
+  file->tile_height = spec.tile_height;
+  file->num_tiles_x = divide_up(spec.width, spec.tile_width);
+  file->num_tiles_y = divide_up(spec.height, spec.tile_height);
+  file->file_channels = min(spec.nchannels, 4);
+  file->channels = (spec.nchannels > 1) ? 4 : 1;
+  file->interpolation = params.interpolation;
+  file->extension = params.extension;
+  file->alpha_type = params.alpha_type;
+  file->associate_alpha = do_associate_alpha;
+  file->colorspace = metadata.colorspace;
+  file->compress_as_srgb = metadata.compress_as_srgb;
+  file->name = path_filename(filepath);
+  file->tiles.resize(size_t(file->num_tiles_x) * file->num_tiles_y);
+
+  VLOG_WORK << "Image " << file->name << " loaded on demand from mipmap level " << miplevel
+            << ", " << file->width << "x" << file->height << " in " << file->tiles.size()
+            << " tiles.";
+
+  add_file(file.get());
+  return file;
+}
+
+void ImageTileCache::set_max_memory(const size_t max_memory_)
+{
+  max_memory = max_memory_;
+  if (memory_used > max_memory) {
+    evict_tiles();
+  }
+}
+
+void ImageTileCache::tile_added(const size_t used)
+{
+  size_t peak = memory_peak.load(std::memory_order_relaxed);
+  while (used > peak && !memory_peak.compare_exchange_weak(peak, used)) {
+    /* Retry with the updated peak. */
+  }
+
+  num_tiles_loaded++;
+  clock++;
+
+  if (used > max_memory) {
+    evict_tiles();
+  }
+}
+
+void ImageTileCache::evict_tiles()
+{
+  thread_scoped_lock lock(files_mutex);
+
+  /* Another thread may have freed enough memory already. */
+  if (memory_used <= max_memory) {
+    return;
+  }
+
+  vector<ImageTileCacheFile::TileEntry> entries;
+  for (ImageTileCacheFile *file : files) {
+    file->collect_tiles(entries);
+  }
+
+  sort(entries.begin(),
+       entries.end(),
+       [](const ImageTileCacheFile::TileEntry &a, const ImageTileCacheFile::TileEntry &b) {
+         return a.last_used < b.last_used;
+       });
+
+  /* Free some more than needed, so eviction does not run again for every tile load. */
+  const size_t target_memory = max_memory - max_memory / 4;
+  for (const ImageTileCacheFile::TileEntry &entry : entries) {
+    if (memory_used <= target_memory) {
+      break;
+    }
+    memory_used -= entry.file->free_tile(entry.index);
+  }
+}
+
+void ImageTileCache::add_file(ImageTileCacheFile *file)
+{
+  thread_scoped_lock lock(files_mutex);
+  files.push_back(file);
+}
+
+void ImageTileCache::remove_file(ImageTileCacheFile *file)
+{
+  thread_scoped_lock lock(files_mutex);
+  files.erase(std::remove(files.begin(), files.end(), file), files.end());
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,144 @@
+/* SPDX-FileCopyrightText: 2011-2024 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#ifndef __IMAGE_CACHE_H__
+#define __IMAGE_CACHE_H__
+
+#include "scene/image.h"
+
+#include "util/image.h"
+#include "util/texture_cache.h"
+
+#include <atomic>
+#include <memory>
+
+CCL_NAMESPACE_BEGIN
+
+class ImageTileCache;
+
+/* Image Tile Cache File
+ *
+ * Tiled image file, typically a mipmapped .tx file, of which the tiles are read when the
+ * kernel first looks them up. Pixels are stored as float in scene linear color space, with
+ * either one or four channels like regular image textures. */
+class ImageTileCacheFile : public TextureCacheImage {
+ public:
+  ~ImageTileCacheFile() override;
+
+  float4 lookup(float x, float y) override;
+
+  int get_width() const
+  {
+    return width;
+  }
+  int get_height() const
+  {
+    return height;
+  }
+
+ protected:
+  struct Tile {
+    vector<float> pixels;
+    std::atomic<uint64_t> last_used;
+  };
+
+  struct TileEntry {
+    uint64_t last_used;
+    ImageTileCacheFile *file;
+    int index;
+  };
+
+  class TexelAccessor;
+
+  ImageTileCacheFile(ImageTileCache *cache, unique_ptr<ImageInput> in);
+
+  std::shared_ptr<Tile> get_tile(int index);
+  std::shared_ptr<Tile> load_tile(int index);
+  void touch_tile(Tile &tile, uint64_t now);
+
+  void collect_tiles(vector<TileEntry> &entries);
+  size_t free_tile(int index);
+
+  uint64_t id;
+  ImageTileCache *cache;
+  unique_ptr<ImageInput> in;
+
+  /* Resolution of the mipmap level used for rendering, and its tiles. */
+  int miplevel;
+  int origin_x, origin_y;
+  int width, height;
+  int tile_width, tile_height;
+  int num_tiles_x, num_tiles_y;
+
+  /* Channels read from file, and stored in the tiles. */
+  int file_channels;
+  int channels;
+
+  InterpolationType interpolation;
+  ExtensionType extension;
+  ImageAlphaType alpha_type;
+  bool associate_alpha;
+  ustring colorspace;
+  bool compress_as_srgb;
+  string name;
+
+  thread_spin_lock tiles_lock;
+  vector<std::shared_ptr<Tile>> tiles;
+
+  friend class ImageTileCache;
+};
+
+/* Image Tile Cache
+ *
+ * Shared by all tiled image files of a scene on the CPU device, and keeps the memory used by
+ * their loaded tiles below a limit by freeing the least recently used tiles. */
+class ImageTileCache {
+ public:
+  ImageTileCache();
+  ~ImageTileCache();
+
+  /* Open the file for on demand loading, returns null if the file is not tiled and must be
+   * loaded in full. With a texture limit, the first mipmap level small enough is used. */
+  unique_ptr<ImageTileCacheFile> open_file(const string &filepath,
+                                           const ImageMetaData &metadata,
+                                           const ImageParams &params,
+                                           const bool associate_alpha,
+                                           const int texture_limit);
+
+  void set_max_memory(const size_t max_memory);
+
+  size_t get_peak_memory() const
+  {
+    return memory_peak;
+  }
+  size_t get_num_tiles_loaded() const
+  {
+    return num_tiles_loaded;
+  }
+
+ protected:
+  /* Called after a tile was added, with the memory used including it. */
+  void tile_added(const size_t used);
+  void evict_tiles();
+
+  void add_file(ImageTileCacheFile *file);
+  void remove_file(ImageTileCacheFile *file);
+
+  size_t max_memory;
+  std::atomic<size_t> memory_used;
+  std::atomic<size_t> memory_peak;
+  std::atomic<size_t> num_tiles_loaded;
+
+  /* Incremented with every tile load, tiles store the value when they were last used. */
+  std::atomic<uint64_t> clock;
+
+  thread_mutex files_mutex;
+  vector<ImageTileCacheFile *> files;
+
+  friend class ImageTileCacheFile;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __IMAGE_CACHE_H__ */
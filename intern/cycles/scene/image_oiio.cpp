@@ -164,6 +164,32 @@ static void oiio_load_pixels(const ImageMetaData &metadata,
   }
 }
 
+bool OIIOImageLoader::file_has_unassociated_alpha(const ImageInput &in, const ImageSpec &spec)
+{
+  if (spec.get_int_attribute("oiio:UnassociatedAlpha", 0)) {
+    return true;
+  }
+  if (spec.alpha_channel == -1) {
+    return false;
+  }
+
+  /* Workaround OIIO not detecting TGA file alpha the same as Blender (since #3019).
+   * We want anything not marked as premultiplied alpha to get associated. */
+  if (strcmp(in.format_name(), "targa") == 0) {
+    return spec.get_int_attribute("targa:alpha_type", -1) != 4;
+  }
+  /* OIIO DDS reader never sets UnassociatedAlpha attribute. */
+  if (strcmp(in.format_name(), "dds") == 0) {
+    return true;
+  }
+  /* Workaround OIIO bug that sets oiio:UnassociatedAlpha on the last layer
+   * but not composite image that we read. */
+  if (strcmp(in.format_name(), "psd") == 0) {
+    return true;
+  }
+  return false;
+}
+
 bool OIIOImageLoader::load_pixels(const ImageMetaData &metadata,
                                   void *pixels,
                                   const size_t,
@@ -194,27 +220,7 @@ bool OIIOImageLoader::load_pixels(const ImageMetaData &metadata,
     return false;
   }
 
-  bool do_associate_alpha = false;
-  if (associate_alpha) {
-    do_associate_alpha = spec.get_int_attribute("oiio:UnassociatedAlpha", 0);
-
-    if (!do_associate_alpha && spec.alpha_channel != -1) {
-      /* Workaround OIIO not detecting TGA file alpha the same as Blender (since #3019).
-       * We want anything not marked as premultiplied alpha to get associated. */
-      if (strcmp(in->format_name(), "targa") == 0) {
-        do_associate_alpha = spec.get_int_attribute("targa:alpha_type", -1) != 4;
-      }
-      /* OIIO DDS reader never sets UnassociatedAlpha attribute. */
-      if (strcmp(in->format_name(), "dds") == 0) {
-        do_associate_alpha = true;
-      }
-      /* Workaround OIIO bug that sets oiio:UnassociatedAlpha on the last layer
-       * but not composite image that we read. */
-      if (strcmp(in->format_name(), "psd") == 0) {
-        do_associate_alpha = true;
-      }
-    }
-  }
+  const bool do_associate_alpha = associate_alpha && file_has_unassociated_alpha(*in, spec);
 
   switch (metadata.type) {
     case IMAGE_DATA_TYPE_BYTE:
@@ -238,6 +244,7 @@ bool OIIOImageLoader::load_pixels(const ImageMetaData &metadata,
     case IMAGE_DATA_TYPE_NANOVDB_FLOAT3:
     case IMAGE_DATA_TYPE_NANOVDB_FPN:
     case IMAGE_DATA_TYPE_NANOVDB_FP16:
+    case IMAGE_DATA_TYPE_TILE_CACHE:
     case IMAGE_DATA_NUM_TYPES:
       break;
   }
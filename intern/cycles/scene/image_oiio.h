@@ -7,6 +7,8 @@
 
 #include "scene/image.h"
 
+#include "util/image.h"
+
 CCL_NAMESPACE_BEGIN
 
 class OIIOImageLoader : public ImageLoader {
@@ -27,6 +29,10 @@ class OIIOImageLoader : public ImageLoader {
 
   bool equals(const ImageLoader &other) const override;
 
+  /* Test if the pixels read from a file opened with "oiio:UnassociatedAlpha" need their
+   * alpha associated, working around file formats where OIIO does not report it. */
+  static bool file_has_unassociated_alpha(const ImageInput &in, const ImageSpec &spec);
+
  protected:
   ustring filepath;
 };
@@ -805,17 +805,25 @@ void LightManager::device_update_tree(Device *,
   KernelIntegrator *kintegrator = &dscene->data.integrator;
 
   if (!kintegrator->use_light_tree) {
+    light_tree_mesh_cache.reset();
     return;
   }
 
   /* Update light tree. */
   progress.set_status("Updating Lights", "Computing tree");
 
+  /* Subtrees of meshes can be reused as long as the emission of their triangles, which depends on
+   * the shaders, does not change. */
+  if (!light_tree_mesh_cache || (update_flags & (SHADER_COMPILED | SHADER_MODIFIED))) {
+    light_tree_mesh_cache = make_unique<LightTreeMeshCache>();
+  }
+
   /* TODO: For now, we'll start with a smaller number of max lights in a node.
    * More benchmarking is needed to determine what number works best. */
   LightTree light_tree(scene, dscene, progress, 8);
-  LightTreeNode *root = light_tree.build(scene, dscene);
+  LightTreeNode *root = light_tree.build(scene, dscene, light_tree_mesh_cache.get());
   if (progress.get_cancel()) {
+    light_tree_mesh_cache.reset();
     return;
   }
 
@@ -843,7 +851,7 @@ void LightManager::device_update_tree(Device *,
   memset(klight_link_sets, 0, sizeof(dscene->data.light_link_sets));
 
   VLOG_INFO << "Use light tree with " << num_emitters << " emitters and " << light_tree.num_nodes
-            << " nodes.";
+            << " nodes, reused subtrees of " << light_tree.num_reused_meshes << " meshes.";
 
   if (!use_light_linking) {
     /* Regular light tree without linking. */
@@ -892,6 +900,12 @@ void LightManager::device_update_tree(Device *,
               << light_link_nodes.size() - light_tree.num_nodes << " additional nodes.";
   }
 
+  /* Keep the subtrees of meshes for the next update. */
+  light_tree.update_mesh_cache(scene, *light_tree_mesh_cache);
+  foreach (Geometry *geom, scene->geometry) {
+    geom->need_update_light_tree = false;
+  }
+
   /* Copy arrays to device. */
   dscene->light_tree_nodes.copy_to_device();
   dscene->light_tree_emitters.copy_to_device();
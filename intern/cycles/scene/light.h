@@ -16,12 +16,14 @@
 #include "util/ies.h"
 #include "util/thread.h"
 #include "util/types.h"
+#include "util/unique_ptr.h"
 #include "util/vector.h"
 
 CCL_NAMESPACE_BEGIN
 
 class Device;
 class DeviceScene;
+struct LightTreeMeshCache;
 class Progress;
 class Scene;
 class Shader;
@@ -166,6 +168,9 @@ class LightManager {
   bool last_background_enabled;
   int last_background_resolution;
 
+  /* Subtrees of emissive meshes from the previous light tree build. */
+  unique_ptr<LightTreeMeshCache> light_tree_mesh_cache;
+
   uint32_t update_flags;
 };
 
@@ -239,6 +239,39 @@ LightTreeEmitter::LightTreeEmitter(Scene *scene,
   }
 }
 
+using LightTreeBuckets = std::array<std::array<LightTreeBucket, LightTreeBucket::num_buckets>, 3>;
+
+/* Accumulate the emitters between start and end into a value. Large ranges are split into chunks
+ * that are accumulated in parallel and merged in order, so the result does not depend on the
+ * number of threads. */
+template<typename T, typename AccumulateFunc, typename MergeFunc>
+static T reduce_emitters(const int start,
+                         const int end,
+                         const int chunk_size,
+                         const T &init,
+                         const AccumulateFunc &accumulate,
+                         const MergeFunc &merge)
+{
+  T result = init;
+
+  const int num_chunks = divide_up(end - start, chunk_size);
+  if (num_chunks <= 1) {
+    accumulate(result, start, end);
+    return result;
+  }
+
+  vector<T> chunk_results(num_chunks, init);
+  parallel_for(0, num_chunks, [&](const int chunk) {
+    const int chunk_start = start + chunk * chunk_size;
+    accumulate(chunk_results[chunk], chunk_start, min(chunk_start + chunk_size, end));
+  });
+
+  for (const T &chunk_result : chunk_results) {
+    merge(result, chunk_result);
+  }
+  return result;
+}
+
 static void sort_leaf(const int start, const int end, LightTreeEmitter *emitters)
 {
   /* Sort primitive by light link mask so that specialized trees can use a subset of these. */
@@ -273,6 +306,97 @@ void LightTree::add_mesh(Scene *scene, Mesh *mesh, int object_id)
   }
 }
 
+/* Shift the emitter indices of the leaves of a subtree taken from the cache, and return the
+ * number of nodes in it. */
+static int offset_mesh_subtree(LightTreeNode *node, const int offset)
+{
+  node->light_link.shared_node_index = -1;
+
+  if (node->is_leaf()) {
+    node->get_leaf().first_emitter_index += offset;
+    return 1;
+  }
+
+  return 1 + offset_mesh_subtree(node->get_inner().children[LightTree::left].get(), offset) +
+         offset_mesh_subtree(node->get_inner().children[LightTree::right].get(), offset);
+}
+
+bool LightTree::reuse_mesh_subtree(LightTreeMeshCache &mesh_cache,
+                                   Object *object,
+                                   Mesh *mesh,
+                                   LightTreeEmitter &emitter)
+{
+  auto map_it = mesh_cache.subtrees.find(mesh);
+  if (map_it == mesh_cache.subtrees.end()) {
+    return false;
+  }
+
+  LightTreeMeshCache::Subtree &subtree = map_it->second;
+  if (mesh->need_update_light_tree || mesh->transform_applied ||
+      subtree.light_set_membership != object->get_light_set_membership())
+  {
+    return false;
+  }
+
+  /* The object of the triangle emitters is the first one using the mesh, which may have a
+   * different index now. */
+  const int offset = emitters_.size() - subtree.first_emitter_index;
+  for (LightTreeEmitter &triangle : subtree.emitters) {
+    triangle.object_id = emitter.object_id;
+    emitters_.push_back(std::move(triangle));
+  }
+
+  /* The root node was already created and counted. */
+  LightTreeNode *root = emitter.root.get();
+  root->measure = subtree.root->measure;
+  root->light_link = subtree.root->light_link;
+  root->type = subtree.root->type | LIGHT_TREE_INSTANCE;
+  root->variant_type = std::move(subtree.root->variant_type);
+  num_nodes += offset_mesh_subtree(root, offset) - 1;
+
+  mesh_cache.subtrees.erase(map_it);
+  return true;
+}
+
+void LightTree::update_mesh_cache(Scene *scene, LightTreeMeshCache &mesh_cache)
+{
+  mesh_cache.subtrees.clear();
+
+  if (progress_.get_cancel()) {
+    return;
+  }
+
+  /* Flattening the tree may have moved the subtree of a mesh from the node it was built for to
+   * the node of another object using the mesh, find the one that has it. */
+  for (LightTreeEmitter &emitter : emitters_) {
+    if (!emitter.is_mesh() ||
+        std::holds_alternative<LightTreeNode::Instance>(emitter.root->variant_type))
+    {
+      continue;
+    }
+
+    Mesh *mesh = static_cast<Mesh *>(scene->objects[emitter.object_id]->get_geometry());
+    if (mesh->transform_applied) {
+      continue;
+    }
+
+    const MeshSubtree &mesh_subtree = mesh_subtrees_.find(mesh)->second;
+    Object *object = scene->objects[mesh_subtree.object_id];
+
+    LightTreeMeshCache::Subtree &subtree = mesh_cache.subtrees[mesh];
+    subtree.root = make_unique<LightTreeNode>(mesh_subtree.measure, 0);
+    subtree.root->light_link = mesh_subtree.light_link;
+    subtree.root->type = emitter.root->type & ~LIGHT_TREE_INSTANCE;
+    subtree.root->variant_type = std::move(emitter.root->variant_type);
+    subtree.emitters.reserve(mesh_subtree.end - mesh_subtree.start);
+    std::move(emitters_.begin() + mesh_subtree.start,
+              emitters_.begin() + mesh_subtree.end,
+              std::back_inserter(subtree.emitters));
+    subtree.first_emitter_index = mesh_subtree.start;
+    subtree.light_set_membership = object->get_light_set_membership();
+  }
+}
+
 LightTree::LightTree(Scene *scene,
                      DeviceScene *dscene,
                      Progress &progress,
@@ -331,7 +455,9 @@ LightTree::LightTree(Scene *scene,
   }
 }
 
-LightTreeNode *LightTree::build(Scene *scene, DeviceScene *dscene)
+LightTreeNode *LightTree::build(Scene *scene,
+                                DeviceScene *dscene,
+                                LightTreeMeshCache *mesh_cache)
 {
   if (local_lights_.empty() && distant_lights_.empty() && mesh_lights_.empty()) {
     return nullptr;
@@ -342,7 +468,6 @@ LightTreeNode *LightTree::build(Scene *scene, DeviceScene *dscene)
   const int num_distant_lights = distant_lights_.size();
 
   /* Create a node for each mesh light, and keep track of unique mesh lights. */
-  std::unordered_map<Mesh *, std::tuple<LightTreeNode *, int, int>> unique_mesh;
   uint *object_offsets = dscene->object_lookup_offset.alloc(scene->objects.size());
   emitters_.reserve(num_triangles + num_local_lights + num_distant_lights);
   for (LightTreeEmitter &emitter : mesh_lights_) {
@@ -350,38 +475,52 @@ LightTreeNode *LightTree::build(Scene *scene, DeviceScene *dscene)
     Mesh *mesh = static_cast<Mesh *>(object->get_geometry());
     emitter.root = create_node(LightTreeMeasure::empty, 0);
 
-    auto map_it = unique_mesh.find(mesh);
-    if (map_it == unique_mesh.end()) {
+    auto map_it = mesh_subtrees_.find(mesh);
+    if (map_it == mesh_subtrees_.end()) {
       const int start = emitters_.size();
-      add_mesh(scene, mesh, emitter.object_id);
+      const bool reused = mesh_cache && reuse_mesh_subtree(*mesh_cache, object, mesh, emitter);
+      if (!reused) {
+        add_mesh(scene, mesh, emitter.object_id);
+      }
       const int end = emitters_.size();
 
-      unique_mesh[mesh] = std::make_tuple(emitter.root.get(), start, end);
+      MeshSubtree &subtree = mesh_subtrees_[mesh];
+      subtree.root = emitter.root.get();
+      subtree.start = start;
+      subtree.end = end;
+      subtree.object_id = emitter.object_id;
+      subtree.reused = reused;
       emitter.root->object_id = emitter.object_id;
+      num_reused_meshes += reused;
     }
     else {
-      emitter.root->make_instance(std::get<0>(map_it->second), emitter.object_id);
+      emitter.root->make_instance(map_it->second.root, emitter.object_id);
     }
     object_offsets[emitter.object_id] = offset_map_[mesh];
   }
 
   /* Build a subtree for each unique mesh light. */
-  parallel_for_each(unique_mesh, [this](auto &map_it) {
-    LightTreeNode *node = std::get<0>(map_it.second);
-    int start = std::get<1>(map_it.second);
-    int end = std::get<2>(map_it.second);
-    recursive_build(self, node, start, end, emitters_.data(), 0, 0);
-    node->type |= LIGHT_TREE_INSTANCE;
+  parallel_for_each(mesh_subtrees_, [this](auto &map_it) {
+    MeshSubtree &subtree = map_it.second;
+    if (!subtree.reused) {
+      recursive_build(self, subtree.root, subtree.start, subtree.end, emitters_.data(), 0, 0);
+      subtree.root->type |= LIGHT_TREE_INSTANCE;
+    }
   });
   task_pool.wait_work();
 
+  for (auto &map_it : mesh_subtrees_) {
+    MeshSubtree &subtree = map_it.second;
+    subtree.measure = subtree.root->measure;
+    subtree.light_link = subtree.root->light_link;
+  }
+
   /* Update measure. */
   parallel_for_each(mesh_lights_, [&](LightTreeEmitter &emitter) {
     Object *object = scene->objects[emitter.object_id];
     Mesh *mesh = static_cast<Mesh *>(object->get_geometry());
 
-    LightTreeNode *reference = std::get<0>(unique_mesh.find(mesh)->second);
-    emitter.measure = emitter.root->measure = reference->measure;
+    emitter.measure = emitter.root->measure = mesh_subtrees_.find(mesh)->second.measure;
 
     /* Transform measure. The measure is only directly transformable if the transformation has
      * uniform scaling, otherwise recount all the triangles in the mesh with transformation. */
@@ -530,39 +669,71 @@ bool LightTree::should_split(LightTreeEmitter *emitters,
 
   middle = (start + end) / 2;
 
-  BoundBox centroid_bbox = BoundBox::empty;
-  for (int i = start; i < end; i++) {
-    centroid_bbox.grow((emitters + i)->centroid);
-  }
+  /* Near the root of the tree the emitters are processed in chunks in parallel. */
+  const BoundBox centroid_bbox = reduce_emitters(
+      start,
+      end,
+      MIN_EMITTERS_PER_THREAD,
+      BoundBox(BoundBox::empty),
+      [emitters](BoundBox &bbox, const int chunk_start, const int chunk_end) {
+        for (int i = chunk_start; i < chunk_end; i++) {
+          bbox.grow(emitters[i].centroid);
+        }
+      },
+      [](BoundBox &bbox, const BoundBox &chunk_bbox) { bbox.grow(chunk_bbox); });
 
   const float3 extent = centroid_bbox.size();
   const float max_extent = max4(extent.x, extent.y, extent.z, 0.0f);
 
+  /* Fill in buckets with emitters, for all dimensions at once. If the centroid bounding box is 0
+   * along a given dimension and the node measure is already computed, skip it. */
+  const LightTreeBuckets buckets_per_dim = reduce_emitters(
+      start,
+      end,
+      MIN_EMITTERS_PER_THREAD,
+      LightTreeBuckets(),
+      [emitters, &centroid_bbox, &extent](
+          LightTreeBuckets &buckets, const int chunk_start, const int chunk_end) {
+        for (int i = chunk_start; i < chunk_end; i++) {
+          const LightTreeEmitter &emitter = emitters[i];
+          for (int dim = 0; dim < 3; dim++) {
+            if (extent[dim] == 0.0f) {
+              if (dim == 0) {
+                buckets[dim][0].add(emitter);
+              }
+              continue;
+            }
+
+            /* Place emitter into the appropriate bucket, where the centroid box is split into
+             * equal partitions. */
+            const float inv_extent = 1 / extent[dim];
+            int bucket_idx = LightTreeBucket::num_buckets *
+                             (emitter.centroid[dim] - centroid_bbox.min[dim]) * inv_extent;
+            bucket_idx = clamp(bucket_idx, 0, LightTreeBucket::num_buckets - 1);
+
+            buckets[dim][bucket_idx].add(emitter);
+          }
+        }
+      },
+      [](LightTreeBuckets &buckets, const LightTreeBuckets &chunk_buckets) {
+        for (int dim = 0; dim < 3; dim++) {
+          for (int i = 0; i < LightTreeBucket::num_buckets; i++) {
+            buckets[dim][i] = buckets[dim][i] + chunk_buckets[dim][i];
+          }
+        }
+      });
+
   /* Check each dimension to find the minimum splitting cost. */
   float total_cost = 0.0f;
   float min_cost = FLT_MAX;
   for (int dim = 0; dim < 3; dim++) {
-    /* If the centroid bounding box is 0 along a given dimension and the node measure is already
-     * computed, skip it. */
-    if (centroid_bbox.size()[dim] == 0.0f && dim != 0) {
+    if (extent[dim] == 0.0f && dim != 0) {
       continue;
     }
 
-    const float inv_extent = 1 / (centroid_bbox.size()[dim]);
-
-    /* Fill in buckets with emitters. */
-    std::array<LightTreeBucket, LightTreeBucket::num_buckets> buckets;
-    for (int i = start; i < end; i++) {
-      const LightTreeEmitter *emitter = emitters + i;
-
-      /* Place emitter into the appropriate bucket, where the centroid box is split into equal
-       * partitions. */
-      int bucket_idx = LightTreeBucket::num_buckets *
-                       (emitter->centroid[dim] - centroid_bbox.min[dim]) * inv_extent;
-      bucket_idx = clamp(bucket_idx, 0, LightTreeBucket::num_buckets - 1);
-
-      buckets[bucket_idx].add(*emitter);
-    }
+    const float inv_extent = 1 / extent[dim];
+    const std::array<LightTreeBucket, LightTreeBucket::num_buckets> &buckets =
+        buckets_per_dim[dim];
 
     /* Precompute the left bucket measure cumulatively. */
     std::array<LightTreeBucket, LightTreeBucket::num_buckets - 1> left_buckets;
@@ -577,12 +748,12 @@ bool LightTree::should_split(LightTreeEmitter *emitters,
       light_link = left_buckets.back().light_link + buckets.back().light_link;
 
       /* Degenerate case with co-located emitters. */
-      if (is_zero(centroid_bbox.size())) {
+      if (is_zero(extent)) {
         break;
       }
 
       /* If the centroid bounding box is 0 along a given dimension, skip it. */
-      if (centroid_bbox.size()[dim] == 0.0f) {
+      if (extent[dim] == 0.0f) {
         continue;
       }
 
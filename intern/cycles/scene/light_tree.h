@@ -370,6 +370,24 @@ struct LightTreeNode {
   }
 };
 
+/* Light Tree Mesh Cache
+ *
+ * Subtrees of emissive meshes kept from the previous light tree build. The subtree of a mesh is
+ * built in object space, so it remains valid when only the transforms of the objects using the
+ * mesh change, and can be reused until the mesh itself or the shaders are modified. */
+struct LightTreeMeshCache {
+  struct Subtree {
+    /* Root node with the untransformed measure, and the triangle emitters of its leaves, which
+     * started at `first_emitter_index` in the light tree they were built for. */
+    unique_ptr<LightTreeNode> root;
+    vector<LightTreeEmitter> emitters;
+    int first_emitter_index = 0;
+    uint64_t light_set_membership = 0;
+  };
+
+  std::unordered_map<const Mesh *, Subtree> subtrees;
+};
+
 /* Light BVH
  *
  * BVH-like data structure that keeps track of lights
@@ -386,6 +404,19 @@ class LightTree {
 
   std::unordered_map<Mesh *, int> offset_map_;
 
+  /* Subtree of each unique emissive mesh, with the range of its triangle emitters and the
+   * measure before transformation by any of the objects using it. */
+  struct MeshSubtree {
+    LightTreeNode *root;
+    int start;
+    int end;
+    int object_id;
+    bool reused;
+    LightTreeMeasure measure;
+    LightTreeLightLink light_link;
+  };
+  std::unordered_map<Mesh *, MeshSubtree> mesh_subtrees_;
+
   Progress &progress_;
 
   uint max_lights_in_leaf_;
@@ -393,6 +424,7 @@ class LightTree {
  public:
   std::atomic<int> num_nodes = 0;
   size_t num_triangles = 0;
+  size_t num_reused_meshes = 0;
 
   /* Bitmask of receiver light sets used. Default set is always used. */
   uint64_t light_link_receiver_used = 1;
@@ -406,8 +438,15 @@ class LightTree {
 
   LightTree(Scene *scene, DeviceScene *dscene, Progress &progress, uint max_lights_in_leaf);
 
-  /* Returns a pointer to the root node. */
-  LightTreeNode *build(Scene *scene, DeviceScene *dscene);
+  /* Returns a pointer to the root node. Subtrees of meshes are taken from the cache when still
+   * valid, instead of building them again. */
+  LightTreeNode *build(Scene *scene,
+                       DeviceScene *dscene,
+                       LightTreeMeshCache *mesh_cache = nullptr);
+
+  /* Move the subtrees of the meshes into the cache for the next build. Must be called after the
+   * tree was flattened, it can not be used anymore afterwards. */
+  void update_mesh_cache(Scene *scene, LightTreeMeshCache &mesh_cache);
 
   /* NOTE: Always use this function to create a new node so the number of nodes is in sync. */
   unique_ptr<LightTreeNode> create_node(const LightTreeMeasure &measure, const uint &bit_trial)
@@ -453,6 +492,12 @@ class LightTree {
 
   /* Add all the emissive triangles of a mesh to the light tree. */
   void add_mesh(Scene *scene, Mesh *mesh, int object_id);
+
+  /* Add the triangles and subtree of a mesh from the cache, if the mesh was not modified. */
+  bool reuse_mesh_subtree(LightTreeMeshCache &mesh_cache,
+                          Object *object,
+                          Mesh *mesh,
+                          LightTreeEmitter &emitter);
 };
 
 CCL_NAMESPACE_END
@@ -47,6 +47,7 @@ Scene::Scene(const SceneParams &params_, Device *device)
       dscene(device),
       params(params_),
       update_stats(NULL),
+      print_update_stats(false),
       kernels_loaded(false),
       /* TODO(sergey): Check if it's indeed optimal value for the split kernel. */
       max_closure_global(1)
@@ -180,16 +181,17 @@ void Scene::device_update(Device *device_, Progress &progress)
   }
 
   bool print_stats = need_data_update();
+  const bool print_update_report = print_stats && print_update_stats;
 
   if (update_stats) {
     update_stats->clear();
   }
 
-  scoped_callback_timer timer([this, print_stats](double time) {
+  scoped_callback_timer timer([this, print_update_report](double time) {
     if (update_stats) {
       update_stats->scene.times.add_entry({"device_update", time});
 
-      if (print_stats) {
+      if (print_update_report) {
         printf("Update statistics:\n%s\n", update_stats->full_report().c_str());
       }
     }
@@ -462,11 +464,12 @@ void Scene::collect_statistics(RenderStats *stats)
   image_manager->collect_statistics(stats);
 }
 
-void Scene::enable_update_stats()
+void Scene::enable_update_stats(const bool print)
 {
   if (!update_stats) {
     update_stats = new SceneUpdateStats();
   }
+  print_update_stats = print;
 }
 
 void Scene::update_kernel_features()
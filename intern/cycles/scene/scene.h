@@ -67,10 +67,19 @@ class SceneParams {
   bool use_bvh_spatial_split;
   bool use_bvh_compact_structure;
   bool use_bvh_unaligned_nodes;
+  /* Refit the BVH of deforming geometry instead of rebuilding it, for scenes that persist
+   * between updates. */
+  bool use_bvh_refit;
+  /* Hash geometry data to skip updating geometry that is synchronized again with identical
+   * data, for scenes that persist between frames. */
+  bool use_geometry_update_hash;
   int num_bvh_time_steps;
   int hair_subdivisions;
   CurveShapeType hair_shape;
   int texture_limit;
+  /* Memory limit in megabytes for tiled image files loaded on demand on the CPU,
+   * zero loads all images in full. */
+  int texture_cache_size;
 
   bool background;
 
@@ -82,10 +91,13 @@ class SceneParams {
     use_bvh_spatial_split = false;
     use_bvh_compact_structure = true;
     use_bvh_unaligned_nodes = true;
+    use_bvh_refit = false;
+    use_geometry_update_hash = false;
     num_bvh_time_steps = 0;
     hair_subdivisions = 3;
     hair_shape = CURVE_RIBBON;
     texture_limit = 0;
+    texture_cache_size = 0;
     background = true;
   }
 
@@ -96,9 +108,12 @@ class SceneParams {
              use_bvh_spatial_split == params.use_bvh_spatial_split &&
              use_bvh_compact_structure == params.use_bvh_compact_structure &&
              use_bvh_unaligned_nodes == params.use_bvh_unaligned_nodes &&
+             use_bvh_refit == params.use_bvh_refit &&
+             use_geometry_update_hash == params.use_geometry_update_hash &&
              num_bvh_time_steps == params.num_bvh_time_steps &&
              hair_subdivisions == params.hair_subdivisions && hair_shape == params.hair_shape &&
-             texture_limit == params.texture_limit);
+             texture_limit == params.texture_limit &&
+             texture_cache_size == params.texture_cache_size);
   }
 
   int curve_subdivisions()
@@ -165,6 +180,8 @@ class Scene : public NodeOwner {
 
   /* scene update statistics */
   SceneUpdateStats *update_stats;
+  /* print update statistics after every update of the scene data */
+  bool print_update_stats;
 
   Scene(const SceneParams &params, Device *device);
   ~Scene();
@@ -186,7 +203,7 @@ class Scene : public NodeOwner {
 
   void collect_statistics(RenderStats *stats);
 
-  void enable_update_stats();
+  void enable_update_stats(bool print = true);
 
   bool load_kernels(Progress &progress);
   bool update(Progress &progress);
@@ -780,6 +780,33 @@ void ShaderGraph::compute_displacement_hash()
   displacement_hash = md5.get_hex();
 }
 
+bool ShaderGraph::compute_hash(Scene *scene, MD5Hash &md5)
+{
+  /* Hash all nodes and links, to find graphs that compile to the same shader. Node ids are
+   * included since they determine the order in which nodes are compiled. Returns false if a
+   * node depends on runtime state that is not known before compilation. */
+  foreach (ShaderNode *node, nodes) {
+    md5.append((uint8_t *)&node->id, sizeof(node->id));
+    node->hash(md5);
+    foreach (ShaderInput *input, node->inputs) {
+      int link_id = (input->link) ? input->link->parent->id : -1;
+      md5.append((uint8_t *)&link_id, sizeof(link_id));
+      md5.append((input->link) ? input->link->name().c_str() : "");
+    }
+
+    if (node->special_type == SHADER_SPECIAL_TYPE_OSL) {
+      OSLNode *oslnode = static_cast<OSLNode *>(node);
+      md5.append(oslnode->bytecode_hash);
+    }
+
+    if (!node->runtime_hash(scene, this, md5)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 void ShaderGraph::clean(Scene *scene)
 {
   /* Graph simplification */
@@ -247,6 +247,14 @@ class ShaderNode : public Node {
    * is to be handled in the subclass.
    */
   virtual bool equals(const ShaderNode &other);
+
+  /* Hash runtime state that compilation depends on but which is not stored in sockets, like
+   * image slots. Nodes add their images to the scene here if needed, the same way compilation
+   * does. Returns false when this state is only known after the node was compiled. */
+  virtual bool runtime_hash(Scene * /*scene*/, ShaderGraph * /*graph*/, MD5Hash & /*md5*/)
+  {
+    return true;
+  }
 };
 
 /* Node definition utility macros */
@@ -314,6 +322,7 @@ class ShaderGraph : public NodeOwner {
 
   void remove_proxy_nodes();
   void compute_displacement_hash();
+  bool compute_hash(Scene *scene, MD5Hash &md5);
   void simplify(Scene *scene);
   void finalize(Scene *scene, bool do_bump = false, bool bump_in_object_space = false);
 
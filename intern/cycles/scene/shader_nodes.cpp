@@ -20,6 +20,7 @@
 #include "util/color.h"
 #include "util/foreach.h"
 #include "util/log.h"
+#include "util/md5.h"
 #include "util/transform.h"
 
 #include "kernel/tables.h"
@@ -206,6 +207,33 @@ void TextureMapping::compile(OSLCompiler &compiler)
   }
 }
 
+/* Image Slot Texture */
+
+static bool image_handle_hash(ImageHandle &handle, MD5Hash &md5)
+{
+  /* Sky and point density images are added to the image manager on compilation. */
+  if (handle.empty()) {
+    return false;
+  }
+
+  const int num_tiles = handle.num_tiles();
+  for (int i = 0; i < num_tiles; i++) {
+    const int slot = handle.svm_slot(i);
+    md5.append((uint8_t *)&slot, sizeof(slot));
+  }
+
+  const ImageMetaData metadata = handle.metadata();
+  md5.append((uint8_t *)&metadata.compress_as_srgb, sizeof(metadata.compress_as_srgb));
+  return true;
+}
+
+bool ImageSlotTextureNode::runtime_hash(Scene *scene, ShaderGraph *graph, MD5Hash &md5)
+{
+  /* Add the image now rather than on compilation, so its slot is known before compiling. */
+  ensure_image(scene, graph);
+  return image_handle_hash(handle, md5);
+}
+
 /* Image Texture */
 
 NODE_DEFINE(ImageTextureNode)
@@ -284,6 +312,15 @@ ImageParams ImageTextureNode::image_params() const
   return params;
 }
 
+void ImageTextureNode::ensure_image(Scene *scene, ShaderGraph *graph)
+{
+  if (handle.empty()) {
+    cull_tiles(scene, graph);
+    ImageManager *image_manager = scene->image_manager;
+    handle = image_manager->add_image(filename.string(), image_params(), tiles);
+  }
+}
+
 void ImageTextureNode::cull_tiles(Scene *scene, ShaderGraph *graph)
 {
   /* Box projection computes its own UVs that always lie in the
@@ -367,11 +404,7 @@ void ImageTextureNode::compile(SVMCompiler &compiler)
   ShaderOutput *color_out = output("Color");
   ShaderOutput *alpha_out = output("Alpha");
 
-  if (handle.empty()) {
-    cull_tiles(compiler.scene, compiler.current_graph);
-    ImageManager *image_manager = compiler.scene->image_manager;
-    handle = image_manager->add_image(filename.string(), image_params(), tiles);
-  }
+  ensure_image(compiler.scene, compiler.current_graph);
 
   /* All tiles have the same metadata. */
   const ImageMetaData metadata = handle.metadata();
@@ -552,6 +585,14 @@ ImageParams EnvironmentTextureNode::image_params() const
   return params;
 }
 
+void EnvironmentTextureNode::ensure_image(Scene *scene, ShaderGraph * /*graph*/)
+{
+  if (handle.empty()) {
+    ImageManager *image_manager = scene->image_manager;
+    handle = image_manager->add_image(filename.string(), image_params());
+  }
+}
+
 void EnvironmentTextureNode::attributes(Shader *shader, AttributeRequestSet *attributes)
 {
 #ifdef WITH_PTEX
@@ -571,10 +612,7 @@ void EnvironmentTextureNode::compile(SVMCompiler &compiler)
   ShaderOutput *color_out = output("Color");
   ShaderOutput *alpha_out = output("Alpha");
 
-  if (handle.empty()) {
-    ImageManager *image_manager = compiler.scene->image_manager;
-    handle = image_manager->add_image(filename.string(), image_params());
-  }
+  ensure_image(compiler.scene, compiler.current_graph);
 
   const ImageMetaData metadata = handle.metadata();
   const bool compress_as_srgb = metadata.compress_as_srgb;
@@ -880,6 +918,12 @@ NODE_DEFINE(SkyTextureNode)
 
 SkyTextureNode::SkyTextureNode() : TextureNode(get_node_type()) {}
 
+bool SkyTextureNode::runtime_hash(Scene * /*scene*/, ShaderGraph * /*graph*/, MD5Hash &md5)
+{
+  /* Only the Nishita sky model is precomputed into an image. */
+  return (sky_type != NODE_SKY_NISHITA) || image_handle_hash(handle, md5);
+}
+
 void SkyTextureNode::simplify_settings(Scene * /* scene */)
 {
   /* Patch sun position so users are able to animate the daylight cycle while keeping the shading
@@ -1459,6 +1503,15 @@ IESLightNode::~IESLightNode()
   }
 }
 
+bool IESLightNode::runtime_hash(Scene *scene, ShaderGraph * /*graph*/, MD5Hash &md5)
+{
+  light_manager = scene->light_manager;
+  get_slot();
+
+  md5.append((uint8_t *)&slot, sizeof(slot));
+  return true;
+}
+
 void IESLightNode::get_slot()
 {
   assert(light_manager);
@@ -1906,6 +1959,13 @@ void PointDensityTextureNode::attributes(Shader *shader, AttributeRequestSet *at
   ShaderNode::attributes(shader, attributes);
 }
 
+bool PointDensityTextureNode::runtime_hash(Scene * /*scene*/,
+                                           ShaderGraph * /*graph*/,
+                                           MD5Hash &md5)
+{
+  return image_handle_hash(handle, md5);
+}
+
 ImageParams PointDensityTextureNode::image_params() const
 {
   ImageParams params;
@@ -6446,6 +6506,14 @@ void OutputAOVNode::simplify_settings(Scene *scene)
   }
 }
 
+bool OutputAOVNode::runtime_hash(Scene * /*scene*/, ShaderGraph * /*graph*/, MD5Hash &md5)
+{
+  /* Pass offset as found in simplify_settings(). */
+  md5.append((uint8_t *)&offset, sizeof(offset));
+  md5.append((uint8_t *)&is_color, sizeof(is_color));
+  return true;
+}
+
 void OutputAOVNode::compile(SVMCompiler &compiler)
 {
   assert(offset >= 0);
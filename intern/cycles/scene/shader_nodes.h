@@ -83,6 +83,11 @@ class ImageSlotTextureNode : public TextureNode {
     return TextureNode::equals(other) && handle == other_node.handle;
   }
 
+  virtual bool runtime_hash(Scene *scene, ShaderGraph *graph, MD5Hash &md5);
+
+  /* Add the image to the image manager, if it wasn't yet. */
+  virtual void ensure_image(Scene *scene, ShaderGraph *graph) = 0;
+
   ImageHandle handle;
 };
 
@@ -103,6 +108,7 @@ class ImageTextureNode : public ImageSlotTextureNode {
   }
 
   ImageParams image_params() const;
+  void ensure_image(Scene *scene, ShaderGraph *graph);
 
   /* Parameters. */
   NODE_SOCKET_API(ustring, filename)
@@ -137,6 +143,7 @@ class EnvironmentTextureNode : public ImageSlotTextureNode {
   }
 
   ImageParams image_params() const;
+  void ensure_image(Scene *scene, ShaderGraph *graph);
 
   /* Parameters. */
   NODE_SOCKET_API(ustring, filename)
@@ -169,6 +176,7 @@ class SkyTextureNode : public TextureNode {
   ImageHandle handle;
 
   void simplify_settings(Scene *scene);
+  virtual bool runtime_hash(Scene *scene, ShaderGraph *graph, MD5Hash &md5);
 
   float get_sun_size()
   {
@@ -211,6 +219,8 @@ class OutputAOVNode : public ShaderNode {
     return false;
   }
 
+  virtual bool runtime_hash(Scene *scene, ShaderGraph *graph, MD5Hash &md5);
+
   int offset;
   bool is_color;
 };
@@ -378,6 +388,8 @@ class PointDensityTextureNode : public ShaderNode {
     const PointDensityTextureNode &other_node = (const PointDensityTextureNode &)other;
     return ShaderNode::equals(other) && handle == other_node.handle;
   }
+
+  virtual bool runtime_hash(Scene *scene, ShaderGraph *graph, MD5Hash &md5);
 };
 
 class IESLightNode : public TextureNode {
@@ -393,6 +405,8 @@ class IESLightNode : public TextureNode {
   NODE_SOCKET_API(float, strength)
   NODE_SOCKET_API(float3, vector)
 
+  virtual bool runtime_hash(Scene *scene, ShaderGraph *graph, MD5Hash &md5);
+
  private:
   LightManager *light_manager;
   int slot;
@@ -128,9 +128,9 @@ string NamedNestedSampleStats::full_report(int indent_level, uint64_t total_samp
   const string indent(indent_level * kIndentNumSpaces, ' ');
 
   const double sum_percent = 100 * ((double)sum_samples) / total_samples;
-  const double sum_seconds = sum_samples * 0.001;
+  const double sum_seconds = Profiler::samples_to_seconds(sum_samples);
   const double self_percent = 100 * ((double)self_samples) / total_samples;
-  const double self_seconds = self_samples * 0.001;
+  const double self_seconds = Profiler::samples_to_seconds(self_samples);
   string info = string_printf("%-32s: Total %3.2f%% (%.2fs), Self %3.2f%% (%.2fs)\n",
                               name.c_str(),
                               sum_percent,
@@ -188,7 +188,7 @@ string NamedSampleCountStats::full_report(int indent_level)
 
   string result = "";
   foreach (const NamedSampleCountPair &entry, sorted_entries) {
-    const double seconds = entry.samples * 0.001;
+    const double seconds = Profiler::samples_to_seconds(entry.samples);
     const double relative = ((double)entry.samples) / (entry.hits * avg_samples_per_hit);
 
     result += indent +
@@ -16,6 +16,7 @@
 
 #include "util/foreach.h"
 #include "util/log.h"
+#include "util/md5.h"
 #include "util/progress.h"
 #include "util/task.h"
 
@@ -27,12 +28,51 @@ SVMShaderManager::SVMShaderManager() {}
 
 SVMShaderManager::~SVMShaderManager() {}
 
-void SVMShaderManager::reset(Scene * /*scene*/) {}
+void SVMShaderManager::reset(Scene * /*scene*/)
+{
+  thread_scoped_lock lock(compiled_shaders_mutex);
+  compiled_shaders.clear();
+}
+
+/* Shader flags that are set by compilation, stored along with compiled shaders. */
+static bool Shader::*const compiled_shader_flags[] = {
+    &Shader::has_surface,
+    &Shader::has_surface_transparent,
+    &Shader::has_surface_raytrace,
+    &Shader::has_surface_bssrdf,
+    &Shader::has_bump,
+    &Shader::has_bssrdf_bump,
+    &Shader::has_volume,
+    &Shader::has_displacement,
+    &Shader::has_surface_spatial_varying,
+    &Shader::has_volume_spatial_varying,
+    &Shader::has_volume_attribute_dependency,
+};
+static const int num_compiled_shader_flags = sizeof(compiled_shader_flags) /
+                                              sizeof(*compiled_shader_flags);
+
+string SVMShaderManager::shader_hash(Scene *scene, Shader *shader, bool background)
+{
+  MD5Hash md5;
+  if (!shader->graph->compute_hash(scene, md5)) {
+    return "";
+  }
+
+  const int displacement_method = shader->get_displacement_method();
+  const bool is_referenced = shader->reference_count() != 0;
+  md5.append((uint8_t *)&displacement_method, sizeof(displacement_method));
+  md5.append((uint8_t *)&is_referenced, sizeof(is_referenced));
+  md5.append((uint8_t *)&background, sizeof(background));
+
+  return md5.get_hex();
+}
 
 void SVMShaderManager::device_update_shader(Scene *scene,
                                             Shader *shader,
                                             Progress *progress,
-                                            array<int4> *svm_nodes)
+                                            array<int4> *svm_nodes,
+                                            string *hash,
+                                            std::atomic_int *num_reused)
 {
   if (progress->get_cancel()) {
     return;
@@ -42,11 +82,71 @@ void SVMShaderManager::device_update_shader(Scene *scene,
   SVMCompiler::Summary summary;
   SVMCompiler compiler(scene);
   compiler.background = (shader == scene->background->get_shader(scene));
+
+  /* The graph is hashed in its optimized form, so that shaders which only differ in nodes
+   * that were removed or folded still compile to the same nodes. */
+  compiler.finalize(shader, &summary);
+  *hash = shader_hash(scene, shader, compiler.background);
+
+  if (!hash->empty()) {
+    thread_scoped_lock lock(compiled_shaders_mutex);
+    const auto it = compiled_shaders.find(*hash);
+    if (it != compiled_shaders.end()) {
+      const CompiledShader &compiled = it->second;
+
+      *svm_nodes = compiled.svm_nodes;
+      foreach (int type, compiled.node_types_used) {
+        compiler.svm_node_types_used[type] = true;
+      }
+      for (int i = 0; i < num_compiled_shader_flags; i++) {
+        shader->*compiled_shader_flags[i] = (compiled.flags & (1 << i)) != 0;
+      }
+      lock.unlock();
+
+      shader->estimate_emission();
+      (*num_reused)++;
+
+      VLOG_WORK << "Reused compiled nodes for shader " << shader->name << ".";
+      return;
+    }
+  }
+
+  /* Record node types used by this shader, to store them with the compiled nodes. */
+  std::atomic_int node_types_used[NODE_NUM] = {};
+  compiler.svm_node_types_used = node_types_used;
   compiler.compile(shader, *svm_nodes, 0, &summary);
 
   VLOG_WORK << "Compilation summary:\n"
             << "Shader name: " << shader->name << "\n"
             << summary.full_report();
+
+  /* Sky and point density images are only added on compilation, so the hash of shaders using
+   * them may only be known now. */
+  if (hash->empty()) {
+    *hash = shader_hash(scene, shader, compiler.background);
+  }
+
+  CompiledShader compiled;
+  compiled.svm_nodes = *svm_nodes;
+  compiled.flags = 0;
+  for (int i = 0; i < num_compiled_shader_flags; i++) {
+    if (shader->*compiled_shader_flags[i]) {
+      compiled.flags |= (1 << i);
+    }
+  }
+
+  std::atomic_int *scene_node_types_used = (std::atomic_int *)&scene->dscene.data.svm_usage;
+  for (int type = 0; type < NODE_NUM; type++) {
+    if (node_types_used[type]) {
+      scene_node_types_used[type] = true;
+      compiled.node_types_used.push_back(type);
+    }
+  }
+
+  if (!hash->empty()) {
+    thread_scoped_lock lock(compiled_shaders_mutex);
+    compiled_shaders[*hash] = compiled;
+  }
 }
 
 void SVMShaderManager::device_update_specific(Device *device,
@@ -76,16 +176,36 @@ void SVMShaderManager::device_update_specific(Device *device,
   /* Build all shaders. */
   TaskPool task_pool;
   vector<array<int4>> shader_svm_nodes(num_shaders);
+  vector<string> shader_hashes(num_shaders);
+  std::atomic_int num_reused = 0;
   for (int i = 0; i < num_shaders; i++) {
     task_pool.push(function_bind(&SVMShaderManager::device_update_shader,
                                  this,
                                  scene,
                                  scene->shaders[i],
                                  &progress,
-                                 &shader_svm_nodes[i]));
+                                 &shader_svm_nodes[i],
+                                 &shader_hashes[i],
+                                 &num_reused));
   }
   task_pool.wait_work();
 
+  /* Forget compiled shaders that are no longer used by any shader. */
+  {
+    const set<string> used_hashes(shader_hashes.begin(), shader_hashes.end());
+    for (auto it = compiled_shaders.begin(); it != compiled_shaders.end();) {
+      if (used_hashes.find(it->first) == used_hashes.end()) {
+        it = compiled_shaders.erase(it);
+      }
+      else {
+        it++;
+      }
+    }
+  }
+
+  VLOG_INFO << "Reused compiled nodes for " << num_reused << " of " << num_shaders
+            << " shaders.";
+
   if (progress.get_cancel()) {
     return;
   }
@@ -867,26 +987,35 @@ void SVMCompiler::compile_type(Shader *shader, ShaderGraph *graph, ShaderType ty
   }
 }
 
-void SVMCompiler::compile(Shader *shader, array<int4> &svm_nodes, int index, Summary *summary)
+bool SVMCompiler::finalize(Shader *shader, Summary *summary)
 {
-  svm_node_types_used[NODE_SHADER_JUMP] = true;
-  svm_nodes.push_back_slow(make_int4(NODE_SHADER_JUMP, 0, 0, 0));
-
   /* copy graph for shader with bump mapping */
   ShaderNode *output = shader->graph->output();
-  int start_num_svm_nodes = svm_nodes.size();
-
-  const double time_start = time_dt();
 
   bool has_bump = (shader->get_displacement_method() != DISPLACE_TRUE) &&
                   output->input("Surface")->link && output->input("Displacement")->link;
 
-  /* finalize */
-  {
+  /* The graph is finalized only once, possibly before compilation. */
+  if (!shader->graph->finalized) {
     scoped_timer timer((summary != NULL) ? &summary->time_finalize : NULL);
     shader->graph->finalize(scene, has_bump, shader->get_displacement_method() == DISPLACE_BOTH);
   }
 
+  return has_bump;
+}
+
+void SVMCompiler::compile(Shader *shader, array<int4> &svm_nodes, int index, Summary *summary)
+{
+  svm_node_types_used[NODE_SHADER_JUMP] = true;
+  svm_nodes.push_back_slow(make_int4(NODE_SHADER_JUMP, 0, 0, 0));
+
+  int start_num_svm_nodes = svm_nodes.size();
+
+  const double time_start = time_dt();
+
+  /* finalize */
+  const bool has_bump = finalize(shader, summary);
+
   current_shader = shader;
 
   shader->has_surface = false;
@@ -10,6 +10,7 @@
 #include "scene/shader_graph.h"
 
 #include "util/array.h"
+#include "util/map.h"
 #include "util/set.h"
 #include "util/string.h"
 #include "util/thread.h"
@@ -41,10 +42,24 @@ class SVMShaderManager : public ShaderManager {
   void device_free(Device *device, DeviceScene *dscene, Scene *scene) override;
 
  protected:
+  /* Compiled shader, reused for shaders with an identical graph. */
+  struct CompiledShader {
+    array<int4> svm_nodes;
+    vector<int> node_types_used;
+    uint flags;
+  };
+
   void device_update_shader(Scene *scene,
                             Shader *shader,
                             Progress *progress,
-                            array<int4> *svm_nodes);
+                            array<int4> *svm_nodes,
+                            string *hash,
+                            std::atomic_int *num_reused);
+
+  string shader_hash(Scene *scene, Shader *shader, bool background);
+
+  thread_mutex compiled_shaders_mutex;
+  unordered_map<string, CompiledShader> compiled_shaders;
 };
 
 /* Graph Compiler */
@@ -83,6 +98,7 @@ class SVMCompiler {
   };
 
   SVMCompiler(Scene *scene);
+  bool finalize(Shader *shader, Summary *summary = NULL);
   void compile(Shader *shader, array<int4> &svm_nodes, int index, Summary *summary = NULL);
 
   int stack_assign(ShaderOutput *output);
@@ -121,6 +137,9 @@ class SVMCompiler {
   ShaderGraph *current_graph;
   bool background;
 
+  /* Flags of node types used by the kernel, points to the scene kernel data by default. */
+  std::atomic_int *svm_node_types_used;
+
  protected:
   /* stack */
   struct Stack {
@@ -220,7 +239,6 @@ class SVMCompiler {
   /* compile */
   void compile_type(Shader *shader, ShaderGraph *graph, ShaderType type);
 
-  std::atomic_int *svm_node_types_used;
   array<int4> current_svm_nodes;
   ShaderType current_type;
   Shader *current_shader;
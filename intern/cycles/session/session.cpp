@@ -323,6 +323,7 @@ RenderWork Session::run_update_for_next_iteration()
       /* After reset make sure the tile manager is at the first big tile. */
       have_tiles = tile_manager_.next();
       switched_to_new_tile = true;
+      update_frame_tile_time_limit();
     }
   }
 
@@ -356,7 +357,7 @@ RenderWork Session::run_update_for_next_iteration()
 
   render_scheduler_.set_num_samples(params.samples);
   render_scheduler_.set_start_sample(params.sample_offset);
-  render_scheduler_.set_time_limit(params.time_limit);
+  render_scheduler_.set_time_limit(get_tile_time_limit());
 
   while (have_tiles) {
     render_work = render_scheduler_.get_render_work();
@@ -370,6 +371,8 @@ RenderWork Session::run_update_for_next_iteration()
     if (have_tiles) {
       render_scheduler_.reset_for_next_tile();
       switched_to_new_tile = true;
+      update_frame_tile_time_limit();
+      render_scheduler_.set_time_limit(get_tile_time_limit());
     }
   }
 
@@ -515,6 +518,48 @@ int2 Session::get_effective_tile_size() const
   return make_int2(tile_size, tile_size);
 }
 
+double Session::get_tile_time_limit() const
+{
+  if (params.frame_time_limit == 0.0) {
+    return params.time_limit;
+  }
+
+  if (params.time_limit == 0.0) {
+    return frame_tile_time_limit_;
+  }
+  return min(params.time_limit, frame_tile_time_limit_);
+}
+
+double Session::get_total_time_limit() const
+{
+  const double time_limit = params.time_limit * ((double)tile_manager_.get_num_tiles());
+  if (params.frame_time_limit == 0.0) {
+    return time_limit;
+  }
+  if (time_limit == 0.0) {
+    return params.frame_time_limit;
+  }
+  return min(time_limit, params.frame_time_limit);
+}
+
+void Session::update_frame_tile_time_limit()
+{
+  if (params.frame_time_limit == 0.0) {
+    return;
+  }
+
+  /* Divide the time which is left over the remaining tiles, so that time not used by previous
+   * tiles goes to the following ones. */
+  double total_time, render_time;
+  progress.get_time(total_time, render_time);
+
+  const double remaining_time = params.frame_time_limit - render_time;
+  const int num_remaining_tiles = max(tile_manager_.get_num_remaining_tiles(), 1);
+
+  /* Keep a small share when the budget is used up, a limit of zero means no limit. */
+  frame_tile_time_limit_ = max(remaining_time / num_remaining_tiles, 1e-3);
+}
+
 void Session::do_delayed_reset()
 {
   if (!delayed_reset_.do_reset) {
@@ -561,7 +606,7 @@ void Session::do_delayed_reset()
   if (!params.background) {
     progress.set_start_time();
   }
-  const double time_limit = params.time_limit * ((double)tile_manager_.get_num_tiles());
+  const double time_limit = get_total_time_limit();
   progress.set_render_start_time();
   progress.set_time_limit(time_limit);
 }
@@ -658,8 +703,7 @@ double Session::get_estimated_remaining_time() const
   progress.get_time(total_time, render_time);
   double remaining = (1.0 - (double)completed) * (render_time / (double)completed);
 
-  const double time_limit = render_scheduler_.get_time_limit() *
-                            ((double)tile_manager_.get_num_tiles());
+  const double time_limit = get_total_time_limit();
   if (time_limit != 0.0) {
     remaining = min(remaining, max(time_limit - render_time, 0.0));
   }
@@ -667,6 +711,12 @@ double Session::get_estimated_remaining_time() const
   return remaining;
 }
 
+void Session::get_render_time_estimate(double &render_time, double &converge_time) const
+{
+  render_time = render_scheduler_.get_render_time();
+  converge_time = render_scheduler_.get_converge_time_estimate();
+}
+
 void Session::wait()
 {
   /* Wait until session thread either is waiting or ending. */
@@ -767,7 +817,7 @@ void Session::collect_statistics(RenderStats *render_stats)
 
 void Session::process_full_buffer_from_disk(string_view filename)
 {
-  path_trace_->process_full_buffer_from_disk(filename);
+  path_trace_->process_full_buffer_from_disk(filename, params.use_tile_streaming);
 }
 
 CCL_NAMESPACE_END
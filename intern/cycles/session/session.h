@@ -53,11 +53,17 @@ class SessionParams {
   /* Limit in seconds for how long path tracing is allowed to happen.
    * Zero means no limit is applied. */
   double time_limit;
+  /* Limit in seconds for the whole frame, divided over the tiles as they are started. Applies in
+   * addition to the time limit of every tile, zero means no limit is applied. */
+  double frame_time_limit;
 
   bool use_profiling;
 
   bool use_auto_tile;
   int tile_size;
+  /* Process the rendered tiles one by one after rendering, without holding the full frame render
+   * buffer in memory. */
+  bool use_tile_streaming;
 
   bool use_resolution_divider;
 
@@ -77,11 +83,13 @@ class SessionParams {
     pixel_size = 1;
     threads = 0;
     time_limit = 0.0;
+    frame_time_limit = 0.0;
 
     use_profiling = false;
 
     use_auto_tile = true;
     tile_size = 2048;
+    use_tile_streaming = false;
 
     use_resolution_divider = true;
 
@@ -146,6 +154,10 @@ class Session {
 
   double get_estimated_remaining_time() const;
 
+  /* Path tracing time of the last render, and the time it is estimated to need for all pixels
+   * to converge. Used to distribute a time budget over the frames of a sequence. */
+  void get_render_time_estimate(double &render_time, double &converge_time) const;
+
   void device_free();
 
   /* Returns the rendering progress or 0 if no progress can be determined
@@ -159,7 +171,7 @@ class Session {
    */
 
   /* Read given full-frame file from disk, perform needed processing and write it to the software
-   * via the write callback. */
+   * via the write callback. Done tile by tile when tile streaming is used. */
   void process_full_buffer_from_disk(string_view filename);
 
  protected:
@@ -208,6 +220,15 @@ class Session {
 
   int2 get_effective_tile_size() const;
 
+  /* Time limit for path tracing of a single tile. */
+  double get_tile_time_limit() const;
+
+  /* Time limit for path tracing of all tiles. */
+  double get_total_time_limit() const;
+
+  /* Give the tile which was just started its share of the frame time limit. */
+  void update_frame_tile_time_limit();
+
   /* Session thread that performs rendering tasks decoupled from the thread
    * controlling the sessions. The thread is created and destroyed along with
    * the session. */
@@ -231,6 +252,9 @@ class Session {
   TileManager tile_manager_;
   BufferParams buffer_params_;
 
+  /* Share of the frame time limit of the current tile. */
+  double frame_tile_time_limit_ = 0.0;
+
   /* Render scheduler is used to get work to be rendered with the current big tile. */
   RenderScheduler render_scheduler_;
 
@@ -32,6 +32,8 @@ static const char *ATTR_PASSES_COUNT = "cycles.passes.count";
 static const char *ATTR_PASS_SOCKET_PREFIX_FORMAT = "cycles.passes.%d.";
 static const char *ATTR_BUFFER_SOCKET_PREFIX = "cycles.buffer.";
 static const char *ATTR_DENOISE_SOCKET_PREFIX = "cycles.denoise.";
+static const char *ATTR_TILE_WIDTH = "cycles.tile.width";
+static const char *ATTR_TILE_HEIGHT = "cycles.tile.height";
 
 /* Global counter of ToleManager object instances. */
 static std::atomic<uint64_t> g_instance_index = 0;
@@ -367,6 +369,9 @@ void TileManager::update(const BufferParams &params, const Scene *scene)
     node_to_image_spec_atttributes(
         &write_state_.image_spec, &denoise_params, ATTR_DENOISE_SOCKET_PREFIX);
 
+    write_state_.image_spec.attribute(ATTR_TILE_WIDTH, tile_size_.x);
+    write_state_.image_spec.attribute(ATTR_TILE_HEIGHT, tile_size_.y);
+
     /* Not adaptive sampling overscan yet for baking, would need overscan also
      * for buffers read from the output driver. */
     if (adaptive_sampling.use && !scene->bake_manager->get_baking()) {
@@ -406,33 +411,54 @@ bool TileManager::next()
 }
 
 Tile TileManager::get_tile_for_index(int index) const
+{
+  return get_tile_for_index(
+      make_int2(buffer_params_.width, buffer_params_.height), tile_size_, overscan_, index);
+}
+
+Tile TileManager::get_tile_for_index(const int2 image_size,
+                                     const int2 tile_size,
+                                     const int overscan,
+                                     const int index)
 {
   /* TODO(sergey): Consider using hilbert spiral, or. maybe, even configurable. Not sure this
    * brings a lot of value since this is only applicable to BIG tiles. */
 
-  const int tile_index_y = index / tile_state_.num_tiles_x;
-  const int tile_index_x = index - tile_index_y * tile_state_.num_tiles_x;
+  const int num_tiles_x = divide_up(image_size.x, tile_size.x);
+
+  const int tile_index_y = index / num_tiles_x;
+  const int tile_index_x = index - tile_index_y * num_tiles_x;
 
-  const int tile_window_x = tile_index_x * tile_size_.x;
-  const int tile_window_y = tile_index_y * tile_size_.y;
+  const int tile_window_x = tile_index_x * tile_size.x;
+  const int tile_window_y = tile_index_y * tile_size.y;
 
   Tile tile;
 
-  tile.x = max(0, tile_window_x - overscan_);
-  tile.y = max(0, tile_window_y - overscan_);
+  tile.x = max(0, tile_window_x - overscan);
+  tile.y = max(0, tile_window_y - overscan);
 
   tile.window_x = tile_window_x - tile.x;
   tile.window_y = tile_window_y - tile.y;
-  tile.window_width = min(tile_size_.x, buffer_params_.width - tile_window_x);
-  tile.window_height = min(tile_size_.y, buffer_params_.height - tile_window_y);
+  tile.window_width = min(tile_size.x, image_size.x - tile_window_x);
+  tile.window_height = min(tile_size.y, image_size.y - tile_window_y);
 
-  tile.width = min(buffer_params_.width - tile.x, tile.window_x + tile.window_width + overscan_);
-  tile.height = min(buffer_params_.height - tile.y,
-                    tile.window_y + tile.window_height + overscan_);
+  tile.width = min(image_size.x - tile.x, tile.window_x + tile.window_width + overscan);
+  tile.height = min(image_size.y - tile.y, tile.window_y + tile.window_height + overscan);
 
   return tile;
 }
 
+int4 TileManager::get_image_tiles_region(const Tile &tile,
+                                         const int2 image_size,
+                                         const int2 image_tile_size)
+{
+  return make_int4(
+      tile.x - tile.x % image_tile_size.x,
+      tile.y - tile.y % image_tile_size.y,
+      min(int(align_up(tile.x + tile.width, image_tile_size.x)), image_size.x),
+      min(int(align_up(tile.y + tile.height, image_tile_size.y)), image_size.y));
+}
+
 const Tile &TileManager::get_current_tile() const
 {
   return tile_state_.current_tile;
@@ -630,6 +656,36 @@ bool TileManager::read_full_buffer_from_disk(const string_view filename,
                                              RenderBuffers *buffers,
                                              DenoiseParams *denoise_params)
 {
+  BufferParams buffer_params;
+  int2 tile_size;
+  if (!open_full_buffer_from_disk(filename, &buffer_params, denoise_params, &tile_size)) {
+    return false;
+  }
+  buffers->reset(buffer_params);
+
+  unique_ptr<ImageInput> in = std::move(read_state_.tile_in);
+
+  const int num_channels = in->spec().nchannels;
+  if (!in->read_image(0, 0, 0, num_channels, TypeDesc::FLOAT, buffers->buffer.data())) {
+    LOG(ERROR) << "Error reading pixels from the tile file " << in->geterror();
+    return false;
+  }
+
+  if (!in->close()) {
+    LOG(ERROR) << "Error closing tile file " << in->geterror();
+    return false;
+  }
+
+  return true;
+}
+
+bool TileManager::open_full_buffer_from_disk(const string_view filename,
+                                             BufferParams *buffer_params,
+                                             DenoiseParams *denoise_params,
+                                             int2 *tile_size)
+{
+  close_full_buffer_from_disk();
+
   unique_ptr<ImageInput> in(ImageInput::open(filename));
   if (!in) {
     LOG(ERROR) << "Error opening tile file " << filename;
@@ -638,28 +694,111 @@ bool TileManager::read_full_buffer_from_disk(const string_view filename,
 
   const ImageSpec &image_spec = in->spec();
 
-  BufferParams buffer_params;
-  if (!buffer_params_from_image_spec_atttributes(&buffer_params, image_spec)) {
+  *buffer_params = BufferParams();
+  if (!buffer_params_from_image_spec_atttributes(buffer_params, image_spec)) {
     return false;
   }
-  buffers->reset(buffer_params);
 
   if (!node_from_image_spec_atttributes(denoise_params, image_spec, ATTR_DENOISE_SOCKET_PREFIX)) {
     return false;
   }
 
-  const int num_channels = in->spec().nchannels;
-  if (!in->read_image(0, 0, 0, num_channels, TypeDesc::FLOAT, buffers->buffer.data())) {
-    LOG(ERROR) << "Error reading pixels from the tile file " << in->geterror();
+  /* Files written before the tile size was stored are read as a single tile. */
+  tile_size->x = image_spec.get_int_attribute(ATTR_TILE_WIDTH, buffer_params->width);
+  tile_size->y = image_spec.get_int_attribute(ATTR_TILE_HEIGHT, buffer_params->height);
+
+  read_state_.tile_in = std::move(in);
+  read_state_.buffer_params = *buffer_params;
+
+  return true;
+}
+
+bool TileManager::read_tile_from_disk(RenderBuffers *tile_buffers)
+{
+  if (!read_state_.tile_in) {
+    LOG(ERROR) << "Tile file is not opened for reading.";
     return false;
   }
 
-  if (!in->close()) {
-    LOG(ERROR) << "Error closing tile file " << in->geterror();
+  const double time_start = time_dt();
+
+  ImageInput *in = read_state_.tile_in.get();
+  const ImageSpec &image_spec = in->spec();
+  const BufferParams &tile_params = tile_buffers->params;
+
+  DCHECK_EQ(tile_params.pass_stride, image_spec.nchannels);
+
+  if (image_spec.tile_width == 0 || image_spec.tile_height == 0) {
+    LOG(ERROR) << "Tile file is not tiled.";
     return false;
   }
 
+  Tile tile;
+  tile.x = tile_params.full_x - read_state_.buffer_params.full_x;
+  tile.y = tile_params.full_y - read_state_.buffer_params.full_y;
+  tile.width = tile_params.width;
+  tile.height = tile_params.height;
+
+  /* Read all image tiles covering the render buffer and copy the needed part of them. */
+  const int4 region = get_image_tiles_region(
+      tile,
+      make_int2(image_spec.width, image_spec.height),
+      make_int2(image_spec.tile_width, image_spec.tile_height));
+  const int x_begin = region.x;
+  const int y_begin = region.y;
+  const int x_end = region.z;
+  const int y_end = region.w;
+
+  const int64_t pass_stride = tile_params.pass_stride;
+  const int64_t region_row_stride = pass_stride * (x_end - x_begin);
+
+  vector<float> pixel_storage(region_row_stride * (y_end - y_begin));
+
+  if (!in->read_tiles(0,
+                      0,
+                      x_begin,
+                      x_end,
+                      y_begin,
+                      y_end,
+                      0,
+                      1,
+                      0,
+                      image_spec.nchannels,
+                      TypeDesc::FLOAT,
+                      pixel_storage.data()))
+  {
+    LOG(ERROR) << "Error reading tile from the tile file " << in->geterror();
+    return false;
+  }
+
+  const int64_t tile_row_stride = pass_stride * tile_params.width;
+  const float *region_pixels = pixel_storage.data() + (tile.y - y_begin) * region_row_stride +
+                               (tile.x - x_begin) * pass_stride;
+  float *tile_pixels = tile_buffers->buffer.data();
+
+  for (int i = 0; i < tile_params.height; ++i) {
+    memcpy(tile_pixels, region_pixels, sizeof(float) * tile_row_stride);
+    region_pixels += region_row_stride;
+    tile_pixels += tile_row_stride;
+  }
+
+  VLOG_WORK << "Tile at " << tile.x << ", " << tile.y << " read in " << time_dt() - time_start
+            << " seconds.";
+
   return true;
 }
 
+void TileManager::close_full_buffer_from_disk()
+{
+  if (!read_state_.tile_in) {
+    return;
+  }
+
+  if (!read_state_.tile_in->close()) {
+    LOG(ERROR) << "Error closing tile file " << read_state_.tile_in->geterror();
+  }
+
+  read_state_.tile_in = nullptr;
+}
+
 CCL_NAMESPACE_END
@@ -64,6 +64,12 @@ class TileManager {
     return tile_state_.num_tiles;
   }
 
+  /* Number of tiles which are not finished yet, including the current one. */
+  inline int get_num_remaining_tiles() const
+  {
+    return tile_state_.num_tiles - max(tile_state_.next_tile_index - 1, 0);
+  }
+
   inline bool has_multiple_tiles() const
   {
     return tile_state_.num_tiles > 1;
@@ -104,12 +110,50 @@ class TileManager {
                                   RenderBuffers *buffers,
                                   DenoiseParams *denoise_params);
 
+  /* Open tiles file on disk for reading the full frame render buffer tile by tile, without
+   * allocating memory for the full frame.
+   * The tile size is the size of tiles used for rendering the frame.
+   *
+   * Returns true on success. */
+  bool open_full_buffer_from_disk(string_view filename,
+                                  BufferParams *buffer_params,
+                                  DenoiseParams *denoise_params,
+                                  int2 *tile_size);
+
+  /* Read pixels of the given buffers from the opened tiles file. The buffers are to be configured
+   * for a region of the full frame render buffer.
+   *
+   * Returns true on success. */
+  bool read_tile_from_disk(RenderBuffers *tile_buffers);
+
+  /* Close tiles file opened by open_full_buffer_from_disk(). */
+  void close_full_buffer_from_disk();
+
+  /* Get tile configuration for its index in the grid of tiles of the given size covering an image
+   * of the given size. The tile is extended by the overscan where the image has pixels around it.
+   * The tile index must be within the number of tiles of the grid. */
+  static Tile get_tile_for_index(const int2 image_size,
+                                 const int2 tile_size,
+                                 const int overscan,
+                                 const int index);
+
+  /* Get the region of the image tiles of a file which cover the given tile, as reading from a
+   * tiled file has to be aligned to its image tiles. The region is given as
+   * (x_begin, y_begin, x_end, y_end), clipped to the image size. */
+  static int4 get_image_tiles_region(const Tile &tile,
+                                     const int2 image_size,
+                                     const int2 image_tile_size);
+
   /* Compute valid tile size compatible with image saving. */
   int compute_render_tile_size(const int suggested_tile_size) const;
 
   /* Tile size in the image file. */
   static const int IMAGE_TILE_SIZE = 128;
 
+  /* Number of extra pixels around a tile which are denoised with it when the full frame render
+   * buffer is processed tile by tile. Avoids visible seams between the denoised tiles. */
+  static const int DENOISE_TILE_OVERLAP = 64;
+
   /* Maximum supported tile size.
    * Needs to be safe from allocation on a GPU point of view: the display driver needs to be able
    * to allocate texture with the side size of this value.
@@ -173,6 +217,14 @@ class TileManager {
 
     int num_tiles_written = 0;
   } write_state_;
+
+  /* State of reading full frame render buffer from a file on disk tile by tile. */
+  struct {
+    unique_ptr<ImageInput> tile_in;
+
+    /* Parameters of the full frame render buffer stored in the file. */
+    BufferParams buffer_params;
+  } read_state_;
 };
 
 CCL_NAMESPACE_END
@@ -0,0 +1,105 @@
+/* SPDX-FileCopyrightText: 2011-2024 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "integrator/render_budget.h"
+
+CCL_NAMESPACE_BEGIN
+
+TEST(RenderTimeBudget, even_frames)
+{
+  RenderTimeBudget budget;
+  budget.set_sequence(100.0, 10, 1);
+
+  for (int frame = 1; frame <= 10; frame++) {
+    const double time_limit = budget.begin_render(frame);
+    EXPECT_NEAR(time_limit, 10.0, 1e-6);
+    budget.end_render(time_limit, 20.0);
+  }
+
+  EXPECT_NEAR(budget.get_remaining_time(), 0.0, 1e-6);
+}
+
+TEST(RenderTimeBudget, harder_frames_get_more_time)
+{
+  RenderTimeBudget budget;
+  budget.set_sequence(100.0, 10, 1);
+
+  /* First frame has no statistics yet and gets an even share. */
+  EXPECT_NEAR(budget.begin_render(1), 10.0, 1e-6);
+  budget.end_render(10.0, 10.0);
+
+  /* Second frame gets an even share, and turns out to be three times as hard. */
+  EXPECT_NEAR(budget.begin_render(2), 10.0, 1e-6);
+  budget.end_render(10.0, 30.0);
+
+  /* The third frame is expected to be as hard as the second one, and gets more than an even
+   * share of the remaining time. */
+  const double average_converge_time = 10.0 + RenderTimeBudget::AVERAGE_CONVERGE_TIME_SMOOTHING *
+                                                   (30.0 - 10.0);
+  const double weight = 30.0 / average_converge_time;
+  const double time_limit = budget.begin_render(3);
+  EXPECT_NEAR(time_limit, 80.0 * weight / (weight + 7.0), 1e-6);
+  EXPECT_GT(time_limit, 80.0 / 8.0);
+}
+
+TEST(RenderTimeBudget, separate_renders_per_frame)
+{
+  RenderTimeBudget budget;
+  budget.set_sequence(40.0, 2, 2);
+
+  /* First frame with an easy and a hard view layer. */
+  EXPECT_NEAR(budget.begin_render(1), 10.0, 1e-6);
+  budget.end_render(10.0, 5.0);
+  EXPECT_NEAR(budget.begin_render(1), 10.0, 1e-6);
+  budget.end_render(10.0, 15.0);
+
+  /* Second frame gives the easy view layer less than an even share, and the hard one gets all
+   * the remaining time as the last render. */
+  const double easy_time_limit = budget.begin_render(2);
+  EXPECT_LT(easy_time_limit, 10.0);
+  budget.end_render(easy_time_limit, 5.0);
+  EXPECT_NEAR(budget.begin_render(2), 20.0 - easy_time_limit, 1e-6);
+  budget.end_render(20.0 - easy_time_limit, 15.0);
+
+  EXPECT_NEAR(budget.get_remaining_time(), 0.0, 1e-6);
+}
+
+TEST(RenderTimeBudget, stays_within_budget)
+{
+  RenderTimeBudget budget;
+  budget.set_sequence(60.0, 30, 1);
+
+  /* Frames which get harder over time, and always use their full time limit. */
+  double total_time = 0.0;
+  for (int frame = 1; frame <= 30; frame++) {
+    const double time_limit = budget.begin_render(frame);
+    EXPECT_GT(time_limit, RenderTimeBudget::MIN_TIME_LIMIT);
+    budget.end_render(time_limit, frame);
+    total_time += time_limit;
+  }
+
+  EXPECT_NEAR(total_time, 60.0, 1e-6);
+}
+
+TEST(RenderTimeBudget, restart_sequence)
+{
+  RenderTimeBudget budget;
+  budget.set_sequence(20.0, 2, 1);
+
+  budget.begin_render(1);
+  budget.end_render(10.0, 10.0);
+
+  /* Rendering the first frame again starts the sequence over. */
+  EXPECT_NEAR(budget.begin_render(1), 10.0, 1e-6);
+  EXPECT_NEAR(budget.get_remaining_time(), 20.0, 1e-6);
+
+  /* Changing the sequence starts over as well. */
+  budget.end_render(10.0, 10.0);
+  budget.set_sequence(30.0, 2, 1);
+  EXPECT_NEAR(budget.begin_render(2), 15.0, 1e-6);
+}
+
+CCL_NAMESPACE_END
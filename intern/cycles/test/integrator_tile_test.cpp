@@ -5,6 +5,7 @@
 #include "testing/testing.h"
 
 #include "integrator/tile.h"
+#include "session/tile.h"
 #include "util/math.h"
 
 CCL_NAMESPACE_BEGIN
@@ -36,4 +37,101 @@ TEST(tile_calculate_best_size, Extreme)
             TileSize(1, 1, 1024));
 }
 
+TEST(TileManager, get_tile_for_index_overlap)
+{
+  const int2 image_size = make_int2(300, 200);
+  const int2 tile_size = make_int2(128, 128);
+  const int overlap = TileManager::DENOISE_TILE_OVERLAP;
+
+  /* First tile, only extended towards the image inside. */
+  const Tile first = TileManager::get_tile_for_index(image_size, tile_size, overlap, 0);
+  EXPECT_EQ(first.x, 0);
+  EXPECT_EQ(first.y, 0);
+  EXPECT_EQ(first.width, 192);
+  EXPECT_EQ(first.height, 192);
+  EXPECT_EQ(first.window_x, 0);
+  EXPECT_EQ(first.window_y, 0);
+  EXPECT_EQ(first.window_width, 128);
+  EXPECT_EQ(first.window_height, 128);
+
+  /* Last tile, partial and clipped to the image size. */
+  const Tile last = TileManager::get_tile_for_index(image_size, tile_size, overlap, 5);
+  EXPECT_EQ(last.x, 192);
+  EXPECT_EQ(last.y, 64);
+  EXPECT_EQ(last.width, 108);
+  EXPECT_EQ(last.height, 136);
+  EXPECT_EQ(last.window_x, 64);
+  EXPECT_EQ(last.window_y, 64);
+  EXPECT_EQ(last.window_width, 44);
+  EXPECT_EQ(last.window_height, 72);
+
+  /* Windows cover every pixel exactly once, and tiles extend them by the overlap where the image
+   * has pixels. */
+  const int num_tiles = divide_up(image_size.x, tile_size.x) *
+                        divide_up(image_size.y, tile_size.y);
+  vector<int> coverage(image_size.x * image_size.y, 0);
+  for (int i = 0; i < num_tiles; i++) {
+    const Tile tile = TileManager::get_tile_for_index(image_size, tile_size, overlap, i);
+    const int window_x = tile.x + tile.window_x;
+    const int window_y = tile.y + tile.window_y;
+
+    EXPECT_EQ(tile.x, max(window_x - overlap, 0));
+    EXPECT_EQ(tile.y, max(window_y - overlap, 0));
+    EXPECT_EQ(tile.x + tile.width, min(window_x + tile.window_width + overlap, image_size.x));
+    EXPECT_EQ(tile.y + tile.height, min(window_y + tile.window_height + overlap, image_size.y));
+
+    for (int y = window_y; y < window_y + tile.window_height; y++) {
+      for (int x = window_x; x < window_x + tile.window_width; x++) {
+        coverage[y * image_size.x + x]++;
+      }
+    }
+  }
+  for (const int count : coverage) {
+    EXPECT_EQ(count, 1);
+  }
+}
+
+namespace {
+
+void expect_region(
+    const int4 region, const int x_begin, const int y_begin, const int x_end, const int y_end)
+{
+  EXPECT_EQ(region.x, x_begin);
+  EXPECT_EQ(region.y, y_begin);
+  EXPECT_EQ(region.z, x_end);
+  EXPECT_EQ(region.w, y_end);
+}
+
+}  // namespace
+
+TEST(TileManager, get_image_tiles_region)
+{
+  const int2 image_size = make_int2(300, 200);
+  const int2 image_tile_size = make_int2(128, 64);
+
+  Tile tile;
+  tile.x = 130;
+  tile.y = 10;
+  tile.width = 20;
+  tile.height = 60;
+  expect_region(
+      TileManager::get_image_tiles_region(tile, image_size, image_tile_size), 128, 0, 256, 128);
+
+  /* Clipped to the image size. */
+  tile.x = 192;
+  tile.y = 64;
+  tile.width = 108;
+  tile.height = 136;
+  expect_region(
+      TileManager::get_image_tiles_region(tile, image_size, image_tile_size), 128, 64, 300, 200);
+
+  /* Aligned tile. */
+  tile.x = 128;
+  tile.y = 128;
+  tile.width = 128;
+  tile.height = 64;
+  expect_region(
+      TileManager::get_image_tiles_region(tile, image_size, image_tile_size), 128, 128, 256, 192);
+}
+
 CCL_NAMESPACE_END
@@ -0,0 +1,255 @@
+/* SPDX-FileCopyrightText: 2011-2024 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include <cstring>
+
+#include "util/math.h"
+#include "util/types.h"
+#include "util/vector.h"
+
+#include "kernel/device/cpu/compat.h"
+#include "kernel/device/cpu/globals.h"
+
+#include "kernel/types.h"
+
+#include "kernel/device/cpu/film_convert.h"
+
+/* Set to 1 to run the film conversion benchmark. It is disabled by default because it takes a
+ * while and only logs the timings. */
+#define DO_PERF_TESTS 0
+
+#if DO_PERF_TESTS
+#  include "util/log.h"
+#  include "util/time.h"
+#endif
+
+CCL_NAMESPACE_BEGIN
+
+namespace {
+
+/* Render buffer with a combined pass, a color pass with alpha, a color pass without alpha and a
+ * sample count pass, filled with pseudo-random values. */
+constexpr int BUFFER_COMBINED = 0;
+constexpr int BUFFER_FLOAT4 = 4;
+constexpr int BUFFER_FLOAT3 = 8;
+constexpr int BUFFER_SAMPLE_COUNT = 11;
+constexpr int BUFFER_PASS_STRIDE = 12;
+
+vector<float> make_render_buffer(const int num_pixels)
+{
+  vector<float> buffer(num_pixels * BUFFER_PASS_STRIDE);
+
+  uint seed = 1;
+  for (int i = 0; i < num_pixels; i++) {
+    float *pixel = buffer.data() + i * BUFFER_PASS_STRIDE;
+    for (int j = 0; j < BUFFER_SAMPLE_COUNT; j++) {
+      seed = seed * 1664525u + 1013904223u;
+      pixel[j] = (seed >> 8) * (8.0f / (1 << 24));
+    }
+    /* Include pixels which are shown as active by the overlay, when the 4th channel of the float4
+     * pass is used as adaptive sampling buffer. */
+    if (i % 5 == 0) {
+      pixel[BUFFER_FLOAT4 + 3] = 0.0f;
+    }
+    /* Include pixels without samples, which are handled differently by the combined pass. */
+    const uint sample_count = (i % 7 == 0) ? 0 : i % 16;
+    pixel[BUFFER_SAMPLE_COUNT] = __uint_as_float(sample_count);
+  }
+
+  return buffer;
+}
+
+KernelFilmConvert make_film_convert(const int pass_offset,
+                                    const int num_components,
+                                    const bool use_sample_count)
+{
+  KernelFilmConvert kfilm_convert = {};
+  kfilm_convert.pass_offset = pass_offset;
+  kfilm_convert.pass_stride = BUFFER_PASS_STRIDE;
+  kfilm_convert.pass_use_exposure = true;
+  kfilm_convert.pass_use_filter = true;
+  kfilm_convert.pass_divide = PASS_UNUSED;
+  kfilm_convert.pass_indirect = PASS_UNUSED;
+  kfilm_convert.pass_combined = BUFFER_COMBINED;
+  kfilm_convert.pass_sample_count = (use_sample_count) ? BUFFER_SAMPLE_COUNT : PASS_UNUSED;
+  kfilm_convert.pass_adaptive_aux_buffer = PASS_UNUSED;
+  kfilm_convert.pass_motion_weight = PASS_UNUSED;
+  kfilm_convert.pass_shadow_catcher = PASS_UNUSED;
+  kfilm_convert.pass_shadow_catcher_sample_count = PASS_UNUSED;
+  kfilm_convert.pass_shadow_catcher_matte = PASS_UNUSED;
+  kfilm_convert.pass_background = PASS_UNUSED;
+  kfilm_convert.exposure = 1.5f;
+  kfilm_convert.scale = 1.0f / 16.0f;
+  kfilm_convert.scale_exposure = kfilm_convert.scale * kfilm_convert.exposure;
+  kfilm_convert.num_components = num_components;
+  kfilm_convert.pixel_stride = num_components;
+  return kfilm_convert;
+}
+
+using PixelFunction = void (*)(const KernelFilmConvert *, const float *, float *);
+using RowFunction = void (*)(const KernelFilmConvert *,
+                             const float *,
+                             const FilmConvertRowOutput &,
+                             const int,
+                             const int);
+
+void convert_pixels(const KernelFilmConvert &kfilm_convert,
+                    const vector<float> &buffer,
+                    PixelFunction pixel_function,
+                    vector<float> &pixels)
+{
+  const int num_pixels = buffer.size() / BUFFER_PASS_STRIDE;
+  pixels.resize(num_pixels * kfilm_convert.num_components);
+  for (int i = 0; i < num_pixels; i++) {
+    pixel_function(&kfilm_convert,
+                   buffer.data() + i * BUFFER_PASS_STRIDE,
+                   pixels.data() + i * kfilm_convert.num_components);
+  }
+}
+
+void convert_row(const KernelFilmConvert &kfilm_convert,
+                 const vector<float> &buffer,
+                 RowFunction row_function,
+                 vector<float> &pixels)
+{
+  const int num_pixels = buffer.size() / BUFFER_PASS_STRIDE;
+  pixels.resize(num_pixels * kfilm_convert.num_components);
+  row_function(&kfilm_convert,
+               buffer.data(),
+               film_convert_row_output_float(
+                   &kfilm_convert, pixels.data(), kfilm_convert.num_components),
+               num_pixels,
+               BUFFER_PASS_STRIDE);
+}
+
+void expect_same_conversion(const KernelFilmConvert &kfilm_convert,
+                            PixelFunction pixel_function,
+                            RowFunction row_function,
+                            RowFunction row_function_half_rgba)
+{
+  const vector<float> buffer = make_render_buffer(1000);
+  const int num_pixels = buffer.size() / BUFFER_PASS_STRIDE;
+
+  vector<float> expected, result;
+  convert_pixels(kfilm_convert, buffer, pixel_function, expected);
+  convert_row(kfilm_convert, buffer, row_function, result);
+
+  ASSERT_EQ(expected.size(), result.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    EXPECT_EQ(expected[i], result[i]) << "component " << i;
+  }
+
+  /* Half RGBA for display, with the overlay of active pixels. */
+  KernelFilmConvert kfilm_convert_display = kfilm_convert;
+  kfilm_convert_display.show_active_pixels = true;
+  kfilm_convert_display.pass_adaptive_aux_buffer = BUFFER_FLOAT4;
+
+  vector<half4> result_half(num_pixels);
+  row_function_half_rgba(&kfilm_convert_display,
+                         buffer.data(),
+                         film_convert_row_output_half_rgba(&kfilm_convert_display,
+                                                           result_half.data()),
+                         num_pixels,
+                         BUFFER_PASS_STRIDE);
+
+  for (int i = 0; i < num_pixels; i++) {
+    float pixel_rgba[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+    const float *pixel_buffer = buffer.data() + i * BUFFER_PASS_STRIDE;
+    pixel_function(&kfilm_convert_display, pixel_buffer, pixel_rgba);
+    film_apply_pass_pixel_overlays_rgba(&kfilm_convert_display, pixel_buffer, pixel_rgba);
+    const half4 expected_half = float4_to_half4_display(
+        make_float4(pixel_rgba[0], pixel_rgba[1], pixel_rgba[2], pixel_rgba[3]));
+
+    EXPECT_EQ(memcmp(&expected_half, &result_half[i], sizeof(half4)), 0) << "pixel " << i;
+  }
+}
+
+}  // namespace
+
+TEST(KernelFilmConvert, combined)
+{
+  for (const bool use_sample_count : {false, true}) {
+    expect_same_conversion(make_film_convert(BUFFER_COMBINED, 4, use_sample_count),
+                           film_get_pass_pixel_combined,
+                           film_convert_row_combined<false>,
+                           film_convert_row_combined<true>);
+  }
+}
+
+TEST(KernelFilmConvert, float4)
+{
+  for (const bool use_sample_count : {false, true}) {
+    expect_same_conversion(make_film_convert(BUFFER_FLOAT4, 4, use_sample_count),
+                           film_get_pass_pixel_float4,
+                           film_convert_row_float4<false>,
+                           film_convert_row_float4<true>);
+  }
+}
+
+TEST(KernelFilmConvert, float3)
+{
+  for (const bool use_sample_count : {false, true}) {
+    for (const int num_components : {3, 4}) {
+      expect_same_conversion(make_film_convert(BUFFER_FLOAT3, num_components, use_sample_count),
+                             film_get_pass_pixel_float3,
+                             film_convert_row_float3<false>,
+                             film_convert_row_float3<true>);
+    }
+  }
+}
+
+#if DO_PERF_TESTS
+
+/* Compare the time it takes to convert a full HD frame with the per-pixel and the row functions.
+ * The timings are only logged, as they depend on the machine running the test. */
+TEST(KernelFilmConvert, benchmark)
+{
+  const vector<float> buffer = make_render_buffer(1920 * 1080);
+  const int num_iterations = 4;
+
+  struct Case {
+    const char *name;
+    KernelFilmConvert kfilm_convert;
+    PixelFunction pixel_function;
+    RowFunction row_function;
+  };
+  const Case cases[] = {
+      {"combined",
+       make_film_convert(BUFFER_COMBINED, 4, true),
+       film_get_pass_pixel_combined,
+       film_convert_row_combined<false>},
+      {"float4",
+       make_film_convert(BUFFER_FLOAT4, 4, false),
+       film_get_pass_pixel_float4,
+       film_convert_row_float4<false>},
+      {"float3",
+       make_film_convert(BUFFER_FLOAT3, 4, true),
+       film_get_pass_pixel_float3,
+       film_convert_row_float3<false>},
+  };
+
+  vector<float> pixels;
+  for (const Case &c : cases) {
+    double pixel_time = 0.0, row_time = 0.0;
+    for (int i = 0; i < num_iterations; i++) {
+      double start_time = time_dt();
+      convert_pixels(c.kfilm_convert, buffer, c.pixel_function, pixels);
+      pixel_time += time_dt() - start_time;
+
+      start_time = time_dt();
+      convert_row(c.kfilm_convert, buffer, c.row_function, pixels);
+      row_time += time_dt() - start_time;
+    }
+
+    VLOG_INFO << "Film convert " << c.name << ": " << pixel_time / num_iterations
+              << " seconds pixel by pixel, " << row_time / num_iterations
+              << " seconds row by row.";
+  }
+}
+
+#endif
+
+CCL_NAMESPACE_END
@@ -14,6 +14,7 @@
 
 #include "util/array.h"
 #include "util/log.h"
+#include "util/md5.h"
 #include "util/stats.h"
 #include "util/string.h"
 #include "util/vector.h"
@@ -1537,4 +1538,72 @@ TEST_F(RenderGraph, constant_fold_convert_color_float_color)
   graph.finalize(scene);
 }
 
+static void build_hash_test_graph(ShaderGraphBuilder &builder, float scale)
+{
+  builder.add_node(ShaderNodeBuilder<GeometryNode>(builder.graph(), "Geometry"))
+      .add_node(ShaderNodeBuilder<NoiseTextureNode>(builder.graph(), "Noise").set("Scale", scale))
+      .add_connection("Geometry::Parametric", "Noise::Vector")
+      .output_color("Noise::Color");
+}
+
+/*
+ * Tests:
+ *  - Finalized graphs with identical nodes and links have the same hash.
+ *  - Changing a node value changes the hash.
+ */
+TEST_F(RenderGraph, compute_hash)
+{
+  EXPECT_ANY_MESSAGE(log);
+
+  ShaderGraph graph_same, graph_different;
+  ShaderGraphBuilder builder_same(&graph_same), builder_different(&graph_different);
+
+  build_hash_test_graph(builder, 2.0f);
+  build_hash_test_graph(builder_same, 2.0f);
+  build_hash_test_graph(builder_different, 3.0f);
+
+  graph.finalize(scene);
+  graph_same.finalize(scene);
+  graph_different.finalize(scene);
+
+  MD5Hash md5, md5_same, md5_different;
+  EXPECT_TRUE(graph.compute_hash(scene, md5));
+  EXPECT_TRUE(graph_same.compute_hash(scene, md5_same));
+  EXPECT_TRUE(graph_different.compute_hash(scene, md5_different));
+
+  const string hash = md5.get_hex();
+  EXPECT_EQ(hash, md5_same.get_hex());
+  EXPECT_NE(hash, md5_different.get_hex());
+}
+
+/*
+ * Tests:
+ *  - Graphs with image textures can be hashed before compilation.
+ *  - Graphs using the same image have the same hash.
+ */
+TEST_F(RenderGraph, compute_hash_image_texture)
+{
+  EXPECT_ANY_MESSAGE(log);
+
+  ShaderGraph graph_same;
+  ShaderGraphBuilder builder_same(&graph_same);
+
+  builder
+      .add_node(ShaderNodeBuilder<ImageTextureNode>(graph, "Image")
+                    .set_param("filename", ustring("image.png")))
+      .output_color("Image::Color");
+  builder_same
+      .add_node(ShaderNodeBuilder<ImageTextureNode>(graph_same, "Image")
+                    .set_param("filename", ustring("image.png")))
+      .output_color("Image::Color");
+
+  graph.finalize(scene);
+  graph_same.finalize(scene);
+
+  MD5Hash md5, md5_same;
+  EXPECT_TRUE(graph.compute_hash(scene, md5));
+  EXPECT_TRUE(graph_same.compute_hash(scene, md5_same));
+  EXPECT_EQ(md5.get_hex(), md5_same.get_hex());
+}
+
 CCL_NAMESPACE_END
@@ -0,0 +1,67 @@
+/* SPDX-FileCopyrightText: 2011-2024 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "scene/mesh.h"
+
+CCL_NAMESPACE_BEGIN
+
+namespace {
+
+void make_quad(Mesh &mesh, const float z)
+{
+  mesh.clear();
+  mesh.reserve_mesh(4, 2);
+  mesh.add_vertex(make_float3(0.0f, 0.0f, z));
+  mesh.add_vertex(make_float3(1.0f, 0.0f, z));
+  mesh.add_vertex(make_float3(1.0f, 1.0f, z));
+  mesh.add_vertex(make_float3(0.0f, 1.0f, z));
+  mesh.add_triangle(0, 1, 2, 0, false);
+  mesh.add_triangle(0, 2, 3, 0, false);
+}
+
+}  // namespace
+
+TEST(GeometryUpdateHash, skip_identical_data)
+{
+  Mesh mesh;
+  make_quad(mesh, 0.0f);
+
+  /* Nothing is known about the device data before the first update. */
+  EXPECT_FALSE(mesh.device_update_hash_matches(mesh.content_hash()));
+  mesh.device_update_hash_commit();
+
+  /* Synchronized again with identical data. */
+  make_quad(mesh, 0.0f);
+  EXPECT_TRUE(mesh.device_update_hash_matches(mesh.content_hash()));
+
+  /* Synchronized again with different data. */
+  make_quad(mesh, 1.0f);
+  EXPECT_FALSE(mesh.device_update_hash_matches(mesh.content_hash()));
+  mesh.device_update_hash_commit();
+  EXPECT_TRUE(mesh.device_update_hash_matches(mesh.content_hash()));
+}
+
+TEST(GeometryUpdateHash, interrupted_update)
+{
+  Mesh mesh;
+  make_quad(mesh, 0.0f);
+
+  /* The hash is only stored once the device update finished. */
+  EXPECT_FALSE(mesh.device_update_hash_matches(mesh.content_hash()));
+  EXPECT_FALSE(mesh.device_update_hash_matches(mesh.content_hash()));
+  mesh.device_update_hash_commit();
+
+  /* An update with different data was canceled after it may have partially updated the device
+   * data, so it matches neither the old nor the new data. */
+  make_quad(mesh, 1.0f);
+  EXPECT_FALSE(mesh.device_update_hash_matches(mesh.content_hash()));
+  make_quad(mesh, 0.0f);
+  EXPECT_FALSE(mesh.device_update_hash_matches(mesh.content_hash()));
+  mesh.device_update_hash_commit();
+  EXPECT_TRUE(mesh.device_update_hash_matches(mesh.content_hash()));
+}
+
+CCL_NAMESPACE_END
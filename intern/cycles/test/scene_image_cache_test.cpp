@@ -0,0 +1,170 @@
+/* SPDX-FileCopyrightText: 2011-2024 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include <OpenImageIO/filesystem.h>
+
+#include "scene/colorspace.h"
+#include "scene/image_cache.h"
+
+#include "util/image.h"
+#include "util/math.h"
+#include "util/path.h"
+#include "util/string.h"
+#include "util/vector.h"
+
+#include "kernel/device/cpu/compat.h"
+#include "kernel/device/cpu/globals.h"
+
+#include "kernel/types.h"
+
+#include "kernel/device/cpu/image.h"
+
+CCL_NAMESPACE_BEGIN
+
+namespace {
+
+/* Image size which is not a multiple of the tile size, so that the last tiles are partial. */
+constexpr int IMAGE_WIDTH = 45;
+constexpr int IMAGE_HEIGHT = 37;
+constexpr int IMAGE_TILE_SIZE = 16;
+
+/* Pixel of the file, with rows counted from the top. Every pixel is different also in the first
+ * channel, so that a flipped or shifted image gives different lookups. */
+float4 file_pixel(const int x, const int y)
+{
+  return make_float4(
+      x * 0.1f + y * 0.013f, y * 0.05f, ((x * 7 + y * 3) % 11) * 0.1f, 0.25f + (x + y) % 4);
+}
+
+string write_tiled_file(const int channels)
+{
+  const string filepath = path_join(OIIO::Filesystem::temp_directory_path(),
+                                    string_printf("cycles_image_cache_test_%d.tif", channels));
+
+  unique_ptr<ImageOutput> out = ImageOutput::create(filepath);
+  if (!out) {
+    return "";
+  }
+
+  ImageSpec spec(IMAGE_WIDTH, IMAGE_HEIGHT, channels, TypeDesc::FLOAT);
+  spec.tile_width = IMAGE_TILE_SIZE;
+  spec.tile_height = IMAGE_TILE_SIZE;
+  if (!out->open(filepath, spec)) {
+    return "";
+  }
+
+  vector<float> pixels;
+  for (int y = 0; y < IMAGE_HEIGHT; y++) {
+    for (int x = 0; x < IMAGE_WIDTH; x++) {
+      const float4 pixel = file_pixel(x, y);
+      for (int c = 0; c < channels; c++) {
+        pixels.push_back(pixel[c]);
+      }
+    }
+  }
+  const bool ok = out->write_image(TypeDesc::FLOAT, pixels.data());
+  out->close();
+  return (ok) ? filepath : "";
+}
+
+/* Regular kernel image texture, with the pixels the image manager would load. */
+class KernelImage {
+ public:
+  explicit KernelImage(const int channels) : channels(channels)
+  {
+    /* Textures are stored bottom to top. */
+    for (int y = IMAGE_HEIGHT - 1; y >= 0; y--) {
+      for (int x = 0; x < IMAGE_WIDTH; x++) {
+        float4 pixel = file_pixel(x, y);
+        if (channels == 3) {
+          pixel.w = 1.0f;
+        }
+        pixels_rgba.push_back(pixel);
+        pixels_float.push_back(pixel.x);
+      }
+    }
+  }
+
+  float4 lookup(const InterpolationType interpolation,
+                const ExtensionType extension,
+                const float x,
+                const float y) const
+  {
+    TextureInfo info = {};
+    info.interpolation = interpolation;
+    info.extension = extension;
+    info.width = IMAGE_WIDTH;
+    info.height = IMAGE_HEIGHT;
+    info.depth = 1;
+
+    if (channels == 1) {
+      info.data = (uint64_t)pixels_float.data();
+      const float f = TextureInterpolator<float, float>::interp(info, x, y);
+      return make_float4(f, f, f, 1.0f);
+    }
+
+    info.data = (uint64_t)pixels_rgba.data();
+    return TextureInterpolator<float4>::interp(info, x, y);
+  }
+
+ private:
+  int channels;
+  vector<float4> pixels_rgba;
+  vector<float> pixels_float;
+};
+
+}  // namespace
+
+TEST(ImageTileCache, lookup)
+{
+  for (const int channels : {1, 3, 4}) {
+    const string filepath = write_tiled_file(channels);
+    ASSERT_FALSE(filepath.empty());
+    const KernelImage kernel_image(channels);
+
+    /* Keep only a few tiles in memory, so that tiles get evicted and loaded again. */
+    ImageTileCache cache;
+    cache.set_max_memory(3 * IMAGE_TILE_SIZE * IMAGE_TILE_SIZE * 4 * sizeof(float));
+
+    ImageMetaData metadata;
+    metadata.colorspace = u_colorspace_raw;
+    metadata.compress_as_srgb = false;
+
+    for (const InterpolationType interpolation :
+         {INTERPOLATION_CLOSEST, INTERPOLATION_LINEAR, INTERPOLATION_CUBIC})
+    {
+      for (const ExtensionType extension :
+           {EXTENSION_REPEAT, EXTENSION_EXTEND, EXTENSION_CLIP, EXTENSION_MIRROR})
+      {
+        ImageParams params;
+        params.interpolation = interpolation;
+        params.extension = extension;
+
+        unique_ptr<ImageTileCacheFile> file = cache.open_file(
+            filepath, metadata, params, false, 0);
+        ASSERT_TRUE(file);
+
+        /* Sample inside and outside of the image, between texel centers. */
+        for (float y = -0.3f; y < 1.3f; y += 0.0173f) {
+          for (float x = -0.3f; x < 1.3f; x += 0.0131f) {
+            const float4 expected = kernel_image.lookup(interpolation, extension, x, y);
+            const float4 result = file->lookup(x, y);
+            for (int c = 0; c < 4; c++) {
+              ASSERT_NEAR(expected[c], result[c], 1e-5f)
+                  << "channels " << channels << ", interpolation " << interpolation
+                  << ", extension " << extension << ", x " << x << ", y " << y;
+            }
+          }
+        }
+      }
+    }
+
+    EXPECT_GT(cache.get_num_tiles_loaded(), 0);
+    path_remove(filepath);
+  }
+}
+
+CCL_NAMESPACE_END
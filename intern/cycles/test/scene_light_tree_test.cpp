@@ -0,0 +1,195 @@
+/* SPDX-FileCopyrightText: 2011-2024 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "device/device.h"
+
+#include "scene/colorspace.h"
+#include "scene/light_tree.h"
+#include "scene/mesh.h"
+#include "scene/object.h"
+#include "scene/scene.h"
+#include "scene/shader.h"
+
+#include "util/progress.h"
+#include "util/stats.h"
+
+CCL_NAMESPACE_BEGIN
+
+namespace {
+
+/* Grid of `size` by `size` emissive quads, large enough to build a subtree with inner nodes. */
+void make_grid(Mesh *mesh, const int size)
+{
+  mesh->clear(true);
+  mesh->reserve_mesh((size + 1) * (size + 1), size * size * 2);
+  for (int y = 0; y <= size; y++) {
+    for (int x = 0; x <= size; x++) {
+      mesh->add_vertex(make_float3(x, y, 0.0f));
+    }
+  }
+  for (int y = 0; y < size; y++) {
+    for (int x = 0; x < size; x++) {
+      const int v = y * (size + 1) + x;
+      mesh->add_triangle(v, v + 1, v + size + 2, 0, false);
+      mesh->add_triangle(v, v + size + 2, v + size + 1, 0, false);
+    }
+  }
+  mesh->compute_bounds();
+}
+
+}  // namespace
+
+class LightTreeMeshCacheTest : public testing::Test {
+ protected:
+  Stats stats;
+  Profiler profiler;
+  DeviceInfo device_info;
+  Device *device_cpu;
+  SceneParams scene_params;
+  Scene *scene;
+  Mesh *mesh;
+
+  /* Result of a light tree build. */
+  struct BuildResult {
+    int num_nodes;
+    size_t num_emitters;
+    size_t num_reused_meshes;
+    float energy;
+  };
+
+  virtual void SetUp()
+  {
+    ColorSpaceManager::init_fallback_config();
+
+    device_cpu = Device::create(device_info, stats, profiler, true);
+    scene = new Scene(scene_params, device_cpu);
+
+    Shader *shader = scene->create_node<Shader>();
+    shader->emission_sampling = EMISSION_SAMPLING_FRONT_BACK;
+    shader->emission_estimate = one_float3();
+
+    array<Node *> used_shaders;
+    used_shaders.push_back_slow(shader);
+    mesh = scene->create_node<Mesh>();
+    mesh->set_used_shaders(used_shaders);
+    make_grid(mesh, 8);
+  }
+
+  virtual void TearDown()
+  {
+    delete scene;
+    delete device_cpu;
+  }
+
+  Object *add_object(const float3 location)
+  {
+    Object *object = scene->create_node<Object>();
+    object->set_geometry(mesh);
+    move_object(object, location);
+    return object;
+  }
+
+  void move_object(Object *object, const float3 location)
+  {
+    object->set_tfm(transform_translate(location));
+    object->compute_bounds(false);
+  }
+
+  /* Build the light tree like the light manager does, and keep the mesh subtrees in the cache.
+   * Pass no cache to build everything from scratch. */
+  BuildResult build(LightTreeMeshCache *mesh_cache)
+  {
+    Progress progress;
+    LightTree light_tree(scene, &scene->dscene, progress, 8);
+    LightTreeNode *root = light_tree.build(scene, &scene->dscene, mesh_cache);
+
+    BuildResult result;
+    result.num_nodes = light_tree.num_nodes;
+    result.num_emitters = light_tree.num_emitters();
+    result.num_reused_meshes = light_tree.num_reused_meshes;
+    result.energy = root->measure.energy;
+
+    if (mesh_cache) {
+      light_tree.update_mesh_cache(scene, *mesh_cache);
+    }
+    for (Geometry *geom : scene->geometry) {
+      geom->need_update_light_tree = false;
+    }
+    return result;
+  }
+};
+
+/*
+ * Tests:
+ *  - The subtree of a mesh is built on the first build and kept in the cache.
+ *  - Moving the object reuses the subtree, and gives the same tree as building it again.
+ */
+TEST_F(LightTreeMeshCacheTest, reuse_moved_mesh)
+{
+  Object *object = add_object(zero_float3());
+
+  LightTreeMeshCache mesh_cache;
+  const BuildResult first = build(&mesh_cache);
+  EXPECT_EQ(first.num_reused_meshes, 0);
+  EXPECT_EQ(mesh_cache.subtrees.size(), 1);
+
+  move_object(object, make_float3(10.0f, 0.0f, 0.0f));
+  const BuildResult reused = build(&mesh_cache);
+  EXPECT_EQ(reused.num_reused_meshes, 1);
+  EXPECT_EQ(mesh_cache.subtrees.size(), 1);
+
+  const BuildResult rebuilt = build(nullptr);
+  EXPECT_EQ(reused.num_nodes, rebuilt.num_nodes);
+  EXPECT_EQ(reused.num_emitters, rebuilt.num_emitters);
+  EXPECT_FLOAT_EQ(reused.energy, rebuilt.energy);
+}
+
+/*
+ * Tests:
+ *  - Changing the triangles of a mesh builds its subtree again.
+ */
+TEST_F(LightTreeMeshCacheTest, invalidate_on_topology_change)
+{
+  add_object(zero_float3());
+
+  LightTreeMeshCache mesh_cache;
+  const BuildResult first = build(&mesh_cache);
+
+  /* The geometry manager flags modified meshes. */
+  make_grid(mesh, 4);
+  mesh->need_update_light_tree = true;
+
+  const BuildResult changed = build(&mesh_cache);
+  EXPECT_EQ(changed.num_reused_meshes, 0);
+  EXPECT_LT(changed.num_emitters, first.num_emitters);
+  EXPECT_EQ(changed.num_emitters, build(nullptr).num_emitters);
+}
+
+/*
+ * Tests:
+ *  - Objects instancing the same mesh share a single cached subtree.
+ *  - The shared subtree is reused for all of them.
+ */
+TEST_F(LightTreeMeshCacheTest, shared_mesh_subtree)
+{
+  add_object(zero_float3());
+  Object *instance = add_object(make_float3(0.0f, 10.0f, 0.0f));
+
+  LightTreeMeshCache mesh_cache;
+  build(&mesh_cache);
+  EXPECT_EQ(mesh_cache.subtrees.size(), 1);
+
+  move_object(instance, make_float3(0.0f, 20.0f, 0.0f));
+  const BuildResult reused = build(&mesh_cache);
+  EXPECT_EQ(reused.num_reused_meshes, 1);
+  EXPECT_EQ(mesh_cache.subtrees.size(), 1);
+
+  const BuildResult rebuilt = build(nullptr);
+  EXPECT_EQ(reused.num_nodes, rebuilt.num_nodes);
+  EXPECT_FLOAT_EQ(reused.energy, rebuilt.energy);
+}
+
+CCL_NAMESPACE_END
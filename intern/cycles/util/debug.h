@@ -46,6 +46,10 @@ class DebugFlags {
      * CPUs and GPUs can be selected here instead.
      */
     BVHLayout bvh_layout = BVH_LAYOUT_AUTO;
+
+    /* Render blocks of pixels in wavefront mode, executing the same kernel for all paths of the
+     * block sorted by shader, instead of tracing each path to completion. */
+    bool use_wavefront = false;
   };
 
   /* Descriptor of CUDA feature-set to be used. */
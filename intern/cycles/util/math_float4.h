@@ -571,6 +571,18 @@ ccl_device_inline float4 load_float4(ccl_private const float *v)
 #  endif
 }
 
+ccl_device_inline void store_float4(const float4 a, ccl_private float *v)
+{
+#  ifdef __KERNEL_SSE__
+  _mm_storeu_ps(v, a);
+#  else
+  v[0] = a.x;
+  v[1] = a.y;
+  v[2] = a.z;
+  v[3] = a.w;
+#  endif
+}
+
 #endif /* !__KERNEL_GPU__ */
 
 ccl_device_inline float4 safe_divide(const float4 a, const float b)
@@ -43,12 +43,13 @@ void Profiler::run()
     }
     lock.unlock();
 
-    /* Relative waits always overshoot a bit, so just waiting 1ms every
+    /* Relative waits always overshoot a bit, so just waiting the sample interval every
      * time would cause the sampling to drift over time.
      * By keeping track of the absolute time, the wait times correct themselves -
      * if one wait overshoots a lot, the next one will be shorter to compensate. */
     updates++;
-    std::this_thread::sleep_until(start_time + updates * std::chrono::milliseconds(1));
+    std::this_thread::sleep_until(start_time +
+                                  updates * std::chrono::milliseconds(SAMPLE_INTERVAL_MS));
   }
 }
 
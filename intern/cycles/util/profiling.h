@@ -88,12 +88,22 @@ class Profiler {
 
   bool active() const;
 
+  /* Interval in milliseconds in which the state of the workers is sampled. */
+  static constexpr int SAMPLE_INTERVAL_MS = 1;
+
+  /* Approximate time in seconds spent in an event with the given number of samples, summed over
+   * all workers. */
+  static double samples_to_seconds(uint64_t samples)
+  {
+    return samples * (SAMPLE_INTERVAL_MS * 0.001);
+  }
+
  protected:
   void run();
 
   /* Tracks how often the worker was in each ProfilingEvent while sampling,
-   * so multiplying the values by the sample frequency (currently 1ms)
-   * gives the approximate time spent in each state. */
+   * so multiplying the values by the sample interval gives the approximate
+   * time spent in each state. */
   vector<uint64_t> event_samples;
   vector<uint64_t> shader_samples;
   vector<uint64_t> object_samples;
@@ -40,6 +40,8 @@ typedef enum ImageDataType {
   IMAGE_DATA_TYPE_NANOVDB_FLOAT3 = 9,
   IMAGE_DATA_TYPE_NANOVDB_FPN = 10,
   IMAGE_DATA_TYPE_NANOVDB_FP16 = 11,
+  /* CPU only, data points to a #TextureCacheImage that loads tiles on demand. */
+  IMAGE_DATA_TYPE_TILE_CACHE = 12,
 
   IMAGE_DATA_NUM_TYPES
 } ImageDataType;
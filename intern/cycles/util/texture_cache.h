@@ -0,0 +1,28 @@
+/* SPDX-FileCopyrightText: 2011-2024 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#ifndef __UTIL_TEXTURE_CACHE_H__
+#define __UTIL_TEXTURE_CACHE_H__
+
+#include "util/types.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Texture Cache Image
+ *
+ * Image whose pixels are not stored in a flat array, but loaded on demand from file by the
+ * CPU device. The image manager implements this, the kernel only calls through the virtual
+ * function so it does not depend on the scene and file loading code. */
+class TextureCacheImage {
+ public:
+  virtual ~TextureCacheImage() = default;
+
+  /* Interpolated lookup at normalized coordinates, with the interpolation and extension of
+   * the image. Safe to call from multiple threads. */
+  virtual float4 lookup(float x, float y) = 0;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __UTIL_TEXTURE_CACHE_H__ */
@@ -428,6 +428,9 @@ class DATA_PT_remesh(MeshButtonsPanel, Panel):
             col.prop(mesh, "remesh_voxel_size")
             col.prop(mesh, "remesh_voxel_adaptivity")
             col.prop(mesh, "use_remesh_fix_poles")
+            sub = col.column()
+            sub.active = mesh.remesh_voxel_adaptivity == 0.0
+            sub.prop(mesh, "use_remesh_fast")
 
             col = layout.column(heading="Preserve")
             col.prop(mesh, "use_remesh_preserve_volume", text="Volume")
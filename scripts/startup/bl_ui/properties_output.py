@@ -319,6 +319,9 @@ class RENDER_PT_output(RenderOutputButtonsPanel, Panel):
             col = layout.column(heading="Image Sequence")
             col.prop(rd, "use_overwrite")
             col.prop(rd, "use_placeholder")
+            sub = col.column()
+            sub.active = image_settings.file_format in {'OPEN_EXR', 'OPEN_EXR_MULTILAYER'}
+            sub.prop(rd, "use_write_background")
 
 
 class RENDER_PT_output_views(RenderOutputButtonsPanel, Panel):
@@ -2426,6 +2426,7 @@ class SEQUENCER_PT_cache_view_settings(SequencerButtonsPanel, Panel):
             col.prop(cache_settings, "show_cache_preprocessed", text="Preprocessed")
             col.prop(cache_settings, "show_cache_composite", text="Composite")
         col.prop(cache_settings, "show_cache_final_out", text="Final")
+        col.prop(cache_settings, "show_cache_statistics", text="Statistics")
 
 
 class SEQUENCER_PT_proxy_settings(SequencerButtonsPanel, Panel):
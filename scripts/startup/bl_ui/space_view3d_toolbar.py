@@ -1050,6 +1050,9 @@ class VIEW3D_PT_sculpt_voxel_remesh(Panel, View3DPaintPanel):
         props.mode = 'VOXEL'
         col.prop(mesh, "remesh_voxel_adaptivity")
         col.prop(mesh, "use_remesh_fix_poles")
+        sub = col.column()
+        sub.active = mesh.remesh_voxel_adaptivity == 0.0
+        sub.prop(mesh, "use_remesh_fast")
 
         col = layout.column(heading="Preserve", align=True)
         col.prop(mesh, "use_remesh_preserve_volume", text="Volume")
@@ -11,7 +11,12 @@
 struct Mesh;
 
 Mesh *BKE_mesh_remesh_voxel_fix_poles(const Mesh *mesh);
-Mesh *BKE_mesh_remesh_voxel(const Mesh *mesh, float voxel_size, float adaptivity, float isovalue);
+/**
+ * Voxel remesh through OpenVDB, or with the native remesher when \a use_fast is true and it
+ * supports the mesh and settings (see #blender::bke::mesh_remesh_voxel_native).
+ */
+Mesh *BKE_mesh_remesh_voxel(
+    const Mesh *mesh, float voxel_size, float adaptivity, float isovalue, bool use_fast);
 Mesh *BKE_mesh_remesh_quadriflow(const Mesh *mesh,
                                  int target_faces,
                                  int seed,
@@ -23,4 +28,19 @@ Mesh *BKE_mesh_remesh_quadriflow(const Mesh *mesh,
 
 namespace blender::bke {
 void mesh_remesh_reproject_attributes(const Mesh &src, Mesh &dst);
+
+/**
+ * Voxel remesh by building a narrow-band signed distance field directly from the mesh triangles.
+ * Faster than #mesh_remesh_voxel_openvdb, but doesn't support adaptivity, and only closed
+ * manifold meshes are supported. Returns null when the mesh isn't supported.
+ *
+ * The sign of the distance comes from the pseudo-normal of the closest feature, which is wrong
+ * inside of overlapping or intersecting closed parts. So this is only used when requested.
+ */
+Mesh *mesh_remesh_voxel_native(const Mesh &mesh, float voxel_size, float isovalue);
+/** Voxel remesh through an OpenVDB level set. Returns null when built without OpenVDB. */
+Mesh *mesh_remesh_voxel_openvdb(const Mesh &mesh,
+                                float voxel_size,
+                                float adaptivity,
+                                float isovalue);
 }
@@ -8,6 +8,7 @@
  * \ingroup bke
  */
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 
@@ -199,6 +200,17 @@ struct MeshRuntime {
   /** Lazily computed face corner normals (#Mesh::corner_normals()). */
   SharedCache<Vector<float3>> corner_normals_cache;
 
+  /**
+   * Vertices moved since the face and vertex normals were calculated, when only part of the mesh
+   * was deformed (see #Mesh::tag_positions_changed_partial). The normal caches are kept, and only
+   * the faces and vertices around these vertices are recalculated the next time normals are
+   * accessed. Empty when no partial update is pending. Protected by #normals_dirty_mutex.
+   */
+  BitVector<> normals_dirty_verts;
+  std::mutex normals_dirty_mutex;
+  /** True when #normals_dirty_verts must be applied before the normal caches can be used. */
+  std::atomic<bool> normals_update_pending = false;
+
   /**
    * Cache of offsets for vert to face/corner maps. The same offsets array is used to group
    * indices for both the vertex to face and vertex to corner maps.
@@ -210,6 +222,19 @@ struct MeshRuntime {
   SharedCache<Array<int>> vert_to_corner_map_cache;
   /** Cache of face indices for each face corner. */
   SharedCache<Array<int>> corner_to_face_map_cache;
+  /**
+   * Cache of offsets for edge to face/corner maps. Like the vertex maps, the same offsets array
+   * is used for both the edge to face and edge to corner maps.
+   */
+  SharedCache<Array<int>> edge_to_face_offset_cache;
+  /** Cache of indices for edge to face map. */
+  SharedCache<Array<int>> edge_to_face_map_cache;
+  /** Cache of indices for edge to corner map. */
+  SharedCache<Array<int>> edge_to_corner_map_cache;
+  /** Cache of offsets for vert to edge map. */
+  SharedCache<Array<int>> vert_to_edge_offset_cache;
+  /** Cache of indices for vert to edge map. */
+  SharedCache<Array<int>> vert_to_edge_map_cache;
   /** Cache of data about edges not used by faces. See #Mesh::loose_edges(). */
   SharedCache<LooseEdgeCache> loose_edges_cache;
   /** Cache of data about vertices not used by edges. See #Mesh::loose_verts(). */
@@ -515,6 +515,11 @@ void store_bounds_orig(Tree &pbvh);
 void update_mask(const Object &object, Tree &pbvh);
 void update_visibility(const Object &object, Tree &pbvh);
 void update_normals(const Depsgraph &depsgraph, Object &object_orig, Tree &pbvh);
+/**
+ * Tag the positions of the vertices in nodes with pending normal updates as changed, so that the
+ * cached normals of the original mesh are only recalculated around them.
+ */
+void mesh_tag_positions_changed_partial(Tree &pbvh, Mesh &mesh);
 /** Update geometry normals (potentially on the original object geometry). */
 void update_normals_from_eval(Object &object_eval, Tree &pbvh);
 
@@ -144,6 +144,13 @@ static void mesh_copy_data(Main *bmain,
   mesh_dst->runtime->vert_normals_cache = mesh_src->runtime->vert_normals_cache;
   mesh_dst->runtime->face_normals_cache = mesh_src->runtime->face_normals_cache;
   mesh_dst->runtime->corner_normals_cache = mesh_src->runtime->corner_normals_cache;
+  if (mesh_src->runtime->normals_update_pending) {
+    /* The shared normal caches are only valid after applying the pending partial update. */
+    std::lock_guard lock{mesh_src->runtime->normals_dirty_mutex};
+    mesh_dst->runtime->normals_dirty_verts = mesh_src->runtime->normals_dirty_verts;
+    mesh_dst->runtime->normals_update_pending.store(
+        mesh_src->runtime->normals_update_pending.load());
+  }
   mesh_dst->runtime->loose_verts_cache = mesh_src->runtime->loose_verts_cache;
   mesh_dst->runtime->verts_no_face_cache = mesh_src->runtime->verts_no_face_cache;
   mesh_dst->runtime->loose_edges_cache = mesh_src->runtime->loose_edges_cache;
@@ -153,6 +160,11 @@ static void mesh_copy_data(Main *bmain,
   mesh_dst->runtime->vert_to_face_map_cache = mesh_src->runtime->vert_to_face_map_cache;
   mesh_dst->runtime->vert_to_corner_map_cache = mesh_src->runtime->vert_to_corner_map_cache;
   mesh_dst->runtime->corner_to_face_map_cache = mesh_src->runtime->corner_to_face_map_cache;
+  mesh_dst->runtime->edge_to_face_offset_cache = mesh_src->runtime->edge_to_face_offset_cache;
+  mesh_dst->runtime->edge_to_face_map_cache = mesh_src->runtime->edge_to_face_map_cache;
+  mesh_dst->runtime->edge_to_corner_map_cache = mesh_src->runtime->edge_to_corner_map_cache;
+  mesh_dst->runtime->vert_to_edge_offset_cache = mesh_src->runtime->vert_to_edge_offset_cache;
+  mesh_dst->runtime->vert_to_edge_map_cache = mesh_src->runtime->vert_to_edge_map_cache;
   if (mesh_src->runtime->bake_materials) {
     mesh_dst->runtime->bake_materials = std::make_unique<blender::bke::bake::BakeMaterialsList>(
         *mesh_src->runtime->bake_materials);
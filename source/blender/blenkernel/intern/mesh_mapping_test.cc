@@ -0,0 +1,135 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup bke
+ */
+
+#include "BLI_array.hh"
+
+#include "BKE_idtype.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_mesh.hh"
+#include "BKE_mesh_mapping.hh"
+
+#include "DNA_mesh_types.h"
+
+#include "testing/testing.h"
+
+namespace blender::bke::tests {
+
+class MeshMappingTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    BKE_idtype_init();
+  }
+};
+
+/** A grid of quads with a loose edge attached to the last vertex. */
+static Mesh *create_grid_mesh(const int verts_x, const int verts_y)
+{
+  const int faces_x = verts_x - 1;
+  const int faces_y = verts_y - 1;
+  const int verts_num = verts_x * verts_y;
+  Mesh *mesh = BKE_mesh_new_nomain(verts_num + 1, 1, faces_x * faces_y, faces_x * faces_y * 4);
+
+  MutableSpan<float3> positions = mesh->vert_positions_for_write();
+  for (const int y : IndexRange(verts_y)) {
+    for (const int x : IndexRange(verts_x)) {
+      positions[y * verts_x + x] = float3(x, y, 0.0f);
+    }
+  }
+  positions.last() = float3(verts_x, verts_y, 0.0f);
+  mesh->edges_for_write().first() = int2(verts_num - 1, verts_num);
+
+  MutableSpan<int> corner_verts = mesh->corner_verts_for_write();
+  for (const int y : IndexRange(faces_y)) {
+    for (const int x : IndexRange(faces_x)) {
+      const int face = y * faces_x + x;
+      corner_verts[face * 4 + 0] = y * verts_x + x;
+      corner_verts[face * 4 + 1] = y * verts_x + x + 1;
+      corner_verts[face * 4 + 2] = (y + 1) * verts_x + x + 1;
+      corner_verts[face * 4 + 3] = (y + 1) * verts_x + x;
+    }
+  }
+  offset_indices::fill_constant_group_size(4, 0, mesh->face_offsets_for_write());
+  mesh_calc_edges(*mesh, true, false);
+  return mesh;
+}
+
+static void expect_groups_equal(const GroupedSpan<int> a, const GroupedSpan<int> b)
+{
+  ASSERT_EQ(a.size(), b.size());
+  for (const int i : a.index_range()) {
+    EXPECT_EQ(a[i], b[i]);
+  }
+}
+
+static void expect_maps_match_builders(const Mesh &mesh)
+{
+  Array<int> offsets;
+  Array<int> indices;
+  expect_groups_equal(mesh.edge_to_face_map(),
+                      mesh::build_edge_to_face_map(
+                          mesh.faces(), mesh.corner_edges(), mesh.edges_num, offsets, indices));
+  expect_groups_equal(
+      mesh.edge_to_corner_map(),
+      mesh::build_edge_to_corner_map(mesh.corner_edges(), mesh.edges_num, offsets, indices));
+  expect_groups_equal(
+      mesh.vert_to_edge_map(),
+      mesh::build_vert_to_edge_map(mesh.edges(), mesh.verts_num, offsets, indices));
+}
+
+TEST_F(MeshMappingTest, CachedTopologyMaps)
+{
+  Mesh *mesh = BKE_mesh_new_nomain(0, 0, 0, 0);
+  EXPECT_TRUE(mesh->edge_to_face_map().is_empty());
+  EXPECT_TRUE(mesh->vert_to_edge_map().is_empty());
+  BKE_id_free(nullptr, mesh);
+
+  mesh = create_grid_mesh(5, 4);
+  expect_maps_match_builders(*mesh);
+
+  /* The loose edge has no faces, inner edges have two. */
+  EXPECT_TRUE(mesh->edge_to_face_map()[0].is_empty());
+  EXPECT_EQ(mesh->vert_to_edge_map()[mesh->verts_num - 1].size(), 1);
+  EXPECT_EQ(mesh->vert_to_edge_map()[6].size(), 4);
+  for (const int edge : mesh->vert_to_edge_map()[6]) {
+    EXPECT_EQ(mesh->edge_to_face_map()[edge].size(), 2);
+  }
+
+  /* Building the edge to face map from the corner maps gives the same result. */
+  mesh->tag_topology_changed();
+  mesh->corner_to_face_map();
+  mesh->edge_to_corner_map();
+  expect_maps_match_builders(*mesh);
+
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(MeshMappingTest, CachedTopologyMapsShared)
+{
+  Mesh *mesh = create_grid_mesh(4, 4);
+  const GroupedSpan<int> edge_to_face = mesh->edge_to_face_map();
+  const GroupedSpan<int> vert_to_edge = mesh->vert_to_edge_map();
+
+  /* Copies share the caches instead of building the maps again. */
+  Mesh *copy = BKE_mesh_copy_for_eval(*mesh);
+  EXPECT_EQ(copy->edge_to_face_map().data.data(), edge_to_face.data.data());
+  EXPECT_EQ(copy->vert_to_edge_map().data.data(), vert_to_edge.data.data());
+
+  /* Changing the edges of the copy doesn't affect the original. */
+  copy->edges_for_write().first() = int2(0, mesh->verts_num - 1);
+  copy->tag_edges_split();
+  EXPECT_EQ(copy->vert_to_edge_map()[mesh->verts_num - 2].size(), 2);
+  EXPECT_EQ(mesh->vert_to_edge_map()[mesh->verts_num - 2].size(), 3);
+  expect_maps_match_builders(*copy);
+  expect_maps_match_builders(*mesh);
+
+  BKE_id_free(nullptr, copy);
+  BKE_id_free(nullptr, mesh);
+}
+
+}  // namespace blender::bke::tests
@@ -23,6 +23,7 @@
 #include "BLI_math_base.hh"
 #include "BLI_math_vector.hh"
 #include "BLI_memarena.h"
+#include "BLI_simd.hh"
 #include "BLI_span.hh"
 #include "BLI_task.hh"
 #include "BLI_utildefines.h"
@@ -78,6 +79,24 @@ namespace blender::bke::mesh {
 /** \name Mesh Normal Calculation (Polygons)
  * \{ */
 
+#if BLI_HAVE_SSE2
+/**
+ * Load a position with the fourth component set to zero. The last position of the array is
+ * loaded in two parts to avoid reading past its end.
+ */
+BLI_INLINE __m128 load_position_sse(const Span<float3> positions, const int index)
+{
+  const float *co = positions[index];
+  if (LIKELY(index + 1 < positions.size())) {
+    /* The fourth component is the first one of the next position. */
+    const __m128 mask_xyz = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+    return _mm_and_ps(_mm_loadu_ps(co), mask_xyz);
+  }
+  const __m128 xy = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double *>(co)));
+  return _mm_movelh_ps(xy, _mm_load_ss(co + 2));
+}
+#endif
+
 /*
  * COMPUTE POLY NORMAL
  *
@@ -90,12 +109,32 @@ static float3 normal_calc_ngon(const Span<float3> vert_positions, const Span<int
   float3 normal(0);
 
   /* Newell's Method */
+#if BLI_HAVE_SSE2
+  /* Same operations as #add_newell_cross_v3_v3v3 in the same order, so the result is identical
+   * to the scalar version. */
+  __m128 v_prev = load_position_sse(vert_positions, face_verts.last());
+  __m128 normal_vec = _mm_setzero_ps();
+  for (const int i : face_verts.index_range()) {
+    const __m128 v_curr = load_position_sse(vert_positions, face_verts[i]);
+    const __m128 diff = _mm_sub_ps(v_prev, v_curr);
+    const __m128 sum = _mm_add_ps(v_prev, v_curr);
+    /* (y, z, x) of the difference times (z, x, y) of the sum. */
+    const __m128 diff_yzx = _mm_shuffle_ps(diff, diff, _MM_SHUFFLE(3, 0, 2, 1));
+    const __m128 sum_zxy = _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(3, 1, 0, 2));
+    normal_vec = _mm_add_ps(normal_vec, _mm_mul_ps(diff_yzx, sum_zxy));
+    v_prev = v_curr;
+  }
+  float normal_result[4];
+  _mm_storeu_ps(normal_result, normal_vec);
+  normal = float3(normal_result);
+#else
   const float *v_prev = vert_positions[face_verts.last()];
   for (const int i : face_verts.index_range()) {
     const float *v_curr = vert_positions[face_verts[i]];
     add_newell_cross_v3_v3v3(normal, v_prev, v_curr);
     v_prev = v_curr;
   }
+#endif
 
   if (UNLIKELY(normalize_v3(normal) == 0.0f)) {
     /* Other axis are already set to zero. */
@@ -148,10 +187,18 @@ void normals_calc_faces(const Span<float3> positions,
                         MutableSpan<float3> face_normals)
 {
   BLI_assert(faces.size() == face_normals.size());
-  threading::parallel_for(faces.index_range(), 1024, [&](const IndexRange range) {
-    for (const int i : range) {
-      face_normals[i] = normal_calc_ngon(positions, corner_verts.slice(faces[i]));
-    }
+  normals_calc_faces(positions, faces, corner_verts, faces.index_range(), face_normals);
+}
+
+void normals_calc_faces(const Span<float3> positions,
+                        const OffsetIndices<int> faces,
+                        const Span<int> corner_verts,
+                        const IndexMask &face_mask,
+                        MutableSpan<float3> face_normals)
+{
+  BLI_assert(faces.size() == face_normals.size());
+  face_mask.foreach_index(GrainSize(1024), [&](const int i) {
+    face_normals[i] = normal_calc_ngon(positions, corner_verts.slice(faces[i]));
   });
 }
 
@@ -162,27 +209,42 @@ void normals_calc_verts(const Span<float3> vert_positions,
                         const Span<float3> face_normals,
                         MutableSpan<float3> vert_normals)
 {
-  const Span<float3> positions = vert_positions;
-  threading::parallel_for(positions.index_range(), 1024, [&](const IndexRange range) {
-    for (const int vert : range) {
-      const Span<int> vert_faces = vert_to_face_map[vert];
-      if (vert_faces.is_empty()) {
-        vert_normals[vert] = math::normalize(positions[vert]);
-        continue;
-      }
+  normals_calc_verts(vert_positions,
+                     faces,
+                     corner_verts,
+                     vert_to_face_map,
+                     face_normals,
+                     vert_positions.index_range(),
+                     vert_normals);
+}
 
-      float3 vert_normal(0);
-      for (const int face : vert_faces) {
-        const int2 adjacent_verts = face_find_adjacent_verts(faces[face], corner_verts, vert);
-        const float3 dir_prev = math::normalize(positions[adjacent_verts[0]] - positions[vert]);
-        const float3 dir_next = math::normalize(positions[adjacent_verts[1]] - positions[vert]);
-        const float factor = math::safe_acos_approx(math::dot(dir_prev, dir_next));
+void normals_calc_verts(const Span<float3> vert_positions,
+                        const OffsetIndices<int> faces,
+                        const Span<int> corner_verts,
+                        const GroupedSpan<int> vert_to_face_map,
+                        const Span<float3> face_normals,
+                        const IndexMask &vert_mask,
+                        MutableSpan<float3> vert_normals)
+{
+  const Span<float3> positions = vert_positions;
+  vert_mask.foreach_index(GrainSize(1024), [&](const int vert) {
+    const Span<int> vert_faces = vert_to_face_map[vert];
+    if (vert_faces.is_empty()) {
+      vert_normals[vert] = math::normalize(positions[vert]);
+      return;
+    }
 
-        vert_normal += face_normals[face] * factor;
-      }
+    float3 vert_normal(0);
+    for (const int face : vert_faces) {
+      const int2 adjacent_verts = face_find_adjacent_verts(faces[face], corner_verts, vert);
+      const float3 dir_prev = math::normalize(positions[adjacent_verts[0]] - positions[vert]);
+      const float3 dir_next = math::normalize(positions[adjacent_verts[1]] - positions[vert]);
+      const float factor = math::safe_acos_approx(math::dot(dir_prev, dir_next));
 
-      vert_normals[vert] = math::normalize(vert_normal);
+      vert_normal += face_normals[face] * factor;
     }
+
+    vert_normals[vert] = math::normalize(vert_normal);
   });
 }
 
@@ -190,6 +252,82 @@ void normals_calc_verts(const Span<float3> vert_positions,
 
 }  // namespace blender::bke::mesh
 
+/* -------------------------------------------------------------------- */
+/** \name Partial Normal Updates
+ * \{ */
+
+namespace blender::bke {
+
+/**
+ * Apply position changes tagged with #Mesh::tag_positions_changed_partial to the cached face and
+ * vertex normals. Only the faces that use a moved vertex are recalculated, followed by all the
+ * vertices of those faces, since their angle weights and face normals may have changed.
+ */
+static void mesh_normals_update_partial(const Mesh &mesh)
+{
+  MeshRuntime &runtime = *mesh.runtime;
+  if (!runtime.normals_update_pending.load(std::memory_order_acquire)) {
+    return;
+  }
+  std::lock_guard lock{runtime.normals_dirty_mutex};
+  if (!runtime.normals_update_pending.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+#ifdef DEBUG_TIME
+  SCOPED_TIMER_AVERAGED(__func__);
+#endif
+
+  const Span<float3> positions = mesh.vert_positions();
+  const OffsetIndices faces = mesh.faces();
+  const Span<int> corner_verts = mesh.corner_verts();
+  const GroupedSpan<int> vert_to_face = mesh.vert_to_face_map();
+
+  IndexMaskMemory memory;
+  const IndexMask dirty_verts = IndexMask::from_bits(runtime.normals_dirty_verts, memory);
+
+  BitVector<> face_bits(faces.size(), false);
+  dirty_verts.foreach_index([&](const int vert) {
+    for (const int face : vert_to_face[vert]) {
+      face_bits[face].set();
+    }
+  });
+  const IndexMask affected_faces = IndexMask::from_bits(face_bits, memory);
+
+  /* Include moved vertices explicitly, since loose vertices aren't part of any face. */
+  BitVector<> vert_bits = runtime.normals_dirty_verts;
+  affected_faces.foreach_index([&](const int face) {
+    for (const int vert : corner_verts.slice(faces[face])) {
+      vert_bits[vert].set();
+    }
+  });
+  const IndexMask affected_verts = IndexMask::from_bits(vert_bits, memory);
+
+  if (runtime.face_normals_cache.is_cached()) {
+    runtime.face_normals_cache.update([&](Vector<float3> &r_data) {
+      mesh::normals_calc_faces(positions, faces, corner_verts, affected_faces, r_data);
+    });
+    if (runtime.vert_normals_cache.is_cached()) {
+      const Span<float3> face_normals = runtime.face_normals_cache.data();
+      runtime.vert_normals_cache.update([&](Vector<float3> &r_data) {
+        mesh::normals_calc_verts(
+            positions, faces, corner_verts, vert_to_face, face_normals, affected_verts, r_data);
+      });
+    }
+  }
+  else {
+    /* Vertex normals depend on the face normals, which must be recalculated completely. */
+    runtime.vert_normals_cache.tag_dirty();
+  }
+
+  runtime.normals_dirty_verts.clear_and_shrink();
+  runtime.normals_update_pending.store(false, std::memory_order_release);
+}
+
+}  // namespace blender::bke
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Mesh Normal Calculation
  * \{ */
@@ -235,6 +373,7 @@ blender::Span<blender::float3> Mesh::vert_normals() const
 {
   using namespace blender;
   using namespace blender::bke;
+  mesh_normals_update_partial(*this);
   if (this->runtime->vert_normals_cache.is_cached()) {
     return this->runtime->vert_normals_cache.data();
   }
@@ -253,6 +392,7 @@ blender::Span<blender::float3> Mesh::vert_normals() const
 blender::Span<blender::float3> Mesh::face_normals() const
 {
   using namespace blender;
+  bke::mesh_normals_update_partial(*this);
   this->runtime->face_normals_cache.ensure([&](Vector<float3> &r_data) {
     const Span<float3> positions = this->vert_positions();
     const OffsetIndices faces = this->faces();
@@ -0,0 +1,225 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup bke
+ */
+
+#include "BLI_index_mask.hh"
+#include "BLI_math_vector.hh"
+#include "BLI_rand.hh"
+
+#include "BKE_idtype.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_mesh.hh"
+
+#include "DNA_mesh_types.h"
+
+#include "testing/testing.h"
+
+/* Set to 1 to run the normal calculation benchmarks. They are disabled by default because they
+ * allocate a lot of memory and take a long time. */
+#define DO_PERF_TESTS 0
+
+#if DO_PERF_TESTS
+#  include "BLI_timeit.hh"
+#endif
+
+namespace blender::bke::tests {
+
+class MeshNormalsTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    BKE_idtype_init();
+  }
+};
+
+/** Create a grid of quads, with a few random perturbations so normals aren't all the same. */
+static Mesh *create_grid_mesh(const int verts_x, const int verts_y)
+{
+  const int faces_x = verts_x - 1;
+  const int faces_y = verts_y - 1;
+  Mesh *mesh = BKE_mesh_new_nomain(verts_x * verts_y, 0, faces_x * faces_y, faces_x * faces_y * 4);
+
+  RandomNumberGenerator rng(0);
+  MutableSpan<float3> positions = mesh->vert_positions_for_write();
+  for (const int y : IndexRange(verts_y)) {
+    for (const int x : IndexRange(verts_x)) {
+      positions[y * verts_x + x] = float3(x, y, rng.get_float() * 0.5f);
+    }
+  }
+
+  MutableSpan<int> face_offsets = mesh->face_offsets_for_write();
+  MutableSpan<int> corner_verts = mesh->corner_verts_for_write();
+  for (const int y : IndexRange(faces_y)) {
+    for (const int x : IndexRange(faces_x)) {
+      const int face = y * faces_x + x;
+      face_offsets[face] = face * 4;
+      corner_verts[face * 4 + 0] = y * verts_x + x;
+      corner_verts[face * 4 + 1] = y * verts_x + x + 1;
+      corner_verts[face * 4 + 2] = (y + 1) * verts_x + x + 1;
+      corner_verts[face * 4 + 3] = (y + 1) * verts_x + x;
+    }
+  }
+  face_offsets.last() = corner_verts.size();
+  return mesh;
+}
+
+static void expect_normals_match_full_calculation(const Mesh &mesh)
+{
+  const Span<float3> positions = mesh.vert_positions();
+  const OffsetIndices faces = mesh.faces();
+  const Span<int> corner_verts = mesh.corner_verts();
+
+  Array<float3> face_normals(faces.size());
+  mesh::normals_calc_faces(positions, faces, corner_verts, face_normals);
+  Array<float3> vert_normals(positions.size());
+  mesh::normals_calc_verts(
+      positions, faces, corner_verts, mesh.vert_to_face_map(), face_normals, vert_normals);
+
+  const Span<float3> cached_face_normals = mesh.face_normals();
+  for (const int i : face_normals.index_range()) {
+    EXPECT_EQ(cached_face_normals[i], face_normals[i]);
+  }
+  const Span<float3> cached_vert_normals = mesh.vert_normals();
+  for (const int i : vert_normals.index_range()) {
+    EXPECT_EQ(cached_vert_normals[i], vert_normals[i]);
+  }
+}
+
+TEST_F(MeshNormalsTest, FaceNormalsNgon)
+{
+  const Array<float3> positions = {{0, 0, 0}, {1, 0, 0}, {2, 1, 0}, {1, 2, 0}, {0, 1, 0}};
+  const Array<int> face_verts = {0, 1, 2, 3, 4};
+  EXPECT_EQ(mesh::face_normal_calc(positions, face_verts), float3(0, 0, 1));
+  const Array<int> face_verts_flipped = {4, 3, 2, 1, 0};
+  EXPECT_EQ(mesh::face_normal_calc(positions, face_verts_flipped), float3(0, 0, -1));
+}
+
+TEST_F(MeshNormalsTest, PartialUpdate)
+{
+  Mesh *mesh = create_grid_mesh(20, 20);
+  mesh->face_normals();
+  mesh->vert_normals();
+
+  MutableSpan<float3> positions = mesh->vert_positions_for_write();
+  const Array<int> moved_verts = {0, 21, 22, 150, 399};
+  for (const int vert : moved_verts) {
+    positions[vert].z += 1.0f;
+  }
+  IndexMaskMemory memory;
+  mesh->tag_positions_changed_partial(IndexMask::from_indices(moved_verts.as_span(), memory));
+  expect_normals_match_full_calculation(*mesh);
+
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(MeshNormalsTest, PartialUpdateShared)
+{
+  Mesh *mesh = create_grid_mesh(20, 20);
+  mesh->vert_normals();
+  Mesh *mesh_copy = BKE_mesh_copy_for_eval(*mesh);
+  const Array<float3> orig_vert_normals = mesh->vert_normals();
+
+  /* Changing the copy must not affect the normals of the original mesh. */
+  MutableSpan<float3> positions = mesh_copy->vert_positions_for_write();
+  positions[42].z -= 2.0f;
+  IndexMaskMemory memory;
+  mesh_copy->tag_positions_changed_partial(IndexMask::from_indices(Span<int>({42}), memory));
+
+  /* The pending update should be kept when the mesh is copied again. */
+  Mesh *mesh_copy_2 = BKE_mesh_copy_for_eval(*mesh_copy);
+  expect_normals_match_full_calculation(*mesh_copy);
+  expect_normals_match_full_calculation(*mesh_copy_2);
+  EXPECT_EQ_ARRAY(orig_vert_normals.data(), mesh->vert_normals().data(), mesh->verts_num);
+
+  BKE_id_free(nullptr, mesh_copy_2);
+  BKE_id_free(nullptr, mesh_copy);
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(MeshNormalsTest, PartialUpdateAfterFullTag)
+{
+  Mesh *mesh = create_grid_mesh(10, 10);
+  mesh->vert_normals();
+
+  IndexMaskMemory memory;
+  MutableSpan<float3> positions = mesh->vert_positions_for_write();
+  positions[3].z += 1.0f;
+  mesh->tag_positions_changed_partial(IndexMask::from_indices(Span<int>({3}), memory));
+  for (float3 &position : positions) {
+    position.y *= 2.0f;
+  }
+  mesh->tag_positions_changed();
+  expect_normals_match_full_calculation(*mesh);
+
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(MeshNormalsTest, PartialUpdateThenFullTagShared)
+{
+  Mesh *mesh = create_grid_mesh(10, 10);
+  mesh->vert_normals();
+
+  IndexMaskMemory memory;
+  MutableSpan<float3> positions = mesh->vert_positions_for_write();
+  positions[55].z += 1.0f;
+  mesh->tag_positions_changed_partial(IndexMask::from_indices(Span<int>({55}), memory));
+
+  /* The copy shares the caches and the pending update. A full tag on the copy must discard the
+   * pending update without applying it to the shared caches of the original. */
+  Mesh *mesh_copy = BKE_mesh_copy_for_eval(*mesh);
+  MutableSpan<float3> positions_copy = mesh_copy->vert_positions_for_write();
+  for (float3 &position : positions_copy) {
+    position.x *= 0.5f;
+  }
+  mesh_copy->tag_positions_changed();
+
+  expect_normals_match_full_calculation(*mesh_copy);
+  expect_normals_match_full_calculation(*mesh);
+
+  BKE_id_free(nullptr, mesh_copy);
+  BKE_id_free(nullptr, mesh);
+}
+
+#if DO_PERF_TESTS
+
+/* About 10 million faces. */
+static constexpr int perf_grid_size = 3163;
+
+TEST_F(MeshNormalsTest, PerformanceFull)
+{
+  Mesh *mesh = create_grid_mesh(perf_grid_size, perf_grid_size);
+  mesh->vert_to_face_map();
+  for ([[maybe_unused]] const int i : IndexRange(5)) {
+    mesh->tag_positions_changed();
+    SCOPED_TIMER_AVERAGED("full normals update");
+    mesh->vert_normals();
+  }
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(MeshNormalsTest, PerformancePartial)
+{
+  Mesh *mesh = create_grid_mesh(perf_grid_size, perf_grid_size);
+  mesh->vert_normals();
+  /* Deform a contiguous block of about 1% of the vertices, like a sculpt brush stroke. */
+  const int64_t block_size = int64_t(mesh->verts_num) / 100;
+  for (const int i : IndexRange(5)) {
+    const IndexRange changed_verts(int64_t(i) * block_size, block_size);
+    MutableSpan<float3> positions = mesh->vert_positions_for_write();
+    for (const int vert : changed_verts) {
+      positions[vert].z += 0.1f;
+    }
+    mesh->tag_positions_changed_partial(changed_verts);
+    SCOPED_TIMER_AVERAGED("partial normals update");
+    mesh->vert_normals();
+  }
+  BKE_id_free(nullptr, mesh);
+}
+
+#endif
+
+}  // namespace blender::bke::tests
@@ -17,11 +17,15 @@
 
 #include "BLI_array.hh"
 #include "BLI_array_utils.hh"
+#include "BLI_bounds.hh"
 #include "BLI_enumerable_thread_specific.hh"
 #include "BLI_index_range.hh"
 #include "BLI_math_vector.h"
+#include "BLI_math_vector.hh"
+#include "BLI_offset_indices.hh"
 #include "BLI_span.hh"
 #include "BLI_task.hh"
+#include "BLI_vector_set.hh"
 
 #include "BKE_attribute.hh"
 #include "BKE_attribute_math.hh"
@@ -50,7 +54,9 @@
 using blender::Array;
 using blender::float3;
 using blender::IndexRange;
+using blender::int2;
 using blender::int3;
+using blender::int4;
 using blender::MutableSpan;
 using blender::Span;
 
@@ -250,15 +256,494 @@ static Mesh *remesh_voxel_volume_to_mesh(const openvdb::FloatGrid::Ptr level_set
 }
 #endif
 
-Mesh *BKE_mesh_remesh_voxel(const Mesh *mesh,
+/* -------------------------------------------------------------------- */
+/** \name Native Narrow-Band Voxel Remesher
+ *
+ * Builds a sparse signed distance field only in a narrow band around the surface and extracts
+ * the iso-surface with "surface nets" (one vertex per cell crossing the surface, one quad per grid
+ * edge crossing it), without converting the mesh to and from OpenVDB containers.
+ *
+ * The voxels are stored in bricks of #SDF_BRICK_SIZE^3 voxels, allocated only where a triangle's
+ * bounds overlap the band. Distances come from nearest-point queries on the mesh triangle BVH,
+ * and the sign is found with the angle weighted pseudo-normal of the closest feature (vertex, edge
+ * or face), which is exact for closed manifold meshes. Other meshes use the OpenVDB path.
+ * \{ */
+
+namespace blender::bke {
+
+static constexpr int SDF_BRICK_SIZE = 8;
+static constexpr int SDF_BRICK_SHIFT = 3;
+static constexpr int SDF_BRICK_VOXELS = SDF_BRICK_SIZE * SDF_BRICK_SIZE * SDF_BRICK_SIZE;
+/** Value of voxels outside of the narrow band. */
+static constexpr float SDF_OUTSIDE_BAND = FLT_MAX;
+
+struct SDFBrick {
+  std::array<float, SDF_BRICK_VOXELS> values;
+  /** Index of the mesh vertex in each cell with the voxel as its minimum corner, or -1. */
+  std::array<int, SDF_BRICK_VOXELS> cell_verts;
+};
+
+struct NarrowBandSDF {
+  float voxel_size;
+  /** The coordinates of each brick, in units of #SDF_BRICK_SIZE voxels. */
+  VectorSet<int3> brick_coords;
+  Array<SDFBrick> bricks;
+
+  static int3 brick_coord(const int3 &voxel)
+  {
+    /* Arithmetic shift, to round negative voxel coordinates down. */
+    return int3(
+        voxel.x >> SDF_BRICK_SHIFT, voxel.y >> SDF_BRICK_SHIFT, voxel.z >> SDF_BRICK_SHIFT);
+  }
+
+  static int local_index(const int3 &voxel)
+  {
+    const int3 local(voxel.x & (SDF_BRICK_SIZE - 1),
+                     voxel.y & (SDF_BRICK_SIZE - 1),
+                     voxel.z & (SDF_BRICK_SIZE - 1));
+    return (local.z * SDF_BRICK_SIZE + local.y) * SDF_BRICK_SIZE + local.x;
+  }
+
+  static int3 local_voxel(const int index)
+  {
+    return int3(index % SDF_BRICK_SIZE,
+                (index / SDF_BRICK_SIZE) % SDF_BRICK_SIZE,
+                index / (SDF_BRICK_SIZE * SDF_BRICK_SIZE));
+  }
+
+  const SDFBrick *find_brick(const int3 &voxel) const
+  {
+    const int index = this->brick_coords.index_of_try(brick_coord(voxel));
+    return index == -1 ? nullptr : &this->bricks[index];
+  }
+
+  float value(const int3 &voxel) const
+  {
+    const SDFBrick *brick = this->find_brick(voxel);
+    return brick ? brick->values[local_index(voxel)] : SDF_OUTSIDE_BAND;
+  }
+
+  int cell_vert(const int3 &voxel) const
+  {
+    const SDFBrick *brick = this->find_brick(voxel);
+    return brick ? brick->cell_verts[local_index(voxel)] : -1;
+  }
+
+  float3 position(const int3 &voxel) const
+  {
+    return float3(voxel) * this->voxel_size;
+  }
+};
+
+enum class TriFeature : int8_t { Face, Vert0, Vert1, Vert2, Edge01, Edge12, Edge20 };
+
+/**
+ * Closest point on a triangle, also returning which feature of the triangle it lies on.
+ * See "Real-Time Collision Detection" by Christer Ericson, section 5.1.5.
+ */
+static float3 closest_point_on_tri(const float3 &p,
+                                   const float3 &a,
+                                   const float3 &b,
+                                   const float3 &c,
+                                   TriFeature &r_feature)
+{
+  const float3 ab = b - a;
+  const float3 ac = c - a;
+  const float3 ap = p - a;
+  const float d1 = math::dot(ab, ap);
+  const float d2 = math::dot(ac, ap);
+  if (d1 <= 0.0f && d2 <= 0.0f) {
+    r_feature = TriFeature::Vert0;
+    return a;
+  }
+  const float3 bp = p - b;
+  const float d3 = math::dot(ab, bp);
+  const float d4 = math::dot(ac, bp);
+  if (d3 >= 0.0f && d4 <= d3) {
+    r_feature = TriFeature::Vert1;
+    return b;
+  }
+  const float vc = d1 * d4 - d3 * d2;
+  if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+    r_feature = TriFeature::Edge01;
+    return a + ab * math::safe_divide(d1, d1 - d3);
+  }
+  const float3 cp = p - c;
+  const float d5 = math::dot(ab, cp);
+  const float d6 = math::dot(ac, cp);
+  if (d6 >= 0.0f && d5 <= d6) {
+    r_feature = TriFeature::Vert2;
+    return c;
+  }
+  const float vb = d5 * d2 - d1 * d6;
+  if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+    r_feature = TriFeature::Edge20;
+    return a + ac * math::safe_divide(d2, d2 - d6);
+  }
+  const float va = d3 * d6 - d5 * d4;
+  if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+    r_feature = TriFeature::Edge12;
+    return b + (c - b) * math::safe_divide(d4 - d3, (d4 - d3) + (d5 - d6));
+  }
+  r_feature = TriFeature::Face;
+  const float denom = math::safe_divide(1.0f, va + vb + vc);
+  return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+/**
+ * Sum the normals of the faces around every edge. Returns false if the mesh isn't a closed
+ * manifold, when the pseudo-normal sign test isn't reliable.
+ */
+static bool calc_edge_pseudo_normals(const Mesh &mesh, MutableSpan<float3> edge_normals)
+{
+  const OffsetIndices faces = mesh.faces();
+  const Span<int> corner_edges = mesh.corner_edges();
+  const Span<float3> face_normals = mesh.face_normals();
+  Array<int> edge_face_count(mesh.edges_num, 0);
+  edge_normals.fill(float3(0));
+  for (const int face : faces.index_range()) {
+    for (const int edge : corner_edges.slice(faces[face])) {
+      edge_normals[edge] += face_normals[face];
+      edge_face_count[edge]++;
+    }
+  }
+  return std::all_of(
+      edge_face_count.begin(), edge_face_count.end(), [](const int count) { return count == 2; });
+}
+
+/** Find the mesh edge between two corners of a face, or -1 for a triangulation diagonal. */
+static int face_corners_edge(const IndexRange face,
+                             const Span<int> corner_edges,
+                             const int corner_a,
+                             const int corner_b)
+{
+  const int next_a = corner_a == face.last() ? face.first() : corner_a + 1;
+  if (next_a == corner_b) {
+    return corner_edges[corner_a];
+  }
+  const int next_b = corner_b == face.last() ? face.first() : corner_b + 1;
+  if (next_b == corner_a) {
+    return corner_edges[corner_b];
+  }
+  return -1;
+}
+
+static void sdf_find_bricks(const Span<float3> positions,
+                            const Span<int> corner_verts,
+                            const Span<int3> corner_tris,
                             const float voxel_size,
-                            const float adaptivity,
-                            const float isovalue)
+                            const float band,
+                            NarrowBandSDF &sdf)
+{
+  threading::EnumerableThreadSpecific<VectorSet<int3>> all_brick_coords;
+  threading::parallel_for(corner_tris.index_range(), 1024, [&](const IndexRange range) {
+    VectorSet<int3> &brick_coords = all_brick_coords.local();
+    for (const int tri : range) {
+      Bounds<float3> bounds(positions[corner_verts[corner_tris[tri][0]]]);
+      math::min_max(positions[corner_verts[corner_tris[tri][1]]], bounds.min, bounds.max);
+      math::min_max(positions[corner_verts[corner_tris[tri][2]]], bounds.min, bounds.max);
+      const int3 min = NarrowBandSDF::brick_coord(
+          int3(math::floor((bounds.min - band) / voxel_size)));
+      const int3 max = NarrowBandSDF::brick_coord(
+          int3(math::ceil((bounds.max + band) / voxel_size)));
+      for (int z = min.z; z <= max.z; z++) {
+        for (int y = min.y; y <= max.y; y++) {
+          for (int x = min.x; x <= max.x; x++) {
+            brick_coords.add(int3(x, y, z));
+          }
+        }
+      }
+    }
+  });
+  for (const VectorSet<int3> &local_coords : all_brick_coords) {
+    for (const int3 &coord : local_coords) {
+      sdf.brick_coords.add(coord);
+    }
+  }
+  sdf.bricks.reinitialize(sdf.brick_coords.size());
+}
+
+static void sdf_calc_values(const Mesh &mesh,
+                            BVHTreeFromMesh &bvhtree,
+                            const Span<float3> edge_normals,
+                            const float band,
+                            NarrowBandSDF &sdf)
+{
+  const Span<float3> positions = mesh.vert_positions();
+  const OffsetIndices faces = mesh.faces();
+  const Span<int> corner_verts = mesh.corner_verts();
+  const Span<int> corner_edges = mesh.corner_edges();
+  const Span<int3> corner_tris = mesh.corner_tris();
+  const Span<int> tri_faces = mesh.corner_tri_faces();
+  const Span<float3> vert_normals = mesh.vert_normals();
+  const Span<float3> face_normals = mesh.face_normals();
+
+  const auto edge_normal = [&](const int tri, const int corner_a, const int corner_b) {
+    const int face = tri_faces[tri];
+    const int edge = face_corners_edge(faces[face], corner_edges, corner_a, corner_b);
+    return edge == -1 ? face_normals[face] : edge_normals[edge];
+  };
+
+  threading::parallel_for(sdf.bricks.index_range(), 1, [&](const IndexRange range) {
+    for (const int brick_index : range) {
+      SDFBrick &brick = sdf.bricks[brick_index];
+      const int3 brick_min = sdf.brick_coords[brick_index] * SDF_BRICK_SIZE;
+      for (const int i : IndexRange(SDF_BRICK_VOXELS)) {
+        const float3 co = sdf.position(brick_min + NarrowBandSDF::local_voxel(i));
+        BVHTreeNearest nearest;
+        nearest.index = -1;
+        nearest.dist_sq = band * band;
+        BLI_bvhtree_find_nearest(
+            bvhtree.tree, co, &nearest, bvhtree.nearest_callback, &bvhtree);
+        if (nearest.index == -1) {
+          brick.values[i] = SDF_OUTSIDE_BAND;
+          continue;
+        }
+        const int tri = nearest.index;
+        const int3 &tri_corners = corner_tris[tri];
+        TriFeature feature;
+        const float3 closest = closest_point_on_tri(co,
+                                                    positions[corner_verts[tri_corners[0]]],
+                                                    positions[corner_verts[tri_corners[1]]],
+                                                    positions[corner_verts[tri_corners[2]]],
+                                                    feature);
+        float3 pseudo_normal;
+        switch (feature) {
+          case TriFeature::Face:
+            pseudo_normal = face_normals[tri_faces[tri]];
+            break;
+          case TriFeature::Vert0:
+            pseudo_normal = vert_normals[corner_verts[tri_corners[0]]];
+            break;
+          case TriFeature::Vert1:
+            pseudo_normal = vert_normals[corner_verts[tri_corners[1]]];
+            break;
+          case TriFeature::Vert2:
+            pseudo_normal = vert_normals[corner_verts[tri_corners[2]]];
+            break;
+          case TriFeature::Edge01:
+            pseudo_normal = edge_normal(tri, tri_corners[0], tri_corners[1]);
+            break;
+          case TriFeature::Edge12:
+            pseudo_normal = edge_normal(tri, tri_corners[1], tri_corners[2]);
+            break;
+          case TriFeature::Edge20:
+            pseudo_normal = edge_normal(tri, tri_corners[2], tri_corners[0]);
+            break;
+        }
+        const float3 offset = co - closest;
+        const float distance = math::length(offset);
+        brick.values[i] = math::dot(offset, pseudo_normal) < 0.0f ? -distance : distance;
+      }
+    }
+  });
+}
+
+/** Create a vertex for every cell crossing the iso-surface and store its index in the brick. */
+static void sdf_calc_cell_verts(const float isovalue, NarrowBandSDF &sdf, Vector<float3> &r_verts)
+{
+  static const std::array<int3, 8> corner_offsets = {int3(0, 0, 0),
+                                                     int3(1, 0, 0),
+                                                     int3(0, 1, 0),
+                                                     int3(1, 1, 0),
+                                                     int3(0, 0, 1),
+                                                     int3(1, 0, 1),
+                                                     int3(0, 1, 1),
+                                                     int3(1, 1, 1)};
+  static const std::array<int2, 12> cell_edges = {int2(0, 1),
+                                                  int2(2, 3),
+                                                  int2(4, 5),
+                                                  int2(6, 7),
+                                                  int2(0, 2),
+                                                  int2(1, 3),
+                                                  int2(4, 6),
+                                                  int2(5, 7),
+                                                  int2(0, 4),
+                                                  int2(1, 5),
+                                                  int2(2, 6),
+                                                  int2(3, 7)};
+
+  /* Compute vertex positions per brick, then give them global indices in brick order so the
+   * result doesn't depend on the scheduling of threads. */
+  Array<Vector<float3>> brick_verts(sdf.bricks.size());
+  threading::parallel_for(sdf.bricks.index_range(), 1, [&](const IndexRange range) {
+    for (const int brick_index : range) {
+      SDFBrick &brick = sdf.bricks[brick_index];
+      const int3 brick_min = sdf.brick_coords[brick_index] * SDF_BRICK_SIZE;
+      Vector<float3> &verts = brick_verts[brick_index];
+      for (const int i : IndexRange(SDF_BRICK_VOXELS)) {
+        brick.cell_verts[i] = -1;
+        const int3 cell = brick_min + NarrowBandSDF::local_voxel(i);
+        std::array<float, 8> values;
+        bool in_band = true;
+        int inside_count = 0;
+        for (const int corner : IndexRange(8)) {
+          values[corner] = sdf.value(cell + corner_offsets[corner]);
+          if (values[corner] == SDF_OUTSIDE_BAND) {
+            in_band = false;
+            break;
+          }
+          inside_count += values[corner] < isovalue;
+        }
+        if (!in_band || ELEM(inside_count, 0, 8)) {
+          continue;
+        }
+        float3 sum(0);
+        int crossings_num = 0;
+        for (const int2 &edge : cell_edges) {
+          const float value_a = values[edge[0]];
+          const float value_b = values[edge[1]];
+          if ((value_a < isovalue) == (value_b < isovalue)) {
+            continue;
+          }
+          const float factor = (isovalue - value_a) / (value_b - value_a);
+          sum += math::interpolate(
+              float3(corner_offsets[edge[0]]), float3(corner_offsets[edge[1]]), factor);
+          crossings_num++;
+        }
+        brick.cell_verts[i] = verts.size();
+        verts.append(sdf.position(cell) + sum / float(crossings_num) * sdf.voxel_size);
+      }
+    }
+  });
+
+  Array<int> vert_offsets_data(sdf.bricks.size() + 1);
+  for (const int i : brick_verts.index_range()) {
+    vert_offsets_data[i] = brick_verts[i].size();
+  }
+  const OffsetIndices vert_offsets = offset_indices::accumulate_counts_to_offsets(
+      vert_offsets_data);
+  r_verts.reinitialize(vert_offsets.total_size());
+  threading::parallel_for(sdf.bricks.index_range(), 64, [&](const IndexRange range) {
+    for (const int brick_index : range) {
+      const IndexRange verts = vert_offsets[brick_index];
+      r_verts.as_mutable_span().slice(verts).copy_from(brick_verts[brick_index]);
+      if (verts.start() == 0) {
+        continue;
+      }
+      for (int &vert : sdf.bricks[brick_index].cell_verts) {
+        if (vert != -1) {
+          vert += verts.start();
+        }
+      }
+    }
+  });
+}
+
+/**
+ * Create a quad for every grid edge with a sign change, connecting the vertices of the four cells
+ * around the edge. The winding is chosen so that face normals point away from the inside.
+ */
+static void sdf_calc_quads(const float isovalue, const NarrowBandSDF &sdf, Vector<int4> &r_quads)
+{
+  Array<Vector<int4>> brick_quads(sdf.bricks.size());
+  threading::parallel_for(sdf.bricks.index_range(), 1, [&](const IndexRange range) {
+    for (const int brick_index : range) {
+      const SDFBrick &brick = sdf.bricks[brick_index];
+      const int3 brick_min = sdf.brick_coords[brick_index] * SDF_BRICK_SIZE;
+      Vector<int4> &quads = brick_quads[brick_index];
+      for (const int i : IndexRange(SDF_BRICK_VOXELS)) {
+        const float value = brick.values[i];
+        if (value == SDF_OUTSIDE_BAND) {
+          continue;
+        }
+        const int3 voxel = brick_min + NarrowBandSDF::local_voxel(i);
+        for (const int axis : IndexRange(3)) {
+          int3 next = voxel;
+          next[axis]++;
+          const float next_value = sdf.value(next);
+          if (next_value == SDF_OUTSIDE_BAND || (value < isovalue) == (next_value < isovalue)) {
+            continue;
+          }
+          /* The two other axes, ordered so that their cross product is the edge axis. */
+          const int axis_u = (axis + 1) % 3;
+          const int axis_w = (axis + 2) % 3;
+          const std::array<int2, 4> offsets = {
+              int2(0, -1), int2(0, 0), int2(-1, 0), int2(-1, -1)};
+          int4 quad;
+          bool valid = true;
+          for (const int corner : IndexRange(4)) {
+            int3 cell = voxel;
+            cell[axis_u] += offsets[corner][0];
+            cell[axis_w] += offsets[corner][1];
+            quad[corner] = sdf.cell_vert(cell);
+            if (quad[corner] == -1) {
+              valid = false;
+              break;
+            }
+          }
+          if (!valid) {
+            continue;
+          }
+          /* Counter-clockwise around the positive axis when the start of the edge is inside. */
+          quads.append(value < isovalue ? quad : int4(quad[3], quad[2], quad[1], quad[0]));
+        }
+      }
+    }
+  });
+
+  Array<int> quad_offsets_data(sdf.bricks.size() + 1);
+  for (const int i : brick_quads.index_range()) {
+    quad_offsets_data[i] = brick_quads[i].size();
+  }
+  const OffsetIndices quad_offsets = offset_indices::accumulate_counts_to_offsets(
+      quad_offsets_data);
+  r_quads.reinitialize(quad_offsets.total_size());
+  threading::parallel_for(brick_quads.index_range(), 64, [&](const IndexRange range) {
+    for (const int brick_index : range) {
+      r_quads.as_mutable_span()
+          .slice(quad_offsets[brick_index])
+          .copy_from(brick_quads[brick_index]);
+    }
+  });
+}
+
+Mesh *mesh_remesh_voxel_native(const Mesh &mesh, const float voxel_size, const float isovalue)
+{
+  if (mesh.faces_num == 0 || voxel_size <= 0.0f) {
+    return nullptr;
+  }
+  Array<float3> edge_normals(mesh.edges_num);
+  if (!calc_edge_pseudo_normals(mesh, edge_normals)) {
+    return nullptr;
+  }
+
+  /* Cells crossing the iso-surface are within half of a cell diagonal from it, so the band must
+   * contain the corners of those cells, up to sqrt(3) voxels away. */
+  const float band = std::abs(isovalue) + 2.0f * voxel_size;
+
+  NarrowBandSDF sdf;
+  sdf.voxel_size = voxel_size;
+  sdf_find_bricks(
+      mesh.vert_positions(), mesh.corner_verts(), mesh.corner_tris(), voxel_size, band, sdf);
+
+  BVHTreeFromMesh bvhtree{};
+  BKE_bvhtree_from_mesh_get(&bvhtree, &mesh, BVHTREE_FROM_CORNER_TRIS, 2);
+  sdf_calc_values(mesh, bvhtree, edge_normals, band, sdf);
+  free_bvhtree_from_mesh(&bvhtree);
+
+  Vector<float3> verts;
+  sdf_calc_cell_verts(isovalue, sdf, verts);
+  Vector<int4> quads;
+  sdf_calc_quads(isovalue, sdf, quads);
+
+  Mesh *result = BKE_mesh_new_nomain(verts.size(), 0, quads.size(), quads.size() * 4);
+  result->vert_positions_for_write().copy_from(verts);
+  offset_indices::fill_constant_group_size(4, 0, result->face_offsets_for_write());
+  result->corner_verts_for_write().copy_from(quads.as_span().cast<int>());
+  mesh_calc_edges(*result, false, false);
+  return result;
+}
+
+Mesh *mesh_remesh_voxel_openvdb(const Mesh &mesh,
+                                const float voxel_size,
+                                const float adaptivity,
+                                const float isovalue)
 {
 #ifdef WITH_OPENVDB
-  openvdb::FloatGrid::Ptr level_set = remesh_voxel_level_set_create(mesh, voxel_size);
+  openvdb::FloatGrid::Ptr level_set = remesh_voxel_level_set_create(&mesh, voxel_size);
   Mesh *result = remesh_voxel_volume_to_mesh(level_set, isovalue, adaptivity, false);
-  BKE_mesh_copy_parameters(result, mesh);
+  BKE_mesh_copy_parameters(result, &mesh);
   return result;
 #else
   UNUSED_VARS(mesh, voxel_size, adaptivity, isovalue);
@@ -266,6 +751,28 @@ Mesh *BKE_mesh_remesh_voxel(const Mesh *mesh,
 #endif
 }
 
+}  // namespace blender::bke
+
+/** \} */
+
+Mesh *BKE_mesh_remesh_voxel(const Mesh *mesh,
+                            const float voxel_size,
+                            const float adaptivity,
+                            const float isovalue,
+                            const bool use_fast)
+{
+  using namespace blender::bke;
+  /* The native remesher doesn't support adaptivity or meshes that aren't closed manifolds. In
+   * those cases it returns null, and the OpenVDB implementation is used instead. */
+  if (use_fast && adaptivity <= 0.0f) {
+    if (Mesh *result = mesh_remesh_voxel_native(*mesh, voxel_size, isovalue)) {
+      BKE_mesh_copy_parameters(result, mesh);
+      return result;
+    }
+  }
+  return mesh_remesh_voxel_openvdb(*mesh, voxel_size, adaptivity, isovalue);
+}
+
 namespace blender::bke {
 
 static void calc_edge_centers(const Span<float3> positions,
@@ -0,0 +1,192 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup bke
+ */
+
+#include "BLI_array.hh"
+#include "BLI_bounds.hh"
+#include "BLI_math_vector.hh"
+
+#include "BKE_idtype.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_mesh.hh"
+#include "BKE_mesh_remesh_voxel.hh"
+
+#include "DNA_mesh_types.h"
+
+#include "testing/testing.h"
+
+/* Set to 1 to compare the performance of the native and OpenVDB voxel remeshers. */
+#define DO_PERF_TESTS 0
+
+#if DO_PERF_TESTS
+#  include "BLI_timeit.hh"
+#endif
+
+namespace blender::bke::tests {
+
+class MeshRemeshVoxelTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    BKE_idtype_init();
+  }
+};
+
+static Mesh *create_cube_mesh(const float size)
+{
+  Mesh *mesh = BKE_mesh_new_nomain(8, 0, 6, 24);
+  MutableSpan<float3> positions = mesh->vert_positions_for_write();
+  for (const int i : positions.index_range()) {
+    positions[i] = float3(i & 1 ? size : -size, i & 2 ? size : -size, i & 4 ? size : -size);
+  }
+  mesh->corner_verts_for_write().copy_from(
+      {0, 2, 3, 1, 4, 5, 7, 6, 0, 1, 5, 4, 2, 6, 7, 3, 0, 4, 6, 2, 1, 3, 7, 5});
+  offset_indices::fill_constant_group_size(4, 0, mesh->face_offsets_for_write());
+  mesh_calc_edges(*mesh, false, false);
+  return mesh;
+}
+
+static void expect_closed_manifold(const Mesh &mesh)
+{
+  Array<int> edge_face_count(mesh.edges_num, 0);
+  for (const int edge : mesh.corner_edges()) {
+    edge_face_count[edge]++;
+  }
+  for (const int count : edge_face_count) {
+    EXPECT_EQ(count, 2);
+  }
+}
+
+TEST_F(MeshRemeshVoxelTest, NativeCube)
+{
+  Mesh *cube = create_cube_mesh(1.0f);
+  Mesh *result = mesh_remesh_voxel_native(*cube, 0.1f, 0.0f);
+  ASSERT_NE(result, nullptr);
+  EXPECT_GT(result->faces_num, 0);
+  expect_closed_manifold(*result);
+
+  const Bounds<float3> bounds = *result->bounds_min_max();
+  EXPECT_NEAR(bounds.min.x, -1.0f, 0.1f);
+  EXPECT_NEAR(bounds.max.z, 1.0f, 0.1f);
+
+  /* Face normals should point away from the center of the cube. */
+  const Span<float3> face_normals = result->face_normals();
+  const OffsetIndices faces = result->faces();
+  const Span<float3> positions = result->vert_positions();
+  const Span<int> corner_verts = result->corner_verts();
+  for (const int face : faces.index_range()) {
+    const float3 center = mesh::face_center_calc(positions, corner_verts.slice(faces[face]));
+    EXPECT_GT(math::dot(face_normals[face], center), 0.0f);
+  }
+
+  BKE_id_free(nullptr, result);
+  BKE_id_free(nullptr, cube);
+}
+
+TEST_F(MeshRemeshVoxelTest, NativeIsovalue)
+{
+  Mesh *cube = create_cube_mesh(1.0f);
+  Mesh *result = mesh_remesh_voxel_native(*cube, 0.1f, 0.3f);
+  ASSERT_NE(result, nullptr);
+  const Bounds<float3> bounds = *result->bounds_min_max();
+  EXPECT_NEAR(bounds.max.x, 1.3f, 0.1f);
+  BKE_id_free(nullptr, result);
+  BKE_id_free(nullptr, cube);
+}
+
+TEST_F(MeshRemeshVoxelTest, NativeOpenMesh)
+{
+  /* A single face isn't closed, the native remesher can't handle it. */
+  Mesh *mesh = BKE_mesh_new_nomain(4, 0, 1, 4);
+  mesh->vert_positions_for_write().copy_from({{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}});
+  mesh->corner_verts_for_write().copy_from({0, 1, 2, 3});
+  mesh_calc_edges(*mesh, false, false);
+  EXPECT_EQ(mesh_remesh_voxel_native(*mesh, 0.1f, 0.0f), nullptr);
+  BKE_id_free(nullptr, mesh);
+}
+
+/** Two cubes in the same mesh, overlapping by half their size like joined sculpt pieces. */
+static Mesh *create_overlapping_cubes_mesh()
+{
+  Mesh *cube = create_cube_mesh(1.0f);
+  Mesh *mesh = BKE_mesh_new_nomain(16, 0, 12, 48);
+  MutableSpan<float3> positions = mesh->vert_positions_for_write();
+  positions.take_front(8).copy_from(cube->vert_positions());
+  for (const int i : IndexRange(8)) {
+    positions[8 + i] = cube->vert_positions()[i] + float3(1.0f, 0.0f, 0.0f);
+  }
+  MutableSpan<int> corner_verts = mesh->corner_verts_for_write();
+  corner_verts.take_front(24).copy_from(cube->corner_verts());
+  for (const int i : IndexRange(24)) {
+    corner_verts[24 + i] = cube->corner_verts()[i] + 8;
+  }
+  offset_indices::fill_constant_group_size(4, 0, mesh->face_offsets_for_write());
+  mesh_calc_edges(*mesh, false, false);
+  BKE_id_free(nullptr, cube);
+  return mesh;
+}
+
+TEST_F(MeshRemeshVoxelTest, OverlappingPartsUseOpenVDB)
+{
+  /* The pseudo-normal sign of the native remesher is wrong inside of the overlap, so it must not
+   * be used unless requested, even though the mesh is closed. */
+  Mesh *mesh = create_overlapping_cubes_mesh();
+  Mesh *result = BKE_mesh_remesh_voxel(mesh, 0.1f, 0.0f, 0.0f, false);
+  Mesh *expected = mesh_remesh_voxel_openvdb(*mesh, 0.1f, 0.0f, 0.0f);
+  if (expected == nullptr) {
+    BKE_id_free(nullptr, mesh);
+    GTEST_SKIP() << "Built without OpenVDB";
+  }
+  ASSERT_NE(result, nullptr);
+  EXPECT_EQ(result->verts_num, expected->verts_num);
+  EXPECT_EQ(result->faces_num, expected->faces_num);
+  expect_closed_manifold(*result);
+
+  /* The union of both cubes, without surfaces inside of the overlap. */
+  const Bounds<float3> bounds = *result->bounds_min_max();
+  EXPECT_NEAR(bounds.min.x, -1.0f, 0.1f);
+  EXPECT_NEAR(bounds.max.x, 2.0f, 0.1f);
+  for (const float3 &position : result->vert_positions()) {
+    const bool inside = position.x > 0.2f && position.x < 0.8f && std::abs(position.y) < 0.8f &&
+                        std::abs(position.z) < 0.8f;
+    EXPECT_FALSE(inside);
+  }
+
+  BKE_id_free(nullptr, expected);
+  BKE_id_free(nullptr, result);
+  BKE_id_free(nullptr, mesh);
+}
+
+#if DO_PERF_TESTS
+
+TEST_F(MeshRemeshVoxelTest, Performance)
+{
+  Mesh *cube = create_cube_mesh(1.0f);
+  for (const float voxel_size : {0.02f, 0.01f, 0.005f}) {
+    std::cout << "Voxel size " << voxel_size << "\n";
+    for ([[maybe_unused]] const int i : IndexRange(3)) {
+      Mesh *result;
+      {
+        SCOPED_TIMER_AVERAGED("native");
+        result = mesh_remesh_voxel_native(*cube, voxel_size, 0.0f);
+      }
+      BKE_id_free(nullptr, result);
+      {
+        SCOPED_TIMER_AVERAGED("openvdb");
+        result = mesh_remesh_voxel_openvdb(*cube, voxel_size, 0.0f, 0.0f);
+      }
+      if (result) {
+        BKE_id_free(nullptr, result);
+      }
+    }
+  }
+  BKE_id_free(nullptr, cube);
+}
+
+#endif
+
+}  // namespace blender::bke::tests
@@ -57,6 +57,13 @@ static void free_batch_cache(MeshRuntime &mesh_runtime)
   }
 }
 
+static void free_normals_dirty_verts(MeshRuntime &mesh_runtime)
+{
+  /* Only called from tagging functions, which require exclusive access to the mesh. */
+  mesh_runtime.normals_dirty_verts.clear_and_shrink();
+  mesh_runtime.normals_update_pending.store(false, std::memory_order_relaxed);
+}
+
 MeshRuntime::MeshRuntime() = default;
 
 MeshRuntime::~MeshRuntime()
@@ -162,6 +169,63 @@ blender::GroupedSpan<int> Mesh::vert_to_corner_map() const
   return {offsets, this->runtime->vert_to_corner_map_cache.data()};
 }
 
+blender::OffsetIndices<int> Mesh::edge_to_face_map_offsets() const
+{
+  using namespace blender;
+  this->runtime->edge_to_face_offset_cache.ensure([&](Array<int> &r_data) {
+    r_data = Array<int>(this->edges_num + 1, 0);
+    offset_indices::build_reverse_offsets(this->corner_edges(), r_data);
+  });
+  return OffsetIndices<int>(this->runtime->edge_to_face_offset_cache.data());
+}
+
+blender::GroupedSpan<int> Mesh::edge_to_face_map() const
+{
+  using namespace blender;
+  const OffsetIndices offsets = this->edge_to_face_map_offsets();
+  this->runtime->edge_to_face_map_cache.ensure([&](Array<int> &r_data) {
+    r_data.reinitialize(this->corners_num);
+    if (this->runtime->edge_to_corner_map_cache.is_cached() &&
+        this->runtime->corner_to_face_map_cache.is_cached())
+    {
+      /* Like the vertex to face map, the edge to face map can be built from the edge to face
+       * corner and face corner to face maps if they are both already cached. */
+      array_utils::gather(this->runtime->corner_to_face_map_cache.data().as_span(),
+                          this->runtime->edge_to_corner_map_cache.data().as_span(),
+                          r_data.as_mutable_span());
+    }
+    else {
+      bke::mesh::build_edge_to_face_indices(this->faces(), this->corner_edges(), offsets, r_data);
+    }
+  });
+  return {offsets, this->runtime->edge_to_face_map_cache.data()};
+}
+
+blender::GroupedSpan<int> Mesh::edge_to_corner_map() const
+{
+  using namespace blender;
+  const OffsetIndices offsets = this->edge_to_face_map_offsets();
+  this->runtime->edge_to_corner_map_cache.ensure([&](Array<int> &r_data) {
+    r_data = bke::mesh::build_edge_to_corner_indices(this->corner_edges(), offsets);
+  });
+  return {offsets, this->runtime->edge_to_corner_map_cache.data()};
+}
+
+blender::GroupedSpan<int> Mesh::vert_to_edge_map() const
+{
+  using namespace blender;
+  this->runtime->vert_to_edge_offset_cache.ensure([&](Array<int> &r_data) {
+    r_data = Array<int>(this->verts_num + 1, 0);
+    offset_indices::build_reverse_offsets(this->edges().cast<int>(), r_data);
+  });
+  const OffsetIndices<int> offsets(this->runtime->vert_to_edge_offset_cache.data());
+  this->runtime->vert_to_edge_map_cache.ensure([&](Array<int> &r_data) {
+    r_data.reinitialize(offsets.total_size());
+    bke::mesh::build_vert_to_edge_indices(this->edges(), offsets, r_data);
+  });
+  return {offsets, this->runtime->vert_to_edge_map_cache.data()};
+}
+
 const blender::bke::LooseVertCache &Mesh::loose_verts() const
 {
   using namespace blender::bke;
@@ -319,9 +383,15 @@ void BKE_mesh_runtime_clear_geometry(Mesh *mesh)
   mesh->runtime->vert_to_face_map_cache.tag_dirty();
   mesh->runtime->vert_to_corner_map_cache.tag_dirty();
   mesh->runtime->corner_to_face_map_cache.tag_dirty();
+  mesh->runtime->edge_to_face_offset_cache.tag_dirty();
+  mesh->runtime->edge_to_face_map_cache.tag_dirty();
+  mesh->runtime->edge_to_corner_map_cache.tag_dirty();
+  mesh->runtime->vert_to_edge_offset_cache.tag_dirty();
+  mesh->runtime->vert_to_edge_map_cache.tag_dirty();
   mesh->runtime->vert_normals_cache.tag_dirty();
   mesh->runtime->face_normals_cache.tag_dirty();
   mesh->runtime->corner_normals_cache.tag_dirty();
+  free_normals_dirty_verts(*mesh->runtime);
   mesh->runtime->loose_edges_cache.tag_dirty();
   mesh->runtime->loose_verts_cache.tag_dirty();
   mesh->runtime->verts_no_face_cache.tag_dirty();
@@ -342,6 +412,11 @@ void Mesh::tag_edges_split()
   this->runtime->vert_to_face_offset_cache.tag_dirty();
   this->runtime->vert_to_face_map_cache.tag_dirty();
   this->runtime->vert_to_corner_map_cache.tag_dirty();
+  this->runtime->edge_to_face_offset_cache.tag_dirty();
+  this->runtime->edge_to_face_map_cache.tag_dirty();
+  this->runtime->edge_to_corner_map_cache.tag_dirty();
+  this->runtime->vert_to_edge_offset_cache.tag_dirty();
+  this->runtime->vert_to_edge_map_cache.tag_dirty();
   if (this->runtime->loose_edges_cache.is_cached() &&
       this->runtime->loose_edges_cache.data().count != 0)
   {
@@ -377,7 +452,9 @@ void Mesh::tag_face_winding_changed()
   this->runtime->vert_normals_cache.tag_dirty();
   this->runtime->face_normals_cache.tag_dirty();
   this->runtime->corner_normals_cache.tag_dirty();
+  free_normals_dirty_verts(*this->runtime);
   this->runtime->vert_to_corner_map_cache.tag_dirty();
+  this->runtime->edge_to_corner_map_cache.tag_dirty();
   this->runtime->shrinkwrap_boundary_cache.tag_dirty();
 }
 
@@ -386,10 +463,37 @@ void Mesh::tag_positions_changed()
   this->runtime->vert_normals_cache.tag_dirty();
   this->runtime->face_normals_cache.tag_dirty();
   this->runtime->corner_normals_cache.tag_dirty();
+  free_normals_dirty_verts(*this->runtime);
   this->runtime->shrinkwrap_boundary_cache.tag_dirty();
   this->tag_positions_changed_no_normals();
 }
 
+void Mesh::tag_positions_changed_partial(const blender::IndexMask &changed_verts)
+{
+  using namespace blender;
+  bke::MeshRuntime &runtime = *this->runtime;
+  if (changed_verts.is_empty()) {
+    return;
+  }
+  /* When most of the mesh moved, a full recalculation is faster than finding affected elements. */
+  if (changed_verts.size() > this->verts_num / 4 ||
+      (!runtime.face_normals_cache.is_cached() && !runtime.vert_normals_cache.is_cached()))
+  {
+    this->tag_positions_changed();
+    return;
+  }
+  {
+    std::lock_guard lock{runtime.normals_dirty_mutex};
+    if (runtime.normals_dirty_verts.is_empty()) {
+      runtime.normals_dirty_verts.resize(this->verts_num, false);
+    }
+    changed_verts.foreach_index([&](const int vert) { runtime.normals_dirty_verts[vert].set(); });
+    runtime.normals_update_pending.store(true, std::memory_order_release);
+  }
+  runtime.corner_normals_cache.tag_dirty();
+  this->tag_positions_changed_no_normals();
+}
+
 void Mesh::tag_positions_changed_no_normals()
 {
   free_bvh_cache(*this->runtime);
@@ -1016,15 +1016,13 @@ static void update_normals_mesh(Object &object_orig, Object &object_eval, Span<N
 
   /* In certain cases when undoing strokes on a duplicate object, the cached data may be marked
    * dirty before this code is run, leaving the relevant vectors empty. We force reinitialize the
-   * vectors to prevent crashes here.
+   * vectors to prevent crashes here. Accessing the normals also applies pending partial updates
+   * from #Mesh::tag_positions_changed_partial, which would otherwise be applied on top of the
+   * node updates below.
    * See #125375 for more detail. */
   if (!pbvh.deformed_) {
-    if (mesh.runtime->face_normals_cache.is_dirty()) {
-      mesh.face_normals();
-    }
-    if (mesh.runtime->vert_normals_cache.is_dirty()) {
-      mesh.vert_normals();
-    }
+    mesh.face_normals();
+    mesh.vert_normals();
   }
 
   VectorSet<int> boundary_verts;
@@ -1103,6 +1101,27 @@ static void update_normals(Object &object_orig, Object &object_eval, Tree &pbvh)
   }
 }
 
+void mesh_tag_positions_changed_partial(Tree &pbvh, Mesh &mesh)
+{
+  BLI_assert(pbvh.type() == Type::Mesh);
+  const Vector<Node *> nodes = search_gather(
+      pbvh, [&](Node &node) { return update_search(&node, PBVH_UpdateNormals); });
+  if (nodes.is_empty()) {
+    mesh.tag_positions_changed();
+    return;
+  }
+
+  Array<bool> changed_verts(mesh.verts_num, false);
+  threading::parallel_for(nodes.index_range(), 8, [&](const IndexRange range) {
+    for (const Node *node : nodes.as_span().slice(range)) {
+      changed_verts.as_mutable_span().fill_indices(node_verts(*node), true);
+    }
+  });
+
+  IndexMaskMemory memory;
+  mesh.tag_positions_changed_partial(IndexMask::from_bools(changed_verts, memory));
+}
+
 void update_normals(const Depsgraph &depsgraph, Object &object_orig, Tree &pbvh)
 {
   BLI_assert(DEG_is_original_object(&object_orig));
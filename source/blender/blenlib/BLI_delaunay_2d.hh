@@ -8,6 +8,7 @@
 #include "BLI_math_mpq.hh"
 #include "BLI_math_vector_mpq_types.hh"
 #include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
 #include "BLI_vector.hh"
 
 /** \file
@@ -45,6 +46,8 @@
  *
  * The underlying method is incremental, but we need to know
  * beforehand a bounding box for all of the constraints.
+ * The initial triangulation of the vertices is done with divide and conquer,
+ * with the halves of large inputs triangulated in parallel.
  * This code can be extended in the future to allow for
  * deletion of constraints, if there is a use in Blender
  * for dynamically maintaining a triangulation.
@@ -185,4 +188,18 @@ CDT_result<mpq_class> delaunay_2d_calc(const CDT_input<mpq_class> &input,
                                        CDT_output_type output_type);
 #endif
 
+/**
+ * Triangulate several independent inputs, in parallel. The results are the same as calling
+ * #delaunay_2d_calc for every input separately. This is useful when there are many small inputs,
+ * like the glyphs of a text, that wouldn't benefit from parallelism within a single
+ * triangulation.
+ */
+Array<CDT_result<double>> delaunay_2d_calc(Span<CDT_input<double>> inputs,
+                                           CDT_output_type output_type);
+
+#ifdef WITH_GMP
+Array<CDT_result<mpq_class>> delaunay_2d_calc(Span<CDT_input<mpq_class>> inputs,
+                                              CDT_output_type output_type);
+#endif
+
 } /* namespace blender::meshintersect */
@@ -355,6 +355,12 @@ size_t BLI_file_zstd_from_mem_at_pos(void *buf,
                                      FILE *file,
                                      size_t file_offset,
                                      int compression_level) ATTR_WARN_UNUSED_RESULT ATTR_NONNULL();
+/**
+ * Compress \a buf into a single ZSTD frame in memory, on the calling thread.
+ * \return The compressed data to be freed with #MEM_freeN, or null on failure.
+ */
+void *BLI_zstd_from_mem(const void *buf, size_t len, int compression_level, size_t *r_len)
+    ATTR_WARN_UNUSED_RESULT ATTR_NONNULL();
 size_t BLI_file_unzstd_to_mem_at_pos(void *buf, size_t len, FILE *file, size_t file_offset)
     ATTR_WARN_UNUSED_RESULT ATTR_NONNULL();
 bool BLI_file_magic_is_zstd(const char header[4]);
@@ -18,6 +18,7 @@
 #include "BLI_math_mpq.hh"
 #include "BLI_math_vector_mpq_types.hh"
 #include "BLI_set.hh"
+#include "BLI_sort.hh"
 #include "BLI_task.hh"
 #include "BLI_vector.hh"
 
@@ -1215,6 +1216,73 @@ inline bool dc_tri_valid(SymEdge<T> *se, SymEdge<T> *basel, SymEdge<T> *basel_sy
   return filtered_orient2d(se->next->vert->co, basel_sym->vert->co, basel->vert->co) > 0;
 }
 
+/**
+ * Halves of the divide and conquer triangulation with at least this many sites are triangulated
+ * in parallel. This only depends on the input, so the result is the same for any number of
+ * threads.
+ */
+constexpr int dc_tri_parallel_threshold = 4096;
+
+template<typename T>
+void dc_tri(CDTArrangement<T> *cdt,
+            Array<SiteInfo<T>> &sites,
+            int start,
+            int end,
+            SymEdge<T> **r_le,
+            SymEdge<T> **r_re);
+
+/**
+ * Move the elements of an arrangement that was built separately into \a cdt.
+ * The separate arrangement had its own outer face, whose boundary is the cycle starting at
+ * \a hull_se. That boundary becomes part of the outer face of \a cdt.
+ */
+template<typename T>
+static void dc_tri_join_arrangement(CDTArrangement<T> *cdt,
+                                    CDTArrangement<T> &part,
+                                    SymEdge<T> *hull_se)
+{
+  BLI_assert(hull_se->face == part.outer_face);
+  SymEdge<T> *se = hull_se;
+  do {
+    se->face = cdt->outer_face;
+    se = se->next;
+  } while (se != hull_se);
+  part.outer_face->deleted = true;
+
+  cdt->edges.extend(part.edges);
+  cdt->faces.extend(part.faces);
+  /* The elements are owned by \a cdt now. */
+  part.edges.clear();
+  part.faces.clear();
+}
+
+/**
+ * Same as the two recursive #dc_tri calls for the left and right halves, but each half is built
+ * in a separate arrangement, so that they can be triangulated in parallel. The elements are
+ * added to \a cdt in the same order as with the serial recursion.
+ */
+template<typename T>
+static void dc_tri_halves_parallel(CDTArrangement<T> *cdt,
+                                   Array<SiteInfo<T>> &sites,
+                                   int start,
+                                   int mid,
+                                   int end,
+                                   SymEdge<T> **r_ldo,
+                                   SymEdge<T> **r_ldi,
+                                   SymEdge<T> **r_rdi,
+                                   SymEdge<T> **r_rdo)
+{
+  CDTArrangement<T> left;
+  CDTArrangement<T> right;
+  left.outer_face = left.add_face();
+  right.outer_face = right.add_face();
+  threading::parallel_invoke(
+      [&]() { dc_tri(&left, sites, start, mid, r_ldo, r_ldi); },
+      [&]() { dc_tri(&right, sites, mid, end, r_rdi, r_rdo); });
+  dc_tri_join_arrangement(cdt, left, sym(*r_ldo));
+  dc_tri_join_arrangement(cdt, right, sym(*r_rdi));
+}
+
 /**
  * Delaunay triangulate sites[start} to sites[end-1].
  * Assume sites are lexicographically sorted by coordinate.
@@ -1281,8 +1349,13 @@ void dc_tri(CDTArrangement<T> *cdt,
   SymEdge<T> *ldi;
   SymEdge<T> *rdi;
   SymEdge<T> *rdo;
-  dc_tri(cdt, sites, start, start + n2, &ldo, &ldi);
-  dc_tri(cdt, sites, start + n2, end, &rdi, &rdo);
+  if (n2 >= dc_tri_parallel_threshold) {
+    dc_tri_halves_parallel(cdt, sites, start, start + n2, end, &ldo, &ldi, &rdi, &rdo);
+  }
+  else {
+    dc_tri(cdt, sites, start, start + n2, &ldo, &ldi);
+    dc_tri(cdt, sites, start + n2, end, &rdi, &rdo);
+  }
   if (dbg_level > 0) {
     std::cout << "\nDC_TRI merge step for start=" << start << ", end=" << end << "\n";
     std::cout << "ldo " << ldo << "\n"
@@ -1476,7 +1549,7 @@ template<typename T> void initial_triangulation(CDTArrangement<T> *cdt)
     sites[i].v = cdt->verts[i];
     sites[i].orig_index = i;
   }
-  std::sort(sites.begin(), sites.end(), site_lexicographic_sort<T>);
+  parallel_sort(sites.begin(), sites.end(), site_lexicographic_sort<T>);
   find_site_merges(sites);
   dc_triangulate(cdt, sites);
 }
@@ -2791,4 +2864,37 @@ blender::meshintersect::CDT_result<mpq_class> delaunay_2d_calc(const CDT_input<m
 }
 #endif
 
+template<typename T>
+Array<CDT_result<T>> delaunay_calc_batch(const Span<CDT_input<T>> inputs,
+                                         const CDT_output_type output_type)
+{
+  Array<CDT_result<T>> results(inputs.size());
+  threading::parallel_for(
+      inputs.index_range(),
+      1024,
+      [&](const IndexRange range) {
+        for (const int i : range) {
+          results[i] = delaunay_calc(inputs[i], output_type);
+        }
+      },
+      threading::individual_task_sizes([&](const int64_t i) {
+        return inputs[i].vert.size() + inputs[i].edge.size();
+      }));
+  return results;
+}
+
+Array<CDT_result<double>> delaunay_2d_calc(const Span<CDT_input<double>> inputs,
+                                           const CDT_output_type output_type)
+{
+  return delaunay_calc_batch(inputs, output_type);
+}
+
+#ifdef WITH_GMP
+Array<CDT_result<mpq_class>> delaunay_2d_calc(const Span<CDT_input<mpq_class>> inputs,
+                                              const CDT_output_type output_type)
+{
+  return delaunay_calc_batch(inputs, output_type);
+}
+#endif
+
 } /* namespace blender::meshintersect */
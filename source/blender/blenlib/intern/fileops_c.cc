@@ -217,6 +217,22 @@ size_t BLI_file_zstd_from_mem_at_pos(
   return ZSTD_isError(ret) ? 0 : total_written;
 }
 
+void *BLI_zstd_from_mem(const void *buf, size_t len, int compression_level, size_t *r_len)
+{
+  const size_t out_len = ZSTD_compressBound(len);
+  void *out_buf = MEM_mallocN(out_len, __func__);
+
+  const size_t ret = ZSTD_compress(out_buf, out_len, buf, len, compression_level);
+  if (ZSTD_isError(ret)) {
+    MEM_freeN(out_buf);
+    *r_len = 0;
+    return nullptr;
+  }
+
+  *r_len = ret;
+  return out_buf;
+}
+
 size_t BLI_file_unzstd_to_mem_at_pos(void *buf, size_t len, FILE *file, size_t file_offset)
 {
   fseek(file, file_offset, SEEK_SET);
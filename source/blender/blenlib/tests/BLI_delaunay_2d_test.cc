@@ -19,6 +19,7 @@
 #define DO_RANDOM_TESTS 0
 
 #include "BLI_array.hh"
+#include "BLI_map.hh"
 #include "BLI_math_boolean.hh"
 #include "BLI_math_mpq.hh"
 #include "BLI_math_vector_mpq_types.hh"
@@ -1447,6 +1448,145 @@ template<typename T> void square_o_test()
   }
 }
 
+template<typename T> void expect_results_equal(const CDT_result<T> &a, const CDT_result<T> &b)
+{
+  EXPECT_EQ(a.vert.size(), b.vert.size());
+  EXPECT_EQ(a.edge.size(), b.edge.size());
+  EXPECT_EQ(a.face.size(), b.face.size());
+  if (a.vert.size() != b.vert.size() || a.edge.size() != b.edge.size() ||
+      a.face.size() != b.face.size())
+  {
+    return;
+  }
+  for (const int i : a.vert.index_range()) {
+    EXPECT_EQ(a.vert[i], b.vert[i]);
+  }
+  for (const int i : a.edge.index_range()) {
+    EXPECT_EQ(a.edge[i], b.edge[i]);
+  }
+  for (const int i : a.face.index_range()) {
+    EXPECT_EQ(a.face[i], b.face[i]);
+  }
+  EXPECT_EQ(a.face_orig.size(), b.face_orig.size());
+}
+
+template<typename T> void batch_test()
+{
+  const char *spec_tri = R"(3 0 1
+  0.0 0.0
+  1.0 0.0
+  0.5 1.0
+  0 1 2
+  )";
+  const char *spec_square_hole = R"(8 0 2
+  0.0 0.0
+  4.0 0.0
+  4.0 4.0
+  0.0 4.0
+  1.0 1.0
+  3.0 1.0
+  3.0 3.0
+  1.0 3.0
+  0 1 2 3
+  4 7 6 5
+  )";
+  const char *spec_cross = R"(4 2 0
+  -1.0 0.0
+  1.0 0.0
+  0.0 -1.0
+  0.0 1.0
+  0 1
+  2 3
+  )";
+
+  Array<CDT_input<T>> inputs(30);
+  for (const int i : inputs.index_range()) {
+    const char *spec = i % 3 == 0 ? spec_tri : (i % 3 == 1 ? spec_square_hole : spec_cross);
+    inputs[i] = fill_input_from_string<T>(spec);
+  }
+  for (const CDT_output_type otype : {CDT_FULL, CDT_INSIDE_WITH_HOLES, CDT_CONSTRAINTS}) {
+    Array<CDT_result<T>> results = delaunay_2d_calc(inputs.as_span(), otype);
+    EXPECT_EQ(results.size(), inputs.size());
+    for (const int i : inputs.index_range()) {
+      expect_results_equal(results[i], delaunay_2d_calc(inputs[i], otype));
+    }
+  }
+  EXPECT_TRUE(delaunay_2d_calc(Span<CDT_input<T>>(), CDT_FULL).is_empty());
+}
+
+/**
+ * Check that a full triangulation only has counter-clockwise triangles, and that every edge
+ * between two triangles satisfies the Delaunay condition.
+ */
+template<typename T> void expect_delaunay(const CDT_result<T> &out)
+{
+  auto co = [&](const int v) {
+    return double2(math_to_double(out.vert[v][0]), math_to_double(out.vert[v][1]));
+  };
+  Map<std::pair<int, int>, int> edge_opposite_vert;
+  int bad_orient = 0;
+  int bad_incircle = 0;
+  for (const Vector<int> &face : out.face) {
+    EXPECT_EQ(face.size(), 3);
+    if (face.size() != 3) {
+      return;
+    }
+    if (orient2d(co(face[0]), co(face[1]), co(face[2])) <= 0) {
+      bad_orient++;
+    }
+    for (const int i : IndexRange(3)) {
+      edge_opposite_vert.add({face[i], face[(i + 1) % 3]}, face[(i + 2) % 3]);
+    }
+  }
+  for (const auto item : edge_opposite_vert.items()) {
+    const int *other = edge_opposite_vert.lookup_ptr({item.key.second, item.key.first});
+    if (other == nullptr) {
+      continue;
+    }
+    if (incircle(co(item.key.first), co(item.key.second), co(item.value), co(*other)) > 0) {
+      bad_incircle++;
+    }
+  }
+  EXPECT_EQ(bad_orient, 0);
+  EXPECT_EQ(bad_incircle, 0);
+}
+
+template<typename T> void large_grid_test()
+{
+  /* Big enough for the divide and conquer step to split into separately built parts. */
+  constexpr int grid_size = 150;
+  CDT_input<T> in;
+  in.vert = Array<VecBase<T, 2>>(grid_size * grid_size);
+  for (const int y : IndexRange(grid_size)) {
+    for (const int x : IndexRange(grid_size)) {
+      in.vert[y * grid_size + x] = VecBase<T, 2>(T(x), T(y));
+    }
+  }
+  in.epsilon = T(0);
+  CDT_result<T> out = delaunay_2d_calc(in, CDT_FULL);
+  EXPECT_EQ(out.vert.size(), grid_size * grid_size);
+  EXPECT_EQ(out.face.size(), 2 * (grid_size - 1) * (grid_size - 1));
+  expect_delaunay(out);
+}
+
+template<typename T> void large_random_test()
+{
+  constexpr int points_num = 30000;
+  RNG *rng = BLI_rng_new(0);
+  CDT_input<T> in;
+  in.vert = Array<VecBase<T, 2>>(points_num);
+  for (const int i : IndexRange(points_num)) {
+    in.vert[i] = VecBase<T, 2>(T(BLI_rng_get_double(rng)), T(BLI_rng_get_double(rng)));
+  }
+  in.epsilon = T(0);
+  CDT_result<T> out = delaunay_2d_calc(in, CDT_FULL);
+  EXPECT_EQ(out.vert.size(), points_num);
+  /* Euler characteristic of a triangulated disk: V - E + F = 1. */
+  EXPECT_EQ(out.vert.size() - out.edge.size() + out.face.size(), 1);
+  expect_delaunay(out);
+  BLI_rng_free(rng);
+}
+
 TEST(delaunay_d, Empty)
 {
   empty_test<double>();
@@ -1592,6 +1732,21 @@ TEST(delaunay_d, SquareO)
   square_o_test<double>();
 }
 
+TEST(delaunay_d, Batch)
+{
+  batch_test<double>();
+}
+
+TEST(delaunay_d, LargeGrid)
+{
+  large_grid_test<double>();
+}
+
+TEST(delaunay_d, LargeRandom)
+{
+  large_random_test<double>();
+}
+
 #  ifdef WITH_GMP
 TEST(delaunay_m, Empty)
 {
@@ -1731,6 +1886,11 @@ TEST(delaunay_m, RepeatTri)
 {
   repeattri_test<mpq_class>();
 }
+
+TEST(delaunay_m, Batch)
+{
+  batch_test<mpq_class>();
+}
 #  endif
 #endif
 
@@ -2264,6 +2424,55 @@ TEST(delaunay_d, RandomTrisCircleB)
   rand_delaunay_test<double>(RANDOM_TRI_BETWEEN_CIRCLES, 1, 6, 1, 1e-4, CDT_FULL);
 }
 
+/* Many small independent inputs, like the glyphs of a text, triangulated one by one and with the
+ * batched API. */
+TEST(delaunay_d, BatchTiming)
+{
+  constexpr int inputs_num = 20000;
+  constexpr int poly_size = 64;
+  RNG *rng = BLI_rng_new(0);
+  Array<CDT_input<double>> inputs(inputs_num);
+  for (CDT_input<double> &in : inputs) {
+    in.vert = Array<double2>(poly_size);
+    in.face = Array<Vector<int>>(1);
+    for (const int i : IndexRange(poly_size)) {
+      const double angle = 2.0 * M_PI * i / poly_size;
+      const double radius = 1.0 + 0.3 * BLI_rng_get_double(rng);
+      in.vert[i] = double2(radius * cos(angle), radius * sin(angle));
+      in.face[0].append(i);
+    }
+    in.need_ids = false;
+  }
+  double tstart = BLI_time_now_seconds();
+  for (const CDT_input<double> &in : inputs) {
+    delaunay_2d_calc(in, CDT_INSIDE_WITH_HOLES);
+  }
+  std::cout << "serial: " << BLI_time_now_seconds() - tstart << "\n";
+  tstart = BLI_time_now_seconds();
+  delaunay_2d_calc(inputs.as_span(), CDT_INSIDE_WITH_HOLES);
+  std::cout << "batched: " << BLI_time_now_seconds() - tstart << "\n";
+  BLI_rng_free(rng);
+}
+
+/* A single large input, where the divide and conquer triangulation is split into parallel
+ * parts. */
+TEST(delaunay_d, LargeTiming)
+{
+  RNG *rng = BLI_rng_new(0);
+  for (const int points_num : {100000, 1000000}) {
+    CDT_input<double> in;
+    in.vert = Array<double2>(points_num);
+    for (double2 &co : in.vert) {
+      co = double2(BLI_rng_get_double(rng), BLI_rng_get_double(rng));
+    }
+    in.need_ids = false;
+    const double tstart = BLI_time_now_seconds();
+    delaunay_2d_calc(in, CDT_FULL);
+    std::cout << points_num << " points: " << BLI_time_now_seconds() - tstart << "\n";
+  }
+  BLI_rng_free(rng);
+}
+
 #  ifdef WITH_GMP
 TEST(delaunay_m, RandomPts)
 {
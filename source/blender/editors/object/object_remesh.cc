@@ -123,8 +123,11 @@ static int voxel_remesh_exec(bContext *C, wmOperator *op)
     isovalue = mesh->remesh_voxel_size * 0.3f;
   }
 
-  Mesh *new_mesh = BKE_mesh_remesh_voxel(
-      mesh, mesh->remesh_voxel_size, mesh->remesh_voxel_adaptivity, isovalue);
+  Mesh *new_mesh = BKE_mesh_remesh_voxel(mesh,
+                                         mesh->remesh_voxel_size,
+                                         mesh->remesh_voxel_adaptivity,
+                                         isovalue,
+                                         mesh->flag & ME_REMESH_FAST);
 
   if (!new_mesh) {
     BKE_report(op->reports, RPT_ERROR, "Voxel remesher failed to create mesh");
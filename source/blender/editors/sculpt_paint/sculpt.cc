@@ -5257,8 +5257,9 @@ void flush_update_step(bContext *C, UpdateType update_type)
       else {
         /* Drawing happens from the modifier stack evaluation result.
          * Tag both coordinates and normals as modified, as both needed for proper drawing and the
-         * modifier stack is not guaranteed to tag normals for update. */
-        mesh->tag_positions_changed();
+         * modifier stack is not guaranteed to tag normals for update. Only the normals around the
+         * vertices of changed nodes are recalculated. */
+        bke::pbvh::mesh_tag_positions_changed_partial(*ss.pbvh, *mesh);
       }
 
       mesh->bounds_set_eager(bke::pbvh::bounds_get(*ob.sculpt->pbvh));
@@ -939,6 +939,7 @@ static void restore_list(bContext *C, Depsgraph *depsgraph, StepData &step_data)
         return;
       }
 
+      Array<bool> modified_verts;
       if (use_multires_undo(step_data, ss)) {
         SubdivCCG &subdiv_ccg = *ss.subdiv_ccg;
         MutableSpan<CCGElem *> grids = subdiv_ccg.grids;
@@ -960,7 +961,8 @@ static void restore_list(bContext *C, Depsgraph *depsgraph, StepData &step_data)
         if (!restore_active_shape_key(*C, *depsgraph, step_data, object)) {
           return;
         }
-        Array<bool> modified_verts(ss.totvert, false);
+        modified_verts.reinitialize(ss.totvert);
+        modified_verts.fill(false);
         restore_position_mesh(object, step_data.nodes, modified_verts);
         bke::pbvh::search_callback(*ss.pbvh, {}, [&](bke::pbvh::Node &node) {
           if (indices_contain_true(modified_verts, bke::pbvh::node_verts(node))) {
@@ -971,7 +973,14 @@ static void restore_list(bContext *C, Depsgraph *depsgraph, StepData &step_data)
 
       if (tag_update) {
         Mesh &mesh = *static_cast<Mesh *>(object.data);
-        mesh.tag_positions_changed();
+        if (modified_verts.is_empty() || ss.shapekey_active) {
+          mesh.tag_positions_changed();
+        }
+        else {
+          /* Only recalculate normals around the restored vertices. */
+          IndexMaskMemory memory;
+          mesh.tag_positions_changed_partial(IndexMask::from_bools(modified_verts, memory));
+        }
         BKE_sculptsession_free_deformMats(&ss);
       }
       bke::pbvh::update_bounds(*depsgraph, object, *ss.pbvh);
@@ -27,9 +27,12 @@
 #include "BKE_global.hh"
 #include "BKE_sound.h"
 
+#include "BLT_translation.hh"
+
 #include "ED_anim_api.hh"
 #include "ED_markers.hh"
 #include "ED_mask.hh"
+#include "ED_screen.hh"
 #include "ED_sequencer.hh"
 #include "ED_space_api.hh"
 #include "ED_time_scrub_ui.hh"
@@ -1820,6 +1823,45 @@ static void draw_cache_view(const bContext *C)
   GPU_blend(GPU_BLEND_NONE);
 }
 
+/* Draw RAM cache counters in the bottom left corner of the region. */
+static void draw_cache_statistics(const bContext *C, ARegion *region)
+{
+  const Scene *scene = CTX_data_scene(C);
+  const SpaceSeq *sseq = CTX_wm_space_seq(C);
+
+  if ((sseq->flag & SEQ_SHOW_OVERLAY) == 0 || (sseq->cache_overlay.flag & SEQ_CACHE_SHOW) == 0 ||
+      (sseq->cache_overlay.flag & SEQ_CACHE_SHOW_STATISTICS) == 0)
+  {
+    return;
+  }
+
+  SeqCacheStatistics stats;
+  if (!SEQ_cache_statistics_get(scene, &stats)) {
+    return;
+  }
+
+  const int64_t lookups = stats.hits + stats.disk_hits + stats.misses;
+  const float hit_ratio = lookups ? float(stats.hits + stats.disk_hits) / float(lookups) : 0.0f;
+
+  char printable[256];
+  SNPRINTF(printable,
+           IFACE_("Cache hits: %.1f%% (disk: %lld), misses: %lld, recycled: %lld, shared: %lld"),
+           hit_ratio * 100.0f,
+           (long long)stats.disk_hits,
+           (long long)stats.misses,
+           (long long)stats.recycled_frames,
+           (long long)stats.shared_images);
+
+  const rcti *rect = ED_region_visible_rect(region);
+  const int font_id = BLF_set_default();
+  UI_FontThemeColor(font_id, TH_TEXT_HI);
+  BLF_draw_default(rect->xmin + U.widget_unit,
+                   rect->ymin + U.widget_unit,
+                   0.0f,
+                   printable,
+                   sizeof(printable));
+}
+
 /* Draw sequencer timeline. */
 static void draw_overlap_frame_indicator(const Scene *scene, const View2D *v2d)
 {
@@ -1947,6 +1989,7 @@ void draw_timeline_seq_display(const bContext *C, ARegion *region)
       draw_overlap_frame_indicator(scene, v2d);
     }
     UI_view2d_view_restore(C);
+    draw_cache_statistics(C, region);
   }
 
   ED_time_scrub_draw_current_frame(region, scene, !(sseq->flag & SEQ_DRAWFRAMES));
@@ -10,8 +10,10 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_fileops.h"
 #include "BLI_math_vector_types.hh"
 #include "BLI_rect.h"
+#include "BLI_string.h"
 
 #include "BKE_colortools.hh"
 #include "BKE_context.hh"
@@ -68,6 +70,11 @@ struct ImageSampleInfo {
   bool draw;
   bool color_manage;
   int use_default_view;
+
+  /** Reads the file of an image whose buffer couldn't be loaded, see #image_sample_tile_source. */
+  ImBufTileSource *tile_source;
+  char tile_source_filepath[FILE_MAX];
+  char tile_source_colorspace[IM_MAX_SPACE];
 };
 
 /** \} */
@@ -152,6 +159,95 @@ static void image_sample_rect_color_float(ImBuf *ibuf, const rcti *rect, float r
 /** \name Image Pixel Sample (Internal Utilities)
  * \{ */
 
+/** Absolute path of the file of an image tile, false for images that are not read from a file. */
+static bool image_sample_file_path(const Image *image,
+                                   const ImageUser *iuser,
+                                   const int tile,
+                                   char r_filepath[FILE_MAX])
+{
+  if (!ELEM(image->source, IMA_SRC_FILE, IMA_SRC_TILED) || BKE_image_has_packedfile(image)) {
+    return false;
+  }
+  ImageUser tile_user = *iuser;
+  tile_user.tile = tile;
+  BKE_image_user_file_path(&tile_user, image, r_filepath);
+  return true;
+}
+
+/**
+ * Huge images may fail to load as a whole, open their file for reading only the tiles that are
+ * sampled instead. The tile source is kept while the operator runs, returns null if the file
+ * can't be read in tiles.
+ */
+static ImBufTileSource *image_sample_tile_source(ImageSampleInfo *info,
+                                                 const Image *image,
+                                                 const ImageUser *iuser,
+                                                 const int tile)
+{
+  char filepath[FILE_MAX];
+  if (!image_sample_file_path(image, iuser, tile, filepath)) {
+    return nullptr;
+  }
+  /* Also don't try to open the same file again when it failed before. */
+  if (STREQ(info->tile_source_filepath, filepath)) {
+    return info->tile_source;
+  }
+
+  if (info->tile_source) {
+    IMB_tile_source_free(info->tile_source);
+  }
+  STRNCPY(info->tile_source_filepath, filepath);
+  STRNCPY(info->tile_source_colorspace, image->colorspace_settings.name);
+  info->tile_source = IMB_tile_source_open(filepath, IB_rect, info->tile_source_colorspace);
+  return info->tile_source;
+}
+
+static bool image_sample_apply_tile_source(ImageSampleInfo *info,
+                                           const Image *image,
+                                           const ImageUser *iuser,
+                                           const int tile,
+                                           const float uv[2])
+{
+  ImBufTileSource *source = image_sample_tile_source(info, image, iuser, tile);
+  if (source == nullptr) {
+    return false;
+  }
+
+  int width, height, tile_width, tile_height;
+  IMB_tile_source_level_size(source, 0, &width, &height, &tile_width, &tile_height);
+  const int x = int(uv[0] * width), y = int(uv[1] * height);
+  if (x < 0 || y < 0 || x >= width || y >= height) {
+    return false;
+  }
+
+  info->width = width;
+  info->height = height;
+  info->x = x;
+  info->y = y;
+
+  info->draw = true;
+  info->channels = 4;
+
+  info->colp = nullptr;
+  info->zp = nullptr;
+  info->zfp = nullptr;
+
+  info->use_default_view = (image->flag & IMA_VIEW_AS_RENDER) ? false : true;
+
+  /* Only the pixel under the cursor is read, a sample at whole pixel coordinates isn't
+   * interpolated. Unlike image buffers, tiles are not converted to scene linear on load. */
+  IMB_tile_source_sample_bilinear(source, 0, float(x), float(y), info->colf);
+  IMB_colormanagement_transform_v4(
+      info->colf,
+      info->tile_source_colorspace,
+      IMB_colormanagement_role_colorspace_name_get(COLOR_ROLE_SCENE_LINEAR));
+  copy_v4_v4(info->linearcol, info->colf);
+  info->colfp = info->colf;
+  info->color_manage = true;
+
+  return true;
+}
+
 static void image_sample_apply(bContext *C, wmOperator *op, const wmEvent *event)
 {
   SpaceImage *sima = CTX_wm_space_image(C);
@@ -170,7 +266,8 @@ static void image_sample_apply(bContext *C, wmOperator *op, const wmEvent *event
 
   if (ibuf == nullptr) {
     ED_space_image_release_buffer(sima, ibuf, lock);
-    info->draw = false;
+    info->draw = image && image_sample_apply_tile_source(info, image, &sima->iuser, tile, uv);
+    ED_area_tag_redraw(CTX_wm_area(C));
     return;
   }
 
@@ -441,6 +538,9 @@ void ED_imbuf_sample_exit(bContext *C, wmOperator *op)
 
   ED_region_draw_cb_exit(info->art, info->draw_handle);
   ED_area_tag_redraw(CTX_wm_area(C));
+  if (info->tile_source) {
+    IMB_tile_source_free(info->tile_source);
+  }
   MEM_freeN(info);
 }
 
@@ -458,7 +558,14 @@ int ED_imbuf_sample_invoke(bContext *C, wmOperator *op, const wmEvent *event)
           }
         }
         if (!ED_space_image_has_buffer(sima)) {
-          return OPERATOR_CANCELLED;
+          /* Files that fail to load as a whole can still be sampled in tiles. */
+          char filepath[FILE_MAX];
+          if (sima->image == nullptr ||
+              !image_sample_file_path(sima->image, &sima->iuser, 0, filepath) ||
+              !BLI_exists(filepath))
+          {
+            return OPERATOR_CANCELLED;
+          }
         }
         break;
       }
@@ -0,0 +1,53 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include "BLI_index_mask.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
+
+/** \file
+ * \ingroup geo
+ */
+
+namespace blender::geometry {
+
+/** The acceleration structure used to find points within the merge distance. */
+enum class MergeByDistanceSearch : int8_t {
+  /** Choose the grid for large inputs and the KD-tree otherwise. */
+  Auto = 0,
+  /** Balanced KD-tree with a range query for every point. */
+  KDTree = 1,
+  /** Uniform grid with a cell size of the merge distance, built with a parallel sort. */
+  Grid = 2,
+};
+
+/**
+ * Resolve #MergeByDistanceSearch::Auto and check whether the grid can be used at all. The grid
+ * needs a non-zero merge distance and a bounded number of cells along every axis.
+ */
+bool merge_by_distance_use_grid(MergeByDistanceSearch search,
+                                Span<float3> positions,
+                                const IndexMask &selection,
+                                float merge_distance);
+
+/**
+ * Grid based equivalent of #BLI_kdtree_3d_calc_duplicates_fast. Only the points in the
+ * \a selection are considered, the resulting indices are indices into \a positions.
+ *
+ * \param use_index_order: Loop over the points in index order, so the point with the lowest index
+ * of every cluster is used as merge target. Otherwise the points are visited in the (faster)
+ * spatial order of the grid.
+ * \param r_duplicates: Must be initialized to -1 for the selected points. Merged points are set
+ * to the index of their target, targets are set to their own index.
+ * \returns The number of merged points.
+ */
+int calc_duplicates_grid(Span<float3> positions,
+                         const IndexMask &selection,
+                         float merge_distance,
+                         bool use_index_order,
+                         MutableSpan<int> r_duplicates);
+
+}  // namespace blender::geometry
@@ -9,6 +9,8 @@
 #include "BLI_index_mask.hh"
 #include "BLI_span.hh"
 
+#include "GEO_merge_by_distance_grid.hh"
+
 struct Mesh;
 
 /** \file
@@ -24,9 +26,11 @@ namespace blender::geometry {
  * \returns #std::nullopt if the mesh should not be changed (no vertices are merged), in order to
  * avoid copying the input. Otherwise returns the new mesh with merged geometry.
  */
-std::optional<Mesh *> mesh_merge_by_distance_all(const Mesh &mesh,
-                                                 const IndexMask &selection,
-                                                 float merge_distance);
+std::optional<Mesh *> mesh_merge_by_distance_all(
+    const Mesh &mesh,
+    const IndexMask &selection,
+    float merge_distance,
+    MergeByDistanceSearch search = MergeByDistanceSearch::Auto);
 
 /**
  * Merge selected vertices along edges to other selected vertices. Only vertices connected by edges
@@ -6,6 +6,8 @@
 
 #include "BLI_index_mask.hh"
 
+#include "GEO_merge_by_distance_grid.hh"
+
 struct PointCloud;
 namespace blender::bke {
 class AnonymousAttributePropagationInfo;
@@ -25,6 +27,7 @@ PointCloud *point_merge_by_distance(
     const PointCloud &src_points,
     const float merge_distance,
     const IndexMask &selection,
-    const bke::AnonymousAttributePropagationInfo &propagation_info);
+    const bke::AnonymousAttributePropagationInfo &propagation_info,
+    MergeByDistanceSearch search = MergeByDistanceSearch::Auto);
 
 }  // namespace blender::geometry
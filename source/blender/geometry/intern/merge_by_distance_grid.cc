@@ -0,0 +1,293 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "BLI_array.hh"
+#include "BLI_bounds.hh"
+#include "BLI_math_vector.hh"
+#include "BLI_offset_indices.hh"
+#include "BLI_sort.hh"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
+
+#include "GEO_merge_by_distance_grid.hh"
+
+namespace blender::geometry {
+
+/* Below this number of points, building the balanced KD-tree is fast enough. */
+static constexpr int64_t auto_grid_min_points = 100000;
+
+/**
+ * Cell coordinates are packed into a 64 bit key with 21 bits per axis. Points outside of that
+ * range are clamped into the outermost cells. That is still correct, because distances are always
+ * checked explicitly, but it is slow when many points end up in the same cell.
+ */
+static constexpr int cell_coord_bits = 21;
+static constexpr int cell_coord_min = -(1 << (cell_coord_bits - 1));
+static constexpr int cell_coord_max = (1 << (cell_coord_bits - 1)) - 1;
+static constexpr uint64_t cell_coord_mask = (uint64_t(1) << cell_coord_bits) - 1;
+
+static int3 cell_coord_calc(const float3 &position, const double inv_cell_size)
+{
+  int3 cell;
+  for (const int axis : IndexRange(3)) {
+    const double value = std::floor(double(position[axis]) * inv_cell_size);
+    /* Written so that NaN coordinates end up in the first cell. */
+    cell[axis] = value >= cell_coord_min ? int(std::min(value, double(cell_coord_max))) :
+                                           cell_coord_min;
+  }
+  return cell;
+}
+
+static uint64_t cell_key_calc(const int3 &cell)
+{
+  return uint64_t(cell.x - cell_coord_min) |
+         (uint64_t(cell.y - cell_coord_min) << cell_coord_bits) |
+         (uint64_t(cell.z - cell_coord_min) << (cell_coord_bits * 2));
+}
+
+static int3 cell_coord_from_key(const uint64_t key)
+{
+  return int3(int(key & cell_coord_mask) + cell_coord_min,
+              int((key >> cell_coord_bits) & cell_coord_mask) + cell_coord_min,
+              int((key >> (cell_coord_bits * 2)) & cell_coord_mask) + cell_coord_min);
+}
+
+bool merge_by_distance_use_grid(const MergeByDistanceSearch search,
+                                const Span<float3> positions,
+                                const IndexMask &selection,
+                                const float merge_distance)
+{
+  /* The grid can't represent zero sized cells, the KD-tree handles exact duplicates. */
+  if (!(merge_distance > 0.0f)) {
+    return false;
+  }
+  switch (search) {
+    case MergeByDistanceSearch::KDTree:
+      return false;
+    case MergeByDistanceSearch::Grid:
+      return true;
+    case MergeByDistanceSearch::Auto:
+      break;
+  }
+  if (selection.size() < auto_grid_min_points) {
+    return false;
+  }
+  /* Fall back to the KD-tree when the points don't fit into the range of the cell coordinates. */
+  const std::optional<Bounds<float3>> bounds = bounds::min_max(positions);
+  const float max_coord = math::reduce_max(
+      math::max(math::abs(bounds->min), math::abs(bounds->max)));
+  return double(max_coord) / double(merge_distance) < double(cell_coord_max);
+}
+
+namespace {
+
+struct CellPoint {
+  uint64_t key;
+  int index;
+};
+
+struct MergeGrid {
+  /** Selected points sorted by cell, and by index within every cell. */
+  Array<CellPoint> points;
+  /** The sorted keys of all non-empty cells. */
+  Array<uint64_t> cell_keys;
+  /** The range of every cell in #points. */
+  Array<int> cell_offsets_data;
+
+  OffsetIndices<int> cell_offsets() const
+  {
+    return this->cell_offsets_data.as_span();
+  }
+};
+
+/**
+ * Finds the points in the 3x3x3 block of cells around a cell. Because X is stored in the lowest
+ * bits of the key, every row of three cells along the X axis is a contiguous range of the sorted
+ * cell keys, so only nine searches are necessary. When the center cells are visited in sorted
+ * order, all row positions only move forward, so they are searched for starting from the
+ * previous position rather than with a hash table lookup.
+ */
+class NeighborSearch {
+  const MergeGrid &grid_;
+  std::array<int64_t, 9> row_cursors_;
+
+ public:
+  NeighborSearch(const MergeGrid &grid) : grid_(grid)
+  {
+    row_cursors_.fill(0);
+  }
+
+  template<typename Fn> void foreach_neighbor(const int3 &cell, const Fn &fn)
+  {
+    const Span<uint64_t> keys = grid_.cell_keys;
+    const OffsetIndices<int> offsets = grid_.cell_offsets();
+    const int x_min = std::max(cell.x - 1, cell_coord_min);
+    const int x_max = std::min(cell.x + 1, cell_coord_max);
+    int row = 0;
+    for (int z = cell.z - 1; z <= cell.z + 1; z++) {
+      for (int y = cell.y - 1; y <= cell.y + 1; y++, row++) {
+        if (std::min(y, z) < cell_coord_min || std::max(y, z) > cell_coord_max) {
+          continue;
+        }
+        const uint64_t first_key = cell_key_calc(int3(x_min, y, z));
+        const uint64_t last_key = cell_key_calc(int3(x_max, y, z));
+        const int64_t first = advance_to(keys, row_cursors_[row], first_key);
+        row_cursors_[row] = first;
+        int64_t last = first;
+        while (last < keys.size() && keys[last] <= last_key) {
+          last++;
+        }
+        if (last > first) {
+          const IndexRange cells(first, last - first);
+          fn(grid_.points.as_span().slice(offsets[cells]));
+        }
+      }
+    }
+  }
+
+  /** Start from the beginning again, for center cells that aren't visited in sorted order. */
+  void reset()
+  {
+    row_cursors_.fill(0);
+  }
+
+ private:
+  static int64_t advance_to(const Span<uint64_t> keys, int64_t cursor, const uint64_t key)
+  {
+    /* The row is usually close to its position for the previous cell. */
+    for (const int64_t end = std::min(cursor + 8, keys.size()); cursor < end; cursor++) {
+      if (keys[cursor] >= key) {
+        return cursor;
+      }
+    }
+    return std::lower_bound(keys.begin() + cursor, keys.end(), key) - keys.begin();
+  }
+};
+
+}  // namespace
+
+static MergeGrid build_grid(const Span<float3> positions,
+                            const IndexMask &selection,
+                            const double inv_cell_size)
+{
+  MergeGrid grid;
+  grid.points.reinitialize(selection.size());
+  selection.foreach_index_optimized<int>(GrainSize(4096), [&](const int i, const int pos) {
+    grid.points[pos] = {cell_key_calc(cell_coord_calc(positions[i], inv_cell_size)), i};
+  });
+  parallel_sort(grid.points.begin(),
+                grid.points.end(),
+                [](const CellPoint &a, const CellPoint &b) {
+                  return a.key < b.key || (a.key == b.key && a.index < b.index);
+                });
+
+  Vector<uint64_t> cell_keys;
+  Vector<int> offsets;
+  for (const int pos : grid.points.index_range()) {
+    if (pos == 0 || grid.points[pos].key != grid.points[pos - 1].key) {
+      cell_keys.append(grid.points[pos].key);
+      offsets.append(pos);
+    }
+  }
+  offsets.append(grid.points.size());
+  grid.cell_keys = cell_keys.as_span();
+  grid.cell_offsets_data = offsets.as_span();
+  return grid;
+}
+
+int calc_duplicates_grid(const Span<float3> positions,
+                         const IndexMask &selection,
+                         const float merge_distance,
+                         const bool use_index_order,
+                         MutableSpan<int> r_duplicates)
+{
+  BLI_assert(merge_distance > 0.0f);
+  BLI_assert(r_duplicates.size() == positions.size());
+  if (selection.is_empty()) {
+    return 0;
+  }
+
+  /* Use slightly larger cells, so that rounding can't put two points within the merge distance
+   * more than one cell apart. */
+  const double inv_cell_size = 1.0 / (double(merge_distance) * (1.0 + 1e-6));
+  const float distance_sq = merge_distance * merge_distance;
+  const MergeGrid grid = build_grid(positions, selection, inv_cell_size);
+  const OffsetIndices<int> cell_offsets = grid.cell_offsets();
+
+  /* Most points of typical inputs have no other point within the merge distance. Find the points
+   * that do in parallel, so that the order dependent merging below only has to look at those. */
+  Array<bool> has_neighbor(positions.size(), false);
+  threading::parallel_for(cell_offsets.index_range(), 1024, [&](const IndexRange range) {
+    NeighborSearch search(grid);
+    Vector<Span<CellPoint>, 9> neighbor_rows;
+    for (const int cell_index : range) {
+      neighbor_rows.clear();
+      search.foreach_neighbor(cell_coord_from_key(grid.cell_keys[cell_index]),
+                              [&](const Span<CellPoint> row) { neighbor_rows.append(row); });
+      for (const CellPoint &point : grid.points.as_span().slice(cell_offsets[cell_index])) {
+        const float3 &position = positions[point.index];
+        has_neighbor[point.index] = std::any_of(
+            neighbor_rows.begin(), neighbor_rows.end(), [&](const Span<CellPoint> row) {
+              return std::any_of(row.begin(), row.end(), [&](const CellPoint &neighbor) {
+                return neighbor.index != point.index &&
+                       math::distance_squared(position, positions[neighbor.index]) <=
+                           distance_sq;
+              });
+            });
+      }
+    }
+  });
+
+  /* Same logic as #BLI_kdtree_3d_calc_duplicates_fast: every point that wasn't merged yet takes
+   * all other unmerged points within the merge distance. */
+  int duplicates_num = 0;
+  NeighborSearch search(grid);
+  auto merge_neighbors = [&](const int index, const int3 &cell) {
+    if (!has_neighbor[index] || !ELEM(r_duplicates[index], -1, index)) {
+      return;
+    }
+    const float3 &position = positions[index];
+    int found = 0;
+    search.foreach_neighbor(cell, [&](const Span<CellPoint> row) {
+      for (const CellPoint &neighbor : row) {
+        if (neighbor.index == index || r_duplicates[neighbor.index] != -1) {
+          continue;
+        }
+        if (math::distance_squared(position, positions[neighbor.index]) <= distance_sq) {
+          r_duplicates[neighbor.index] = index;
+          found++;
+        }
+      }
+    });
+    if (found > 0) {
+      r_duplicates[index] = index;
+      duplicates_num += found;
+    }
+  };
+
+  if (use_index_order) {
+    selection.foreach_index([&](const int i) {
+      if (has_neighbor[i]) {
+        search.reset();
+        merge_neighbors(i, cell_coord_calc(positions[i], inv_cell_size));
+      }
+    });
+  }
+  else {
+    for (const int cell_index : cell_offsets.index_range()) {
+      const int3 cell = cell_coord_from_key(grid.cell_keys[cell_index]);
+      for (const CellPoint &point : grid.points.as_span().slice(cell_offsets[cell_index])) {
+        merge_neighbors(point.index, cell);
+      }
+    }
+  }
+
+  return duplicates_num;
+}
+
+}  // namespace blender::geometry
@@ -526,17 +526,11 @@ void split_edges(Mesh &mesh,
 
   const GroupedSpan<int> vert_to_corner_map = mesh.vert_to_corner_map();
 
-  Array<int> edge_to_corner_offsets;
-  Array<int> edge_to_corner_indices;
-  const GroupedSpan<int> edge_to_corner_map = bke::mesh::build_edge_to_corner_map(
-      mesh.corner_edges(), orig_edges.size(), edge_to_corner_offsets, edge_to_corner_indices);
+  const GroupedSpan<int> edge_to_corner_map = mesh.edge_to_corner_map();
 
-  Array<int> vert_to_edge_offsets;
-  Array<int> vert_to_edge_indices;
   GroupedSpan<int> vert_to_edge_map;
   if (loose_edges.count > 0) {
-    vert_to_edge_map = bke::mesh::build_vert_to_edge_map(
-        orig_edges, orig_verts_num, vert_to_edge_offsets, vert_to_edge_indices);
+    vert_to_edge_map = mesh.vert_to_edge_map();
   }
 
   const Array<int> corner_to_face_map = mesh.corner_to_face_map();
@@ -20,46 +20,62 @@ namespace blender::geometry {
 PointCloud *point_merge_by_distance(const PointCloud &src_points,
                                     const float merge_distance,
                                     const IndexMask &selection,
-                                    const bke::AnonymousAttributePropagationInfo &propagation_info)
+                                    const bke::AnonymousAttributePropagationInfo &propagation_info,
+                                    const MergeByDistanceSearch search)
 {
   const bke::AttributeAccessor src_attributes = src_points.attributes();
   const Span<float3> positions = src_points.positions();
   const int src_size = positions.size();
 
-  /* Create the KD tree based on only the selected points, to speed up merge detection and
-   * balancing. */
-  KDTree_3d *tree = BLI_kdtree_3d_new(selection.size());
-  selection.foreach_index_optimized<int64_t>(
-      [&](const int64_t i, const int64_t pos) { BLI_kdtree_3d_insert(tree, pos, positions[i]); });
-  BLI_kdtree_3d_balance(tree);
-
-  /* Find the duplicates in the KD tree. Because the tree only contains the selected points, the
-   * resulting indices are indices into the selection, rather than indices of the source point
-   * cloud. */
-  Array<int> selection_merge_indices(selection.size(), -1);
-  const int duplicate_count = BLI_kdtree_3d_calc_duplicates_fast(
-      tree, merge_distance, false, selection_merge_indices.data());
-  BLI_kdtree_3d_free(tree);
+  /* By default, every point is just "merged" with itself. Then fill in the results of the merge
+   * finding. */
+  Array<int> merge_indices(src_size);
+  array_utils::fill_index_range<int>(merge_indices);
+
+  int duplicate_count;
+  if (merge_by_distance_use_grid(search, positions, selection, merge_distance)) {
+    /* The grid works with indices of the source point cloud directly. */
+    Array<int> duplicates(src_size, -1);
+    duplicate_count = calc_duplicates_grid(
+        positions, selection, merge_distance, false, duplicates);
+    selection.foreach_index(GrainSize(4096), [&](const int src_index) {
+      if (duplicates[src_index] != -1) {
+        merge_indices[src_index] = duplicates[src_index];
+      }
+    });
+  }
+  else {
+    /* Create the KD tree based on only the selected points, to speed up merge detection and
+     * balancing. */
+    KDTree_3d *tree = BLI_kdtree_3d_new(selection.size());
+    selection.foreach_index_optimized<int64_t>([&](const int64_t i, const int64_t pos) {
+      BLI_kdtree_3d_insert(tree, pos, positions[i]);
+    });
+    BLI_kdtree_3d_balance(tree);
+
+    /* Find the duplicates in the KD tree. Because the tree only contains the selected points,
+     * the resulting indices are indices into the selection, rather than indices of the source
+     * point cloud. */
+    Array<int> selection_merge_indices(selection.size(), -1);
+    duplicate_count = BLI_kdtree_3d_calc_duplicates_fast(
+        tree, merge_distance, false, selection_merge_indices.data());
+    BLI_kdtree_3d_free(tree);
+
+    /* Convert from indices into the selection to indices into the full input point cloud. */
+    selection.foreach_index([&](const int src_index, const int pos) {
+      const int merge_index = selection_merge_indices[pos];
+      if (merge_index != -1) {
+        const int src_merge_index = selection[merge_index];
+        merge_indices[src_index] = src_merge_index;
+      }
+    });
+  }
 
   /* Create the new point cloud and add it to a temporary component for the attribute API. */
   const int dst_size = src_size - duplicate_count;
   PointCloud *dst_pointcloud = BKE_pointcloud_new_nomain(dst_size);
   bke::MutableAttributeAccessor dst_attributes = dst_pointcloud->attributes_for_write();
 
-  /* By default, every point is just "merged" with itself. Then fill in the results of the merge
-   * finding, converting from indices into the selection to indices into the full input point
-   * cloud. */
-  Array<int> merge_indices(src_size);
-  array_utils::fill_index_range<int>(merge_indices);
-
-  selection.foreach_index([&](const int src_index, const int pos) {
-    const int merge_index = selection_merge_indices[pos];
-    if (merge_index != -1) {
-      const int src_merge_index = selection[merge_index];
-      merge_indices[src_index] = src_merge_index;
-    }
-  });
-
   /* For every source index, find the corresponding index in the result by iterating through the
    * source indices and counting how many merges happened before that point. */
   int merged_points = 0;
@@ -0,0 +1,175 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "BLI_array.hh"
+#include "BLI_kdtree.h"
+#include "BLI_math_vector.hh"
+#include "BLI_rand.hh"
+#include "BLI_vector.hh"
+
+#include "GEO_merge_by_distance_grid.hh"
+
+#include "testing/testing.h"
+
+/* Set to 1 to compare the performance of the grid and the KD-tree. */
+#define DO_PERF_TESTS 0
+
+#if DO_PERF_TESTS
+#  include "BLI_timeit.hh"
+#endif
+
+namespace blender::geometry::tests {
+
+static Array<float3> random_positions(const int size, const float extent, const int seed)
+{
+  RandomNumberGenerator rng(seed);
+  Array<float3> positions(size);
+  for (float3 &position : positions) {
+    position = float3(rng.get_float(), rng.get_float(), rng.get_float()) * extent;
+  }
+  return positions;
+}
+
+static int calc_duplicates_kdtree(const Span<float3> positions,
+                                  const IndexMask &selection,
+                                  const float merge_distance,
+                                  MutableSpan<int> r_duplicates)
+{
+  KDTree_3d *tree = BLI_kdtree_3d_new(selection.size());
+  selection.foreach_index([&](const int i) { BLI_kdtree_3d_insert(tree, i, positions[i]); });
+  BLI_kdtree_3d_balance(tree);
+  const int duplicates_num = BLI_kdtree_3d_calc_duplicates_fast(
+      tree, merge_distance, true, r_duplicates.data());
+  BLI_kdtree_3d_free(tree);
+  return duplicates_num;
+}
+
+/** Check the invariants of the merge result that don't depend on the iteration order. */
+static void expect_valid_duplicates(const Span<float3> positions,
+                                    const Span<int> duplicates,
+                                    const float merge_distance)
+{
+  Vector<int> kept;
+  for (const int i : duplicates.index_range()) {
+    const int target = duplicates[i];
+    if (ELEM(target, -1, i)) {
+      kept.append(i);
+      continue;
+    }
+    /* Merged points are close to their target, and the target isn't merged itself. */
+    EXPECT_EQ(duplicates[target], target);
+    EXPECT_LE(math::distance(positions[i], positions[target]), merge_distance * 1.0001f);
+  }
+  /* No two remaining points are within the merge distance. */
+  for (const int i : kept.index_range()) {
+    for (const int j : kept.index_range().drop_front(i + 1)) {
+      EXPECT_GT(math::distance(positions[kept[i]], positions[kept[j]]), merge_distance);
+    }
+  }
+}
+
+TEST(merge_by_distance_grid, MatchesKDTree)
+{
+  const Array<float3> positions = random_positions(2000, 10.0f, 0);
+  const IndexMask selection(positions.size());
+  for (const float merge_distance : {0.2f, 0.5f, 1.0f}) {
+    Array<int> duplicates_kdtree(positions.size(), -1);
+    Array<int> duplicates_grid(positions.size(), -1);
+    const int kdtree_num = calc_duplicates_kdtree(
+        positions, selection, merge_distance, duplicates_kdtree);
+    const int grid_num = calc_duplicates_grid(
+        positions, selection, merge_distance, true, duplicates_grid);
+    EXPECT_GT(grid_num, 0);
+    EXPECT_EQ(kdtree_num, grid_num);
+    EXPECT_EQ_ARRAY(duplicates_kdtree.data(), duplicates_grid.data(), positions.size());
+  }
+}
+
+TEST(merge_by_distance_grid, SpatialOrder)
+{
+  const Array<float3> positions = random_positions(1000, 5.0f, 1);
+  Array<int> duplicates(positions.size(), -1);
+  const int duplicates_num = calc_duplicates_grid(
+      positions, IndexMask(positions.size()), 0.4f, false, duplicates);
+  EXPECT_GT(duplicates_num, 0);
+  int merged_num = 0;
+  for (const int i : duplicates.index_range()) {
+    merged_num += !ELEM(duplicates[i], -1, i);
+  }
+  EXPECT_EQ(duplicates_num, merged_num);
+  expect_valid_duplicates(positions, duplicates, 0.4f);
+}
+
+TEST(merge_by_distance_grid, Selection)
+{
+  /* Points on a line, only every other point is selected. */
+  Array<float3> positions(10);
+  for (const int i : positions.index_range()) {
+    positions[i] = float3(i * 0.5f, 0.0f, 0.0f);
+  }
+  IndexMaskMemory memory;
+  const IndexMask selection = IndexMask::from_predicate(
+      positions.index_range(), GrainSize(1), memory, [](const int i) { return i % 2 == 0; });
+
+  Array<int> duplicates(positions.size(), -1);
+  EXPECT_EQ(calc_duplicates_grid(positions, selection, 0.6f, true, duplicates), 0);
+
+  duplicates.fill(-1);
+  EXPECT_EQ(calc_duplicates_grid(positions, selection, 1.0f, true, duplicates), 2);
+  EXPECT_EQ_ARRAY(duplicates.data(),
+                  Span<int>({0, -1, 0, -1, 4, -1, 4, -1, -1, -1}).data(),
+                  positions.size());
+}
+
+TEST(merge_by_distance_grid, LargeCoordinates)
+{
+  /* Coordinates outside of the range of the cell keys are clamped into the outer cells. */
+  const Array<float3> positions = {
+      {1e9f, 0.0f, 0.0f}, {1e9f, 0.0f, 0.0f}, {-1e9f, 5.0f, 0.0f}, {2e9f, 0.0f, 0.0f}};
+  Array<int> duplicates(positions.size(), -1);
+  EXPECT_EQ(calc_duplicates_grid(positions, IndexMask(positions.size()), 0.1f, true, duplicates),
+            1);
+  EXPECT_EQ_ARRAY(duplicates.data(), Span<int>({0, 0, -1, -1}).data(), positions.size());
+}
+
+TEST(merge_by_distance_grid, UseGrid)
+{
+  const Array<float3> positions = random_positions(200000, 1.0f, 2);
+  const IndexMask selection(positions.size());
+  EXPECT_TRUE(
+      merge_by_distance_use_grid(MergeByDistanceSearch::Auto, positions, selection, 1e-4f));
+  EXPECT_FALSE(
+      merge_by_distance_use_grid(MergeByDistanceSearch::Auto, positions, selection, 0.0f));
+  EXPECT_FALSE(
+      merge_by_distance_use_grid(MergeByDistanceSearch::KDTree, positions, selection, 1e-4f));
+  EXPECT_FALSE(merge_by_distance_use_grid(
+      MergeByDistanceSearch::Auto, positions, selection.slice(0, 100), 1e-4f));
+  EXPECT_TRUE(merge_by_distance_use_grid(
+      MergeByDistanceSearch::Grid, positions, selection.slice(0, 100), 1e-4f));
+}
+
+#if DO_PERF_TESTS
+
+TEST(merge_by_distance_grid, Performance)
+{
+  /* Similar to a dense scan, where most points have a few neighbors within the distance. */
+  const Array<float3> positions = random_positions(20'000'000, 100.0f, 3);
+  const IndexMask selection(positions.size());
+  for ([[maybe_unused]] const int i : IndexRange(3)) {
+    Array<int> duplicates(positions.size(), -1);
+    {
+      SCOPED_TIMER_AVERAGED("kdtree");
+      calc_duplicates_kdtree(positions, selection, 0.1f, duplicates);
+    }
+    duplicates.fill(-1);
+    {
+      SCOPED_TIMER_AVERAGED("grid");
+      calc_duplicates_grid(positions, selection, 0.1f, true, duplicates);
+    }
+  }
+}
+
+#endif
+
+}  // namespace blender::geometry::tests
@@ -73,10 +73,60 @@ ImBuf *IMB_testiffname(const char *filepath, int flags);
 
 ImBuf *IMB_loadiffname(const char *filepath, int flags, char colorspace[IM_MAX_SPACE]);
 
+/**
+ * Load an image for a thumbnail of at most \a max_thumb_size. Images with MIP levels, like
+ * texture files, are read from the smallest level that is still large enough.
+ */
 ImBuf *IMB_thumb_load_image(const char *filepath,
                             const size_t max_thumb_size,
                             char colorspace[IM_MAX_SPACE]);
 
+/**
+ * Tiled image reading.
+ *
+ * Reads parts of large images on demand instead of decoding the whole image into one #ImBuf.
+ * Scan-line and tiled files are supported, only the scan-lines or tiles that are needed get
+ * decoded. Tiles are stored in the movie cache, so the least recently used ones are freed when
+ * the memory cache limit is reached.
+ */
+struct ImBufTileSource;
+
+/**
+ * Open an image file for reading tiles, only the header is read.
+ * Returns null if the file can't be read in tiles, the whole image has to be loaded instead.
+ *
+ * \param flags: Same as for #IMB_loadiffname, for the color space and alpha mode of the tiles.
+ */
+ImBufTileSource *IMB_tile_source_open(const char *filepath,
+                                      int flags,
+                                      char colorspace[IM_MAX_SPACE]);
+void IMB_tile_source_free(ImBufTileSource *source);
+
+/** Number of MIP levels stored in the file, at least one. */
+int IMB_tile_source_levels_num(const ImBufTileSource *source);
+/** Size of a MIP level and its tiles, tiles in the bottom row and last column can be smaller. */
+void IMB_tile_source_level_size(const ImBufTileSource *source,
+                                int level,
+                                int *r_width,
+                                int *r_height,
+                                int *r_tile_width,
+                                int *r_tile_height);
+
+/**
+ * Get a tile of a MIP level, counted from the bottom left like the pixels of an #ImBuf. The tile
+ * has the same buffers, color space and alpha mode as loading the whole image would give.
+ * Thread safe, returns null if reading failed. Release the tile with #IMB_freeImBuf.
+ */
+ImBuf *IMB_tile_source_acquire_tile(ImBufTileSource *source, int level, int tile_x, int tile_y);
+
+/**
+ * Bilinear sample of a MIP level at pixel coordinates, with the same conventions as
+ * #blender::imbuf::interpolate_bilinear_fl. Byte images are returned as floats without color
+ * space conversion. Thread safe.
+ */
+void IMB_tile_source_sample_bilinear(
+    ImBufTileSource *source, int level, float u, float v, float r_color[4]);
+
 void IMB_freeImBuf(ImBuf *ibuf);
 
 ImBuf *IMB_allocImBuf(unsigned int x, unsigned int y, unsigned char planes, unsigned int flags);
@@ -348,6 +398,19 @@ void IMB_close_anim(ImBufAnim *anim);
 void IMB_close_anim_proxies(ImBufAnim *anim);
 bool IMB_anim_can_produce_frames(const ImBufAnim *anim);
 
+/**
+ * When frames are requested one after another, decode up to \a frames_num following frames in
+ * the same direction in the background, while the caller is busy with the current frame.
+ * All movies share one task pool, so multiple movies played back at once are decoded in parallel
+ * without a thread per movie. Zero disables decoding ahead, which is the default.
+ */
+void IMB_anim_set_decode_ahead(ImBufAnim *anim, int frames_num);
+/**
+ * Don't decode frames ahead while more than \a limit bytes of memory are in use, so that frames
+ * decoded ahead are charged to the same budget as the caches of the caller. Zero means no limit.
+ */
+void IMB_anim_decode_ahead_memory_limit_set(size_t limit);
+
 int IMB_anim_get_image_width(ImBufAnim *anim);
 int IMB_anim_get_image_height(ImBufAnim *anim);
 bool IMB_get_gop_decode_time(ImBufAnim *anim);
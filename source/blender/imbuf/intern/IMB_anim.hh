@@ -19,6 +19,7 @@ struct AVCodec;
 struct AVFrame;
 struct AVPacket;
 struct SwsContext;
+struct AnimDecodeAhead;
 #endif
 
 struct IDProperty;
@@ -59,8 +60,14 @@ struct ImBufAnim {
   AVPacket *cur_packet;
 
   bool seek_before_decode;
+
+  /** Frames decoded ahead of playback, created on demand. */
+  AnimDecodeAhead *decode_ahead;
 #endif
 
+  /** Number of frames to decode ahead in playback direction, see #IMB_anim_set_decode_ahead. */
+  int decode_ahead_frames;
+
   char index_dir[768];
 
   int proxies_tried;
@@ -75,3 +82,9 @@ struct ImBufAnim {
 
   IDProperty *metadata;
 };
+
+/**
+ * Stop decoding frames ahead of playback and free the frames that were decoded already.
+ * Must be called before changing state that the decoding task uses, like the time-code indices.
+ */
+void imb_anim_decode_ahead_clear(ImBufAnim *anim);
@@ -6,11 +6,13 @@
  * \ingroup imbuf
  */
 
+#include <atomic>
 #include <cctype>
 #include <climits>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <mutex>
 #include <sys/types.h>
 #ifndef _WIN32
 #  include <dirent.h>
@@ -20,8 +22,10 @@
 
 #include "BLI_path_util.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
 
 #include "DNA_scene_types.h"
 
@@ -1088,7 +1092,7 @@ static bool ffmpeg_must_seek(ImBufAnim *anim, int position)
   return must_seek;
 }
 
-static ImBuf *ffmpeg_fetchibuf(ImBufAnim *anim, int position, IMB_Timecode_Type tc)
+static ImBuf *ffmpeg_fetchibuf(ImBufAnim *anim, int position, ImBufAnimIndex *tc_index)
 {
   if (anim == nullptr) {
     return nullptr;
@@ -1096,7 +1100,6 @@ static ImBuf *ffmpeg_fetchibuf(ImBufAnim *anim, int position, IMB_Timecode_Type
 
   av_log(anim->pFormatCtx, AV_LOG_DEBUG, "FETCH: seek_pos=%d\n", position);
 
-  ImBufAnimIndex *tc_index = IMB_anim_open_index(anim, tc);
   int64_t pts_to_search = ffmpeg_get_pts_to_search(anim, tc_index, position);
   AVStream *v_st = anim->pFormatCtx->streams[anim->videoStream];
   double frame_rate = av_q2d(v_st->r_frame_rate);
@@ -1157,12 +1160,213 @@ static ImBuf *ffmpeg_fetchibuf(ImBufAnim *anim, int position, IMB_Timecode_Type
   return cur_frame_final;
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Decode Ahead
+ *
+ * During playback the next frames are decoded in the background while the caller processes the
+ * current one. Every movie has its own task pool, so movies are decoded in parallel and stopping
+ * the decoding of one movie never waits for another. With TBB the pools share its scheduler, so
+ * the number of decoding threads doesn't grow with the number of open movies. The decoding
+ * state of a movie is only used by its task while it runs, the task is stopped before decoding
+ * anything else on the calling thread.
+ *
+ * Decoded frames are allocated like any other image buffer, so they count towards the memory in
+ * use that the sequencer cache limit is checked against. No frames are decoded ahead while that
+ * limit is exceeded, see #IMB_anim_decode_ahead_memory_limit_set.
+ * \{ */
+
+struct AnimDecodedFrame {
+  int position;
+  ImBuf *ibuf;
+};
+
+struct AnimDecodeAhead {
+  /** Only changed while the task isn't running. */
+  ImBufAnimIndex *tc_index = nullptr;
+  IMB_Timecode_Type tc = IMB_TC_NONE;
+  int last_position = -1;
+
+  /** Runs the decoding task of this movie, created on first use. */
+  TaskPool *pool = nullptr;
+
+  /** Protects the members below, which are shared with the task. */
+  std::mutex mutex;
+  blender::Vector<AnimDecodedFrame> frames;
+  int next_position = 0;
+  int step = 0;
+  /** The task is queued or running. */
+  bool is_running = false;
+  /** Stop the task after the frame it is currently decoding. */
+  bool cancel = false;
+};
+
+/** Memory in use above which no frames are decoded ahead, zero for no limit. */
+static std::atomic<size_t> g_decode_ahead_memory_limit = 0;
+
+static bool anim_decode_ahead_memory_exceeded()
+{
+  const size_t memory_limit = g_decode_ahead_memory_limit;
+  return memory_limit != 0 && MEM_get_memory_in_use() >= memory_limit;
+}
+
+static void anim_decode_ahead_task(TaskPool *__restrict pool, void *taskdata)
+{
+  ImBufAnim *anim = static_cast<ImBufAnim *>(taskdata);
+  AnimDecodeAhead &decode = *anim->decode_ahead;
+
+  while (true) {
+    int position;
+    {
+      std::scoped_lock lock(decode.mutex);
+      if (decode.cancel || BLI_task_pool_current_canceled(pool) ||
+          decode.frames.size() >= anim->decode_ahead_frames || decode.next_position < 0 ||
+          decode.next_position >= anim->duration_in_frames || anim_decode_ahead_memory_exceeded())
+      {
+        decode.is_running = false;
+        return;
+      }
+      position = decode.next_position;
+    }
+
+    ImBuf *ibuf = ffmpeg_fetchibuf(anim, position, decode.tc_index);
+
+    std::scoped_lock lock(decode.mutex);
+    decode.frames.append({position, ibuf});
+    decode.next_position += decode.step;
+  }
+}
+
+/** Take the frame at \a position if it was decoded already, skipped frames are freed. */
+static ImBuf *anim_decode_ahead_take_frame(AnimDecodeAhead &decode,
+                                           int position,
+                                           IMB_Timecode_Type tc)
+{
+  std::scoped_lock lock(decode.mutex);
+  if (tc != decode.tc) {
+    return nullptr;
+  }
+  for (const int i : decode.frames.index_range()) {
+    if (decode.frames[i].position != position) {
+      continue;
+    }
+    ImBuf *ibuf = decode.frames[i].ibuf;
+    for (const int skipped : decode.frames.index_range().take_front(i)) {
+      IMB_freeImBuf(decode.frames[skipped].ibuf);
+    }
+    decode.frames.remove(0, i + 1);
+    return ibuf;
+  }
+  return nullptr;
+}
+
+static void anim_decode_ahead_start(ImBufAnim *anim)
+{
+  AnimDecodeAhead &decode = *anim->decode_ahead;
+  if (decode.pool == nullptr) {
+    /* Uses TBB when available. Otherwise, and when running single threaded, the pool gets its own
+     * background thread, so that decoding never runs on the calling thread. */
+    decode.pool = BLI_task_pool_create_background(nullptr, TASK_PRIORITY_HIGH);
+  }
+  BLI_task_pool_push(decode.pool, anim_decode_ahead_task, anim, false, nullptr);
+}
+
+/**
+ * Stop the task of the movie. A task which is still queued is canceled without running, a running
+ * task stops after the frame it is decoding. Tasks of other movies keep running.
+ */
+static void anim_decode_ahead_stop(AnimDecodeAhead &decode)
+{
+  {
+    std::scoped_lock lock(decode.mutex);
+    if (!decode.is_running) {
+      return;
+    }
+    decode.cancel = true;
+  }
+
+  BLI_task_pool_cancel(decode.pool);
+
+  std::scoped_lock lock(decode.mutex);
+  decode.is_running = false;
+  decode.cancel = false;
+}
+
+void imb_anim_decode_ahead_clear(ImBufAnim *anim)
+{
+  if (anim->decode_ahead == nullptr) {
+    return;
+  }
+  AnimDecodeAhead &decode = *anim->decode_ahead;
+  anim_decode_ahead_stop(decode);
+  for (const AnimDecodedFrame &frame : decode.frames) {
+    IMB_freeImBuf(frame.ibuf);
+  }
+  decode.frames.clear();
+  decode.tc_index = nullptr;
+  decode.last_position = -1;
+}
+
+static ImBuf *anim_decode_ahead_fetchibuf(ImBufAnim *anim, int position, IMB_Timecode_Type tc)
+{
+  if (anim->decode_ahead == nullptr) {
+    anim->decode_ahead = MEM_new<AnimDecodeAhead>(__func__);
+  }
+  AnimDecodeAhead &decode = *anim->decode_ahead;
+  const int step = position - decode.last_position;
+
+  ImBuf *ibuf = anim_decode_ahead_take_frame(decode, position, tc);
+  if (ibuf == nullptr) {
+    /* The task may be decoding the requested frame right now. */
+    anim_decode_ahead_stop(decode);
+    ibuf = anim_decode_ahead_take_frame(decode, position, tc);
+  }
+  if (ibuf == nullptr) {
+    imb_anim_decode_ahead_clear(anim);
+    decode.tc = tc;
+    decode.tc_index = IMB_anim_open_index(anim, tc);
+    ibuf = ffmpeg_fetchibuf(anim, position, decode.tc_index);
+  }
+  decode.last_position = position;
+
+  /* Only decode ahead for playback, not when jumping around. Steps larger than one happen when
+   * the frame rate of the movie is higher than the one of the scene. */
+  if (step == 0 || std::abs(step) > anim->decode_ahead_frames) {
+    return ibuf;
+  }
+  if (anim_decode_ahead_memory_exceeded()) {
+    return ibuf;
+  }
+
+  std::scoped_lock lock(decode.mutex);
+  if (!decode.is_running) {
+    decode.step = step;
+    decode.next_position = (decode.frames.is_empty() ? position : decode.frames.last().position) +
+                           step;
+    decode.is_running = true;
+    anim_decode_ahead_start(anim);
+  }
+  return ibuf;
+}
+
+/** \} */
+
 static void free_anim_ffmpeg(ImBufAnim *anim)
 {
   if (anim == nullptr) {
     return;
   }
 
+  if (anim->decode_ahead) {
+    imb_anim_decode_ahead_clear(anim);
+    if (anim->decode_ahead->pool) {
+      /* The stopped task may still be returning. */
+      BLI_task_pool_work_and_wait(anim->decode_ahead->pool);
+      BLI_task_pool_free(anim->decode_ahead->pool);
+    }
+    MEM_delete(anim->decode_ahead);
+    anim->decode_ahead = nullptr;
+  }
+
   if (anim->pCodecCtx) {
     avcodec_free_context(&anim->pCodecCtx);
     avformat_close_input(&anim->pFormatCtx);
@@ -1277,15 +1481,17 @@ ImBuf *IMB_anim_absolute(ImBufAnim *anim,
 
 #ifdef WITH_FFMPEG
   if (anim->state == ImBufAnim::State::Valid) {
-    ibuf = ffmpeg_fetchibuf(anim, position, tc);
-    if (ibuf) {
-      anim->cur_position = position;
+    if (anim->decode_ahead_frames > 0) {
+      ibuf = anim_decode_ahead_fetchibuf(anim, position, tc);
+    }
+    else {
+      ibuf = ffmpeg_fetchibuf(anim, position, IMB_anim_open_index(anim, tc));
     }
   }
 #endif
 
   if (ibuf) {
-    SNPRINTF(ibuf->filepath, "%s.%04d", anim->filepath, anim->cur_position + 1);
+    SNPRINTF(ibuf->filepath, "%s.%04d", anim->filepath, position + 1);
   }
   return ibuf;
 }
@@ -1348,6 +1554,26 @@ bool IMB_anim_get_fps(const ImBufAnim *anim,
   return false;
 }
 
+void IMB_anim_set_decode_ahead(ImBufAnim *anim, int frames_num)
+{
+  if (anim->decode_ahead_frames == frames_num) {
+    return;
+  }
+#ifdef WITH_FFMPEG
+  imb_anim_decode_ahead_clear(anim);
+#endif
+  anim->decode_ahead_frames = frames_num;
+}
+
+void IMB_anim_decode_ahead_memory_limit_set(size_t limit)
+{
+#ifdef WITH_FFMPEG
+  g_decode_ahead_memory_limit = limit;
+#else
+  UNUSED_VARS(limit);
+#endif
+}
+
 int IMB_anim_get_image_width(ImBufAnim *anim)
 {
   return anim->x;
@@ -28,14 +28,19 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_array.hh"
 #include "BLI_blenlib.h"
+#include "BLI_hash.h"
+#include "BLI_math_bits.h"
 #include "BLI_math_color.h"
 #include "BLI_math_color.hh"
 #include "BLI_rect.h"
+#include "BLI_simd.hh"
 #include "BLI_string.h"
 #include "BLI_task.h"
 #include "BLI_task.hh"
 #include "BLI_threads.h"
+#include "BLI_vector.hh"
 
 #include "BKE_appdir.hh"
 #include "BKE_colortools.hh"
@@ -120,6 +125,48 @@ static struct global_color_picking_state {
   bool failed;
 } global_color_picking_state = {nullptr};
 
+/**
+ * Settings a #DisplayLUT was created for, zero initialized so it can be compared as memory.
+ * Gamma is never part of the table, see #display_lut_params_get.
+ */
+struct DisplayLUTKey {
+  char colorspace[MAX_COLORSPACE_NAME];
+  char look[64];
+  char view_transform[64];
+  char display_device[64];
+  /** Zero when exposure is applied to the input of the table instead. */
+  float exposure;
+  float temperature;
+  float tint;
+  int flag;
+  const CurveMapping *curve_mapping;
+  int curve_mapping_timestamp;
+};
+
+/** Display transform baked into a 3D lookup table, see #display_lut_acquire. */
+struct DisplayLUT {
+  DisplayLUTKey key;
+  /** Display space RGB, indexed by the shaped blue, green and red input. Alpha is zero. */
+  float (*table)[4];
+  /** Largest input value covered by the table. */
+  float max_value;
+  /** False when the table is not accurate enough, the OCIO processor is used instead. */
+  bool is_valid;
+  /** Number of display buffer transforms currently using the table. */
+  int users;
+};
+
+/* Lookup table of the last used display transform, replaced when the settings change. Tables
+ * which are still in use when they are replaced are freed by their last user. */
+static DisplayLUT *global_display_lut = nullptr;
+static pthread_mutex_t display_lut_lock = BLI_MUTEX_INITIALIZER;
+
+static void display_lut_free(DisplayLUT *lut)
+{
+  MEM_SAFE_FREE(lut->table);
+  MEM_delete(lut);
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -753,6 +800,12 @@ void colormanagement_exit()
     OCIO_cpuProcessorRelease(global_color_picking_state.cpu_processor_from);
   }
 
+  if (global_display_lut) {
+    BLI_assert(global_display_lut->users == 0);
+    display_lut_free(global_display_lut);
+    global_display_lut = nullptr;
+  }
+
   memset(&global_gpu_state, 0, sizeof(global_gpu_state));
   memset(&global_color_picking_state, 0, sizeof(global_color_picking_state));
 
@@ -1543,6 +1596,331 @@ bool IMB_colormanagement_set_whitepoint(const float whitepoint[3], float &temper
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Display Transform Lookup Table
+ *
+ * Creating the display buffer of a float image is the most common color transform: exposure,
+ * gamma, curves, look, view and display transform are evaluated by the OCIO processor for
+ * every pixel, followed by dithering and conversion to bytes in separate passes. For large
+ * images the whole chain is baked into a 3D lookup table instead, which is evaluated with one
+ * tetrahedral interpolation per pixel in the same pass as un-premultiplying, dithering and
+ * quantizing.
+ *
+ * The table is indexed by the bit pattern of the input values, which is a piecewise linear
+ * approximation of a logarithm, so both the shadows and the high dynamic range part of the
+ * image are sampled well, with four grid points per octave. When the table is created it is
+ * compared to the OCIO processor, if it is not accurate enough (e.g. for custom configurations
+ * with discontinuous transforms) the processor is used as before. Pixels outside of the range
+ * of the table always use the processor. Exposure and gamma are applied outside of the table
+ * where possible, so that adjusting them doesn't create a new table.
+ * \{ */
+
+#define DISPLAY_LUT_SIZE 65
+/** Smallest and largest represented input value, as exponents of two. */
+#define DISPLAY_LUT_MIN_EXP -10
+#define DISPLAY_LUT_MAX_EXP 6
+/** Smaller images don't create a table, creating it would take longer than the transform. */
+#define DISPLAY_LUT_MIN_PIXELS (512 * 512)
+/** Largest allowed difference to the OCIO processor, in display space. */
+#define DISPLAY_LUT_TOLERANCE (1.0f / 255.0f)
+#define DISPLAY_LUT_VALIDATE_SAMPLES 4096
+
+static const float display_lut_offset = 1.0f / float(1 << -DISPLAY_LUT_MIN_EXP);
+static const int display_lut_offset_bits = (127 + DISPLAY_LUT_MIN_EXP) << 23;
+static const int display_lut_step_bits = ((DISPLAY_LUT_MAX_EXP - DISPLAY_LUT_MIN_EXP) << 23) /
+                                         (DISPLAY_LUT_SIZE - 1);
+/* The bit pattern is only linear within an octave, grid cells must not cross octaves. */
+static_assert((DISPLAY_LUT_SIZE - 1) % (DISPLAY_LUT_MAX_EXP - DISPLAY_LUT_MIN_EXP) == 0,
+              "Display lookup table grid has to be aligned to powers of two");
+
+/** Input value of a grid point, the inverse of #display_lut_shaper. */
+static float display_lut_grid_value(const int index)
+{
+  return int_as_float(display_lut_offset_bits + index * display_lut_step_bits) -
+         display_lut_offset;
+}
+
+/** Position of \a value in the table in grid units, \a value must be in the range of the table. */
+BLI_INLINE float display_lut_shaper(const float value)
+{
+  return float(float_as_int(value + display_lut_offset) - display_lut_offset_bits) *
+         (1.0f / display_lut_step_bits);
+}
+
+/**
+ * Corners of the table and their weights for tetrahedral interpolation. The cell containing the
+ * sample is split into six tetrahedra along its diagonal, only the four corners of the one that
+ * contains the sample are interpolated.
+ */
+struct DisplayLUTSample {
+  int index;
+  int offsets[3];
+  float weights[4];
+};
+
+BLI_INLINE void display_lut_sample(const float position[3], DisplayLUTSample &r_sample)
+{
+  const int strides[3] = {1, DISPLAY_LUT_SIZE, DISPLAY_LUT_SIZE * DISPLAY_LUT_SIZE};
+  float fractions[3];
+  r_sample.index = 0;
+  for (int i = 0; i < 3; i++) {
+    const int grid = min_ii(int(position[i]), DISPLAY_LUT_SIZE - 2);
+    fractions[i] = position[i] - float(grid);
+    r_sample.index += grid * strides[i];
+  }
+
+  /* Walk from the first to the opposite corner of the cell along the axes, in the order of
+   * decreasing fractions. */
+  int axes[3] = {0, 1, 2};
+  if (fractions[axes[0]] < fractions[axes[1]]) {
+    std::swap(axes[0], axes[1]);
+  }
+  if (fractions[axes[1]] < fractions[axes[2]]) {
+    std::swap(axes[1], axes[2]);
+  }
+  if (fractions[axes[0]] < fractions[axes[1]]) {
+    std::swap(axes[0], axes[1]);
+  }
+
+  r_sample.offsets[0] = strides[axes[0]];
+  r_sample.offsets[1] = r_sample.offsets[0] + strides[axes[1]];
+  r_sample.offsets[2] = r_sample.offsets[1] + strides[axes[2]];
+  r_sample.weights[0] = 1.0f - fractions[axes[0]];
+  r_sample.weights[1] = fractions[axes[0]] - fractions[axes[1]];
+  r_sample.weights[2] = fractions[axes[1]] - fractions[axes[2]];
+  r_sample.weights[3] = fractions[axes[2]];
+}
+
+BLI_INLINE bool display_lut_in_range(const DisplayLUT *lut, const float rgb[3])
+{
+  /* Written so that NaN is out of range. */
+  return (rgb[0] >= 0.0f && rgb[0] <= lut->max_value) &&
+         (rgb[1] >= 0.0f && rgb[1] <= lut->max_value) &&
+         (rgb[2] >= 0.0f && rgb[2] <= lut->max_value);
+}
+
+/** Display space color of \a rgb, which must be in the range of the table. */
+static void display_lut_evaluate(const DisplayLUT *lut, const float rgb[3], float r_rgb[3])
+{
+  const float position[3] = {
+      display_lut_shaper(rgb[0]), display_lut_shaper(rgb[1]), display_lut_shaper(rgb[2])};
+  DisplayLUTSample sample;
+  display_lut_sample(position, sample);
+
+  const float(*corner)[4] = lut->table + sample.index;
+  mul_v3_v3fl(r_rgb, corner[0], sample.weights[0]);
+  madd_v3_v3fl(r_rgb, corner[sample.offsets[0]], sample.weights[1]);
+  madd_v3_v3fl(r_rgb, corner[sample.offsets[1]], sample.weights[2]);
+  madd_v3_v3fl(r_rgb, corner[sample.offsets[2]], sample.weights[3]);
+}
+
+/** Apply the exact display transform to \a pixels_num straight alpha RGBA pixels. */
+static void display_lut_transform_exact(ColormanageProcessor *cm_processor,
+                                        OCIO_ConstCPUProcessorRcPtr *to_scene_linear,
+                                        float (*pixels)[4],
+                                        const int pixels_num)
+{
+  if (to_scene_linear) {
+    OCIO_PackedImageDesc *img = OCIO_createOCIO_PackedImageDesc(pixels[0],
+                                                                pixels_num,
+                                                                1,
+                                                                4,
+                                                                sizeof(float),
+                                                                4 * sizeof(float),
+                                                                4 * sizeof(float) * pixels_num);
+    OCIO_cpuProcessorApply(to_scene_linear, img);
+    OCIO_PackedImageDescRelease(img);
+  }
+
+  IMB_colormanagement_processor_apply(cm_processor, pixels[0], pixels_num, 1, 4, false);
+}
+
+static DisplayLUT *display_lut_create(const DisplayLUTKey &key,
+                                      ColormanageProcessor *cm_processor,
+                                      OCIO_ConstCPUProcessorRcPtr *to_scene_linear)
+{
+  using namespace blender;
+
+  DisplayLUT *lut = MEM_new<DisplayLUT>(__func__);
+  lut->key = key;
+  lut->max_value = display_lut_grid_value(DISPLAY_LUT_SIZE - 1);
+  lut->table = static_cast<float(*)[4]>(
+      MEM_malloc_arrayN(size_t(DISPLAY_LUT_SIZE) * DISPLAY_LUT_SIZE * DISPLAY_LUT_SIZE,
+                        sizeof(float[4]),
+                        "display transform lookup table"));
+
+  float grid_values[DISPLAY_LUT_SIZE];
+  for (int i = 0; i < DISPLAY_LUT_SIZE; i++) {
+    grid_values[i] = display_lut_grid_value(i);
+  }
+
+  /* Every row of the table is transformed as an image of one line. */
+  threading::parallel_for(
+      IndexRange(DISPLAY_LUT_SIZE * DISPLAY_LUT_SIZE), 64, [&](const IndexRange rows) {
+        for (const int row : rows) {
+          float(*pixels)[4] = lut->table + size_t(row) * DISPLAY_LUT_SIZE;
+          for (int i = 0; i < DISPLAY_LUT_SIZE; i++) {
+            pixels[i][0] = grid_values[i];
+            pixels[i][1] = grid_values[row % DISPLAY_LUT_SIZE];
+            pixels[i][2] = grid_values[row / DISPLAY_LUT_SIZE];
+            pixels[i][3] = 1.0f;
+          }
+          display_lut_transform_exact(cm_processor, to_scene_linear, pixels, DISPLAY_LUT_SIZE);
+          for (int i = 0; i < DISPLAY_LUT_SIZE; i++) {
+            pixels[i][3] = 0.0f;
+          }
+        }
+      });
+
+  /* Compare to the processor between the grid points, spread evenly over the shaped range. */
+  float(*samples)[4] = static_cast<float(*)[4]>(
+      MEM_malloc_arrayN(DISPLAY_LUT_VALIDATE_SAMPLES, sizeof(float[4]), __func__));
+  for (int i = 0; i < DISPLAY_LUT_VALIDATE_SAMPLES; i++) {
+    for (int c = 0; c < 3; c++) {
+      const float position = BLI_hash_int_2d_to_float(i, c) * (DISPLAY_LUT_SIZE - 1);
+      samples[i][c] = int_as_float(display_lut_offset_bits +
+                                   int(position * float(display_lut_step_bits))) -
+                      display_lut_offset;
+    }
+    samples[i][3] = 1.0f;
+  }
+
+  float max_error = 0.0f;
+  float(*expected)[4] = static_cast<float(*)[4]>(MEM_dupallocN(samples));
+  display_lut_transform_exact(
+      cm_processor, to_scene_linear, expected, DISPLAY_LUT_VALIDATE_SAMPLES);
+  for (int i = 0; i < DISPLAY_LUT_VALIDATE_SAMPLES; i++) {
+    float result[3];
+    display_lut_evaluate(lut, samples[i], result);
+    for (int c = 0; c < 3; c++) {
+      const float error = fabsf(clamp_f(result[c], 0.0f, 1.0f) -
+                                clamp_f(expected[i][c], 0.0f, 1.0f));
+      /* Not using #max_ff, so that NaN is counted as an error. */
+      if (!(error <= max_error)) {
+        max_error = error;
+      }
+    }
+  }
+  MEM_freeN(samples);
+  MEM_freeN(expected);
+
+  lut->is_valid = max_error <= DISPLAY_LUT_TOLERANCE;
+  if (!lut->is_valid) {
+    MEM_SAFE_FREE(lut->table);
+  }
+
+  return lut;
+}
+
+/**
+ * Exposure and gamma are applied outside of the table, so that changing them doesn't create a
+ * new table. Gamma is an exponent applied to the display space result. Exposure is a scale in
+ * scene linear space, which can only be applied to the input of the table when the steps before
+ * it are linear. Otherwise it is baked into the table.
+ */
+static bool display_lut_exposure_in_table(const ImBuf *ibuf,
+                                          const ColorManagedViewSettings *view_settings)
+{
+  if (view_settings->flag & COLORMANAGE_VIEW_USE_CURVES) {
+    return true;
+  }
+  ColorSpace *colorspace = ibuf->float_buffer.colorspace;
+  return colorspace && !IMB_colormanagement_space_is_scene_linear(colorspace);
+}
+
+/** Scale of the input and exponent of the output of the table, see #DisplayLUTKey. */
+static void display_lut_params_get(const DisplayLUT *lut,
+                                   const ColorManagedViewSettings *view_settings,
+                                   float *r_scale,
+                                   float *r_exponent)
+{
+  const float exposure = view_settings->exposure - lut->key.exposure;
+  const float gamma = view_settings->gamma;
+  /* Same as #create_display_buffer_processor. */
+  *r_scale = (exposure == 0.0f) ? 1.0f : powf(2.0f, exposure);
+  *r_exponent = (gamma == 1.0f) ? 1.0f : 1.0f / max_ff(FLT_EPSILON, gamma);
+}
+
+/**
+ * Lookup table for the display transform of the float buffer of \a ibuf, or null when the OCIO
+ * processor has to be used. Tables are created on demand for large images and reused for as
+ * long as the settings don't change, the result has to be released with #display_lut_release.
+ */
+static DisplayLUT *display_lut_acquire(const ImBuf *ibuf,
+                                       const ColorManagedViewSettings *view_settings,
+                                       const ColorManagedDisplaySettings *display_settings)
+{
+  DisplayLUTKey key;
+  memset(&key, 0, sizeof(key));
+  if (ibuf->float_buffer.colorspace) {
+    STRNCPY(key.colorspace, ibuf->float_buffer.colorspace->name);
+  }
+  STRNCPY(key.look, view_settings->look);
+  STRNCPY(key.view_transform, view_settings->view_transform);
+  STRNCPY(key.display_device, display_settings->display_device);
+  if (display_lut_exposure_in_table(ibuf, view_settings)) {
+    key.exposure = view_settings->exposure;
+  }
+  key.temperature = view_settings->temperature;
+  key.tint = view_settings->tint;
+  key.flag = view_settings->flag;
+  if (view_settings->flag & COLORMANAGE_VIEW_USE_CURVES) {
+    key.curve_mapping = view_settings->curve_mapping;
+    key.curve_mapping_timestamp = view_settings->curve_mapping->changed_timestamp;
+  }
+
+  BLI_mutex_lock(&display_lut_lock);
+
+  DisplayLUT *lut = global_display_lut;
+  if (lut == nullptr || memcmp(&lut->key, &key, sizeof(key)) != 0) {
+    if (size_t(ibuf->x) * ibuf->y < DISPLAY_LUT_MIN_PIXELS) {
+      BLI_mutex_unlock(&display_lut_lock);
+      return nullptr;
+    }
+
+    /* Created while locked, so concurrent display transforms don't create the same table. */
+    OCIO_ConstCPUProcessorRcPtr *to_scene_linear = nullptr;
+    if (ibuf->float_buffer.colorspace) {
+      to_scene_linear = colorspace_to_scene_linear_cpu_processor(ibuf->float_buffer.colorspace);
+    }
+    ColorManagedViewSettings table_view_settings = *view_settings;
+    table_view_settings.exposure = key.exposure;
+    table_view_settings.gamma = 1.0f;
+    ColormanageProcessor *cm_processor = IMB_colormanagement_display_processor_new(
+        &table_view_settings, display_settings);
+    lut = display_lut_create(key, cm_processor, to_scene_linear);
+    IMB_colormanagement_processor_free(cm_processor);
+
+    if (global_display_lut && global_display_lut->users == 0) {
+      display_lut_free(global_display_lut);
+    }
+    global_display_lut = lut;
+  }
+
+  if (!lut->is_valid) {
+    lut = nullptr;
+  }
+  else {
+    lut->users++;
+  }
+
+  BLI_mutex_unlock(&display_lut_lock);
+
+  return lut;
+}
+
+static void display_lut_release(DisplayLUT *lut)
+{
+  BLI_mutex_lock(&display_lut_lock);
+  lut->users--;
+  if (lut->users == 0 && lut != global_display_lut) {
+    display_lut_free(lut);
+  }
+  BLI_mutex_unlock(&display_lut_lock);
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Threaded Display Buffer Transform Routines
  * \{ */
@@ -1567,6 +1945,11 @@ struct DisplayBufferThread {
 
   const char *byte_colorspace;
   const char *float_colorspace;
+
+  const DisplayLUT *display_lut;
+  float display_lut_scale;
+  float display_lut_exponent;
+  OCIO_ConstCPUProcessorRcPtr *float_to_scene_linear;
 };
 
 struct DisplayBufferInitData {
@@ -1582,6 +1965,10 @@ struct DisplayBufferInitData {
 
   const char *byte_colorspace;
   const char *float_colorspace;
+
+  const DisplayLUT *display_lut;
+  float display_lut_scale;
+  float display_lut_exponent;
 };
 
 static void display_buffer_init_handle(void *handle_v,
@@ -1632,6 +2019,14 @@ static void display_buffer_init_handle(void *handle_v,
 
   handle->byte_colorspace = init_data->byte_colorspace;
   handle->float_colorspace = init_data->float_colorspace;
+
+  handle->display_lut = init_data->display_lut;
+  handle->display_lut_scale = init_data->display_lut_scale;
+  handle->display_lut_exponent = init_data->display_lut_exponent;
+  if (init_data->display_lut && ibuf->float_buffer.colorspace) {
+    handle->float_to_scene_linear = colorspace_to_scene_linear_cpu_processor(
+        ibuf->float_buffer.colorspace);
+  }
 }
 
 static void display_buffer_apply_get_linear_buffer(DisplayBufferThread *handle,
@@ -1714,6 +2109,193 @@ static void display_buffer_apply_get_linear_buffer(DisplayBufferThread *handle,
   }
 }
 
+/**
+ * Display transform of pixels of a row of the float buffer with the OCIO processor, in the same
+ * order as #display_buffer_apply_get_linear_buffer and #IMB_buffer_byte_from_float do it for the
+ * whole buffer. Used for the pixels that can't be looked up in the table, which are collected
+ * per row so the processor is invoked once per row instead of once per pixel.
+ *
+ * \param pixels: Temporary buffer with four floats for every pixel.
+ */
+static void display_buffer_apply_pixels_exact(const DisplayBufferThread *handle,
+                                              const float *from_row,
+                                              uchar *to_row,
+                                              const blender::Span<int> xs,
+                                              const blender::Span<float> dither_values,
+                                              float *pixels)
+{
+  const int channels = handle->channels;
+  const bool predivide = handle->predivide && channels == 4;
+  const int pixels_num = int(xs.size());
+
+  for (const int i : xs.index_range()) {
+    const float *from = from_row + size_t(channels) * xs[i];
+    float *pixel = pixels + size_t(4) * i;
+    copy_v3_v3(pixel, from);
+    pixel[3] = channels == 4 ? from[3] : 1.0f;
+  }
+
+  if (handle->float_to_scene_linear) {
+    OCIO_PackedImageDesc *img = OCIO_createOCIO_PackedImageDesc(pixels,
+                                                                pixels_num,
+                                                                1,
+                                                                4,
+                                                                sizeof(float),
+                                                                4 * sizeof(float),
+                                                                4 * sizeof(float) * pixels_num);
+    if (predivide) {
+      OCIO_cpuProcessorApply_predivide(handle->float_to_scene_linear, img);
+    }
+    else {
+      OCIO_cpuProcessorApply(handle->float_to_scene_linear, img);
+    }
+    OCIO_PackedImageDescRelease(img);
+  }
+
+  IMB_colormanagement_processor_apply(handle->cm_processor, pixels, pixels_num, 1, 4, predivide);
+
+  for (const int i : xs.index_range()) {
+    float *pixel = pixels + size_t(4) * i;
+    if (predivide) {
+      premul_to_straight_v4(pixel);
+    }
+    uchar *to = to_row + size_t(4) * xs[i];
+    to[0] = unit_float_to_uchar_clamp(dither_values[i] + pixel[0]);
+    to[1] = unit_float_to_uchar_clamp(dither_values[i] + pixel[1]);
+    to[2] = unit_float_to_uchar_clamp(dither_values[i] + pixel[2]);
+    to[3] = unit_float_to_uchar_clamp(pixel[3]);
+  }
+}
+
+/**
+ * Display transform of the float buffer into the display byte buffer using the lookup table,
+ * un-premultiplying, dithering and quantizing in the same pass.
+ */
+static void display_buffer_apply_lut(const DisplayBufferThread *handle)
+{
+  const DisplayLUT *lut = handle->display_lut;
+  const int channels = handle->channels;
+  const int width = handle->width;
+  const int height = handle->tot_line;
+  /* Byte buffers are only dithered from four channel buffers, matching
+   * #IMB_buffer_byte_from_float. */
+  const float dither = channels == 4 ? handle->dither : 0.0f;
+  const bool predivide = handle->predivide && channels == 4;
+  /* Curves are applied to premultiplied colors, which can't be looked up in the table. */
+  const bool use_curve_mapping = handle->cm_processor->curve_mapping != nullptr;
+  const float scale = handle->display_lut_scale;
+  const float exponent = handle->display_lut_exponent;
+  const float inv_width = 1.0f / width;
+  const float inv_height = 1.0f / height;
+
+  /* Pixels of the current row that use the processor. */
+  blender::Vector<int> exact_xs;
+  blender::Vector<float> exact_dither_values;
+  blender::Array<float> exact_pixels(size_t(4) * width);
+
+#if BLI_HAVE_SSE2
+  const __m128 offset = _mm_set1_ps(display_lut_offset);
+  const __m128i offset_bits = _mm_set1_epi32(display_lut_offset_bits);
+  const __m128 inv_step = _mm_set1_ps(1.0f / display_lut_step_bits);
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 scale_255 = _mm_set1_ps(255.0f);
+  const __m128 half = _mm_set1_ps(0.5f);
+#endif
+
+  for (int y = 0; y < height; y++) {
+    const float *from_row = handle->buffer + size_t(channels) * width * y;
+    uchar *to_row = handle->display_buffer_byte + size_t(4) * width * y;
+    const float t = y * inv_height;
+    const float *from = from_row;
+    uchar *to = to_row;
+
+    exact_xs.clear();
+    exact_dither_values.clear();
+
+    for (int x = 0; x < width; x++, from += channels, to += 4) {
+      const float alpha = channels == 4 ? from[3] : 1.0f;
+      const float dither_value = dither != 0.0f ?
+                                     dither_random_value(x * inv_width, t) * 0.0033f * dither :
+                                     0.0f;
+
+      float rgb[3] = {from[0], from[1], from[2]};
+      float rgb_scale = scale;
+      if (predivide && alpha != 0.0f && alpha != 1.0f) {
+        if (use_curve_mapping) {
+          exact_xs.append(x);
+          exact_dither_values.append(dither_value);
+          continue;
+        }
+        rgb_scale /= alpha;
+      }
+      if (rgb_scale != 1.0f) {
+        mul_v3_fl(rgb, rgb_scale);
+      }
+
+      if (!display_lut_in_range(lut, rgb)) {
+        exact_xs.append(x);
+        exact_dither_values.append(dither_value);
+        continue;
+      }
+
+#if BLI_HAVE_SSE2
+      /* Shape all channels at once, the interpolation of the four corners is done on whole
+       * table entries, with the alpha channel of the table being zero. */
+      const __m128 value = _mm_set_ps(0.0f, rgb[2], rgb[1], rgb[0]);
+      const __m128i bits = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(value, offset)),
+                                         offset_bits);
+      float position[4];
+      _mm_storeu_ps(position, _mm_mul_ps(_mm_cvtepi32_ps(bits), inv_step));
+
+      DisplayLUTSample sample;
+      display_lut_sample(position, sample);
+
+      const float(*corner)[4] = lut->table + sample.index;
+      __m128 color = _mm_mul_ps(_mm_loadu_ps(corner[0]), _mm_set1_ps(sample.weights[0]));
+      for (int i = 0; i < 3; i++) {
+        color = _mm_add_ps(color,
+                           _mm_mul_ps(_mm_loadu_ps(corner[sample.offsets[i]]),
+                                      _mm_set1_ps(sample.weights[i + 1])));
+      }
+
+      if (exponent != 1.0f) {
+        float color_v[4];
+        _mm_storeu_ps(color_v, color);
+        for (int i = 0; i < 3; i++) {
+          color_v[i] = powf(max_ff(color_v[i], 0.0f), exponent);
+        }
+        color = _mm_loadu_ps(color_v);
+      }
+
+      color = _mm_add_ps(color, _mm_set_ps(alpha, dither_value, dither_value, dither_value));
+      color = _mm_min_ps(_mm_max_ps(color, zero), one);
+      const __m128i color_int = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(color, scale_255), half));
+      const __m128i color_short = _mm_packs_epi32(color_int, color_int);
+      const int color_byte = _mm_cvtsi128_si32(_mm_packus_epi16(color_short, color_short));
+      memcpy(to, &color_byte, sizeof(color_byte));
+#else
+      float color[3];
+      display_lut_evaluate(lut, rgb, color);
+      if (exponent != 1.0f) {
+        for (int i = 0; i < 3; i++) {
+          color[i] = powf(max_ff(color[i], 0.0f), exponent);
+        }
+      }
+      to[0] = unit_float_to_uchar_clamp(dither_value + color[0]);
+      to[1] = unit_float_to_uchar_clamp(dither_value + color[1]);
+      to[2] = unit_float_to_uchar_clamp(dither_value + color[2]);
+      to[3] = unit_float_to_uchar_clamp(alpha);
+#endif
+    }
+
+    if (!exact_xs.is_empty()) {
+      display_buffer_apply_pixels_exact(
+          handle, from_row, to_row, exact_xs, exact_dither_values, exact_pixels.data());
+    }
+  }
+}
+
 static void *do_display_buffer_apply_thread(void *handle_v)
 {
   DisplayBufferThread *handle = (DisplayBufferThread *)handle_v;
@@ -1726,6 +2308,11 @@ static void *do_display_buffer_apply_thread(void *handle_v)
   float dither = handle->dither;
   bool is_data = handle->is_data;
 
+  if (handle->display_lut) {
+    display_buffer_apply_lut(handle);
+    return nullptr;
+  }
+
   if (cm_processor == nullptr) {
     if (display_buffer_byte && display_buffer_byte != handle->byte_buffer) {
       IMB_buffer_byte_from_byte(display_buffer_byte,
@@ -1812,12 +2399,18 @@ static void display_buffer_apply_threaded(ImBuf *ibuf,
                                           uchar *byte_buffer,
                                           float *display_buffer,
                                           uchar *display_buffer_byte,
-                                          ColormanageProcessor *cm_processor)
+                                          ColormanageProcessor *cm_processor,
+                                          const DisplayLUT *display_lut,
+                                          const float display_lut_scale,
+                                          const float display_lut_exponent)
 {
   DisplayBufferInitData init_data;
 
   init_data.ibuf = ibuf;
   init_data.cm_processor = cm_processor;
+  init_data.display_lut = display_lut;
+  init_data.display_lut_scale = display_lut_scale;
+  init_data.display_lut_exponent = display_lut_exponent;
   init_data.buffer = buffer;
   init_data.byte_buffer = byte_buffer;
   init_data.display_buffer = display_buffer;
@@ -1893,12 +2486,33 @@ static void colormanage_display_buffer_process_ex(
     cm_processor = IMB_colormanagement_display_processor_new(view_settings, display_settings);
   }
 
+  /* The lookup table only creates byte display buffers of float images. */
+  DisplayLUT *display_lut = nullptr;
+  if (cm_processor && !cm_processor->is_data_result && view_settings && display_buffer_byte &&
+      display_buffer == nullptr && ibuf->float_buffer.data &&
+      (ibuf->colormanage_flag & IMB_COLORMANAGE_IS_DATA) == 0 &&
+      ELEM(ibuf->channels, 3, 4))
+  {
+    display_lut = display_lut_acquire(ibuf, view_settings, display_settings);
+  }
+  float display_lut_scale = 1.0f, display_lut_exponent = 1.0f;
+  if (display_lut) {
+    display_lut_params_get(display_lut, view_settings, &display_lut_scale, &display_lut_exponent);
+  }
+
   display_buffer_apply_threaded(ibuf,
                                 ibuf->float_buffer.data,
                                 ibuf->byte_buffer.data,
                                 display_buffer,
                                 display_buffer_byte,
-                                cm_processor);
+                                cm_processor,
+                                display_lut,
+                                display_lut_scale,
+                                display_lut_exponent);
+
+  if (display_lut) {
+    display_lut_release(display_lut);
+  }
 
   if (cm_processor) {
     IMB_colormanagement_processor_free(cm_processor);
@@ -0,0 +1,152 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include <cmath>
+
+#include "BLI_math_color.h"
+#include "BLI_math_vector_types.hh"
+#include "BLI_string.h"
+
+#include "BKE_appdir.hh"
+
+#include "CLG_log.h"
+
+#include "DNA_color_types.h"
+
+#include "IMB_colormanagement.hh"
+#include "IMB_imbuf.hh"
+#include "IMB_imbuf_types.hh"
+
+#include "MEM_guardedalloc.h"
+
+namespace blender::imbuf::tests {
+
+class ColormanagementTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    CLG_init();
+    BKE_appdir_init();
+    IMB_init();
+  }
+
+  static void TearDownTestSuite()
+  {
+    IMB_exit();
+    BKE_appdir_exit();
+    CLG_exit();
+  }
+};
+
+/**
+ * Premultiplied float image large enough to use the lookup table of the display transform, with
+ * values covering the shadows and the high dynamic range, partial and zero alpha, and pixels
+ * outside of the range of the table.
+ */
+static ImBuf *create_hdr_test_image()
+{
+  const int size = 512;
+  ImBuf *ibuf = IMB_allocImBuf(size, size, 32, IB_rectfloat);
+  float4 *pixels = reinterpret_cast<float4 *>(ibuf->float_buffer.data);
+
+  uint seed = 1;
+  auto random_float = [&]() {
+    seed = seed * 1664525u + 1013904223u;
+    return float(seed >> 8) / float(1 << 24);
+  };
+
+  for (int i = 0; i < size * size; i++) {
+    float4 &pixel = pixels[i];
+    for (int c = 0; c < 3; c++) {
+      /* Logarithmic distribution between 2^-12 and 2^7. */
+      pixel[c] = exp2f(random_float() * 19.0f - 12.0f);
+    }
+    pixel.w = 1.0f;
+
+    if (i % 7 == 0) {
+      pixel.w = random_float();
+      pixel.x *= pixel.w;
+      pixel.y *= pixel.w;
+      pixel.z *= pixel.w;
+    }
+    if (i % 101 == 0) {
+      pixel = float4(0.0f);
+    }
+    if (i % 53 == 0) {
+      pixel.y = -0.25f;
+    }
+    if (i % 97 == 0) {
+      pixel.z = NAN;
+    }
+  }
+  return ibuf;
+}
+
+/** Compare the display buffer of \a ibuf to applying the OCIO processor to every pixel. */
+static void expect_display_buffer_matches_processor(ImBuf *ibuf,
+                                                    const ColorManagedViewSettings &view_settings,
+                                                    const ColorManagedDisplaySettings &display)
+{
+  const int pixels_num = ibuf->x * ibuf->y;
+
+  float *expected = static_cast<float *>(
+      MEM_malloc_arrayN(size_t(pixels_num), sizeof(float[4]), __func__));
+  IMB_display_buffer_transform_apply_float(expected,
+                                           ibuf->float_buffer.data,
+                                           ibuf->x,
+                                           ibuf->y,
+                                           4,
+                                           &view_settings,
+                                           &display,
+                                           true);
+
+  void *cache_handle = nullptr;
+  const uchar *result = IMB_display_buffer_acquire(ibuf, &view_settings, &display, &cache_handle);
+  ASSERT_NE(result, nullptr);
+
+  /* The table is accurate to 1/255, plus the rounding to bytes. */
+  const int tolerance = 2;
+  int mismatches = 0;
+  for (int i = 0; i < pixels_num; i++) {
+    float *pixel = expected + size_t(4) * i;
+    premul_to_straight_v4(pixel);
+    for (int c = 0; c < 4; c++) {
+      const int expected_byte = unit_float_to_uchar_clamp(pixel[c]);
+      if (std::abs(expected_byte - int(result[4 * i + c])) > tolerance) {
+        mismatches++;
+      }
+    }
+  }
+  EXPECT_EQ(mismatches, 0);
+
+  IMB_display_buffer_release(cache_handle);
+  MEM_freeN(expected);
+}
+
+TEST_F(ColormanagementTest, DisplayBufferLookupTable)
+{
+  ImBuf *ibuf = create_hdr_test_image();
+
+  ColorManagedDisplaySettings display;
+  STRNCPY(display.display_device, IMB_colormanagement_display_get_default_name());
+  ColorManagedViewSettings view_settings;
+  IMB_colormanagement_init_default_view_settings(&view_settings, &display);
+
+  expect_display_buffer_matches_processor(ibuf, view_settings, display);
+
+  /* Exposure and gamma are applied outside of the table. */
+  view_settings.exposure = 1.5f;
+  view_settings.gamma = 1.8f;
+  expect_display_buffer_matches_processor(ibuf, view_settings, display);
+
+  view_settings.exposure = -2.0f;
+  view_settings.gamma = 0.6f;
+  expect_display_buffer_matches_processor(ibuf, view_settings, display);
+
+  IMB_freeImBuf(ibuf);
+}
+
+}  // namespace blender::imbuf::tests
@@ -1328,6 +1328,11 @@ void IMB_free_indices(ImBufAnim *anim)
 {
   int i;
 
+#ifdef WITH_FFMPEG
+  /* Frames decoded ahead may use the indices or proxies. */
+  imb_anim_decode_ahead_clear(anim);
+#endif
+
   for (i = 0; i < IMB_PROXY_MAX_SLOT; i++) {
     if (anim->proxy_anim[i]) {
       IMB_close_anim(anim->proxy_anim[i]);
@@ -1379,6 +1384,9 @@ ImBufAnim *IMB_anim_open_proxy(ImBufAnim *anim, IMB_Proxy_Size preview_size)
 
   /* proxies are generated in the same color space as animation itself */
   anim->proxy_anim[i] = IMB_open_anim(filepath, 0, 0, anim->colorspace);
+  if (anim->proxy_anim[i]) {
+    IMB_anim_set_decode_ahead(anim->proxy_anim[i], anim->decode_ahead_frames);
+  }
 
   anim->proxies_tried |= preview_size;
 
@@ -1398,10 +1406,14 @@ ImBufAnimIndex *IMB_anim_open_index(ImBufAnim *anim, IMB_Timecode_Type tc)
     index = &anim->no_gaps;
   }
 
-  if (anim->indices_tried & tc) {
+  if (index == nullptr) {
     return nullptr;
   }
-  if (index == nullptr) {
+  /* Keep using the index that was opened already, so seeking uses its seek positions. */
+  if (*index) {
+    return *index;
+  }
+  if (anim->indices_tried & tc) {
     return nullptr;
   }
 
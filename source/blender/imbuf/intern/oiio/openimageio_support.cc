@@ -289,6 +289,111 @@ ImBuf *imb_oiio_read(const ReadContext &ctx,
   return get_oiio_ibuf(in.get(), ctx, colorspace);
 }
 
+unique_ptr<ImageInput> imb_oiio_open_file(const char *filepath, const ImageSpec &config)
+{
+  unique_ptr<ImageInput> in = ImageInput::open(filepath, &config);
+  if (!in) {
+    /* Clear the global error, not being able to open the file is expected for some formats. */
+    OIIO::geterror();
+  }
+  return in;
+}
+
+template<typename T>
+static ImBuf *read_region_pixels(ImageInput *in,
+                                 const ImageSpec &spec,
+                                 const int miplevel,
+                                 const int xbegin,
+                                 const int xend,
+                                 const int ybegin,
+                                 const int yend,
+                                 const bool use_all_planes)
+{
+  constexpr bool is_float = sizeof(T) > 1;
+  const int width = xend - xbegin;
+  const int height = yend - ybegin;
+  const int channels = spec.nchannels <= 4 ? spec.nchannels : 4;
+  const int planes = use_all_planes ? 32 : 8 * channels;
+  ImBuf *ibuf = IMB_allocImBuf(
+      width, height, planes, (is_float ? IB_rectfloat : IB_rect) | IB_uninitialized_pixels);
+  if (!ibuf) {
+    return nullptr;
+  }
+
+  /* Same as #load_pixels, read n-channels directly into the flipped 4-channel layout. */
+  const stride_t ibuf_xstride = sizeof(T) * 4;
+  const stride_t ibuf_ystride = ibuf_xstride * width;
+  const TypeDesc format = is_float ? TypeDesc::FLOAT : TypeDesc::UINT8;
+  uchar *rect = is_float ? reinterpret_cast<uchar *>(ibuf->float_buffer.data) :
+                           reinterpret_cast<uchar *>(ibuf->byte_buffer.data);
+  void *ibuf_data = rect + ((stride_t(height) - 1) * ibuf_ystride);
+
+  bool ok;
+  if (spec.tile_width > 0) {
+    ok = in->read_tiles(0,
+                        miplevel,
+                        spec.x + xbegin,
+                        spec.x + xend,
+                        spec.y + ybegin,
+                        spec.y + yend,
+                        spec.z,
+                        spec.z + std::max(spec.depth, 1),
+                        0,
+                        channels,
+                        format,
+                        ibuf_data,
+                        ibuf_xstride,
+                        -ibuf_ystride,
+                        AutoStride);
+  }
+  else {
+    BLI_assert(xbegin == 0 && xend == spec.width);
+    ok = in->read_scanlines(0,
+                            miplevel,
+                            spec.y + ybegin,
+                            spec.y + yend,
+                            spec.z,
+                            0,
+                            channels,
+                            format,
+                            ibuf_data,
+                            ibuf_xstride,
+                            -ibuf_ystride);
+  }
+
+  if (!ok) {
+    fprintf(stderr, "%s: reading pixels failed: %s\n", __func__, in->geterror().c_str());
+
+    IMB_freeImBuf(ibuf);
+    return nullptr;
+  }
+
+  const T alpha_fill = is_float ? 1.0f : 0xFF;
+  fill_all_channels<T>(reinterpret_cast<T *>(rect), width, height, channels, alpha_fill);
+
+  return ibuf;
+}
+
+ImBuf *imb_oiio_read_region(ImageInput *in,
+                            const int miplevel,
+                            const int xbegin,
+                            const int xend,
+                            const int ybegin,
+                            const int yend,
+                            const bool use_all_planes)
+{
+  const ImageSpec spec = in->spec_dimensions(0, miplevel);
+  if (spec.nchannels < 1) {
+    return nullptr;
+  }
+
+  if (spec.format.basesize() > 1) {
+    return read_region_pixels<float>(
+        in, spec, miplevel, xbegin, xend, ybegin, yend, use_all_planes);
+  }
+  return read_region_pixels<uchar>(in, spec, miplevel, xbegin, xend, ybegin, yend, use_all_planes);
+}
+
 bool imb_oiio_write(const WriteContext &ctx, const char *filepath, const ImageSpec &file_spec)
 {
   unique_ptr<ImageOutput> out = ImageOutput::create(ctx.file_format);
@@ -72,6 +72,29 @@ ImBuf *imb_oiio_read(const ReadContext &ctx,
                      char colorspace[IM_MAX_SPACE],
                      OIIO::ImageSpec &r_newspec);
 
+/**
+ * Open an image file for reading parts of it on demand with #imb_oiio_read_region, instead of
+ * mapping and decoding the whole file. Returns null if OIIO can't read the file.
+ */
+std::unique_ptr<OIIO::ImageInput> imb_oiio_open_file(const char *filepath,
+                                                     const OIIO::ImageSpec &config);
+
+/**
+ * Read a region of a MIP level into a new #ImBuf with the same layout as #imb_oiio_read creates.
+ * Region coordinates are relative to the top left of the data window, as in the file.
+ *
+ * Only the tiles or scan-lines overlapping the region are decoded. For tiled files the region
+ * has to be aligned to the tiles, for scan-line files it has to span the full width.
+ * Safe to call from multiple threads with the same #OIIO::ImageInput.
+ */
+ImBuf *imb_oiio_read_region(OIIO::ImageInput *in,
+                            int miplevel,
+                            int xbegin,
+                            int xend,
+                            int ybegin,
+                            int yend,
+                            bool use_all_planes);
+
 /**
  * The primary method for writing data from an #ImBuf to either a physical or in-memory
  * destination.
@@ -79,6 +79,7 @@
 #include "BLI_fileops.h"
 #include "BLI_math_color.h"
 #include "BLI_mmap.h"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
 
 #include "BKE_idprop.hh"
@@ -420,6 +421,13 @@ static void openexr_header_compression(Header *header, int compression)
       header->compression() = DWAB_COMPRESSION;
       break;
 #endif
+    case R_IMF_EXR_CODEC_ZIP_FAST:
+      header->compression() = ZIP_COMPRESSION;
+#if OPENEXR_VERSION_MAJOR > 3 || (OPENEXR_VERSION_MAJOR == 3 && OPENEXR_VERSION_MINOR >= 1)
+      /* Fastest deflate level, the files are regular ZIP compressed files. */
+      header->zipCompressionLevel() = 1;
+#endif
+      break;
     default:
       header->compression() = ZIP_COMPRESSION;
       break;
@@ -497,38 +505,35 @@ static bool imb_save_openexr_half(ImBuf *ibuf, const char *filepath, const int f
     if (is_alpha) {
       frameBuffer.insert("A", Slice(HALF, (char *)&to->a, xstride, ystride));
     }
-    if (ibuf->float_buffer.data) {
-      float *from;
-
-      for (int i = ibuf->y - 1; i >= 0; i--) {
-        from = ibuf->float_buffer.data + channels * i * width;
-
-        for (int j = ibuf->x; j > 0; j--) {
-          to->r = float_to_half_safe(from[0]);
-          to->g = float_to_half_safe((channels >= 2) ? from[1] : from[0]);
-          to->b = float_to_half_safe((channels >= 3) ? from[2] : from[0]);
-          to->a = float_to_half_safe((channels >= 4) ? from[3] : 1.0f);
-          to++;
-          from += channels;
-        }
-      }
-    }
-    else {
-      uchar *from;
-
-      for (int i = ibuf->y - 1; i >= 0; i--) {
-        from = ibuf->byte_buffer.data + 4 * i * width;
-
-        for (int j = ibuf->x; j > 0; j--) {
-          to->r = srgb_to_linearrgb(float(from[0]) / 255.0f);
-          to->g = srgb_to_linearrgb(float(from[1]) / 255.0f);
-          to->b = srgb_to_linearrgb(float(from[2]) / 255.0f);
-          to->a = channels >= 4 ? float(from[3]) / 255.0f : 1.0f;
-          to++;
-          from += 4;
-        }
-      }
-    }
+    /* Convert rows in parallel, OpenEXR compresses the lines on its own thread pool. */
+    blender::threading::parallel_for(
+        blender::IndexRange(height), 64, [&](const blender::IndexRange rows) {
+          for (const int64_t y : rows) {
+            /* The image is stored upside down, the last row of the buffer is written first. */
+            RGBAZ *to_row = to + (height - 1 - y) * width;
+
+            if (ibuf->float_buffer.data) {
+              const float *from = ibuf->float_buffer.data + channels * y * width;
+
+              for (int j = 0; j < width; j++, to_row++, from += channels) {
+                to_row->r = float_to_half_safe(from[0]);
+                to_row->g = float_to_half_safe((channels >= 2) ? from[1] : from[0]);
+                to_row->b = float_to_half_safe((channels >= 3) ? from[2] : from[0]);
+                to_row->a = float_to_half_safe((channels >= 4) ? from[3] : 1.0f);
+              }
+            }
+            else {
+              const uchar *from = ibuf->byte_buffer.data + 4 * y * width;
+
+              for (int j = 0; j < width; j++, to_row++, from += 4) {
+                to_row->r = srgb_to_linearrgb(float(from[0]) / 255.0f);
+                to_row->g = srgb_to_linearrgb(float(from[1]) / 255.0f);
+                to_row->b = srgb_to_linearrgb(float(from[2]) / 255.0f);
+                to_row->a = channels >= 4 ? float(from[3]) / 255.0f : 1.0f;
+              }
+            }
+          }
+        });
 
     exr_printf("OpenEXR-save: Writing OpenEXR file of height %d.\n", height);
 
@@ -1158,11 +1163,15 @@ void IMB_exr_write_channels(void *handle)
     LISTBASE_FOREACH (ExrChannel *, echan, &data->channels) {
       /* Writing starts from last scan-line, stride negative. */
       if (echan->use_half_float) {
-        float *rect = echan->rect;
+        const float *rect = echan->rect;
         half *cur = current_rect_half;
-        for (size_t i = 0; i < num_pixels; i++, cur++) {
-          *cur = float_to_half_safe(rect[i * echan->xstride]);
-        }
+        const int xstride = echan->xstride;
+        blender::threading::parallel_for(
+            blender::IndexRange(num_pixels), 65536, [&](const blender::IndexRange range) {
+              for (const int64_t i : range) {
+                cur[i] = float_to_half_safe(rect[i * xstride]);
+              }
+            });
         half *rect_to_write = current_rect_half + (data->height - 1L) * data->width;
         frameBuffer.insert(
             echan->name,
@@ -13,19 +13,29 @@
 #endif
 
 #include "BLI_fileops.h"
+#include "BLI_hash.h"
+#include "BLI_math_base.h"
+#include "BLI_math_color.h"
+#include "BLI_math_vector.h"
 #include "BLI_mmap.h"
 #include "BLI_path_util.h" /* For assertions. */
 #include "BLI_string.h"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
 #include <cstdlib>
+#include <mutex>
+
+#include "MEM_guardedalloc.h"
 
 #include "IMB_allocimbuf.hh"
 #include "IMB_filetype.hh"
 #include "IMB_imbuf.hh"
 #include "IMB_imbuf_types.hh"
 #include "IMB_metadata.hh"
+#include "IMB_moviecache.hh"
 #include "IMB_thumbs.hh"
 #include "imbuf.hh"
+#include "oiio/openimageio_support.hh"
 
 #include "IMB_colormanagement.hh"
 #include "IMB_colormanagement_intern.hh"
@@ -166,6 +176,13 @@ ImBuf *IMB_loadiffname(const char *filepath, int flags, char colorspace[IM_MAX_S
   return ibuf;
 }
 
+static ImBuf *tile_source_load_thumbnail(const char *filepath,
+                                         int flags,
+                                         size_t max_thumb_size,
+                                         char colorspace[IM_MAX_SPACE],
+                                         size_t *r_width,
+                                         size_t *r_height);
+
 ImBuf *IMB_thumb_load_image(const char *filepath,
                             size_t max_thumb_size,
                             char colorspace[IM_MAX_SPACE])
@@ -191,6 +208,13 @@ ImBuf *IMB_thumb_load_image(const char *filepath,
         filepath, flags, max_thumb_size, colorspace, &width, &height);
   }
   else {
+    /* Images with MIP levels only need the level closest to the thumbnail size to be read,
+     * regardless of the file size. */
+    ibuf = tile_source_load_thumbnail(
+        filepath, flags, max_thumb_size, colorspace, &width, &height);
+  }
+
+  if (ibuf == nullptr && type->load_filepath_thumbnail == nullptr) {
     /* Skip images of other types if over 100MB. */
     const size_t file_size = BLI_file_size(filepath);
     if (file_size != size_t(-1) && file_size > THUMB_SIZE_MAX) {
@@ -244,3 +268,314 @@ ImBuf *IMB_testiffname(const char *filepath, int flags)
 
   return ibuf;
 }
+
+/* -------------------------------------------------------------------- */
+/** \name Tiled Image Reading
+ * \{ */
+
+/** Small tiles of the file are grouped into tiles of at least this size. */
+#define TILE_SOURCE_MIN_TILE_SIZE 256
+/** Scan-line files are read in bands of the full width and about this many pixels. */
+#define TILE_SOURCE_BAND_PIXELS (256 * 256)
+
+struct ImBufTileLevel {
+  int width;
+  int height;
+  int tile_width;
+  int tile_height;
+  int tiles_x;
+  int tiles_y;
+};
+
+struct ImBufTileKey {
+  int level;
+  int tile_x;
+  int tile_y;
+};
+
+struct ImBufTileSource {
+  std::unique_ptr<OIIO::ImageInput> input;
+  blender::Vector<ImBufTileLevel> levels;
+
+  /** Flags and color space the tiles are loaded with, see #imb_handle_alpha. */
+  int flags;
+  char colorspace[IM_MAX_SPACE];
+  /** Alpha mode of the file, for #IB_alphamode_detect. */
+  int alpha_flags;
+  bool use_all_planes;
+
+  /** Decoded tiles. The movie cache is not thread safe by itself. */
+  MovieCache *cache;
+  std::mutex cache_mutex;
+};
+
+static uint tile_source_hashhash(const void *key_v)
+{
+  const ImBufTileKey *key = static_cast<const ImBufTileKey *>(key_v);
+  return BLI_hash_int_3d(key->level, key->tile_x, key->tile_y);
+}
+
+static bool tile_source_hashcmp(const void *a_v, const void *b_v)
+{
+  const ImBufTileKey *a = static_cast<const ImBufTileKey *>(a_v);
+  const ImBufTileKey *b = static_cast<const ImBufTileKey *>(b_v);
+  return (a->level != b->level) || (a->tile_x != b->tile_x) || (a->tile_y != b->tile_y);
+}
+
+ImBufTileSource *IMB_tile_source_open(const char *filepath,
+                                      int flags,
+                                      char colorspace[IM_MAX_SPACE])
+{
+  BLI_assert(!BLI_path_is_rel(filepath));
+
+  OIIO::ImageSpec config;
+  config.attribute("oiio:UnassociatedAlpha", 1);
+  std::unique_ptr<OIIO::ImageInput> input = blender::imbuf::imb_oiio_open_file(filepath, config);
+  if (!input) {
+    return nullptr;
+  }
+
+  /* Multi-layer files and volumes have to be loaded as a whole. */
+  const OIIO::ImageSpec &spec = input->spec();
+  if (spec.nchannels < 1 || spec.nchannels > 4 || spec.depth > 1) {
+    return nullptr;
+  }
+  const bool is_float = spec.format.basesize() > 1;
+
+  ImBufTileSource *source = MEM_new<ImBufTileSource>(__func__);
+
+  for (int level = 0;; level++) {
+    const OIIO::ImageSpec level_spec = input->spec_dimensions(0, level);
+    if (level_spec.width <= 0 || level_spec.height <= 0) {
+      break;
+    }
+
+    ImBufTileLevel info;
+    info.width = level_spec.width;
+    info.height = level_spec.height;
+    if (level_spec.tile_width > 0) {
+      /* Tiles have to stay aligned to the tiles of the file. */
+      info.tile_width = level_spec.tile_width *
+                        max_ii(1, TILE_SOURCE_MIN_TILE_SIZE / level_spec.tile_width);
+      info.tile_height = level_spec.tile_height *
+                         max_ii(1, TILE_SOURCE_MIN_TILE_SIZE / level_spec.tile_height);
+    }
+    else {
+      /* Multiple of 16 scan-lines, the size of the compressed blocks of EXR files. */
+      info.tile_width = info.width;
+      info.tile_height = min_ii(
+          divide_ceil_u(TILE_SOURCE_BAND_PIXELS, info.width * 16) * 16, info.height);
+    }
+    info.tiles_x = divide_ceil_u(info.width, info.tile_width);
+    info.tiles_y = divide_ceil_u(info.height, info.tile_height);
+    source->levels.append(info);
+  }
+
+  if (source->levels.is_empty()) {
+    MEM_delete(source);
+    return nullptr;
+  }
+
+  /* Same color space choice as #imb_oiio_read. */
+  source->flags = flags;
+  if (colorspace) {
+    STRNCPY(source->colorspace, colorspace);
+  }
+  colorspace_set_default_role(source->colorspace,
+                              IM_MAX_SPACE,
+                              is_float ? COLOR_ROLE_DEFAULT_FLOAT : COLOR_ROLE_DEFAULT_BYTE);
+  if (colorspace) {
+    BLI_strncpy(colorspace, source->colorspace, IM_MAX_SPACE);
+  }
+
+  if (spec.alpha_channel != -1 && spec.get_int_attribute("oiio:UnassociatedAlpha", 0) == 0) {
+    source->alpha_flags = IB_alphamode_premul;
+  }
+  source->use_all_planes = spec.alpha_channel != -1;
+
+  source->input = std::move(input);
+  source->cache = IMB_moviecache_create(
+      "tile source", sizeof(ImBufTileKey), tile_source_hashhash, tile_source_hashcmp);
+
+  return source;
+}
+
+void IMB_tile_source_free(ImBufTileSource *source)
+{
+  IMB_moviecache_free(source->cache);
+  source->input->close();
+  MEM_delete(source);
+}
+
+int IMB_tile_source_levels_num(const ImBufTileSource *source)
+{
+  return source->levels.size();
+}
+
+void IMB_tile_source_level_size(const ImBufTileSource *source,
+                                int level,
+                                int *r_width,
+                                int *r_height,
+                                int *r_tile_width,
+                                int *r_tile_height)
+{
+  const ImBufTileLevel &info = source->levels[level];
+  *r_width = info.width;
+  *r_height = info.height;
+  *r_tile_width = info.tile_width;
+  *r_tile_height = info.tile_height;
+}
+
+ImBuf *IMB_tile_source_acquire_tile(ImBufTileSource *source, int level, int tile_x, int tile_y)
+{
+  const ImBufTileLevel &info = source->levels[level];
+  BLI_assert(tile_x >= 0 && tile_x < info.tiles_x && tile_y >= 0 && tile_y < info.tiles_y);
+
+  ImBufTileKey key = {level, tile_x, tile_y};
+  {
+    std::scoped_lock lock(source->cache_mutex);
+    if (ImBuf *ibuf = IMB_moviecache_get(source->cache, &key, nullptr)) {
+      return ibuf;
+    }
+  }
+
+  /* Decode without holding the lock, so that different tiles are read in parallel. Tiles are
+   * counted from the bottom, but stored from the top in the file. */
+  const int file_tile_y = info.tiles_y - 1 - tile_y;
+  const int xbegin = tile_x * info.tile_width;
+  const int xend = min_ii(xbegin + info.tile_width, info.width);
+  const int ybegin = file_tile_y * info.tile_height;
+  const int yend = min_ii(ybegin + info.tile_height, info.height);
+  ImBuf *ibuf = blender::imbuf::imb_oiio_read_region(
+      source->input.get(), level, xbegin, xend, ybegin, yend, source->use_all_planes);
+  if (ibuf == nullptr) {
+    return nullptr;
+  }
+
+  ibuf->flags |= source->alpha_flags;
+  char colorspace[IM_MAX_SPACE];
+  STRNCPY(colorspace, source->colorspace);
+  imb_handle_alpha(ibuf, source->flags, colorspace, source->colorspace);
+
+  std::scoped_lock lock(source->cache_mutex);
+  /* Another thread may have decoded the same tile in the meantime. */
+  if (ImBuf *cached_ibuf = IMB_moviecache_get(source->cache, &key, nullptr)) {
+    IMB_freeImBuf(ibuf);
+    return cached_ibuf;
+  }
+  IMB_moviecache_put(source->cache, &key, ibuf);
+
+  return ibuf;
+}
+
+/**
+ * Read the smallest MIP level of the file which is still at least \a max_thumb_size, without
+ * handling alpha, like the #ImFileType.load_filepath_thumbnail callbacks. Returns null for files
+ * without MIP levels, which have to be loaded as a whole.
+ */
+static ImBuf *tile_source_load_thumbnail(const char *filepath,
+                                         int flags,
+                                         size_t max_thumb_size,
+                                         char colorspace[IM_MAX_SPACE],
+                                         size_t *r_width,
+                                         size_t *r_height)
+{
+  /* Only pass on the color space when a level is read, the regular loader may choose another. */
+  char source_colorspace[IM_MAX_SPACE] = "";
+  if (colorspace) {
+    STRNCPY(source_colorspace, colorspace);
+  }
+  ImBufTileSource *source = IMB_tile_source_open(filepath, flags, source_colorspace);
+  if (source == nullptr) {
+    return nullptr;
+  }
+  if (source->levels.size() < 2) {
+    IMB_tile_source_free(source);
+    return nullptr;
+  }
+
+  int level = 0;
+  while (level + 1 < source->levels.size()) {
+    const ImBufTileLevel &next = source->levels[level + 1];
+    if (size_t(max_ii(next.width, next.height)) < max_thumb_size) {
+      break;
+    }
+    level++;
+  }
+
+  const ImBufTileLevel &info = source->levels[level];
+  ImBuf *ibuf = blender::imbuf::imb_oiio_read_region(
+      source->input.get(), level, 0, info.width, 0, info.height, source->use_all_planes);
+  if (ibuf) {
+    ibuf->flags |= source->alpha_flags;
+    if (colorspace) {
+      BLI_strncpy(colorspace, source_colorspace, IM_MAX_SPACE);
+    }
+    *r_width = source->levels[0].width;
+    *r_height = source->levels[0].height;
+  }
+
+  IMB_tile_source_free(source);
+  return ibuf;
+}
+
+void IMB_tile_source_sample_bilinear(
+    ImBufTileSource *source, int level, float u, float v, float r_color[4])
+{
+  const ImBufTileLevel &info = source->levels[level];
+  const float u_floor = floorf(u);
+  const float v_floor = floorf(v);
+  const float u_frac = u - u_floor;
+  const float v_frac = v - v_floor;
+  const int x0 = clamp_i(int(u_floor), 0, info.width - 1);
+  const int y0 = clamp_i(int(v_floor), 0, info.height - 1);
+  const int xs[4] = {x0, min_ii(x0 + 1, info.width - 1), x0, min_ii(x0 + 1, info.width - 1)};
+  const int ys[4] = {y0, y0, min_ii(y0 + 1, info.height - 1), min_ii(y0 + 1, info.height - 1)};
+  const float weights[4] = {(1.0f - u_frac) * (1.0f - v_frac),
+                            u_frac * (1.0f - v_frac),
+                            (1.0f - u_frac) * v_frac,
+                            u_frac * v_frac};
+
+  /* Usually all samples are in the same tile, only acquire it again when that changes. */
+  ImBuf *tile = nullptr;
+  int tile_x = -1;
+  int tile_y = -1;
+  zero_v4(r_color);
+
+  for (int i = 0; i < 4; i++) {
+    /* Rows of the file are stored from the top, so the bottom row of tiles can be smaller. */
+    const int file_y = info.height - 1 - ys[i];
+    const int file_tile_y = file_y / info.tile_height;
+    const int sample_tile_x = xs[i] / info.tile_width;
+    const int sample_tile_y = info.tiles_y - 1 - file_tile_y;
+    if (sample_tile_x != tile_x || sample_tile_y != tile_y) {
+      if (tile) {
+        IMB_freeImBuf(tile);
+      }
+      tile_x = sample_tile_x;
+      tile_y = sample_tile_y;
+      tile = IMB_tile_source_acquire_tile(source, level, tile_x, tile_y);
+    }
+    if (tile == nullptr) {
+      continue;
+    }
+
+    const int tile_file_yend = min_ii((file_tile_y + 1) * info.tile_height, info.height);
+    const size_t offset = 4 * (size_t(tile_file_yend - 1 - file_y) * tile->x +
+                               (xs[i] - tile_x * info.tile_width));
+    if (tile->float_buffer.data) {
+      madd_v4_v4fl(r_color, tile->float_buffer.data + offset, weights[i]);
+    }
+    else {
+      float color[4];
+      rgba_uchar_to_float(color, tile->byte_buffer.data + offset);
+      madd_v4_v4fl(r_color, color, weights[i]);
+    }
+  }
+
+  if (tile) {
+    IMB_freeImBuf(tile);
+  }
+}
+
+/** \} */
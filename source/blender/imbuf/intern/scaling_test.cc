@@ -0,0 +1,152 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_color.hh"
+#include "BLI_math_vector_types.hh"
+#include "IMB_imbuf.hh"
+
+namespace blender::imbuf::tests {
+
+static const ColorTheme4b test_image_pixels[12] = {
+    /* First row. */
+    ColorTheme4b(0, 0, 0, 255),
+    ColorTheme4b(255, 0, 0, 255),
+    ColorTheme4b(133, 55, 31, 13),
+    ColorTheme4b(133, 55, 31, 15),
+    ColorTheme4b(50, 200, 0, 255),
+    ColorTheme4b(55, 0, 32, 254),
+    /* Second row. */
+    ColorTheme4b(255, 255, 0, 255),
+    ColorTheme4b(255, 255, 255, 255),
+    ColorTheme4b(133, 55, 31, 17),
+    ColorTheme4b(133, 55, 31, 19),
+    ColorTheme4b(56, 0, 64, 253),
+    ColorTheme4b(57, 0, 96, 252),
+};
+
+/** Same pixels as the transform tests, stored row by row. */
+static ImBuf *create_6x2_test_image(const bool use_float)
+{
+  ImBuf *img = IMB_allocImBuf(6, 2, 32, use_float ? IB_rectfloat : IB_rect);
+  for (int i = 0; i < 12; i++) {
+    if (use_float) {
+      const ColorTheme4b &col = test_image_pixels[i];
+      reinterpret_cast<float4 *>(img->float_buffer.data)[i] = float4(col.r, col.g, col.b, col.a) /
+                                                               255.0f;
+    }
+    else {
+      reinterpret_cast<ColorTheme4b *>(img->byte_buffer.data)[i] = test_image_pixels[i];
+    }
+  }
+  return img;
+}
+
+static ImBuf *scale_test_image(const bool use_float, const int newx, const int newy)
+{
+  ImBuf *img = create_6x2_test_image(use_float);
+  IMB_scaleImBuf(img, newx, newy);
+  EXPECT_EQ(img->x, newx);
+  EXPECT_EQ(img->y, newy);
+  return img;
+}
+
+static void expect_float4_near(const float4 &a, const float4 &b)
+{
+  EXPECT_NEAR(a.x, b.x, 1.0e-5f);
+  EXPECT_NEAR(a.y, b.y, 1.0e-5f);
+  EXPECT_NEAR(a.z, b.z, 1.0e-5f);
+  EXPECT_NEAR(a.w, b.w, 1.0e-5f);
+}
+
+TEST(imbuf_scaling, box_2x_smaller_byte)
+{
+  ImBuf *res = scale_test_image(false, 3, 1);
+  const ColorTheme4b *got = reinterpret_cast<ColorTheme4b *>(res->byte_buffer.data);
+  EXPECT_EQ(got[0], ColorTheme4b(191, 127, 63, 255));
+  EXPECT_EQ(got[1], ColorTheme4b(133, 55, 31, 16));
+  EXPECT_EQ(got[2], ColorTheme4b(55, 50, 48, 253));
+  IMB_freeImBuf(res);
+}
+
+TEST(imbuf_scaling, box_2x_smaller_float)
+{
+  ImBuf *res = scale_test_image(true, 3, 1);
+  const float4 *got = reinterpret_cast<float4 *>(res->float_buffer.data);
+  expect_float4_near(got[0], float4(0.748324f, 0.497487f, 0.248328f, 1.0f));
+  expect_float4_near(got[1], float4(0.522367f, 0.216157f, 0.122196f, 0.064257f));
+  expect_float4_near(got[2], float4(0.214685f, 0.198113f, 0.187070f, 0.991050f));
+  IMB_freeImBuf(res);
+}
+
+TEST(imbuf_scaling, box_fractional_smaller_byte)
+{
+  ImBuf *res = scale_test_image(false, 4, 2);
+  const ColorTheme4b *got = reinterpret_cast<ColorTheme4b *>(res->byte_buffer.data);
+  EXPECT_EQ(got[0], ColorTheme4b(85, 0, 0, 255));
+  EXPECT_EQ(got[1], ColorTheme4b(174, 37, 21, 94));
+  EXPECT_EQ(got[3], ColorTheme4b(53, 68, 21, 254));
+  EXPECT_EQ(got[5], ColorTheme4b(174, 122, 106, 97));
+  EXPECT_EQ(got[7], ColorTheme4b(57, 0, 85, 252));
+  IMB_freeImBuf(res);
+}
+
+TEST(imbuf_scaling, linear_fractional_larger_byte)
+{
+  ImBuf *res = scale_test_image(false, 9, 7);
+  const ColorTheme4b *got = reinterpret_cast<ColorTheme4b *>(res->byte_buffer.data);
+  /* Corners match the source corners. */
+  EXPECT_EQ(got[0], ColorTheme4b(0, 0, 0, 255));
+  EXPECT_EQ(got[8], ColorTheme4b(55, 0, 32, 254));
+  EXPECT_EQ(got[54], ColorTheme4b(255, 255, 0, 255));
+  EXPECT_EQ(got[62], ColorTheme4b(57, 0, 96, 252));
+  EXPECT_EQ(got[1], ColorTheme4b(159, 0, 0, 255));
+  EXPECT_EQ(got[20], ColorTheme4b(225, 78, 72, 195));
+  EXPECT_EQ(got[31], ColorTheme4b(133, 55, 31, 16));
+  EXPECT_EQ(got[42], ColorTheme4b(74, 64, 40, 194));
+  EXPECT_EQ(got[52], ColorTheme4b(55, 21, 65, 253));
+  IMB_freeImBuf(res);
+}
+
+TEST(imbuf_scaling, linear_fractional_larger_float)
+{
+  ImBuf *res = scale_test_image(true, 9, 7);
+  const float4 *got = reinterpret_cast<float4 *>(res->float_buffer.data);
+  expect_float4_near(got[0], float4(0.0f, 0.0f, 0.0f, 1.0f));
+  expect_float4_near(got[1], float4(0.624875f, 0.0f, 0.0f, 1.0f));
+  expect_float4_near(got[20], float4(0.880512f, 0.303701f, 0.280195f, 0.764287f));
+  expect_float4_near(got[31], float4(0.521569f, 0.215686f, 0.121569f, 0.062733f));
+  expect_float4_near(got[42], float4(0.289436f, 0.250357f, 0.155723f, 0.762706f));
+  expect_float4_near(got[62], float4(0.223518f, 0.000001f, 0.376094f, 0.988247f));
+  IMB_freeImBuf(res);
+}
+
+TEST(imbuf_scaling, mixed_smaller_and_larger_byte)
+{
+  ImBuf *res = scale_test_image(false, 12, 1);
+  const ColorTheme4b *got = reinterpret_cast<ColorTheme4b *>(res->byte_buffer.data);
+  EXPECT_EQ(got[0], ColorTheme4b(127, 127, 0, 255));
+  EXPECT_EQ(got[3], ColorTheme4b(211, 101, 92, 168));
+  EXPECT_EQ(got[6], ColorTheme4b(133, 55, 31, 16));
+  EXPECT_EQ(got[11], ColorTheme4b(56, 0, 64, 253));
+  IMB_freeImBuf(res);
+}
+
+TEST(imbuf_scaling, single_pixel)
+{
+  ImBuf *res = scale_test_image(false, 1, 1);
+  const ColorTheme4b *got = reinterpret_cast<ColorTheme4b *>(res->byte_buffer.data);
+  EXPECT_EQ(got[0], ColorTheme4b(126, 78, 47, 174));
+
+  /* Scaling a single pixel up copies it. */
+  IMB_scaleImBuf(res, 5, 3);
+  got = reinterpret_cast<ColorTheme4b *>(res->byte_buffer.data);
+  for (int i = 0; i < 15; i++) {
+    EXPECT_EQ(got[i], ColorTheme4b(126, 78, 47, 174));
+  }
+  IMB_freeImBuf(res);
+}
+
+}  // namespace blender::imbuf::tests
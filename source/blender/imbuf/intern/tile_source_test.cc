@@ -0,0 +1,216 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "BLI_fileops.h"
+#include "BLI_math_base.h"
+#include "BLI_path_util.h"
+#include "BLI_string.h"
+#include "BLI_tempfile.h"
+#include "BLI_vector.hh"
+
+#include "BKE_appdir.hh"
+
+#include "CLG_log.h"
+
+#include "IMB_imbuf.hh"
+#include "IMB_imbuf_types.hh"
+#include "IMB_metadata.hh"
+
+#include "oiio/openimageio_support.hh"
+
+#include <OpenImageIO/imageio.h>
+
+namespace blender::imbuf::tests {
+
+/* Tiled TIFF file with MIP levels. The tile source groups the 64 pixel tiles of the file into 256
+ * pixel tiles, so the last column and the top row of tiles of every level are clipped. */
+static constexpr int file_width = 300;
+static constexpr int file_height = 600;
+static constexpr int file_tile_size = 64;
+static constexpr int file_levels_num = 3;
+static constexpr int source_tile_size = 256;
+
+/** Every pixel encodes its position in the file, with rows counted from the top. */
+static void file_pixel(const int level, const int x, const int y, uchar r_pixel[4])
+{
+  r_pixel[0] = uchar(x % 256);
+  r_pixel[1] = uchar(y % 256);
+  r_pixel[2] = uchar(x / 256 + 4 * (y / 256) + 16 * level);
+  r_pixel[3] = 255;
+}
+
+class TileSourceTest : public testing::Test {
+ public:
+  static char filepath[FILE_MAX];
+
+  static void SetUpTestSuite()
+  {
+    CLG_init();
+    BKE_appdir_init();
+    IMB_init();
+
+    char tempdir[FILE_MAX];
+    BLI_temp_directory_path_get(tempdir, sizeof(tempdir));
+    BLI_path_join(filepath, sizeof(filepath), tempdir, "imbuf_tile_source_test.tif");
+
+    std::unique_ptr<OIIO::ImageOutput> out = OIIO::ImageOutput::create(filepath);
+    ASSERT_TRUE(out && out->supports("mipmap"));
+    for (int level = 0; level < file_levels_num; level++) {
+      OIIO::ImageSpec spec(file_width >> level, file_height >> level, 4, OIIO::TypeDesc::UINT8);
+      spec.tile_width = file_tile_size;
+      spec.tile_height = file_tile_size;
+      const OIIO::ImageOutput::OpenMode mode = (level == 0) ? OIIO::ImageOutput::Create :
+                                                              OIIO::ImageOutput::AppendMIPLevel;
+      ASSERT_TRUE(out->open(filepath, spec, mode));
+
+      Vector<uchar> pixels(size_t(4) * spec.width * spec.height);
+      for (int y = 0; y < spec.height; y++) {
+        for (int x = 0; x < spec.width; x++) {
+          file_pixel(level, x, y, &pixels[(size_t(y) * spec.width + x) * 4]);
+        }
+      }
+      ASSERT_TRUE(out->write_image(OIIO::TypeDesc::UINT8, pixels.data()));
+    }
+    out->close();
+  }
+
+  static void TearDownTestSuite()
+  {
+    BLI_delete(filepath, false, false);
+    IMB_exit();
+    BKE_appdir_exit();
+    CLG_exit();
+  }
+};
+
+char TileSourceTest::filepath[FILE_MAX] = "";
+
+/**
+ * Check that \a ibuf contains the file region starting at \a xbegin and ending at \a yend, with
+ * the bottom row of the #ImBuf being the last row of the region in the file.
+ */
+static void expect_region(const ImBuf *ibuf, const int level, const int xbegin, const int yend)
+{
+  ASSERT_NE(ibuf->byte_buffer.data, nullptr);
+  int mismatches = 0;
+  for (int y = 0; y < ibuf->y; y++) {
+    for (int x = 0; x < ibuf->x; x++) {
+      uchar expected[4];
+      file_pixel(level, xbegin + x, yend - 1 - y, expected);
+      const uchar *pixel = ibuf->byte_buffer.data + (size_t(y) * ibuf->x + x) * 4;
+      if (memcmp(pixel, expected, sizeof(expected)) != 0) {
+        mismatches++;
+      }
+    }
+  }
+  EXPECT_EQ(mismatches, 0);
+}
+
+TEST_F(TileSourceTest, ReadRegion)
+{
+  std::unique_ptr<OIIO::ImageInput> input = imb_oiio_open_file(filepath, OIIO::ImageSpec());
+  ASSERT_TRUE(input);
+
+  /* Second row and column of file tiles of the first MIP level. */
+  const int level = 1;
+  ImBuf *ibuf = imb_oiio_read_region(input.get(),
+                                     level,
+                                     file_tile_size,
+                                     2 * file_tile_size,
+                                     file_tile_size,
+                                     2 * file_tile_size,
+                                     true);
+  ASSERT_NE(ibuf, nullptr);
+  EXPECT_EQ(ibuf->x, file_tile_size);
+  EXPECT_EQ(ibuf->y, file_tile_size);
+  expect_region(ibuf, level, file_tile_size, 2 * file_tile_size);
+  IMB_freeImBuf(ibuf);
+
+  /* Bottom right corner of the full resolution, clipped by the file size. */
+  const int xbegin = (file_width / file_tile_size) * file_tile_size;
+  const int ybegin = (file_height / file_tile_size) * file_tile_size;
+  ibuf = imb_oiio_read_region(input.get(), 0, xbegin, file_width, ybegin, file_height, true);
+  ASSERT_NE(ibuf, nullptr);
+  EXPECT_EQ(ibuf->x, file_width - xbegin);
+  EXPECT_EQ(ibuf->y, file_height - ybegin);
+  expect_region(ibuf, 0, xbegin, file_height);
+  IMB_freeImBuf(ibuf);
+}
+
+TEST_F(TileSourceTest, Tiles)
+{
+  ImBufTileSource *source = IMB_tile_source_open(filepath, IB_rect, nullptr);
+  ASSERT_NE(source, nullptr);
+  ASSERT_EQ(IMB_tile_source_levels_num(source), file_levels_num);
+
+  for (int level = 0; level < file_levels_num; level++) {
+    int width, height, tile_width, tile_height;
+    IMB_tile_source_level_size(source, level, &width, &height, &tile_width, &tile_height);
+    EXPECT_EQ(width, file_width >> level);
+    EXPECT_EQ(height, file_height >> level);
+    EXPECT_EQ(tile_width, source_tile_size);
+    EXPECT_EQ(tile_height, source_tile_size);
+
+    /* Tiles are counted from the bottom, so the clipped tiles of the top row of the file are the
+     * last ones, and the bottom row of the file is the bottom row of the first tiles. */
+    const int tiles_x = divide_ceil_u(width, tile_width);
+    const int tiles_y = divide_ceil_u(height, tile_height);
+    for (int tile_y = 0; tile_y < tiles_y; tile_y++) {
+      for (int tile_x = 0; tile_x < tiles_x; tile_x++) {
+        ImBuf *tile = IMB_tile_source_acquire_tile(source, level, tile_x, tile_y);
+        ASSERT_NE(tile, nullptr);
+
+        const int xbegin = tile_x * tile_width;
+        const int ybegin = (tiles_y - 1 - tile_y) * tile_height;
+        const int yend = std::min(ybegin + tile_height, height);
+        EXPECT_EQ(tile->x, std::min(tile_width, width - xbegin));
+        EXPECT_EQ(tile->y, yend - ybegin);
+        expect_region(tile, level, xbegin, yend);
+        IMB_freeImBuf(tile);
+      }
+    }
+  }
+
+  /* Samples at pixel centers across tile borders, in #ImBuf coordinates. */
+  for (const int x : {0, source_tile_size - 1, source_tile_size, file_width - 1}) {
+    for (const int y : {0, file_height - source_tile_size - 1, file_height - 1}) {
+      float color[4];
+      IMB_tile_source_sample_bilinear(source, 0, x, y, color);
+      uchar expected[4];
+      file_pixel(0, x, file_height - 1 - y, expected);
+      for (int c = 0; c < 4; c++) {
+        EXPECT_FLOAT_EQ(color[c], expected[c] / 255.0f);
+      }
+    }
+  }
+
+  IMB_tile_source_free(source);
+}
+
+TEST_F(TileSourceTest, Thumbnail)
+{
+  /* The smallest level which is at least the thumbnail size is read. */
+  ImBuf *ibuf = IMB_thumb_load_image(filepath, 256, nullptr);
+  ASSERT_NE(ibuf, nullptr);
+  EXPECT_EQ(ibuf->x, file_width >> 1);
+  EXPECT_EQ(ibuf->y, file_height >> 1);
+  expect_region(ibuf, 1, 0, file_height >> 1);
+
+  char value[40];
+  ASSERT_TRUE(
+      IMB_metadata_get_field(ibuf->metadata, "Thumb::Image::Width", value, sizeof(value)));
+  EXPECT_STREQ(value, "300");
+  ASSERT_TRUE(
+      IMB_metadata_get_field(ibuf->metadata, "Thumb::Image::Height", value, sizeof(value)));
+  EXPECT_STREQ(value, "600");
+
+  IMB_freeImBuf(ibuf);
+}
+
+}  // namespace blender::imbuf::tests
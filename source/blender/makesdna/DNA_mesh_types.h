@@ -18,6 +18,7 @@
 
 #  include <optional>
 
+#  include "BLI_index_mask_fwd.hh"
 #  include "BLI_math_vector_types.hh"
 #  include "BLI_memory_counter_fwd.hh"
 
@@ -322,6 +323,22 @@ typedef struct Mesh {
    * Cached map from each vertex to the faces using it.
    */
   blender::GroupedSpan<int> vert_to_face_map() const;
+  /**
+   * Offsets per edge used to slice arrays containing data for connected faces or face corners.
+   */
+  blender::OffsetIndices<int> edge_to_face_map_offsets() const;
+  /**
+   * Cached map from each edge to the corners using it.
+   */
+  blender::GroupedSpan<int> edge_to_corner_map() const;
+  /**
+   * Cached map from each edge to the faces using it.
+   */
+  blender::GroupedSpan<int> edge_to_face_map() const;
+  /**
+   * Cached map from each vertex to the edges using it.
+   */
+  blender::GroupedSpan<int> vert_to_edge_map() const;
 
   /**
    * Cached information about loose edges, calculated lazily when necessary.
@@ -404,6 +421,11 @@ typedef struct Mesh {
   void tag_positions_changed_uniformly();
   /** Like #tag_positions_changed but doesn't tag normals; they must be updated separately. */
   void tag_positions_changed_no_normals();
+  /**
+   * Like #tag_positions_changed, but only the given vertices moved. Cached face and vertex normals
+   * are kept and lazily updated only around the changed vertices.
+   */
+  void tag_positions_changed_partial(const blender::IndexMask &changed_verts);
   /** Call when changing "sharp_face" or "sharp_edge" data. */
   void tag_sharpness_changed();
   /** Call when changing #CD_CUSTOMLOOPNORMAL data. */
@@ -463,7 +485,8 @@ enum {
 
 /** #Mesh.flag */
 enum {
-  ME_FLAG_UNUSED_0 = 1 << 0,     /* cleared */
+  /** Use the native voxel remesher instead of OpenVDB (see #BKE_mesh_remesh_voxel). */
+  ME_REMESH_FAST = 1 << 0,
   ME_FLAG_UNUSED_1 = 1 << 1,     /* cleared */
   ME_FLAG_DEPRECATED_2 = 1 << 2, /* deprecated */
   ME_FLAG_UNUSED_3 = 1 << 3,     /* cleared */
@@ -1653,6 +1653,8 @@ typedef struct NodeGeometryMeshCone {
 typedef struct NodeGeometryMergeByDistance {
   /** #GeometryNodeMergeByDistanceMode. */
   uint8_t mode;
+  /** #GeometryNodeMergeByDistanceSearchMethod. */
+  uint8_t search_method;
 } NodeGeometryMergeByDistance;
 
 typedef struct NodeGeometryMeshLine {
@@ -2831,6 +2833,12 @@ typedef enum GeometryNodeMergeByDistanceMode {
   GEO_NODE_MERGE_BY_DISTANCE_MODE_CONNECTED = 1,
 } GeometryNodeMergeByDistanceMode;
 
+typedef enum GeometryNodeMergeByDistanceSearchMethod {
+  GEO_NODE_MERGE_BY_DISTANCE_SEARCH_AUTO = 0,
+  GEO_NODE_MERGE_BY_DISTANCE_SEARCH_KD_TREE = 1,
+  GEO_NODE_MERGE_BY_DISTANCE_SEARCH_GRID = 2,
+} GeometryNodeMergeByDistanceSearchMethod;
+
 typedef enum GeometryNodeUVUnwrapMethod {
   GEO_NODE_UV_UNWRAP_METHOD_ANGLE_BASED = 0,
   GEO_NODE_UV_UNWRAP_METHOD_CONFORMAL = 1,
@@ -529,7 +529,9 @@ enum {
   R_IMF_EXR_CODEC_B44A = 7,
   R_IMF_EXR_CODEC_DWAA = 8,
   R_IMF_EXR_CODEC_DWAB = 9,
-  R_IMF_EXR_CODEC_MAX = 10,
+  /** ZIP with the fastest compression level, files are read as regular ZIP. */
+  R_IMF_EXR_CODEC_ZIP_FAST = 10,
+  R_IMF_EXR_CODEC_MAX = 11,
 };
 
 /** #ImageFormatData::jp2_flag */
@@ -2187,6 +2189,8 @@ enum {
   R_SCEMODE_UNUSED_19 = 1 << 19, /* cleared */
   R_EXR_CACHE_FILE = 1 << 20,
   R_MULTIVIEW = 1 << 21,
+  /** Write OpenEXR frames of animations while the next frame renders. */
+  R_WRITE_BACKGROUND = 1 << 22,
 };
 
 /** #RenderData::stamp */
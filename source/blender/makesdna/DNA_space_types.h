@@ -658,6 +658,7 @@ typedef enum eSpaceSeq_SequencerCacheOverlay_Flag {
   SEQ_CACHE_SHOW_PREPROCESSED = (1 << 3),
   SEQ_CACHE_SHOW_COMPOSITE = (1 << 4),
   SEQ_CACHE_SHOW_FINAL_OUT = (1 << 5),
+  SEQ_CACHE_SHOW_STATISTICS = (1 << 6),
 } eSpaceSeq_SequencerCacheOverlay_Flag;
 
 /** Sequencer. */
@@ -3204,6 +3204,16 @@ static void rna_def_mesh(BlenderRNA *brna)
   RNA_def_property_update(prop, 0, "rna_Mesh_update_draw");
   RNA_def_property_flag(prop, PROP_NO_DEG_UPDATE);
 
+  prop = RNA_def_property(srna, "use_remesh_fast", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, nullptr, "flag", ME_REMESH_FAST);
+  RNA_def_property_ui_text(
+      prop,
+      "Fast",
+      "Build the volume directly from the mesh faces, which is faster. Only supported without "
+      "adaptivity and for closed meshes, overlapping or intersecting parts may give holes");
+  RNA_def_property_update(prop, 0, "rna_Mesh_update_draw");
+  RNA_def_property_flag(prop, PROP_NO_DEG_UPDATE);
+
   prop = RNA_def_property(srna, "use_remesh_preserve_volume", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, nullptr, "flag", ME_REMESH_REPROJECT_VOLUME);
   RNA_def_property_ui_text(
@@ -178,9 +178,8 @@ static void rna_Mesh_update(Mesh *mesh,
   /* Default state is not to have tessface's so make sure this is the case. */
   BKE_mesh_tessface_clear(mesh);
 
-  mesh->runtime->vert_normals_cache.tag_dirty();
-  mesh->runtime->face_normals_cache.tag_dirty();
-  mesh->runtime->corner_normals_cache.tag_dirty();
+  /* Also discards pending partial normal updates, which are invalid after arbitrary edits. */
+  mesh->tag_positions_changed();
 
   DEG_id_tag_update(&mesh->id, 0);
   WM_event_add_notifier(C, NC_GEOM | ND_DATA, mesh);
@@ -6029,6 +6029,12 @@ static void rna_def_space_sequencer_cache_overlay(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Final Images", "Visualize cached complete frames");
   RNA_def_property_update(prop, NC_SCENE | ND_SEQUENCER, nullptr);
 
+  prop = RNA_def_property(srna, "show_cache_statistics", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, nullptr, "cache_overlay.flag", SEQ_CACHE_SHOW_STATISTICS);
+  RNA_def_property_ui_text(
+      prop, "Statistics", "Display hit rate and memory reuse counters of the cache");
+  RNA_def_property_update(prop, NC_SCENE | ND_SEQUENCER, nullptr);
+
   prop = RNA_def_property(srna, "show_cache_raw", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, nullptr, "cache_overlay.flag", SEQ_CACHE_SHOW_RAW);
   RNA_def_property_ui_text(prop, "Raw Images", "Visualize cached raw images");
@@ -84,9 +84,8 @@ static meshintersect::CDT_result<double> do_cdt(const bke::CurvesGeometry &curve
   return delaunay_2d_calc(input, output_type);
 }
 
-static meshintersect::CDT_result<double> do_cdt_with_mask(const bke::CurvesGeometry &curves,
-                                                          const CDT_output_type output_type,
-                                                          const IndexMask &mask)
+static meshintersect::CDT_input<double> cdt_input_with_mask(const bke::CurvesGeometry &curves,
+                                                            const IndexMask &mask)
 {
   const OffsetIndices points_by_curve = curves.evaluated_points_by_curve();
   const Span<float3> positions = curves.evaluated_positions();
@@ -113,8 +112,7 @@ static meshintersect::CDT_result<double> do_cdt_with_mask(const bke::CurvesGeome
   input.need_ids = false;
   input.vert = std::move(positions_2d);
   input.face = std::move(faces);
-
-  return delaunay_2d_calc(input, output_type);
+  return input;
 }
 
 static Array<meshintersect::CDT_result<double>> do_group_aware_cdt(
@@ -138,20 +136,15 @@ static Array<meshintersect::CDT_result<double>> do_group_aware_cdt(
       curve_group_ids, mask_memory, group_indexing);
   const int groups_num = group_masks.size();
 
-  Array<meshintersect::CDT_result<double>> cdt_results(groups_num);
-
-  /* The grain size should be larger as each group gets smaller. */
-  const int domain_size = curve_group_ids.size();
-  const int avg_group_size = domain_size / groups_num;
-  const int grain_size = std::max(8192 / avg_group_size, 1);
-  threading::parallel_for(IndexRange(groups_num), grain_size, [&](const IndexRange range) {
+  Array<meshintersect::CDT_input<double>> cdt_inputs(groups_num);
+  threading::parallel_for(IndexRange(groups_num), 256, [&](const IndexRange range) {
     for (const int group_index : range) {
-      const IndexMask &mask = group_masks[group_index];
-      cdt_results[group_index] = do_cdt_with_mask(curves, output_type, mask);
+      cdt_inputs[group_index] = cdt_input_with_mask(curves, group_masks[group_index]);
     }
   });
 
-  return cdt_results;
+  /* The batched triangulation balances the work based on the size of each group. */
+  return meshintersect::delaunay_2d_calc(cdt_inputs.as_span(), output_type);
 }
 
 /* Converts multiple CDT results into a single Mesh. */
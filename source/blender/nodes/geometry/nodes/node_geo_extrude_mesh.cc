@@ -407,12 +407,9 @@ static void extrude_mesh_vertices(Mesh &mesh,
   const IDsByDomain ids_by_domain = attribute_ids_by_domain(attributes,
                                                             {"position", ".edge_verts"});
 
-  Array<int> vert_to_edge_offsets;
-  Array<int> vert_to_edge_indices;
   GroupedSpan<int> vert_to_edge_map;
   if (!ids_by_domain[int(AttrDomain::Edge)].is_empty()) {
-    vert_to_edge_map = bke::mesh::build_vert_to_edge_map(
-        mesh.edges(), orig_vert_size, vert_to_edge_offsets, vert_to_edge_indices);
+    vert_to_edge_map = mesh.vert_to_edge_map();
   }
 
   remove_unsupported_vert_data(mesh);
@@ -614,10 +611,7 @@ static void extrude_mesh_edges(Mesh &mesh,
   MutableAttributeAccessor attributes = mesh.attributes_for_write();
   remove_non_propagated_attributes(attributes, propagation_info);
 
-  Array<int> edge_to_face_offsets;
-  Array<int> edge_to_face_indices;
-  const GroupedSpan<int> edge_to_face_map = bke::mesh::build_edge_to_face_map(
-      orig_faces, mesh.corner_edges(), mesh.edges_num, edge_to_face_offsets, edge_to_face_indices);
+  const GroupedSpan<int> edge_to_face_map = mesh.edge_to_face_map();
 
   Array<int> vert_to_edge_offsets;
   Array<int> vert_to_edge_indices;
@@ -884,10 +878,7 @@ static void extrude_mesh_face_regions(Mesh &mesh,
   }
 
   /* All of the faces (selected and deselected) connected to each edge. */
-  Array<int> edge_to_face_offsets;
-  Array<int> edge_to_face_indices;
-  const GroupedSpan<int> edge_to_face_map = bke::mesh::build_edge_to_face_map(
-      orig_faces, mesh.corner_edges(), mesh.edges_num, edge_to_face_offsets, edge_to_face_indices);
+  const GroupedSpan<int> edge_to_face_map = mesh.edge_to_face_map();
 
   /* All vertices that are connected to the selected faces. */
   IndexMaskMemory memory;
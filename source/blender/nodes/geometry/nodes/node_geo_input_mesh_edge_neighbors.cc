@@ -2,8 +2,6 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
-#include "BLI_array_utils.hh"
-
 #include "BKE_mesh.hh"
 
 #include "node_geometry_util.hh"
@@ -29,8 +27,9 @@ class EdgeNeighborCountFieldInput final : public bke::MeshFieldInput {
                                  const AttrDomain domain,
                                  const IndexMask & /*mask*/) const final
   {
-    Array<int> counts(mesh.edges_num, 0);
-    array_utils::count_indices(mesh.corner_edges(), counts);
+    const OffsetIndices<int> offsets = mesh.edge_to_face_map_offsets();
+    Array<int> counts(mesh.edges_num);
+    offset_indices::copy_group_sizes(offsets, offsets.index_range(), counts);
     return mesh.attributes().adapt_domain<int>(
         VArray<int>::ForContainer(std::move(counts)), AttrDomain::Edge, domain);
   }
@@ -35,10 +35,17 @@ static void node_layout(uiLayout *layout, bContext * /*C*/, PointerRNA *ptr)
   uiItemR(layout, ptr, "mode", UI_ITEM_NONE, "", ICON_NONE);
 }
 
+static void node_layout_ex(uiLayout *layout, bContext *C, PointerRNA *ptr)
+{
+  node_layout(layout, C, ptr);
+  uiItemR(layout, ptr, "search_method", UI_ITEM_NONE, nullptr, ICON_NONE);
+}
+
 static void node_init(bNodeTree * /*tree*/, bNode *node)
 {
   NodeGeometryMergeByDistance *data = MEM_cnew<NodeGeometryMergeByDistance>(__func__);
   data->mode = GEO_NODE_MERGE_BY_DISTANCE_MODE_ALL;
+  data->search_method = GEO_NODE_MERGE_BY_DISTANCE_SEARCH_AUTO;
   node->storage = data;
 }
 
@@ -46,6 +53,7 @@ static PointCloud *pointcloud_merge_by_distance(
     const PointCloud &src_points,
     const float merge_distance,
     const Field<bool> &selection_field,
+    const geometry::MergeByDistanceSearch search,
     const AnonymousAttributePropagationInfo &propagation_info)
 {
   const bke::PointCloudFieldContext context{src_points};
@@ -59,7 +67,7 @@ static PointCloud *pointcloud_merge_by_distance(
   }
 
   return geometry::point_merge_by_distance(
-      src_points, merge_distance, selection, propagation_info);
+      src_points, merge_distance, selection, propagation_info, search);
 }
 
 static std::optional<Mesh *> mesh_merge_by_distance_connected(const Mesh &mesh,
@@ -75,9 +83,11 @@ static std::optional<Mesh *> mesh_merge_by_distance_connected(const Mesh &mesh,
   return geometry::mesh_merge_by_distance_connected(mesh, selection, merge_distance, false);
 }
 
-static std::optional<Mesh *> mesh_merge_by_distance_all(const Mesh &mesh,
-                                                        const float merge_distance,
-                                                        const Field<bool> &selection_field)
+static std::optional<Mesh *> mesh_merge_by_distance_all(
+    const Mesh &mesh,
+    const float merge_distance,
+    const Field<bool> &selection_field,
+    const geometry::MergeByDistanceSearch search)
 {
   const bke::MeshFieldContext context{mesh, AttrDomain::Point};
   FieldEvaluator evaluator{context, mesh.verts_num};
@@ -89,13 +99,15 @@ static std::optional<Mesh *> mesh_merge_by_distance_all(const Mesh &mesh,
     return std::nullopt;
   }
 
-  return geometry::mesh_merge_by_distance_all(mesh, selection, merge_distance);
+  return geometry::mesh_merge_by_distance_all(mesh, selection, merge_distance, search);
 }
 
 static void node_geo_exec(GeoNodeExecParams params)
 {
   const NodeGeometryMergeByDistance &storage = node_storage(params.node());
   const GeometryNodeMergeByDistanceMode mode = (GeometryNodeMergeByDistanceMode)storage.mode;
+  const geometry::MergeByDistanceSearch search = geometry::MergeByDistanceSearch(
+      storage.search_method);
 
   GeometrySet geometry_set = params.extract_input<GeometrySet>("Geometry");
 
@@ -105,7 +117,11 @@ static void node_geo_exec(GeoNodeExecParams params)
   geometry_set.modify_geometry_sets([&](GeometrySet &geometry_set) {
     if (const PointCloud *pointcloud = geometry_set.get_pointcloud()) {
       PointCloud *result = pointcloud_merge_by_distance(
-          *pointcloud, merge_distance, selection, params.get_output_propagation_info("Geometry"));
+          *pointcloud,
+          merge_distance,
+          selection,
+          search,
+          params.get_output_propagation_info("Geometry"));
       if (result) {
         geometry_set.replace_pointcloud(result);
       }
@@ -114,7 +130,7 @@ static void node_geo_exec(GeoNodeExecParams params)
       std::optional<Mesh *> result;
       switch (mode) {
         case GEO_NODE_MERGE_BY_DISTANCE_MODE_ALL:
-          result = mesh_merge_by_distance_all(*mesh, merge_distance, selection);
+          result = mesh_merge_by_distance_all(*mesh, merge_distance, selection, search);
           break;
         case GEO_NODE_MERGE_BY_DISTANCE_MODE_CONNECTED:
           result = mesh_merge_by_distance_connected(*mesh, merge_distance, selection);
@@ -154,6 +170,35 @@ static void node_rna(StructRNA *srna)
                     mode_items,
                     NOD_storage_enum_accessors(mode),
                     GEO_NODE_MERGE_BY_DISTANCE_MODE_ALL);
+
+  static EnumPropertyItem search_method_items[] = {
+      {GEO_NODE_MERGE_BY_DISTANCE_SEARCH_AUTO,
+       "AUTO",
+       0,
+       "Auto",
+       "Use the grid for large inputs and the KD-tree otherwise"},
+      {GEO_NODE_MERGE_BY_DISTANCE_SEARCH_KD_TREE,
+       "KD_TREE",
+       0,
+       "KD-Tree",
+       "Find close points with a balanced KD-tree"},
+      {GEO_NODE_MERGE_BY_DISTANCE_SEARCH_GRID,
+       "GRID",
+       0,
+       "Grid",
+       "Find close points with a uniform grid with cells the size of the merge distance. Faster "
+       "and uses less memory for large inputs, but slow when many points are within the distance "
+       "of each other"},
+      {0, nullptr, 0, nullptr, nullptr},
+  };
+
+  RNA_def_node_enum(srna,
+                    "search_method",
+                    "Search Method",
+                    "Acceleration structure used to find points to merge when merging all points",
+                    search_method_items,
+                    NOD_storage_enum_accessors(search_method),
+                    GEO_NODE_MERGE_BY_DISTANCE_SEARCH_AUTO);
 }
 
 static void node_register()
@@ -169,6 +214,7 @@ static void node_register()
   ntype.declare = node_declare;
   ntype.geometry_node_execute = node_geo_exec;
   ntype.draw_buttons = node_layout;
+  ntype.draw_buttons_ex = node_layout_ex;
   blender::bke::nodeRegisterType(&ntype);
 
   node_rna(ntype.rna_ext.srna);
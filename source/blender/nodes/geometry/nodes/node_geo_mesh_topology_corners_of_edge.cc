@@ -3,7 +3,6 @@
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
 #include "BKE_mesh.hh"
-#include "BKE_mesh_mapping.hh"
 
 #include "BLI_array_utils.hh"
 
@@ -50,11 +49,8 @@ class CornersOfEdgeInput final : public bke::MeshFieldInput {
                                  const IndexMask &mask) const final
   {
     const IndexRange edge_range(mesh.edges_num);
-    Array<int> map_offsets;
-    Array<int> map_indices;
     const Span<int> corner_edges = mesh.corner_edges();
-    const GroupedSpan<int> edge_to_loop_map = bke::mesh::build_edge_to_corner_map(
-        mesh.corner_edges(), mesh.edges_num, map_offsets, map_indices);
+    const GroupedSpan<int> edge_to_loop_map = mesh.edge_to_corner_map();
 
     const bke::MeshFieldContext context{mesh, domain};
     fn::FieldEvaluator evaluator{context, &mask};
@@ -147,8 +143,9 @@ class CornersOfEdgeCountInput final : public bke::MeshFieldInput {
     if (domain != AttrDomain::Edge) {
       return {};
     }
-    Array<int> counts(mesh.edges_num, 0);
-    array_utils::count_indices(mesh.corner_edges(), counts);
+    const OffsetIndices<int> offsets = mesh.edge_to_face_map_offsets();
+    Array<int> counts(mesh.edges_num);
+    offset_indices::copy_group_sizes(offsets, offsets.index_range(), counts);
     return VArray<int>::ForContainer(std::move(counts));
   }
 
@@ -36,6 +36,7 @@
 #include "BLI_rect.h"
 #include "BLI_set.hh"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_time.h"
 #include "BLI_timecode.h"
@@ -167,12 +168,14 @@ static void render_callback_exec_id(Render *re, Main *bmain, ID *id, eCbEvent ev
 /** \name Allocation & Free
  * \{ */
 
+struct RenderWriteJob;
 static bool do_write_image_or_movie(Render *re,
                                     Main *bmain,
                                     Scene *scene,
                                     bMovieHandle *mh,
                                     const int totvideos,
-                                    const char *filepath_override);
+                                    const char *filepath_override,
+                                    RenderWriteJob **r_write_job = nullptr);
 
 /* default callbacks, set in each new render */
 static void result_nothing(void * /*arg*/, RenderResult * /*rr*/) {}
@@ -2221,17 +2224,159 @@ bool RE_WriteRenderViewsMovie(ReportList *reports,
   return ok;
 }
 
+/**
+ * An OpenEXR frame written by a background task while the next frame renders,
+ * see #R_WRITE_BACKGROUND. The job writes a copy of the render result, so the
+ * render can continue with the next frame right away.
+ */
+struct RenderWriteJob {
+  ReportList *reports;
+  RenderResult *rr;
+  ImageFormatData image_format;
+  /** File path and view name for every file to write. A null view writes all views. */
+  blender::Vector<std::pair<std::string, const char *>> files;
+  int cfra;
+  bool ok;
+  TaskPool *pool;
+};
+
+static bool render_write_background_supported(const RenderResult *rr,
+                                              const ImageFormatData *imf)
+{
+  if (!ELEM(imf->imtype, R_IMF_IMTYPE_OPENEXR, R_IMF_IMTYPE_MULTILAYER) ||
+      !RE_HasFloatPixels(rr))
+  {
+    return false;
+  }
+  /* JPEG previews and stereo 3D images are written by the regular code path. */
+  if (imf->flag & R_IMF_FLAG_PREVIEW_JPG) {
+    return false;
+  }
+  const bool is_mono = BLI_listbase_count_at_most(&rr->views, 2) < 2;
+  return is_mono || imf->views_format != R_IMF_VIEWS_STEREO_3D;
+}
+
+static void render_write_job_task(TaskPool *__restrict pool, void * /*taskdata*/)
+{
+  RenderWriteJob *job = static_cast<RenderWriteJob *>(BLI_task_pool_user_data(pool));
+
+  for (const std::pair<std::string, const char *> &file : job->files) {
+    const char *filepath = file.first.c_str();
+    if (!BKE_image_render_write_exr(
+            job->reports, job->rr, filepath, &job->image_format, true, file.second, -1))
+    {
+      BKE_reportf(job->reports,
+                  RPT_ERROR,
+                  "Render error (%s) cannot save: '%s'",
+                  strerror(errno),
+                  filepath);
+      job->ok = false;
+      return;
+    }
+    if (!G.quiet) {
+      printf("Saved: '%s'\n", filepath);
+    }
+  }
+}
+
+/**
+ * Start writing the render result in the background.
+ * Returns null when the image format has to be written by #BKE_image_render_write.
+ */
+static RenderWriteJob *render_write_job_start(Render *re,
+                                              Scene *scene,
+                                              RenderResult *rres,
+                                              const char *filepath)
+{
+  RenderWriteJob *job = MEM_new<RenderWriteJob>(__func__);
+  BKE_image_format_init_for_write(&job->image_format, scene, nullptr);
+
+  if (!render_write_background_supported(rres, &job->image_format)) {
+    BKE_image_format_free(&job->image_format);
+    MEM_delete(job);
+    return nullptr;
+  }
+
+  /* Resolve the file paths here, the scene is not accessed while writing. */
+  const bool is_mono = BLI_listbase_count_at_most(&rres->views, 2) < 2;
+  if (job->image_format.views_format == R_IMF_VIEWS_MULTIVIEW) {
+    job->files.append({filepath, nullptr});
+  }
+  else {
+    LISTBASE_FOREACH (const RenderView *, rv, &rres->views) {
+      char filepath_view[FILE_MAX];
+      if (is_mono) {
+        STRNCPY(filepath_view, filepath);
+      }
+      else {
+        BKE_scene_multiview_view_filepath_get(&scene->r, filepath, rv->name, filepath_view);
+      }
+      job->files.append({filepath_view, rv->name});
+    }
+  }
+
+  job->reports = re->reports;
+  job->rr = RE_DuplicateRenderResult(rres);
+  job->cfra = scene->r.cfra;
+  job->ok = true;
+
+  /* View names point into the copy of the render result. */
+  const RenderView *rv_copy = static_cast<const RenderView *>(job->rr->views.first);
+  for (std::pair<std::string, const char *> &file : job->files) {
+    if (file.second) {
+      file.second = rv_copy->name;
+      rv_copy = rv_copy->next;
+    }
+  }
+
+  job->pool = BLI_task_pool_create_background(job, TASK_PRIORITY_HIGH);
+  BLI_task_pool_push(job->pool, render_write_job_task, nullptr, false, nullptr);
+  return job;
+}
+
+/**
+ * Wait for the background write to finish and run the write handlers for its frame.
+ * Returns false when the file could not be written.
+ */
+static bool render_write_job_finish(Render *re, Scene *scene, RenderWriteJob **job_p)
+{
+  RenderWriteJob *job = *job_p;
+  if (job == nullptr) {
+    return true;
+  }
+  *job_p = nullptr;
+
+  BLI_task_pool_work_and_wait(job->pool);
+  BLI_task_pool_free(job->pool);
+
+  const bool ok = job->ok;
+  if (ok) {
+    /* Handlers expect the current frame to be the one that was written. */
+    const int cfra = scene->r.cfra;
+    scene->r.cfra = job->cfra;
+    render_callback_exec_id(re, re->main, &scene->id, BKE_CB_EVT_RENDER_WRITE);
+    scene->r.cfra = cfra;
+  }
+
+  RE_FreeRenderResult(job->rr);
+  BKE_image_format_free(&job->image_format);
+  MEM_delete(job);
+  return ok;
+}
+
 static bool do_write_image_or_movie(Render *re,
                                     Main *bmain,
                                     Scene *scene,
                                     bMovieHandle *mh,
                                     const int totvideos,
-                                    const char *filepath_override)
+                                    const char *filepath_override,
+                                    RenderWriteJob **r_write_job)
 {
   char filepath[FILE_MAX];
   RenderResult rres;
   double render_time;
   bool ok = true;
+  bool is_write_background = false;
   RenderEngineType *re_type = RE_engines_find(re->r.engine);
 
   /* Only disable file writing if postprocessing is also disabled. */
@@ -2261,8 +2406,14 @@ static bool do_write_image_or_movie(Render *re,
                                      nullptr);
       }
 
-      /* write images as individual images or stereo */
-      ok = BKE_image_render_write(re->reports, &rres, scene, true, filepath);
+      if (r_write_job) {
+        *r_write_job = render_write_job_start(re, scene, &rres, filepath);
+        is_write_background = *r_write_job != nullptr;
+      }
+      if (!is_write_background) {
+        /* write images as individual images or stereo */
+        ok = BKE_image_render_write(re->reports, &rres, scene, true, filepath);
+      }
     }
 
     RE_ReleaseResultImageViews(re, &rres);
@@ -2274,7 +2425,10 @@ static bool do_write_image_or_movie(Render *re,
   BLI_timecode_string_from_time_simple(filepath, sizeof(filepath), re->i.lastframetime);
   std::string message = fmt::format("Time: {}", filepath);
 
-  if (do_write_file) {
+  if (is_write_background) {
+    message = fmt::format("{} (Saving in background)", message);
+  }
+  else if (do_write_file) {
     BLI_timecode_string_from_time_simple(
         filepath, sizeof(filepath), re->i.lastframetime - render_time);
     message = fmt::format("{} (Saving: {})", message, filepath);
@@ -2352,6 +2506,8 @@ void RE_RenderAnim(Render *re,
   const bool is_movie = BKE_imtype_is_movie(rd.im_format.imtype);
   const bool is_multiview_name = ((rd.scemode & R_MULTIVIEW) != 0 &&
                                   (rd.im_format.views_format == R_IMF_VIEWS_INDIVIDUAL));
+  const bool use_write_background = !is_movie && (rd.scemode & R_WRITE_BACKGROUND) != 0;
+  RenderWriteJob *write_job = nullptr;
 
   /* do not fully call for each frame, it initializes & pops output window */
   if (!render_init_from_main(re, &rd, bmain, scene, single_layer, camera_override, false, true)) {
@@ -2534,11 +2690,24 @@ void RE_RenderAnim(Render *re,
     totrendered++;
 
     const bool should_write = !(re->flag & R_SKIP_WRITE);
+    bool is_write_background = false;
     if (re->test_break_cb(re->tbh) == 0) {
       if (!G.is_break && should_write) {
-        if (!do_write_image_or_movie(re, bmain, scene, mh, totvideos, nullptr)) {
+        /* Only one frame is written in the background at a time. */
+        if (!render_write_job_finish(re, scene, &write_job)) {
+          G.is_break = true;
+        }
+        else if (!do_write_image_or_movie(re,
+                                          bmain,
+                                          scene,
+                                          mh,
+                                          totvideos,
+                                          nullptr,
+                                          use_write_background ? &write_job : nullptr))
+        {
           G.is_break = true;
         }
+        is_write_background = write_job != nullptr;
       }
     }
     else {
@@ -2580,12 +2749,17 @@ void RE_RenderAnim(Render *re,
     if (G.is_break == false) {
       /* keep after file save */
       render_callback_exec_id(re, re->main, &scene->id, BKE_CB_EVT_RENDER_POST);
-      if (should_write) {
+      if (should_write && !is_write_background) {
         render_callback_exec_id(re, re->main, &scene->id, BKE_CB_EVT_RENDER_WRITE);
       }
     }
   }
 
+  /* The last frame may still be writing, also when the render was canceled. */
+  if (!render_write_job_finish(re, scene, &write_job)) {
+    G.is_break = true;
+  }
+
   /* end movie */
   if (is_movie && do_write_file) {
     re_movie_free_all(re, mh, totvideos);
@@ -59,6 +59,23 @@ void SEQ_cache_iterate(
     void *userdata,
     bool callback_init(void *userdata, size_t item_count),
     bool callback_iter(void *userdata, Sequence *seq, int timeline_frame, int cache_type));
+
+/** Counters of the RAM cache, since it was created or last cleaned up. */
+struct SeqCacheStatistics {
+  /** Images found in RAM, on disk or not found, for image types that are stored. */
+  int64_t hits;
+  int64_t disk_hits;
+  int64_t misses;
+  /** Frames freed to stay within the memory limit. */
+  int64_t recycled_frames;
+  /** Images stored by sharing the buffer of an identical image. */
+  int64_t shared_images;
+};
+/**
+ * Get the cache counters of the scene.
+ * \return false when the scene has no cache.
+ */
+bool SEQ_cache_statistics_get(const Scene *scene, SeqCacheStatistics *r_stats);
 /**
  * Return immediate parent meta of sequence.
  */
@@ -23,7 +23,9 @@ struct rctf;
 
 enum eSeqTaskId {
   SEQ_TASK_MAIN_RENDER,
+  /** Prefetch workers use consecutive IDs starting with this one. */
   SEQ_TASK_PREFETCH_RENDER,
+  SEQ_TASK_PREFETCH_RENDER_LAST = SEQ_TASK_PREFETCH_RENDER + 15,
 };
 
 struct SeqRenderData {
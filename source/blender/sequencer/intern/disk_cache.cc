@@ -25,7 +25,9 @@
 #include "BLI_fileops.h"
 #include "BLI_fileops_types.h"
 #include "BLI_listbase.h"
+#include "BLI_mmap.h"
 #include "BLI_path_util.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 
 #include "BKE_main.hh"
@@ -44,13 +46,20 @@
  * For each cached non-temp image, image data and supplementary info are written to HDD.
  * Multiple(DCACHE_IMAGES_PER_FILE) images share the same file.
  * Each of these files contains header DiskCacheHeader followed by image data.
- * ZLIB compression with user definable level can be used to compress image data(per image)
+ * ZSTD compression with user definable level can be used to compress image data(per image)
  * Images are written in order in which they are rendered.
  * Overwriting of individual entry is not possible.
  * Stored images are deleted by invalidation, or when size of all files exceeds maximum
  * size specified in user preferences.
  * To distinguish 2 blend files with same name, scene->ed->disk_cache_timestamp
  * is used as UID. Blend file can still be copied manually which may cause conflict.
+ *
+ * Images are written in the background: the file path is resolved and the image is queued when
+ * it is added, and a worker thread compresses and writes queued images in order. Compression
+ * runs without any lock held, only appending the data and updating the header is done under
+ * `read_write_mutex`. Reading an image that is still queued returns the queued image.
+ * Invalidation removes queued images together with the files. When the queue is full, the image
+ * is written on the calling thread instead.
  */
 
 /* Format string:
@@ -58,6 +67,7 @@
 #define DCACHE_FNAME_FORMAT "%d-%dx%d-%d%%(%d)-%d.dcf"
 #define DCACHE_IMAGES_PER_FILE 100
 #define DCACHE_CURRENT_VERSION 2
+#define DCACHE_WRITE_QUEUE_MAX 8
 #define COLORSPACE_NAME_MAX 64 /* XXX: defined in IMB intern. */
 
 struct DiskCacheHeaderEntry {
@@ -73,12 +83,33 @@ struct DiskCacheHeader {
   DiskCacheHeaderEntry entry[DCACHE_IMAGES_PER_FILE];
 };
 
+struct DiskCacheWrite {
+  DiskCacheWrite *next, *prev;
+  char filepath[FILE_MAX];
+  char dir[FILE_MAXDIR];
+  int cache_type;
+  int start_frame;
+  float frame_index;
+  ImBuf *ibuf;
+  /** Set when the file is invalidated while the image is written. */
+  bool invalid;
+};
+
 struct SeqDiskCache {
   Main *bmain;
   int64_t timestamp;
   ListBase files;
   ThreadMutex read_write_mutex;
   size_t size_total;
+  /** Protects `write_queue`, `write_queue_len` and `write_active`, never held while writing. */
+  ThreadMutex write_queue_mutex;
+  /** #DiskCacheWrite items waiting to be written. */
+  ListBase write_queue;
+  int write_queue_len;
+  /** Item taken from the queue, readable until it is written to its file. */
+  DiskCacheWrite *write_active;
+  /** Created when the first image is written. */
+  TaskPool *write_pool;
 };
 
 struct DiskCacheFile {
@@ -107,6 +138,9 @@ static int seq_disk_cache_compression_level()
   switch (U.sequencer_disk_cache_compression) {
     case USER_SEQ_DISK_CACHE_COMPRESSION_NONE:
       return 0;
+    case USER_SEQ_DISK_CACHE_COMPRESSION_FAST:
+      /* ZSTD fast mode, trades compression ratio for speed similar to LZ4. */
+      return -4;
     case USER_SEQ_DISK_CACHE_COMPRESSION_LOW:
       return 1;
     case USER_SEQ_DISK_CACHE_COMPRESSION_HIGH:
@@ -367,6 +401,28 @@ static void seq_disk_cache_handle_versioning(SeqDiskCache *disk_cache)
   }
 }
 
+static bool seq_disk_cache_file_is_invalid(Sequence *seq,
+                                           const char *cache_dir,
+                                           const char *file_dir,
+                                           int file_cache_type,
+                                           int file_start_frame,
+                                           int invalidate_types,
+                                           int range_start,
+                                           int range_end)
+{
+  if ((file_cache_type & invalidate_types) == 0 || !STREQ(cache_dir, file_dir)) {
+    return false;
+  }
+  int timeline_frame_start = seq_cache_frame_index_to_timeline_frame(seq, file_start_frame);
+  return timeline_frame_start > range_start && timeline_frame_start <= range_end;
+}
+
+static void seq_disk_cache_write_free(DiskCacheWrite *write)
+{
+  IMB_freeImBuf(write->ibuf);
+  MEM_freeN(write);
+}
+
 static void seq_disk_cache_delete_invalid_files(SeqDiskCache *disk_cache,
                                                 Scene *scene,
                                                 Sequence *seq,
@@ -381,17 +437,50 @@ static void seq_disk_cache_delete_invalid_files(SeqDiskCache *disk_cache,
 
   while (cache_file) {
     next_file = cache_file->next;
-    if (cache_file->cache_type & invalidate_types) {
-      if (STREQ(cache_dir, cache_file->dir)) {
-        int timeline_frame_start = seq_cache_frame_index_to_timeline_frame(
-            seq, cache_file->start_frame);
-        if (timeline_frame_start > range_start && timeline_frame_start <= range_end) {
-          seq_disk_cache_delete_file(disk_cache, cache_file);
-        }
-      }
+    if (seq_disk_cache_file_is_invalid(seq,
+                                       cache_dir,
+                                       cache_file->dir,
+                                       cache_file->cache_type,
+                                       cache_file->start_frame,
+                                       invalidate_types,
+                                       range_start,
+                                       range_end))
+    {
+      seq_disk_cache_delete_file(disk_cache, cache_file);
     }
     cache_file = next_file;
   }
+
+  /* Queued images would be written to files that are deleted now. */
+  BLI_mutex_lock(&disk_cache->write_queue_mutex);
+  DiskCacheWrite *active = disk_cache->write_active;
+  if (active != nullptr && seq_disk_cache_file_is_invalid(seq,
+                                                          cache_dir,
+                                                          active->dir,
+                                                          active->cache_type,
+                                                          active->start_frame,
+                                                          invalidate_types,
+                                                          range_start,
+                                                          range_end))
+  {
+    active->invalid = true;
+  }
+  LISTBASE_FOREACH_MUTABLE (DiskCacheWrite *, write, &disk_cache->write_queue) {
+    if (seq_disk_cache_file_is_invalid(seq,
+                                       cache_dir,
+                                       write->dir,
+                                       write->cache_type,
+                                       write->start_frame,
+                                       invalidate_types,
+                                       range_start,
+                                       range_end))
+    {
+      BLI_remlink(&disk_cache->write_queue, write);
+      disk_cache->write_queue_len--;
+      seq_disk_cache_write_free(write);
+    }
+  }
+  BLI_mutex_unlock(&disk_cache->write_queue_mutex);
 }
 
 void seq_disk_cache_invalidate(SeqDiskCache *disk_cache,
@@ -413,28 +502,35 @@ void seq_disk_cache_invalidate(SeqDiskCache *disk_cache,
   BLI_mutex_unlock(&disk_cache->read_write_mutex);
 }
 
-static size_t deflate_imbuf_to_file(ImBuf *ibuf,
-                                    FILE *file,
-                                    int level,
-                                    DiskCacheHeaderEntry *header_entry)
+static void *imbuf_data(ImBuf *ibuf)
 {
-  void *data = (ibuf->byte_buffer.data != nullptr) ? (void *)ibuf->byte_buffer.data :
-                                                     (void *)ibuf->float_buffer.data;
+  return (ibuf->byte_buffer.data != nullptr) ? (void *)ibuf->byte_buffer.data :
+                                               (void *)ibuf->float_buffer.data;
+}
 
-  /* Apply compression if wanted, otherwise just write directly to the file. */
-  if (level > 0) {
-    return BLI_file_zstd_from_mem_at_pos(
-        data, header_entry->size_raw, file, header_entry->offset, level);
-  }
+static size_t imbuf_data_size(const ImBuf *ibuf)
+{
+  const size_t size = size_t(ibuf->x) * ibuf->y * ibuf->channels;
+  return (ibuf->byte_buffer.data != nullptr) ? size : size * sizeof(float);
+}
 
-  fseek(file, header_entry->offset, SEEK_SET);
-  return fwrite(data, 1, header_entry->size_raw, file);
+/**
+ * Compress the image data if wanted, this doesn't need any lock.
+ * \return The compressed data to be freed with #MEM_freeN, or null to write the data of the image
+ * as is.
+ */
+static void *deflate_imbuf(ImBuf *ibuf, int level, size_t *r_len)
+{
+  if (level == 0) {
+    *r_len = imbuf_data_size(ibuf);
+    return nullptr;
+  }
+  return BLI_zstd_from_mem(imbuf_data(ibuf), imbuf_data_size(ibuf), level, r_len);
 }
 
 static size_t inflate_file_to_imbuf(ImBuf *ibuf, FILE *file, DiskCacheHeaderEntry *header_entry)
 {
-  void *data = (ibuf->byte_buffer.data != nullptr) ? (void *)ibuf->byte_buffer.data :
-                                                     (void *)ibuf->float_buffer.data;
+  void *data = imbuf_data(ibuf);
   char header[4];
   fseek(file, header_entry->offset, SEEK_SET);
   if (fread(header, 1, sizeof(header), file) != sizeof(header)) {
@@ -446,6 +542,16 @@ static size_t inflate_file_to_imbuf(ImBuf *ibuf, FILE *file, DiskCacheHeaderEntr
     return BLI_file_unzstd_to_mem_at_pos(data, header_entry->size_raw, file, header_entry->offset);
   }
 
+  /* Copy raw images from a mapping of the file, this avoids copying through the buffers of the C
+   * library for large images. */
+  BLI_mmap_file *mmap_file = BLI_mmap_open(fileno(file));
+  if (mmap_file != nullptr) {
+    const bool success = BLI_mmap_read(
+        mmap_file, data, header_entry->offset, header_entry->size_raw);
+    BLI_mmap_free(mmap_file);
+    return success ? header_entry->size_raw : 0;
+  }
+
   fseek(file, header_entry->offset, SEEK_SET);
   return fread(data, 1, header_entry->size_raw, file);
 }
@@ -478,7 +584,9 @@ static size_t seq_disk_cache_write_header(FILE *file, const DiskCacheHeader *hea
   return fwrite(header, sizeof(*header), 1, file);
 }
 
-static int seq_disk_cache_add_header_entry(SeqCacheKey *key, ImBuf *ibuf, DiskCacheHeader *header)
+static int seq_disk_cache_add_header_entry(float frame_index,
+                                           ImBuf *ibuf,
+                                           DiskCacheHeader *header)
 {
   int i;
   uint64_t offset = sizeof(*header);
@@ -511,16 +619,15 @@ static int seq_disk_cache_add_header_entry(SeqCacheKey *key, ImBuf *ibuf, DiskCa
   }
 
   header->entry[i].offset = offset;
-  header->entry[i].frameno = key->frame_index;
+  header->entry[i].frameno = frame_index;
 
   /* Store colorspace name of ibuf. */
   const char *colorspace_name;
+  header->entry[i].size_raw = imbuf_data_size(ibuf);
   if (ibuf->byte_buffer.data) {
-    header->entry[i].size_raw = int64_t(ibuf->x) * ibuf->y * ibuf->channels;
     colorspace_name = IMB_colormanagement_get_rect_colorspace(ibuf);
   }
   else {
-    header->entry[i].size_raw = int64_t(ibuf->x) * ibuf->y * ibuf->channels * 4;
     colorspace_name = IMB_colormanagement_get_float_colorspace(ibuf);
   }
   STRNCPY(header->entry[i].colorspace_name, colorspace_name);
@@ -539,13 +646,17 @@ static int seq_disk_cache_get_header_entry(SeqCacheKey *key, const DiskCacheHead
   return -1;
 }
 
-bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf *ibuf)
+/**
+ * Append already compressed image data to its cache file, `read_write_mutex` must be locked.
+ * \param data: Data from #deflate_imbuf, null to write the data of the image as is.
+ */
+static bool seq_disk_cache_write_file_ex(SeqDiskCache *disk_cache,
+                                         const char *filepath,
+                                         float frame_index,
+                                         ImBuf *ibuf,
+                                         const void *data,
+                                         size_t data_len)
 {
-  BLI_mutex_lock(&disk_cache->read_write_mutex);
-
-  char filepath[FILE_MAX];
-
-  seq_disk_cache_get_file_path(disk_cache, key, filepath, sizeof(filepath));
   BLI_file_ensure_parent_dir_exists(filepath);
 
   /* Touch the file. */
@@ -553,7 +664,6 @@ bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf
   if (!file) {
     file = BLI_fopen(filepath, "wb+");
     if (!file) {
-      BLI_mutex_unlock(&disk_cache->read_write_mutex);
       return false;
     }
     seq_disk_cache_add_file_to_list(disk_cache, filepath);
@@ -567,15 +677,17 @@ bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf
   if (cache_file->fstat.st_size != 0 && !seq_disk_cache_read_header(file, &header)) {
     fclose(file);
     seq_disk_cache_delete_file(disk_cache, cache_file);
-    BLI_mutex_unlock(&disk_cache->read_write_mutex);
     return false;
   }
-  int entry_index = seq_disk_cache_add_header_entry(key, ibuf, &header);
+  int entry_index = seq_disk_cache_add_header_entry(frame_index, ibuf, &header);
 
-  size_t bytes_written = deflate_imbuf_to_file(
-      ibuf, file, seq_disk_cache_compression_level(), &header.entry[entry_index]);
+  if (data == nullptr) {
+    data = imbuf_data(ibuf);
+  }
+  fseek(file, header.entry[entry_index].offset, SEEK_SET);
+  size_t bytes_written = fwrite(data, 1, data_len, file);
 
-  if (bytes_written != 0) {
+  if (bytes_written == data_len) {
     /* Last step is writing header, as image data can be overwritten,
      * but missing data would cause problems.
      */
@@ -583,23 +695,136 @@ bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf
     seq_disk_cache_write_header(file, &header);
     seq_disk_cache_update_file(disk_cache, filepath);
     fclose(file);
-
-    BLI_mutex_unlock(&disk_cache->read_write_mutex);
     return true;
   }
 
-  BLI_mutex_unlock(&disk_cache->read_write_mutex);
+  fclose(file);
   return false;
 }
 
-ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *key)
+static void seq_disk_cache_write_task(TaskPool *__restrict pool, void * /*taskdata*/)
 {
+  SeqDiskCache *disk_cache = static_cast<SeqDiskCache *>(BLI_task_pool_user_data(pool));
+
+  BLI_mutex_lock(&disk_cache->write_queue_mutex);
+  /* One task is pushed per queued image, but the image may have been invalidated since. */
+  DiskCacheWrite *write = static_cast<DiskCacheWrite *>(BLI_pophead(&disk_cache->write_queue));
+  if (write == nullptr) {
+    BLI_mutex_unlock(&disk_cache->write_queue_mutex);
+    return;
+  }
+  disk_cache->write_queue_len--;
+  disk_cache->write_active = write;
+  BLI_mutex_unlock(&disk_cache->write_queue_mutex);
+
+  size_t data_len;
+  void *data = deflate_imbuf(write->ibuf, seq_disk_cache_compression_level(), &data_len);
+
   BLI_mutex_lock(&disk_cache->read_write_mutex);
+  BLI_mutex_lock(&disk_cache->write_queue_mutex);
+  const bool invalid = write->invalid;
+  BLI_mutex_unlock(&disk_cache->write_queue_mutex);
+  if (!invalid && data_len != 0) {
+    seq_disk_cache_write_file_ex(
+        disk_cache, write->filepath, write->frame_index, write->ibuf, data, data_len);
+  }
+  /* Only stop returning the image from the queue once it can be read from the file. */
+  BLI_mutex_lock(&disk_cache->write_queue_mutex);
+  disk_cache->write_active = nullptr;
+  BLI_mutex_unlock(&disk_cache->write_queue_mutex);
+  BLI_mutex_unlock(&disk_cache->read_write_mutex);
+
+  MEM_SAFE_FREE(data);
+  seq_disk_cache_write_free(write);
+  seq_disk_cache_enforce_limits(disk_cache);
+}
+
+bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf *ibuf)
+{
+  char filepath[FILE_MAX];
+  seq_disk_cache_get_file_path(disk_cache, key, filepath, sizeof(filepath));
+
+  BLI_mutex_lock(&disk_cache->write_queue_mutex);
+  if (disk_cache->write_queue_len >= DCACHE_WRITE_QUEUE_MAX) {
+    BLI_mutex_unlock(&disk_cache->write_queue_mutex);
+
+    /* Writing can't keep up with rendering, don't hold on to more images. */
+    size_t data_len;
+    void *data = deflate_imbuf(ibuf, seq_disk_cache_compression_level(), &data_len);
+    bool success = false;
+    if (data_len != 0) {
+      BLI_mutex_lock(&disk_cache->read_write_mutex);
+      success = seq_disk_cache_write_file_ex(
+          disk_cache, filepath, key->frame_index, ibuf, data, data_len);
+      BLI_mutex_unlock(&disk_cache->read_write_mutex);
+    }
+    MEM_SAFE_FREE(data);
+    seq_disk_cache_enforce_limits(disk_cache);
+    return success;
+  }
+
+  DiskCacheWrite *write = static_cast<DiskCacheWrite *>(
+      MEM_callocN(sizeof(DiskCacheWrite), "SeqDiskCacheWrite"));
+  STRNCPY(write->filepath, filepath);
+  BLI_path_split_dir_part(filepath, write->dir, sizeof(write->dir));
+  write->cache_type = key->type;
+  write->start_frame = (int(key->frame_index) / DCACHE_IMAGES_PER_FILE) * DCACHE_IMAGES_PER_FILE;
+  write->frame_index = key->frame_index;
+  write->ibuf = ibuf;
+  IMB_refImBuf(ibuf);
+  BLI_addtail(&disk_cache->write_queue, write);
+  disk_cache->write_queue_len++;
+
+  if (disk_cache->write_pool == nullptr) {
+    disk_cache->write_pool = BLI_task_pool_create_background_serial(disk_cache,
+                                                                    TASK_PRIORITY_LOW);
+  }
+  BLI_mutex_unlock(&disk_cache->write_queue_mutex);
+
+  BLI_task_pool_push(disk_cache->write_pool, seq_disk_cache_write_task, nullptr, false, nullptr);
+  return true;
+}
+
+static ImBuf *seq_disk_cache_find_queued(SeqDiskCache *disk_cache,
+                                         const char *filepath,
+                                         float frame_index)
+{
+  ImBuf *ibuf = nullptr;
+  BLI_mutex_lock(&disk_cache->write_queue_mutex);
+  DiskCacheWrite *active = disk_cache->write_active;
+  if (active != nullptr && !active->invalid && active->frame_index == frame_index &&
+      STREQ(active->filepath, filepath))
+  {
+    ibuf = active->ibuf;
+  }
+  LISTBASE_FOREACH (DiskCacheWrite *, write, &disk_cache->write_queue) {
+    if (ibuf == nullptr && write->frame_index == frame_index && STREQ(write->filepath, filepath))
+    {
+      ibuf = write->ibuf;
+    }
+  }
+  if (ibuf != nullptr) {
+    IMB_refImBuf(ibuf);
+  }
+  BLI_mutex_unlock(&disk_cache->write_queue_mutex);
+  return ibuf;
+}
 
+ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *key)
+{
   char filepath[FILE_MAX];
   DiskCacheHeader header;
 
   seq_disk_cache_get_file_path(disk_cache, key, filepath, sizeof(filepath));
+
+  /* The image may not be written yet. */
+  ImBuf *queued_ibuf = seq_disk_cache_find_queued(disk_cache, filepath, key->frame_index);
+  if (queued_ibuf != nullptr) {
+    return queued_ibuf;
+  }
+
+  BLI_mutex_lock(&disk_cache->read_write_mutex);
+
   BLI_file_ensure_parent_dir_exists(filepath);
 
   FILE *file = BLI_fopen(filepath, "rb");
@@ -668,6 +893,7 @@ SeqDiskCache *seq_disk_cache_create(Main *bmain, Scene *scene)
       MEM_callocN(sizeof(SeqDiskCache), "SeqDiskCache"));
   disk_cache->bmain = bmain;
   BLI_mutex_init(&disk_cache->read_write_mutex);
+  BLI_mutex_init(&disk_cache->write_queue_mutex);
   seq_disk_cache_handle_versioning(disk_cache);
   seq_disk_cache_get_files(disk_cache, seq_disk_cache_base_dir());
   disk_cache->timestamp = scene->ed->disk_cache_timestamp;
@@ -677,7 +903,15 @@ SeqDiskCache *seq_disk_cache_create(Main *bmain, Scene *scene)
 
 void seq_disk_cache_free(SeqDiskCache *disk_cache)
 {
+  if (disk_cache->write_pool != nullptr) {
+    /* Finish writing queued images, so the cache is complete when it's used again. */
+    BLI_task_pool_work_and_wait(disk_cache->write_pool);
+    BLI_task_pool_free(disk_cache->write_pool);
+  }
+  BLI_assert(BLI_listbase_is_empty(&disk_cache->write_queue));
+
   BLI_freelistN(&disk_cache->files);
   BLI_mutex_end(&disk_cache->read_write_mutex);
+  BLI_mutex_end(&disk_cache->write_queue_mutex);
   MEM_freeN(disk_cache);
 }
@@ -20,6 +20,7 @@
 #include "BLI_math_vector_types.hh"
 #include "BLI_path_util.h"
 #include "BLI_rect.h"
+#include "BLI_simd.hh"
 #include "BLI_string.h"
 #include "BLI_task.hh"
 #include "BLI_threads.h"
@@ -156,6 +157,122 @@ static void store_opaque_black_pixel(float *dst)
   dst[3] = 1.0f;
 }
 
+/* The SIMD versions of the effects below give exactly the same results as the scalar code, so
+ * the operations are done in the same order, and branches are replaced by selecting lanes. */
+#if BLI_HAVE_SSE2
+
+/** Lanes of \a a where \a mask is set, lanes of \a b otherwise. */
+static __m128 select_ps(const __m128 mask, const __m128 a, const __m128 b)
+{
+#  if BLI_HAVE_SSE4
+  return _mm_blendv_ps(b, a, mask);
+#  else
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+#  endif
+}
+
+static __m128 splat_alpha_ps(const __m128 col)
+{
+  return _mm_shuffle_ps(col, col, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+/** Color channels of \a col with the alpha of \a alpha_src. */
+static __m128 copy_alpha_ps(const __m128 col, const __m128 alpha_src)
+{
+  return select_ps(_mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0)), alpha_src, col);
+}
+
+static __m128 abs_ps(const __m128 value)
+{
+  return _mm_andnot_ps(_mm_set1_ps(-0.0f), value);
+}
+
+/** Same as #straight_uchar_to_premul_float. */
+static __m128 load_premul_pixel_sse2(const uchar *ptr)
+{
+  int packed;
+  memcpy(&packed, ptr, sizeof(packed));
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i col = _mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero);
+  const __m128 colf = _mm_cvtepi32_ps(_mm_unpacklo_epi16(col, zero));
+  const __m128 alpha = _mm_mul_ps(splat_alpha_ps(colf), _mm_set1_ps(1.0f / 255.0f));
+  const __m128 fac = _mm_mul_ps(alpha, _mm_set1_ps(1.0f / 255.0f));
+  return copy_alpha_ps(_mm_mul_ps(colf, fac), alpha);
+}
+
+static __m128 load_premul_pixel_sse2(const float *ptr)
+{
+  return _mm_loadu_ps(ptr);
+}
+
+/** Same as #premul_float_to_straight_uchar. */
+static void store_premul_pixel_sse2(const __m128 pix, uchar *dst)
+{
+  const float alpha = _mm_cvtss_f32(splat_alpha_ps(pix));
+  __m128 col = pix;
+  if (alpha != 0.0f && alpha != 1.0f) {
+    col = copy_alpha_ps(_mm_mul_ps(pix, _mm_set1_ps(1.0f / alpha)), pix);
+  }
+  /* Same as #unit_float_to_uchar_clamp. */
+  const __m128 scaled = _mm_add_ps(_mm_mul_ps(col, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f));
+  const __m128 clamped = select_ps(_mm_cmpgt_ps(col, _mm_set1_ps(1.0f - 0.5f / 255.0f)),
+                                   _mm_set1_ps(255.0f),
+                                   _mm_andnot_ps(_mm_cmple_ps(col, _mm_setzero_ps()), scaled));
+  const __m128i col_epi32 = _mm_cvttps_epi32(clamped);
+  const __m128i col_epi16 = _mm_packs_epi32(col_epi32, col_epi32);
+  const int packed = _mm_cvtsi128_si32(_mm_packus_epi16(col_epi16, col_epi16));
+  memcpy(dst, &packed, sizeof(packed));
+}
+
+static void store_premul_pixel_sse2(const __m128 pix, float *dst)
+{
+  _mm_storeu_ps(dst, pix);
+}
+
+/**
+ * Byte images are processed four pixels at a time, with the channels widened to 16 bit. Every
+ * vector passed to \a fn contains two pixels. Returns the number of processed pixels, the
+ * remaining ones have to be processed by the caller.
+ */
+template<typename Fn>
+static int apply_byte_function_sse2(
+    const int num, const uchar *src1, const uchar *src2, uchar *dst, const Fn &fn)
+{
+  const __m128i zero = _mm_setzero_si128();
+  int i = 0;
+  for (; i + 4 <= num; i += 4) {
+    const __m128i col1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src1 + i * 4));
+    const __m128i col2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src2 + i * 4));
+    const __m128i lo = fn(_mm_unpacklo_epi8(col1, zero), _mm_unpacklo_epi8(col2, zero));
+    const __m128i hi = fn(_mm_unpackhi_epi8(col1, zero), _mm_unpackhi_epi8(col2, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4), _mm_packus_epi16(lo, hi));
+  }
+  return i;
+}
+
+static __m128i splat_alpha_epi16(const __m128i col)
+{
+  return _mm_shufflehi_epi16(_mm_shufflelo_epi16(col, _MM_SHUFFLE(3, 3, 3, 3)),
+                             _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+static __m128i copy_alpha_epi16(const __m128i col, const __m128i alpha_src)
+{
+  const __m128i mask = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+  return _mm_or_si128(_mm_and_si128(mask, alpha_src), _mm_andnot_si128(mask, col));
+}
+
+/**
+ * The byte effects use integer factors up to 256, so intermediate products of a factor and a
+ * channel fit into 16 bit. Factors outside of that range fall back to the scalar code.
+ */
+static bool byte_fac_fits_epi16(const int fac)
+{
+  return fac >= 0 && fac <= 256;
+}
+
+#endif
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -251,6 +368,32 @@ static bool alpha_opaque(float alpha)
   return alpha >= 1.0f;
 }
 
+#if BLI_HAVE_SSE2
+template<typename T>
+static void do_alphaover_effect_sse2(
+    float fac, int width, int height, const T *src1, const T *src2, T *dst)
+{
+  const __m128 fac4 = _mm_set1_ps(fac);
+  for (int pixel_idx = 0; pixel_idx < width * height; pixel_idx++) {
+    if (src1[3] <= 0.0f) {
+      memcpy(dst, src2, sizeof(T) * 4);
+    }
+    else if (fac == 1.0f && alpha_opaque(src1[3])) {
+      memcpy(dst, src1, sizeof(T) * 4);
+    }
+    else {
+      const __m128 col1 = load_premul_pixel_sse2(src1);
+      const __m128 mfac = _mm_set1_ps(1.0f - fac * _mm_cvtss_f32(splat_alpha_ps(col1)));
+      const __m128 col2 = load_premul_pixel_sse2(src2);
+      store_premul_pixel_sse2(_mm_add_ps(_mm_mul_ps(fac4, col1), _mm_mul_ps(mfac, col2)), dst);
+    }
+    src1 += 4;
+    src2 += 4;
+    dst += 4;
+  }
+}
+#endif
+
 /* dst = src1 over src2 (alpha from src1) */
 template<typename T>
 static void do_alphaover_effect(
@@ -261,6 +404,9 @@ static void do_alphaover_effect(
     return;
   }
 
+#if BLI_HAVE_SSE2
+  do_alphaover_effect_sse2(fac, width, height, src1, src2, dst);
+#else
   for (int pixel_idx = 0; pixel_idx < width * height; pixel_idx++) {
     if (src1[3] <= 0.0f) {
       /* Alpha of zero. No color addition will happen as the colors are pre-multiplied. */
@@ -281,6 +427,7 @@ static void do_alphaover_effect(
     src2 += 4;
     dst += 4;
   }
+#endif
 }
 
 static void do_alphaover_effect(const SeqRenderData *context,
@@ -318,6 +465,31 @@ static void do_alphaover_effect(const SeqRenderData *context,
 /** \name Alpha Under Effect
  * \{ */
 
+#if BLI_HAVE_SSE2
+template<typename T>
+static void do_alphaunder_effect_sse2(
+    float fac, int width, int height, const T *src1, const T *src2, T *dst)
+{
+  for (int pixel_idx = 0; pixel_idx < width * height; pixel_idx++) {
+    if (src2[3] <= 0.0f && fac >= 1.0f) {
+      memcpy(dst, src1, sizeof(T) * 4);
+    }
+    else if (alpha_opaque(src2[3])) {
+      memcpy(dst, src2, sizeof(T) * 4);
+    }
+    else {
+      const __m128 col2 = load_premul_pixel_sse2(src2);
+      const __m128 mfac = _mm_set1_ps(fac * (1.0f - _mm_cvtss_f32(splat_alpha_ps(col2))));
+      const __m128 col1 = load_premul_pixel_sse2(src1);
+      store_premul_pixel_sse2(_mm_add_ps(_mm_mul_ps(mfac, col1), col2), dst);
+    }
+    src1 += 4;
+    src2 += 4;
+    dst += 4;
+  }
+}
+#endif
+
 /* dst = src1 under src2 (alpha from src2) */
 template<typename T>
 static void do_alphaunder_effect(
@@ -328,6 +500,9 @@ static void do_alphaunder_effect(
     return;
   }
 
+#if BLI_HAVE_SSE2
+  do_alphaunder_effect_sse2(fac, width, height, src1, src2, dst);
+#else
   for (int pixel_idx = 0; pixel_idx < width * height; pixel_idx++) {
     if (src2[3] <= 0.0f && fac >= 1.0f) {
       memcpy(dst, src1, sizeof(T) * 4);
@@ -346,6 +521,7 @@ static void do_alphaunder_effect(
     src2 += 4;
     dst += 4;
   }
+#endif
 }
 
 static void do_alphaunder_effect(const SeqRenderData *context,
@@ -392,17 +568,30 @@ static void do_cross_effect_byte(float fac, int x, int y, uchar *rect1, uchar *r
   int temp_fac = int(256.0f * fac);
   int temp_mfac = 256 - temp_fac;
 
-  for (int i = 0; i < y; i++) {
-    for (int j = 0; j < x; j++) {
-      rt[0] = (temp_mfac * rt1[0] + temp_fac * rt2[0]) >> 8;
-      rt[1] = (temp_mfac * rt1[1] + temp_fac * rt2[1]) >> 8;
-      rt[2] = (temp_mfac * rt1[2] + temp_fac * rt2[2]) >> 8;
-      rt[3] = (temp_mfac * rt1[3] + temp_fac * rt2[3]) >> 8;
+  int i = 0;
+#if BLI_HAVE_SSE2
+  if (byte_fac_fits_epi16(temp_fac)) {
+    const __m128i fac8 = _mm_set1_epi16(short(temp_fac));
+    const __m128i mfac8 = _mm_set1_epi16(short(temp_mfac));
+    i = apply_byte_function_sse2(x * y, rt1, rt2, rt, [&](const __m128i col1, const __m128i col2) {
+      return _mm_srli_epi16(
+          _mm_add_epi16(_mm_mullo_epi16(mfac8, col1), _mm_mullo_epi16(fac8, col2)), 8);
+    });
+    rt1 += i * 4;
+    rt2 += i * 4;
+    rt += i * 4;
+  }
+#endif
 
-      rt1 += 4;
-      rt2 += 4;
-      rt += 4;
-    }
+  for (; i < x * y; i++) {
+    rt[0] = (temp_mfac * rt1[0] + temp_fac * rt2[0]) >> 8;
+    rt[1] = (temp_mfac * rt1[1] + temp_fac * rt2[1]) >> 8;
+    rt[2] = (temp_mfac * rt1[2] + temp_fac * rt2[2]) >> 8;
+    rt[3] = (temp_mfac * rt1[3] + temp_fac * rt2[3]) >> 8;
+
+    rt1 += 4;
+    rt2 += 4;
+    rt += 4;
   }
 }
 
@@ -414,6 +603,18 @@ static void do_cross_effect_float(float fac, int x, int y, float *rect1, float *
 
   float mfac = 1.0f - fac;
 
+#if BLI_HAVE_SSE2
+  const __m128 fac4 = _mm_set1_ps(fac);
+  const __m128 mfac4 = _mm_set1_ps(mfac);
+  for (int i = 0; i < x * y; i++) {
+    const __m128 col1 = _mm_loadu_ps(rt1);
+    const __m128 col2 = _mm_loadu_ps(rt2);
+    _mm_storeu_ps(rt, _mm_add_ps(_mm_mul_ps(mfac4, col1), _mm_mul_ps(fac4, col2)));
+    rt1 += 4;
+    rt2 += 4;
+    rt += 4;
+  }
+#else
   for (int i = 0; i < y; i++) {
     for (int j = 0; j < x; j++) {
       rt[0] = mfac * rt1[0] + fac * rt2[0];
@@ -426,6 +627,7 @@ static void do_cross_effect_float(float fac, int x, int y, float *rect1, float *
       rt += 4;
     }
   }
+#endif
 }
 
 static void do_cross_effect(const SeqRenderData *context,
@@ -468,6 +670,36 @@ static void do_cross_effect(const SeqRenderData *context,
  * maybe not even that, but do interpolation in some perceptual color space
  * like OKLAB. But currently it is fixed to just 2.0 gamma. */
 
+#if BLI_HAVE_SSE2
+static __m128 gamma_correct_ps(const __m128 c)
+{
+  const __m128 negative = _mm_and_ps(_mm_cmplt_ps(c, _mm_setzero_ps()), _mm_set1_ps(-0.0f));
+  return _mm_xor_ps(_mm_mul_ps(c, c), negative);
+}
+
+static __m128 inv_gamma_correct_ps(const __m128 c)
+{
+  const __m128 sign = _mm_and_ps(c, _mm_set1_ps(-0.0f));
+  return _mm_or_ps(_mm_sqrt_ps(abs_ps(c)), sign);
+}
+
+template<typename T>
+static void do_gammacross_effect_sse2(
+    float fac, int width, int height, const T *src1, const T *src2, T *dst)
+{
+  const __m128 fac4 = _mm_set1_ps(fac);
+  const __m128 mfac4 = _mm_set1_ps(1.0f - fac);
+  for (int pixel_idx = 0; pixel_idx < width * height; pixel_idx++) {
+    const __m128 col1 = inv_gamma_correct_ps(load_premul_pixel_sse2(src1));
+    const __m128 col2 = inv_gamma_correct_ps(load_premul_pixel_sse2(src2));
+    store_premul_pixel_sse2(
+        gamma_correct_ps(_mm_add_ps(_mm_mul_ps(mfac4, col1), _mm_mul_ps(fac4, col2))), dst);
+    src1 += 4;
+    src2 += 4;
+    dst += 4;
+  }
+}
+#else
 static float gammaCorrect(float c)
 {
   if (UNLIKELY(c < 0)) {
@@ -480,11 +712,15 @@ static float invGammaCorrect(float c)
 {
   return sqrtf_signed(c);
 }
+#endif
 
 template<typename T>
 static void do_gammacross_effect(
     float fac, int width, int height, const T *src1, const T *src2, T *dst)
 {
+#if BLI_HAVE_SSE2
+  do_gammacross_effect_sse2(fac, width, height, src1, src2, dst);
+#else
   float mfac = 1.0f - fac;
 
   for (int y = 0; y < height; y++) {
@@ -501,6 +737,7 @@ static void do_gammacross_effect(
       dst += 4;
     }
   }
+#endif
 }
 
 static ImBuf *gammacross_init_execution(const SeqRenderData *context,
@@ -555,18 +792,32 @@ static void do_add_effect_byte(float fac, int x, int y, uchar *rect1, uchar *rec
 
   int temp_fac = int(256.0f * fac);
 
-  for (int i = 0; i < y; i++) {
-    for (int j = 0; j < x; j++) {
-      const int temp_fac2 = temp_fac * int(cp2[3]);
-      rt[0] = min_ii(cp1[0] + ((temp_fac2 * cp2[0]) >> 16), 255);
-      rt[1] = min_ii(cp1[1] + ((temp_fac2 * cp2[1]) >> 16), 255);
-      rt[2] = min_ii(cp1[2] + ((temp_fac2 * cp2[2]) >> 16), 255);
-      rt[3] = cp1[3];
-
-      cp1 += 4;
-      cp2 += 4;
-      rt += 4;
-    }
+  int i = 0;
+#if BLI_HAVE_SSE2
+  if (byte_fac_fits_epi16(temp_fac)) {
+    const __m128i fac16 = _mm_set1_epi16(short(temp_fac));
+    i = apply_byte_function_sse2(x * y, cp1, cp2, rt, [&](const __m128i col1, const __m128i col2) {
+      const __m128i fac2 = _mm_mullo_epi16(fac16, splat_alpha_epi16(col2));
+      /* Packing to bytes clamps to 255. */
+      const __m128i col = _mm_add_epi16(col1, _mm_mulhi_epu16(fac2, col2));
+      return copy_alpha_epi16(col, col1);
+    });
+    cp1 += i * 4;
+    cp2 += i * 4;
+    rt += i * 4;
+  }
+#endif
+
+  for (; i < x * y; i++) {
+    const int temp_fac2 = temp_fac * int(cp2[3]);
+    rt[0] = min_ii(cp1[0] + ((temp_fac2 * cp2[0]) >> 16), 255);
+    rt[1] = min_ii(cp1[1] + ((temp_fac2 * cp2[1]) >> 16), 255);
+    rt[2] = min_ii(cp1[2] + ((temp_fac2 * cp2[2]) >> 16), 255);
+    rt[3] = cp1[3];
+
+    cp1 += 4;
+    cp2 += 4;
+    rt += 4;
   }
 }
 
@@ -576,6 +827,20 @@ static void do_add_effect_float(float fac, int x, int y, float *rect1, float *re
   float *rt2 = rect2;
   float *rt = out;
 
+#if BLI_HAVE_SSE2
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 mfac4 = _mm_set1_ps(1.0f - fac);
+  for (int i = 0; i < x * y; i++) {
+    const __m128 col1 = _mm_loadu_ps(rt1);
+    const __m128 col2 = _mm_loadu_ps(rt2);
+    const __m128 temp_fac = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(splat_alpha_ps(col1), mfac4)),
+                                       splat_alpha_ps(col2));
+    _mm_storeu_ps(rt, copy_alpha_ps(_mm_add_ps(col1, _mm_mul_ps(temp_fac, col2)), col1));
+    rt1 += 4;
+    rt2 += 4;
+    rt += 4;
+  }
+#else
   for (int i = 0; i < y; i++) {
     for (int j = 0; j < x; j++) {
       const float temp_fac = (1.0f - (rt1[3] * (1.0f - fac))) * rt2[3];
@@ -589,6 +854,7 @@ static void do_add_effect_float(float fac, int x, int y, float *rect1, float *re
       rt += 4;
     }
   }
+#endif
 }
 
 static void do_add_effect(const SeqRenderData *context,
@@ -634,18 +900,31 @@ static void do_sub_effect_byte(float fac, int x, int y, uchar *rect1, uchar *rec
 
   int temp_fac = int(256.0f * fac);
 
-  for (int i = 0; i < y; i++) {
-    for (int j = 0; j < x; j++) {
-      const int temp_fac2 = temp_fac * int(cp2[3]);
-      rt[0] = max_ii(cp1[0] - ((temp_fac2 * cp2[0]) >> 16), 0);
-      rt[1] = max_ii(cp1[1] - ((temp_fac2 * cp2[1]) >> 16), 0);
-      rt[2] = max_ii(cp1[2] - ((temp_fac2 * cp2[2]) >> 16), 0);
-      rt[3] = cp1[3];
-
-      cp1 += 4;
-      cp2 += 4;
-      rt += 4;
-    }
+  int i = 0;
+#if BLI_HAVE_SSE2
+  if (byte_fac_fits_epi16(temp_fac)) {
+    const __m128i fac16 = _mm_set1_epi16(short(temp_fac));
+    i = apply_byte_function_sse2(x * y, cp1, cp2, rt, [&](const __m128i col1, const __m128i col2) {
+      const __m128i fac2 = _mm_mullo_epi16(fac16, splat_alpha_epi16(col2));
+      const __m128i col = _mm_subs_epu16(col1, _mm_mulhi_epu16(fac2, col2));
+      return copy_alpha_epi16(col, col1);
+    });
+    cp1 += i * 4;
+    cp2 += i * 4;
+    rt += i * 4;
+  }
+#endif
+
+  for (; i < x * y; i++) {
+    const int temp_fac2 = temp_fac * int(cp2[3]);
+    rt[0] = max_ii(cp1[0] - ((temp_fac2 * cp2[0]) >> 16), 0);
+    rt[1] = max_ii(cp1[1] - ((temp_fac2 * cp2[1]) >> 16), 0);
+    rt[2] = max_ii(cp1[2] - ((temp_fac2 * cp2[2]) >> 16), 0);
+    rt[3] = cp1[3];
+
+    cp1 += 4;
+    cp2 += 4;
+    rt += 4;
   }
 }
 
@@ -657,6 +936,22 @@ static void do_sub_effect_float(float fac, int x, int y, float *rect1, float *re
 
   float mfac = 1.0f - fac;
 
+#if BLI_HAVE_SSE2
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 mfac4 = _mm_set1_ps(mfac);
+  for (int i = 0; i < x * y; i++) {
+    const __m128 col1 = _mm_loadu_ps(rt1);
+    const __m128 col2 = _mm_loadu_ps(rt2);
+    const __m128 temp_fac = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(splat_alpha_ps(col1), mfac4)),
+                                       splat_alpha_ps(col2));
+    const __m128 col = _mm_max_ps(_mm_sub_ps(col1, _mm_mul_ps(temp_fac, col2)), zero);
+    _mm_storeu_ps(rt, copy_alpha_ps(col, col1));
+    rt1 += 4;
+    rt2 += 4;
+    rt += 4;
+  }
+#else
   for (int i = 0; i < y; i++) {
     for (int j = 0; j < x; j++) {
       const float temp_fac = (1.0f - (rt1[3] * mfac)) * rt2[3];
@@ -670,6 +965,7 @@ static void do_sub_effect_float(float fac, int x, int y, float *rect1, float *re
       rt += 4;
     }
   }
+#endif
 }
 
 static void do_sub_effect(const SeqRenderData *context,
@@ -796,17 +1092,37 @@ static void do_mul_effect_byte(float fac, int x, int y, uchar *rect1, uchar *rec
    * `fac * (a * b) + (1 - fac) * a => fac * a * (b - 1) + axaux = c * px + py * s;` // + centx
    * `yaux = -s * px + c * py;` // + centy */
 
-  for (int i = 0; i < y; i++) {
-    for (int j = 0; j < x; j++) {
-      rt[0] = rt1[0] + ((temp_fac * rt1[0] * (rt2[0] - 255)) >> 16);
-      rt[1] = rt1[1] + ((temp_fac * rt1[1] * (rt2[1] - 255)) >> 16);
-      rt[2] = rt1[2] + ((temp_fac * rt1[2] * (rt2[2] - 255)) >> 16);
-      rt[3] = rt1[3] + ((temp_fac * rt1[3] * (rt2[3] - 255)) >> 16);
+  int i = 0;
+#if BLI_HAVE_SSE2
+  if (byte_fac_fits_epi16(temp_fac)) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i c255 = _mm_set1_epi16(255);
+    const __m128i fac16 = _mm_set1_epi16(short(temp_fac));
+    i = apply_byte_function_sse2(x * y, rt1, rt2, rt, [&](const __m128i col1, const __m128i col2) {
+      /* The product is negative, so the arithmetic shift rounds its magnitude up. */
+      const __m128i a = _mm_mullo_epi16(fac16, col1);
+      const __m128i b = _mm_sub_epi16(c255, col2);
+      const __m128i product_lo = _mm_mullo_epi16(a, b);
+      const __m128i product_hi = _mm_mulhi_epu16(a, b);
+      const __m128i round_up = _mm_andnot_si128(_mm_cmpeq_epi16(product_lo, zero), one);
+      return _mm_sub_epi16(_mm_sub_epi16(col1, product_hi), round_up);
+    });
+    rt1 += i * 4;
+    rt2 += i * 4;
+    rt += i * 4;
+  }
+#endif
 
-      rt1 += 4;
-      rt2 += 4;
-      rt += 4;
-    }
+  for (; i < x * y; i++) {
+    rt[0] = rt1[0] + ((temp_fac * rt1[0] * (rt2[0] - 255)) >> 16);
+    rt[1] = rt1[1] + ((temp_fac * rt1[1] * (rt2[1] - 255)) >> 16);
+    rt[2] = rt1[2] + ((temp_fac * rt1[2] * (rt2[2] - 255)) >> 16);
+    rt[3] = rt1[3] + ((temp_fac * rt1[3] * (rt2[3] - 255)) >> 16);
+
+    rt1 += 4;
+    rt2 += 4;
+    rt += 4;
   }
 }
 
@@ -819,6 +1135,18 @@ static void do_mul_effect_float(float fac, int x, int y, float *rect1, float *re
   /* Formula:
    * `fac * (a * b) + (1 - fac) * a => fac * a * (b - 1) + a`. */
 
+#if BLI_HAVE_SSE2
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 fac4 = _mm_set1_ps(fac);
+  for (int i = 0; i < x * y; i++) {
+    const __m128 col1 = _mm_loadu_ps(rt1);
+    const __m128 col2 = _mm_loadu_ps(rt2);
+    _mm_storeu_ps(rt, _mm_add_ps(col1, _mm_mul_ps(_mm_mul_ps(fac4, col1), _mm_sub_ps(col2, one))));
+    rt1 += 4;
+    rt2 += 4;
+    rt += 4;
+  }
+#else
   for (int i = 0; i < y; i++) {
     for (int j = 0; j < x; j++) {
       rt[0] = rt1[0] + fac * rt1[0] * (rt2[0] - 1.0f);
@@ -831,6 +1159,7 @@ static void do_mul_effect_float(float fac, int x, int y, float *rect1, float *re
       rt += 4;
     }
   }
+#endif
 }
 
 static void do_mul_effect(const SeqRenderData *context,
@@ -887,9 +1216,179 @@ static void apply_blend_function(
   }
 }
 
+#if BLI_HAVE_SSE2
+
+/**
+ * Same as #apply_blend_function for float images. \a blend_function gets both pixels, the alpha
+ * of the second pixel multiplied by the factor and one minus that alpha, and returns the color.
+ */
+template<typename Func>
+static void apply_blend_function_sse2(float fac,
+                                      int width,
+                                      int height,
+                                      const float *src1,
+                                      const float *src2,
+                                      float *dst,
+                                      const Func &blend_function)
+{
+  const __m128 one = _mm_set1_ps(1.0f);
+  for (int pixel_idx = 0; pixel_idx < width * height; pixel_idx++) {
+    const __m128 col1 = _mm_loadu_ps(src1);
+    const float t = src2[3] * fac;
+    if (t != 0.0f) {
+      const __m128 t4 = _mm_set1_ps(t);
+      const __m128 col = blend_function(col1, _mm_loadu_ps(src2), t4, _mm_sub_ps(one, t4));
+      _mm_storeu_ps(dst, copy_alpha_ps(col, col1));
+    }
+    else {
+      _mm_storeu_ps(dst, col1);
+    }
+    src1 += 4;
+    src2 += 4;
+    dst += 4;
+  }
+}
+
+/**
+ * Vectorized versions of the `blend_color_*_float` functions.
+ * \return False if there is none for the blend mode.
+ */
+static bool do_blend_effect_float_sse2(
+    float fac, int x, int y, const float *rect1, const float *rect2, int btype, float *out)
+{
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 half = _mm_set1_ps(0.5f);
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 two = _mm_set1_ps(2.0f);
+
+  /* Most blend modes mix the blended color with the first color. */
+  auto mix = [](const __m128 col, const __m128 col1, const __m128 t, const __m128 mt) {
+    return _mm_add_ps(_mm_mul_ps(col, t), _mm_mul_ps(col1, mt));
+  };
+  auto apply = [&](const auto &blend_function) {
+    apply_blend_function_sse2(fac, x, y, rect1, rect2, out, blend_function);
+  };
+
+  switch (btype) {
+    case SEQ_TYPE_ADD:
+      apply([&](auto s1, auto s2, auto, auto) {
+        return _mm_add_ps(s1, _mm_mul_ps(s2, splat_alpha_ps(s1)));
+      });
+      return true;
+    case SEQ_TYPE_SUB:
+      apply([&](auto s1, auto s2, auto, auto) {
+        return _mm_max_ps(_mm_sub_ps(s1, _mm_mul_ps(s2, splat_alpha_ps(s1))), zero);
+      });
+      return true;
+    case SEQ_TYPE_MUL:
+      apply([&](auto s1, auto s2, auto, auto mt) {
+        return _mm_add_ps(_mm_mul_ps(mt, s1), _mm_mul_ps(_mm_mul_ps(s1, s2), splat_alpha_ps(s1)));
+      });
+      return true;
+    case SEQ_TYPE_DARKEN:
+    case SEQ_TYPE_LIGHTEN:
+      apply([&](auto s1, auto s2, auto t, auto mt) {
+        const __m128 s2_mapped = _mm_mul_ps(s2, _mm_div_ps(splat_alpha_ps(s1), t));
+        const __m128 col = btype == SEQ_TYPE_DARKEN ? _mm_min_ps(s1, s2_mapped) :
+                                                      _mm_max_ps(s1, s2_mapped);
+        return _mm_add_ps(_mm_mul_ps(mt, s1), _mm_mul_ps(t, col));
+      });
+      return true;
+    case SEQ_TYPE_COLOR_BURN:
+      apply([&](auto s1, auto s2, auto t, auto mt) {
+        const __m128 burn = _mm_max_ps(_mm_sub_ps(one, _mm_div_ps(_mm_sub_ps(one, s1), s2)), zero);
+        return mix(select_ps(_mm_cmpeq_ps(s2, zero), zero, burn), s1, t, mt);
+      });
+      return true;
+    case SEQ_TYPE_LINEAR_BURN:
+      apply([&](auto s1, auto s2, auto t, auto mt) {
+        return mix(_mm_max_ps(_mm_sub_ps(_mm_add_ps(s1, s2), one), zero), s1, t, mt);
+      });
+      return true;
+    case SEQ_TYPE_SCREEN:
+      apply([&](auto s1, auto s2, auto t, auto mt) {
+        const __m128 screen = _mm_sub_ps(one,
+                                         _mm_mul_ps(_mm_sub_ps(one, s1), _mm_sub_ps(one, s2)));
+        return mix(_mm_max_ps(screen, zero), s1, t, mt);
+      });
+      return true;
+    case SEQ_TYPE_DODGE:
+      apply([&](auto s1, auto s2, auto t, auto mt) {
+        const __m128 dodge = _mm_min_ps(_mm_div_ps(s1, _mm_sub_ps(one, s2)), one);
+        return mix(select_ps(_mm_cmpge_ps(s2, one), one, dodge), s1, t, mt);
+      });
+      return true;
+    case SEQ_TYPE_OVERLAY:
+      apply([&](auto s1, auto s2, auto t, auto mt) {
+        const __m128 high = _mm_sub_ps(
+            one, _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_sub_ps(s1, half))),
+                            _mm_sub_ps(one, s2)));
+        const __m128 low = _mm_mul_ps(_mm_mul_ps(two, s1), s2);
+        return _mm_min_ps(mix(select_ps(_mm_cmpgt_ps(s1, half), high, low), s1, t, mt), one);
+      });
+      return true;
+    case SEQ_TYPE_SOFT_LIGHT:
+      apply([&](auto s1, auto s2, auto t, auto mt) {
+        const __m128 screen = _mm_sub_ps(one,
+                                         _mm_mul_ps(_mm_sub_ps(one, s1), _mm_sub_ps(one, s2)));
+        const __m128 soft_light = _mm_mul_ps(
+            _mm_add_ps(_mm_mul_ps(_mm_sub_ps(one, s1), s2), screen), s1);
+        return mix(soft_light, s1, t, mt);
+      });
+      return true;
+    case SEQ_TYPE_HARD_LIGHT:
+      apply([&](auto s1, auto s2, auto t, auto mt) {
+        const __m128 high = _mm_sub_ps(
+            one, _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_sub_ps(s2, half))),
+                            _mm_sub_ps(one, s1)));
+        const __m128 low = _mm_mul_ps(_mm_mul_ps(two, s2), s1);
+        return _mm_min_ps(mix(select_ps(_mm_cmpgt_ps(s2, half), high, low), s1, t, mt), one);
+      });
+      return true;
+    case SEQ_TYPE_PIN_LIGHT:
+      apply([&](auto s1, auto s2, auto t, auto mt) {
+        const __m128 high = _mm_max_ps(_mm_mul_ps(two, _mm_sub_ps(s2, half)), s1);
+        const __m128 low = _mm_min_ps(_mm_mul_ps(two, s2), s1);
+        return mix(select_ps(_mm_cmpgt_ps(s2, half), high, low), s1, t, mt);
+      });
+      return true;
+    case SEQ_TYPE_LIN_LIGHT:
+      apply([&](auto s1, auto s2, auto t, auto mt) {
+        const __m128 high = _mm_min_ps(_mm_add_ps(s1, _mm_mul_ps(two, _mm_sub_ps(s2, half))), one);
+        const __m128 low = _mm_max_ps(_mm_sub_ps(_mm_add_ps(s1, _mm_mul_ps(two, s2)), one), zero);
+        return mix(select_ps(_mm_cmpgt_ps(s2, half), high, low), s1, t, mt);
+      });
+      return true;
+    case SEQ_TYPE_DIFFERENCE:
+      apply([&](auto s1, auto s2, auto t, auto mt) {
+        return mix(abs_ps(_mm_sub_ps(s1, s2)), s1, t, mt);
+      });
+      return true;
+    case SEQ_TYPE_EXCLUSION:
+      apply([&](auto s1, auto s2, auto t, auto mt) {
+        const __m128 exclusion = _mm_sub_ps(
+            half, _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(s1, half)), _mm_sub_ps(s2, half)));
+        return mix(exclusion, s1, t, mt);
+      });
+      return true;
+    default:
+      /* Vivid light has too many special cases, and the HSV based modes convert every pixel to
+       * HSV and back, which doesn't benefit much. */
+      return false;
+  }
+}
+
+#endif
+
 static void do_blend_effect_float(
     float fac, int x, int y, const float *rect1, float *rect2, int btype, float *out)
 {
+#if BLI_HAVE_SSE2
+  if (do_blend_effect_float_sse2(fac, x, y, rect1, rect2, btype, out)) {
+    return;
+  }
+#endif
+
   switch (btype) {
     case SEQ_TYPE_ADD:
       apply_blend_function(fac, x, y, rect1, rect2, out, blend_color_add_float);
@@ -3500,6 +3999,130 @@ static SeqEffectHandle get_sequence_effect_impl(int seq_type)
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Strip Stack Blending
+ * \{ */
+
+bool seq_effect_blend_supports_rows(const Sequence *seq)
+{
+  switch (seq->blend_mode) {
+    case SEQ_TYPE_CROSS:
+    case SEQ_TYPE_GAMCROSS:
+    case SEQ_TYPE_ADD:
+    case SEQ_TYPE_SUB:
+    case SEQ_TYPE_MUL:
+    case SEQ_TYPE_SCREEN:
+    case SEQ_TYPE_OVERLAY:
+    case SEQ_TYPE_COLOR_BURN:
+    case SEQ_TYPE_LINEAR_BURN:
+    case SEQ_TYPE_DARKEN:
+    case SEQ_TYPE_LIGHTEN:
+    case SEQ_TYPE_DODGE:
+    case SEQ_TYPE_SOFT_LIGHT:
+    case SEQ_TYPE_HARD_LIGHT:
+    case SEQ_TYPE_PIN_LIGHT:
+    case SEQ_TYPE_LIN_LIGHT:
+    case SEQ_TYPE_VIVID_LIGHT:
+    case SEQ_TYPE_BLEND_COLOR:
+    case SEQ_TYPE_HUE:
+    case SEQ_TYPE_SATURATION:
+    case SEQ_TYPE_VALUE:
+    case SEQ_TYPE_DIFFERENCE:
+    case SEQ_TYPE_EXCLUSION:
+    case SEQ_TYPE_ALPHAOVER:
+    case SEQ_TYPE_ALPHAUNDER:
+      return true;
+    default:
+      /* Drop shadow reads neighboring pixels, so it can't work on independent rows. */
+      return false;
+  }
+}
+
+template<typename T>
+static void blend_rows(
+    const Sequence *seq, float fac, int width, int height, const T *below, T *strip, T *dst)
+{
+  /* The kernels don't write to their first input, they just aren't declared const. */
+  T *rect1 = const_cast<T *>(below);
+  constexpr bool is_float = std::is_same_v<T, float>;
+  switch (seq->blend_mode) {
+    case SEQ_TYPE_CROSS:
+      if constexpr (is_float) {
+        do_cross_effect_float(fac, width, height, rect1, strip, dst);
+      }
+      else {
+        do_cross_effect_byte(fac, width, height, rect1, strip, dst);
+      }
+      break;
+    case SEQ_TYPE_GAMCROSS:
+      do_gammacross_effect(fac, width, height, below, strip, dst);
+      break;
+    case SEQ_TYPE_ADD:
+      if constexpr (is_float) {
+        do_add_effect_float(fac, width, height, rect1, strip, dst);
+      }
+      else {
+        do_add_effect_byte(fac, width, height, rect1, strip, dst);
+      }
+      break;
+    case SEQ_TYPE_SUB:
+      if constexpr (is_float) {
+        do_sub_effect_float(fac, width, height, rect1, strip, dst);
+      }
+      else {
+        do_sub_effect_byte(fac, width, height, rect1, strip, dst);
+      }
+      break;
+    case SEQ_TYPE_MUL:
+      if constexpr (is_float) {
+        do_mul_effect_float(fac, width, height, rect1, strip, dst);
+      }
+      else {
+        do_mul_effect_byte(fac, width, height, rect1, strip, dst);
+      }
+      break;
+    /* Inputs are swapped for these, see #seq_must_swap_input_in_blend_mode. */
+    case SEQ_TYPE_ALPHAOVER:
+      do_alphaover_effect(fac, width, height, strip, below, dst);
+      break;
+    case SEQ_TYPE_ALPHAUNDER:
+      do_alphaunder_effect(fac, width, height, strip, below, dst);
+      break;
+    default:
+      if constexpr (is_float) {
+        do_blend_effect_float(fac, width, height, below, strip, seq->blend_mode, dst);
+      }
+      else {
+        do_blend_effect_byte(fac, width, height, rect1, strip, seq->blend_mode, dst);
+      }
+      break;
+  }
+}
+
+void seq_effect_blend_rows(const Sequence *seq,
+                           float fac,
+                           int width,
+                           int height,
+                           const uchar *below,
+                           uchar *strip,
+                           uchar *dst)
+{
+  blend_rows(seq, fac, width, height, below, strip, dst);
+}
+
+void seq_effect_blend_rows(const Sequence *seq,
+                           float fac,
+                           int width,
+                           int height,
+                           const float *below,
+                           float *strip,
+                           float *dst)
+{
+  blend_rows(seq, fac, width, height, below, strip, dst);
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Public Sequencer Effect API
  * \{ */
@@ -8,12 +8,38 @@
  * \ingroup sequencer
  */
 
+#include "BLI_sys_types.h"
+
 #include "SEQ_effects.hh"
 
 struct Scene;
 struct Sequence;
 
 SeqEffectHandle seq_effect_get_sequence_blend(Sequence *seq);
+/**
+ * Whether the blend mode of the strip only depends on the pixels at the same position in both
+ * inputs, so it can be applied to a band of rows with #seq_effect_blend_rows.
+ */
+bool seq_effect_blend_supports_rows(const Sequence *seq);
+/**
+ * Blend \a strip onto the composite of the strips \a below it, with the same result as the
+ * effect used for the blend mode. All buffers contain `width * height` pixels and must not
+ * overlap. The strip buffer is modified temporarily by some blend modes.
+ */
+void seq_effect_blend_rows(const Sequence *seq,
+                           float fac,
+                           int width,
+                           int height,
+                           const uchar *below,
+                           uchar *strip,
+                           uchar *dst);
+void seq_effect_blend_rows(const Sequence *seq,
+                           float fac,
+                           int width,
+                           int height,
+                           const float *below,
+                           float *strip,
+                           float *dst);
 /**
  * Build frame map when speed in mode #SEQ_SPEED_MULTIPLY is animated.
  * This is, because `target_frame` value is integrated over time.
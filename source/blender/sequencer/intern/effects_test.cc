@@ -0,0 +1,439 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <cstring>
+#include <type_traits>
+
+#include "BLI_array.hh"
+#include "BLI_math_base.h"
+#include "BLI_math_color.h"
+#include "BLI_math_color_blend.h"
+#include "BLI_math_vector.h"
+#include "BLI_math_vector_types.hh"
+#include "BLI_rand.hh"
+
+#include "DNA_sequence_types.h"
+
+#include "IMB_imbuf.hh"
+#include "IMB_imbuf_types.hh"
+
+#include "SEQ_effects.hh"
+#include "SEQ_render.hh"
+
+#include "testing/testing.h"
+
+/* Set to 1 to compare the performance of the effects with the scalar reference code. */
+#define DO_PERF_TESTS 0
+
+#if DO_PERF_TESTS
+#  include "BLI_timeit.hh"
+#endif
+
+namespace blender::seq::tests {
+
+/* Not a multiple of the number of pixels processed at once by the SIMD code. */
+static constexpr int test_width = 37;
+static constexpr int test_height = 5;
+
+template<typename T> static T *image_pixels(const ImBuf *ibuf)
+{
+  if constexpr (std::is_same_v<T, float>) {
+    return ibuf->float_buffer.data;
+  }
+  else {
+    return ibuf->byte_buffer.data;
+  }
+}
+
+static ImBuf *create_random_image(const bool is_float, const int width, const int height, int seed)
+{
+  RandomNumberGenerator rng(seed);
+  ImBuf *ibuf = IMB_allocImBuf(width, height, 32, is_float ? IB_rectfloat : IB_rect);
+  for (const int i : IndexRange(int64_t(width) * height * 4)) {
+    /* Include fully transparent and opaque pixels, as well as the extreme channel values that
+     * most effects handle separately. */
+    const float r = rng.get_float();
+    const float value = r < 0.1f ? 0.0f : (r > 0.9f ? 1.0f : rng.get_float());
+    if (is_float) {
+      ibuf->float_buffer.data[i] = r < 0.02f ? -value : value;
+    }
+    else {
+      ibuf->byte_buffer.data[i] = uchar(value * 255.0f);
+    }
+  }
+  return ibuf;
+}
+
+static void execute_effect(
+    Sequence &seq, const float fac, const ImBuf *ibuf1, const ImBuf *ibuf2, ImBuf *out)
+{
+  SeqRenderData context{};
+  context.rectx = ibuf1->x;
+  context.recty = ibuf1->y;
+  const SeqEffectHandle handle = SEQ_effect_handle_get(&seq);
+  /* Split the image into two slices, like the threaded execution. */
+  const int first_lines = ibuf1->y / 2;
+  handle.execute_slice(&context, &seq, 0.0f, fac, ibuf1, ibuf2, nullptr, 0, first_lines, out);
+  handle.execute_slice(
+      &context, &seq, 0.0f, fac, ibuf1, ibuf2, nullptr, first_lines, ibuf1->y - first_lines, out);
+}
+
+/**
+ * Compare an effect with the reference implementation, which is called for every pixel as
+ * `reference(fac, src1, src2, dst)`.
+ */
+template<typename T, typename Fn>
+static void expect_effect_matches_reference(Sequence &seq, const Fn &reference)
+{
+  constexpr bool is_float = std::is_same_v<T, float>;
+  ImBuf *ibuf1 = create_random_image(is_float, test_width, test_height, 1);
+  ImBuf *ibuf2 = create_random_image(is_float, test_width, test_height, 2);
+  const int64_t size = int64_t(test_width) * test_height * 4;
+
+  ImBuf *result = IMB_allocImBuf(test_width, test_height, 32, is_float ? IB_rectfloat : IB_rect);
+
+  for (const float fac : {0.0f, 0.3f, 0.5f, 0.77f, 1.0f}) {
+    execute_effect(seq, fac, ibuf1, ibuf2, result);
+
+    Array<T> expected(size);
+    const T *src1 = image_pixels<T>(ibuf1);
+    const T *src2 = image_pixels<T>(ibuf2);
+    for (int64_t i = 0; i < size; i += 4) {
+      reference(fac, src1 + i, src2 + i, &expected[i]);
+    }
+
+    const T *actual = image_pixels<T>(result);
+    if constexpr (is_float) {
+      for (const int64_t i : IndexRange(size)) {
+        EXPECT_NEAR(expected[i], actual[i], 1e-6f) << "fac " << fac << ", index " << i;
+      }
+    }
+    else {
+      EXPECT_EQ_ARRAY(expected.data(), actual, size);
+    }
+  }
+
+  IMB_freeImBuf(result);
+  IMB_freeImBuf(ibuf1);
+  IMB_freeImBuf(ibuf2);
+}
+
+template<typename Fn> static void expect_effect_matches_reference(const int type, const Fn &fn)
+{
+  Sequence seq{};
+  seq.type = type;
+  expect_effect_matches_reference<uchar>(seq, fn);
+  expect_effect_matches_reference<float>(seq, fn);
+}
+
+/* -------------------------------------------------------------------- */
+/** \name Reference Implementations
+ *
+ * The scalar per pixel code of the effects, which the optimized versions have to match.
+ * \{ */
+
+static float4 load_pixel(const uchar *ptr)
+{
+  float4 res;
+  straight_uchar_to_premul_float(res, ptr);
+  return res;
+}
+
+static float4 load_pixel(const float *ptr)
+{
+  return float4(ptr);
+}
+
+static void store_pixel(const float4 &pix, uchar *dst)
+{
+  premul_float_to_straight_uchar(dst, pix);
+}
+
+static void store_pixel(const float4 &pix, float *dst)
+{
+  copy_v4_v4(dst, pix);
+}
+
+static void reference_cross(const float fac, const uchar *a, const uchar *b, uchar *dst)
+{
+  const int temp_fac = int(256.0f * fac);
+  const int temp_mfac = 256 - temp_fac;
+  for (const int c : IndexRange(4)) {
+    dst[c] = (temp_mfac * a[c] + temp_fac * b[c]) >> 8;
+  }
+}
+
+static void reference_cross(const float fac, const float *a, const float *b, float *dst)
+{
+  for (const int c : IndexRange(4)) {
+    dst[c] = (1.0f - fac) * a[c] + fac * b[c];
+  }
+}
+
+template<typename T>
+static void reference_gammacross(const float fac, const T *a, const T *b, T *dst)
+{
+  auto gamma = [](const float c) { return c < 0.0f ? -(c * c) : c * c; };
+  const float4 col1 = load_pixel(a);
+  const float4 col2 = load_pixel(b);
+  float4 col;
+  for (const int c : IndexRange(4)) {
+    col[c] = gamma((1.0f - fac) * sqrtf_signed(col1[c]) + fac * sqrtf_signed(col2[c]));
+  }
+  store_pixel(col, dst);
+}
+
+static void reference_add(const float fac, const uchar *a, const uchar *b, uchar *dst)
+{
+  const int temp_fac2 = int(256.0f * fac) * int(b[3]);
+  for (const int c : IndexRange(3)) {
+    dst[c] = min_ii(a[c] + ((temp_fac2 * b[c]) >> 16), 255);
+  }
+  dst[3] = a[3];
+}
+
+static void reference_add(const float fac, const float *a, const float *b, float *dst)
+{
+  const float temp_fac = (1.0f - (a[3] * (1.0f - fac))) * b[3];
+  for (const int c : IndexRange(3)) {
+    dst[c] = a[c] + temp_fac * b[c];
+  }
+  dst[3] = a[3];
+}
+
+static void reference_sub(const float fac, const uchar *a, const uchar *b, uchar *dst)
+{
+  const int temp_fac2 = int(256.0f * fac) * int(b[3]);
+  for (const int c : IndexRange(3)) {
+    dst[c] = max_ii(a[c] - ((temp_fac2 * b[c]) >> 16), 0);
+  }
+  dst[3] = a[3];
+}
+
+static void reference_sub(const float fac, const float *a, const float *b, float *dst)
+{
+  const float temp_fac = (1.0f - (a[3] * (1.0f - fac))) * b[3];
+  for (const int c : IndexRange(3)) {
+    dst[c] = max_ff(a[c] - temp_fac * b[c], 0.0f);
+  }
+  dst[3] = a[3];
+}
+
+static void reference_mul(const float fac, const uchar *a, const uchar *b, uchar *dst)
+{
+  const int temp_fac = int(256.0f * fac);
+  for (const int c : IndexRange(4)) {
+    dst[c] = a[c] + ((temp_fac * a[c] * (b[c] - 255)) >> 16);
+  }
+}
+
+static void reference_mul(const float fac, const float *a, const float *b, float *dst)
+{
+  for (const int c : IndexRange(4)) {
+    dst[c] = a[c] + fac * a[c] * (b[c] - 1.0f);
+  }
+}
+
+template<typename T>
+static void reference_alphaover(const float fac, const T *a, const T *b, T *dst)
+{
+  constexpr float max_alpha = std::is_same_v<T, float> ? 1.0f : 255.0f;
+  if (fac <= 0.0f || a[3] <= 0.0f) {
+    memcpy(dst, b, sizeof(T) * 4);
+  }
+  else if (fac == 1.0f && a[3] >= max_alpha) {
+    memcpy(dst, a, sizeof(T) * 4);
+  }
+  else {
+    const float4 col1 = load_pixel(a);
+    const float4 col2 = load_pixel(b);
+    store_pixel(fac * col1 + (1.0f - fac * col1.w) * col2, dst);
+  }
+}
+
+template<typename T>
+static void reference_alphaunder(const float fac, const T *a, const T *b, T *dst)
+{
+  constexpr float max_alpha = std::is_same_v<T, float> ? 1.0f : 255.0f;
+  if (fac <= 0.0f) {
+    memcpy(dst, b, sizeof(T) * 4);
+  }
+  else if (b[3] <= 0.0f && fac >= 1.0f) {
+    memcpy(dst, a, sizeof(T) * 4);
+  }
+  else if (b[3] >= max_alpha) {
+    memcpy(dst, b, sizeof(T) * 4);
+  }
+  else {
+    const float4 col1 = load_pixel(a);
+    const float4 col2 = load_pixel(b);
+    store_pixel(fac * (1.0f - col2.w) * col1 + col2, dst);
+  }
+}
+
+struct BlendFunctions {
+  void (*byte_fn)(uchar dst[4], const uchar src1[4], const uchar src2[4]);
+  void (*float_fn)(float dst[4], const float src1[4], const float src2[4]);
+};
+
+static const std::pair<int, BlendFunctions> blend_modes[] = {
+    {SEQ_TYPE_ADD, {blend_color_add_byte, blend_color_add_float}},
+    {SEQ_TYPE_SUB, {blend_color_sub_byte, blend_color_sub_float}},
+    {SEQ_TYPE_MUL, {blend_color_mul_byte, blend_color_mul_float}},
+    {SEQ_TYPE_DARKEN, {blend_color_darken_byte, blend_color_darken_float}},
+    {SEQ_TYPE_COLOR_BURN, {blend_color_burn_byte, blend_color_burn_float}},
+    {SEQ_TYPE_LINEAR_BURN, {blend_color_linearburn_byte, blend_color_linearburn_float}},
+    {SEQ_TYPE_SCREEN, {blend_color_screen_byte, blend_color_screen_float}},
+    {SEQ_TYPE_LIGHTEN, {blend_color_lighten_byte, blend_color_lighten_float}},
+    {SEQ_TYPE_DODGE, {blend_color_dodge_byte, blend_color_dodge_float}},
+    {SEQ_TYPE_OVERLAY, {blend_color_overlay_byte, blend_color_overlay_float}},
+    {SEQ_TYPE_SOFT_LIGHT, {blend_color_softlight_byte, blend_color_softlight_float}},
+    {SEQ_TYPE_HARD_LIGHT, {blend_color_hardlight_byte, blend_color_hardlight_float}},
+    {SEQ_TYPE_PIN_LIGHT, {blend_color_pinlight_byte, blend_color_pinlight_float}},
+    {SEQ_TYPE_LIN_LIGHT, {blend_color_linearlight_byte, blend_color_linearlight_float}},
+    {SEQ_TYPE_VIVID_LIGHT, {blend_color_vividlight_byte, blend_color_vividlight_float}},
+    {SEQ_TYPE_BLEND_COLOR, {blend_color_color_byte, blend_color_color_float}},
+    {SEQ_TYPE_HUE, {blend_color_hue_byte, blend_color_hue_float}},
+    {SEQ_TYPE_SATURATION, {blend_color_saturation_byte, blend_color_saturation_float}},
+    {SEQ_TYPE_VALUE, {blend_color_luminosity_byte, blend_color_luminosity_float}},
+    {SEQ_TYPE_DIFFERENCE, {blend_color_difference_byte, blend_color_difference_float}},
+    {SEQ_TYPE_EXCLUSION, {blend_color_exclusion_byte, blend_color_exclusion_float}},
+};
+
+template<typename T>
+static void reference_blend(
+    const BlendFunctions &functions, const float fac, const T *a, const T *b, T *dst)
+{
+  T src2[4] = {b[0], b[1], b[2], T(b[3] * fac)};
+  if constexpr (std::is_same_v<T, float>) {
+    functions.float_fn(dst, a, src2);
+  }
+  else {
+    functions.byte_fn(dst, a, src2);
+  }
+  dst[3] = a[3];
+}
+
+/** \} */
+
+TEST(sequencer_effects, Cross)
+{
+  expect_effect_matches_reference(SEQ_TYPE_CROSS, [](float fac, auto a, auto b, auto dst) {
+    reference_cross(fac, a, b, dst);
+  });
+}
+
+TEST(sequencer_effects, GammaCross)
+{
+  expect_effect_matches_reference(SEQ_TYPE_GAMCROSS, [](float fac, auto a, auto b, auto dst) {
+    reference_gammacross(fac, a, b, dst);
+  });
+}
+
+TEST(sequencer_effects, Add)
+{
+  expect_effect_matches_reference(SEQ_TYPE_ADD, [](float fac, auto a, auto b, auto dst) {
+    reference_add(fac, a, b, dst);
+  });
+}
+
+TEST(sequencer_effects, Subtract)
+{
+  expect_effect_matches_reference(SEQ_TYPE_SUB, [](float fac, auto a, auto b, auto dst) {
+    reference_sub(fac, a, b, dst);
+  });
+}
+
+TEST(sequencer_effects, Multiply)
+{
+  expect_effect_matches_reference(SEQ_TYPE_MUL, [](float fac, auto a, auto b, auto dst) {
+    reference_mul(fac, a, b, dst);
+  });
+}
+
+TEST(sequencer_effects, AlphaOver)
+{
+  expect_effect_matches_reference(SEQ_TYPE_ALPHAOVER, [](float fac, auto a, auto b, auto dst) {
+    reference_alphaover(fac, a, b, dst);
+  });
+}
+
+TEST(sequencer_effects, AlphaUnder)
+{
+  expect_effect_matches_reference(SEQ_TYPE_ALPHAUNDER, [](float fac, auto a, auto b, auto dst) {
+    reference_alphaunder(fac, a, b, dst);
+  });
+}
+
+TEST(sequencer_effects, BlendModes)
+{
+  for (const auto &[blend_mode, functions] : blend_modes) {
+    SCOPED_TRACE(blend_mode);
+    /* The color mix effect uses its own factor, the one passed to the effect is ignored. */
+    for (const float factor : {0.0f, 0.4f, 1.0f}) {
+      ColorMixVars data{blend_mode, factor};
+      Sequence seq{};
+      seq.type = SEQ_TYPE_COLORMIX;
+      seq.effectdata = &data;
+      auto reference = [&](float /*fac*/, auto a, auto b, auto dst) {
+        reference_blend(functions, factor, a, b, dst);
+      };
+      expect_effect_matches_reference<uchar>(seq, reference);
+      expect_effect_matches_reference<float>(seq, reference);
+    }
+  }
+}
+
+#if DO_PERF_TESTS
+
+static void time_effect(Sequence &seq, const char *name, const ImBuf *ibuf1, const ImBuf *ibuf2)
+{
+  ImBuf *out = IMB_allocImBuf(
+      ibuf1->x, ibuf1->y, 32, ibuf1->float_buffer.data ? IB_rectfloat : IB_rect);
+  /* Run once to touch the output buffer. */
+  execute_effect(seq, 0.5f, ibuf1, ibuf2, out);
+  for ([[maybe_unused]] const int i : IndexRange(5)) {
+    SCOPED_TIMER(name);
+    execute_effect(seq, 0.5f, ibuf1, ibuf2, out);
+  }
+  IMB_freeImBuf(out);
+}
+
+TEST(sequencer_effects, Performance)
+{
+  const int width = 3840;
+  const int height = 2160;
+  for (const bool is_float : {false, true}) {
+    ImBuf *ibuf1 = create_random_image(is_float, width, height, 1);
+    ImBuf *ibuf2 = create_random_image(is_float, width, height, 2);
+    const std::string type_name = is_float ? "float " : "byte ";
+    for (const auto &[type, name] : {std::pair(SEQ_TYPE_CROSS, "cross"),
+                                     std::pair(SEQ_TYPE_GAMCROSS, "gamma cross"),
+                                     std::pair(SEQ_TYPE_ADD, "add"),
+                                     std::pair(SEQ_TYPE_MUL, "multiply"),
+                                     std::pair(SEQ_TYPE_ALPHAOVER, "alpha over"),
+                                     std::pair(SEQ_TYPE_ALPHAUNDER, "alpha under")})
+    {
+      Sequence seq{};
+      seq.type = type;
+      time_effect(seq, (type_name + name).c_str(), ibuf1, ibuf2);
+    }
+    for (const auto &[blend_mode, name] : {std::pair(SEQ_TYPE_SCREEN, "screen"),
+                                           std::pair(SEQ_TYPE_OVERLAY, "overlay"),
+                                           std::pair(SEQ_TYPE_DIFFERENCE, "difference")})
+    {
+      ColorMixVars data{blend_mode, 0.5f};
+      Sequence seq{};
+      seq.type = SEQ_TYPE_COLORMIX;
+      seq.effectdata = &data;
+      time_effect(seq, (type_name + name).c_str(), ibuf1, ibuf2);
+    }
+    IMB_freeImBuf(ibuf1);
+    IMB_freeImBuf(ibuf2);
+  }
+}
+
+#endif
+
+}  // namespace blender::seq::tests
@@ -6,9 +6,14 @@
  * \ingroup bke
  */
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <cstring>
 #include <ctime>
+#include <deque>
 #include <memory.h>
+#include <optional>
 
 #include "MEM_guardedalloc.h"
 
@@ -21,9 +26,13 @@
 
 #include "BLI_fileops_types.h"
 #include "BLI_ghash.h"
+#include "BLI_hash_mm2a.hh"
+#include "BLI_map.hh"
 #include "BLI_mempool.h"
 #include "BLI_threads.h"
+#include "BLI_vector.hh"
 
+#include "BKE_idprop.hh"
 #include "BKE_main.hh"
 
 #include "SEQ_prefetch.hh"
@@ -59,24 +68,133 @@
  * entries one by one in reverse order to their creation.
  *
  * User can exclude caching of some images. Such entries will have is_temp_cache set.
+ *
+ * Sharding: Entries are distributed over multiple hash tables by their key hash, each with its own
+ * lock. Looking up images only locks one shard, so the prefetch job and the UI rarely wait for
+ * each other. All other operations first lock `iterator_mutex`, which serializes changes to the
+ * cache, and lock a shard only while inserting into it or removing from it.
+ *
+ * Recycling: Which frame is freed is decided with an adaptive replacement policy (ARC). Frames
+ * that were only stored and frames that were used again after that are kept in two groups, and
+ * the least recently used frame of one of them is freed. Keys of recently freed frames are
+ * remembered, when such a frame is stored again, the group it was freed from is given more room.
+ *
+ * Deduplication: Stored images with identical content (held frames, still images, repeated
+ * clips) share a single image buffer. Images are found by a fingerprint of some of their rows
+ * and compared completely before they are shared.
  */
 
 #define THUMB_CACHE_LIMIT 5000
+#define SEQ_CACHE_SHARDS_NUM 16
+
+struct SeqCacheShard {
+  GHash *hash;
+  ThreadMutex mutex;
+};
+
+struct SeqCacheContent {
+  ImBuf *ibuf;
+  int users;
+};
+
+/**
+ * Hashes of recently freed frames in the order they were freed, indexed by hash so that looking
+ * up a stored frame doesn't have to search all of them.
+ */
+struct SeqCacheGhosts {
+  /** Value of #next_order when the hash was added, for every hash in the list. */
+  blender::Map<uint, uint64_t> order_by_hash;
+  /** Added hashes from oldest to newest. Removed hashes are skipped when they are reached. */
+  std::deque<std::pair<uint64_t, uint>> queue;
+  uint64_t next_order = 0;
+
+  int64_t size() const
+  {
+    return order_by_hash.size();
+  }
+
+  bool remove(const uint hash)
+  {
+    return order_by_hash.remove(hash);
+  }
+
+  void add(const uint hash, const int64_t max_num)
+  {
+    order_by_hash.add_overwrite(hash, next_order);
+    queue.emplace_back(next_order, hash);
+    next_order++;
+
+    while (!queue.empty() && (order_by_hash.size() > max_num || !this->is_live(queue.front())))
+    {
+      if (this->is_live(queue.front())) {
+        order_by_hash.remove(queue.front().second);
+      }
+      queue.pop_front();
+    }
+
+    /* Removed hashes behind a hash that stays are only skipped later, don't let them pile up. */
+    if (int64_t(queue.size()) > 2 * order_by_hash.size() + 64) {
+      queue.erase(std::remove_if(queue.begin(),
+                                 queue.end(),
+                                 [&](const std::pair<uint64_t, uint> &entry) {
+                                   return !this->is_live(entry);
+                                 }),
+                  queue.end());
+    }
+  }
+
+  void clear()
+  {
+    order_by_hash.clear();
+    queue.clear();
+  }
+
+ private:
+  bool is_live(const std::pair<uint64_t, uint> &entry) const
+  {
+    const uint64_t *order = order_by_hash.lookup_ptr(entry.second);
+    return order && *order == entry.first;
+  }
+};
 
 struct SeqCache {
   Main *bmain;
-  GHash *hash;
+  SeqCacheShard shards[SEQ_CACHE_SHARDS_NUM];
   ThreadMutex iterator_mutex;
   BLI_mempool *keys_pool;
   BLI_mempool *items_pool;
   SeqCacheKey *last_key;
   SeqDiskCache *disk_cache;
   int thumbnail_count;
+
+  /** Incremented for every access, to find the least recently used frames. */
+  std::atomic<uint64_t> access_clock;
+  /** Hashes of recently freed frames, that were used once or multiple times. */
+  SeqCacheGhosts ghost_recent;
+  SeqCacheGhosts ghost_frequent;
+  /** Number of frames that the group of frames used only once should have. */
+  int target_recent_num;
+
+  /** Images that can be shared by their content fingerprint. */
+  blender::Map<uint, SeqCacheContent> contents;
+
+  std::atomic<int64_t> stat_hits;
+  std::atomic<int64_t> stat_misses;
+  std::atomic<int64_t> stat_disk_hits;
+  std::atomic<int64_t> stat_recycled_frames;
+  std::atomic<int64_t> stat_shared_images;
 };
 
 struct SeqCacheItem {
   SeqCache *cache_owner;
   ImBuf *ibuf;
+  /** Value of #SeqCache::access_clock when the image was stored or last used. */
+  uint64_t last_access;
+  /** Number of times the image was used after it was stored. */
+  int hits;
+  /** Whether the image is registered in #SeqCache::contents with this fingerprint. */
+  bool has_content;
+  uint content_fingerprint;
 };
 
 static ThreadMutex cache_create_lock = BLI_MUTEX_INITIALIZER;
@@ -173,7 +291,7 @@ static void seq_cache_unlock(Scene *scene)
   }
 }
 
-static size_t seq_cache_get_mem_total()
+size_t seq_cache_get_mem_total()
 {
   return size_t(U.memcachelimit) * 1024 * 1024;
 }
@@ -187,19 +305,192 @@ static void seq_cache_keyfree(void *val)
 static void seq_cache_valfree(void *val)
 {
   SeqCacheItem *item = (SeqCacheItem *)val;
+  SeqCache *cache = item->cache_owner;
+
+  if (item->has_content) {
+    SeqCacheContent &content = cache->contents.lookup(item->content_fingerprint);
+    BLI_assert(content.ibuf == item->ibuf);
+    content.users--;
+    if (content.users == 0) {
+      cache->contents.remove(item->content_fingerprint);
+    }
+  }
 
   if (item->ibuf) {
     IMB_freeImBuf(item->ibuf);
   }
 
-  BLI_mempool_free(item->cache_owner->items_pool, item);
+  BLI_mempool_free(cache->items_pool, item);
+}
+
+static SeqCacheShard &seq_cache_shard_get(SeqCache *cache, const SeqCacheKey *key)
+{
+  /* Use the high bits of the mixed key hash, the hash tables of the shards use the low bits. */
+  static_assert(SEQ_CACHE_SHARDS_NUM == 16);
+  const uint hash = seq_cache_hashhash(key) * 2654435761u;
+  return cache->shards[hash >> 28];
+}
+
+static bool seq_cache_haskey(SeqCache *cache, const SeqCacheKey *key)
+{
+  return BLI_ghash_haskey(seq_cache_shard_get(cache, key).hash, key);
+}
+
+/** Remove an entry while `iterator_mutex` is locked. */
+static void seq_cache_remove_key(SeqCache *cache, SeqCacheKey *key)
+{
+  SeqCacheShard &shard = seq_cache_shard_get(cache, key);
+  BLI_mutex_lock(&shard.mutex);
+  BLI_ghash_remove(shard.hash, key, seq_cache_keyfree, seq_cache_valfree);
+  BLI_mutex_unlock(&shard.mutex);
+}
+
+/**
+ * Call `fn(key, item)` for all entries while `iterator_mutex` is locked. The function may remove
+ * the entry it is called for, but no other entries.
+ */
+template<typename Fn> static void seq_cache_foreach_entry(SeqCache *cache, const Fn &fn)
+{
+  for (SeqCacheShard &shard : cache->shards) {
+    GHashIterator gh_iter;
+    BLI_ghashIterator_init(&gh_iter, shard.hash);
+    while (!BLI_ghashIterator_done(&gh_iter)) {
+      SeqCacheKey *key = static_cast<SeqCacheKey *>(BLI_ghashIterator_getKey(&gh_iter));
+      SeqCacheItem *item = static_cast<SeqCacheItem *>(BLI_ghashIterator_getValue(&gh_iter));
+      BLI_ghashIterator_step(&gh_iter);
+      BLI_assert(key->cache_owner == cache);
+      fn(key, item);
+    }
+  }
+}
+
+static int64_t seq_cache_entries_num(SeqCache *cache)
+{
+  int64_t num = 0;
+  for (const SeqCacheShard &shard : cache->shards) {
+    num += BLI_ghash_len(shard.hash);
+  }
+  return num;
+}
+
+/* -------------------------------------------------------------------- */
+/** \name Content Deduplication
+ * \{ */
+
+/** Only images with a single buffer are shared, with at most this many rows being hashed. */
+static std::optional<uint> seq_cache_image_fingerprint(const ImBuf *ibuf)
+{
+  const bool is_float = ibuf->float_buffer.data != nullptr;
+  if (is_float == (ibuf->byte_buffer.data != nullptr) || ibuf->x <= 0 || ibuf->y <= 0) {
+    return std::nullopt;
+  }
+  const size_t row_size = is_float ? sizeof(float) * ibuf->channels * ibuf->x :
+                                     sizeof(uchar) * 4 * ibuf->x;
+  const uchar *data = is_float ? reinterpret_cast<const uchar *>(ibuf->float_buffer.data) :
+                                 ibuf->byte_buffer.data;
+
+  BLI_HashMurmur2A mm2;
+  BLI_hash_mm2a_init(&mm2, 0);
+  BLI_hash_mm2a_add_int(&mm2, ibuf->x);
+  BLI_hash_mm2a_add_int(&mm2, ibuf->y);
+  BLI_hash_mm2a_add_int(&mm2, is_float ? ibuf->channels : 0);
+  /* Hashing a few rows is enough to tell most different images apart, images with the same
+   * fingerprint are compared completely. */
+  const int rows_num = std::min(ibuf->y, 16);
+  for (int i = 0; i < rows_num; i++) {
+    const int64_t y = int64_t(ibuf->y - 1) * i / std::max(rows_num - 1, 1);
+    BLI_hash_mm2a_add(&mm2, data + row_size * y, row_size);
+  }
+  return BLI_hash_mm2a_end(&mm2);
 }
 
-static int get_stored_types_flag(Scene *scene, SeqCacheKey *key)
+static bool seq_cache_images_equal(const ImBuf *a, const ImBuf *b)
+{
+  if (a->x != b->x || a->y != b->y || a->planes != b->planes || a->channels != b->channels ||
+      a->flags != b->flags || a->byte_buffer.colorspace != b->byte_buffer.colorspace ||
+      a->float_buffer.colorspace != b->float_buffer.colorspace ||
+      (a->float_buffer.data == nullptr) != (b->float_buffer.data == nullptr) ||
+      (a->byte_buffer.data == nullptr) != (b->byte_buffer.data == nullptr))
+  {
+    return false;
+  }
+  if (!IDP_EqualsProperties_ex(a->metadata, b->metadata, true)) {
+    return false;
+  }
+  const size_t pixels_num = size_t(a->x) * size_t(a->y);
+  if (a->float_buffer.data) {
+    return memcmp(a->float_buffer.data,
+                  b->float_buffer.data,
+                  sizeof(float) * a->channels * pixels_num) == 0;
+  }
+  return memcmp(a->byte_buffer.data, b->byte_buffer.data, sizeof(uchar) * 4 * pixels_num) == 0;
+}
+
+/**
+ * Return an image already in the cache with the same content as \a ibuf, or \a ibuf itself when
+ * there is none. The returned image is registered as being used by \a item.
+ */
+static ImBuf *seq_cache_share_content(SeqCache *cache, SeqCacheItem *item, ImBuf *ibuf)
+{
+  const std::optional<uint> fingerprint = seq_cache_image_fingerprint(ibuf);
+  if (!fingerprint) {
+    return ibuf;
+  }
+
+  SeqCacheContent *content = cache->contents.lookup_ptr(*fingerprint);
+  if (content == nullptr) {
+    cache->contents.add_new(*fingerprint, {ibuf, 1});
+  }
+  else if (content->ibuf == ibuf || seq_cache_images_equal(content->ibuf, ibuf)) {
+    if (content->ibuf != ibuf) {
+      cache->stat_shared_images++;
+      ibuf = content->ibuf;
+    }
+    content->users++;
+  }
+  else {
+    /* Different images with the same fingerprint, store this one without sharing. */
+    return ibuf;
+  }
+
+  item->has_content = true;
+  item->content_fingerprint = *fingerprint;
+  return ibuf;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Adaptive Replacement
+ * \{ */
+
+/**
+ * When a frame that was freed recently is stored again, the group of frames it was freed from
+ * was too small. Give that group more room, and count the frame as being used multiple times.
+ */
+static void seq_cache_ghost_check(SeqCache *cache, const SeqCacheKey *key, SeqCacheItem *item)
+{
+  const uint hash = seq_cache_hashhash(key);
+  const int ghost_recent_num = int(cache->ghost_recent.size());
+  const int ghost_frequent_num = int(cache->ghost_frequent.size());
+  if (cache->ghost_recent.remove(hash)) {
+    cache->target_recent_num += std::max(ghost_frequent_num / ghost_recent_num, 1);
+    item->hits = 1;
+  }
+  else if (cache->ghost_frequent.remove(hash)) {
+    cache->target_recent_num -= std::max(ghost_recent_num / ghost_frequent_num, 1);
+    cache->target_recent_num = std::max(cache->target_recent_num, 0);
+    item->hits = 1;
+  }
+}
+
+/** \} */
+
+static int get_stored_types_flag(const Scene *scene, const Sequence *seq)
 {
   int flag;
-  if (key->seq->cache_flag & SEQ_CACHE_OVERRIDE) {
-    flag = key->seq->cache_flag;
+  if (seq->cache_flag & SEQ_CACHE_OVERRIDE) {
+    flag = seq->cache_flag;
   }
   else {
     flag = scene->ed->cache_flag;
@@ -217,18 +508,28 @@ static void seq_cache_put_ex(Scene *scene, SeqCacheKey *key, ImBuf *ibuf)
   SeqCacheItem *item;
   item = static_cast<SeqCacheItem *>(BLI_mempool_alloc(cache->items_pool));
   item->cache_owner = cache;
-  item->ibuf = ibuf;
+  item->last_access = cache->access_clock++;
+  item->hits = 0;
+  item->has_content = false;
 
-  const int stored_types_flag = get_stored_types_flag(scene, key);
+  const int stored_types_flag = get_stored_types_flag(scene, key->seq);
 
   /* Item stored for later use. */
   if (stored_types_flag & key->type) {
     key->is_temp_cache = false;
     key->link_prev = cache->last_key;
+    seq_cache_ghost_check(cache, key, item);
+    if (key->type != SEQ_CACHE_STORE_THUMBNAIL) {
+      ibuf = seq_cache_share_content(cache, item, ibuf);
+    }
   }
+  item->ibuf = ibuf;
 
-  BLI_assert(!BLI_ghash_haskey(cache->hash, key));
-  BLI_ghash_insert(cache->hash, key, item);
+  SeqCacheShard &shard = seq_cache_shard_get(cache, key);
+  BLI_mutex_lock(&shard.mutex);
+  BLI_assert(!BLI_ghash_haskey(shard.hash, key));
+  BLI_ghash_insert(shard.hash, key, item);
+  BLI_mutex_unlock(&shard.mutex);
   IMB_refImBuf(ibuf);
 
   /* Store pointer to last cached key. */
@@ -251,17 +552,24 @@ static void seq_cache_put_ex(Scene *scene, SeqCacheKey *key, ImBuf *ibuf)
   }
 }
 
-static ImBuf *seq_cache_get_ex(SeqCache *cache, SeqCacheKey *key)
+static ImBuf *seq_cache_get_ex(SeqCache *cache, SeqCacheKey *key, const bool update_statistics)
 {
-  SeqCacheItem *item = static_cast<SeqCacheItem *>(BLI_ghash_lookup(cache->hash, key));
+  SeqCacheShard &shard = seq_cache_shard_get(cache, key);
+  ImBuf *ibuf = nullptr;
 
+  BLI_mutex_lock(&shard.mutex);
+  SeqCacheItem *item = static_cast<SeqCacheItem *>(BLI_ghash_lookup(shard.hash, key));
   if (item && item->ibuf) {
-    IMB_refImBuf(item->ibuf);
-
-    return item->ibuf;
+    ibuf = item->ibuf;
+    IMB_refImBuf(ibuf);
+    if (update_statistics) {
+      item->last_access = cache->access_clock++;
+      item->hits++;
+    }
   }
+  BLI_mutex_unlock(&shard.mutex);
 
-  return nullptr;
+  return ibuf;
 }
 
 static void seq_cache_key_unlink(SeqCacheKey *key)
@@ -276,69 +584,6 @@ static void seq_cache_key_unlink(SeqCacheKey *key)
   }
 }
 
-/* Choose a key out of 2 candidates(leftmost and rightmost items)
- * to recycle based on currently used strategy */
-static SeqCacheKey *seq_cache_choose_key(Scene *scene, SeqCacheKey *lkey, SeqCacheKey *rkey)
-{
-  SeqCacheKey *finalkey = nullptr;
-
-  /* Ideally, cache would not need to check the state of prefetching task
-   * that is tricky to do however, because prefetch would need to know,
-   * if a key, that is about to be created would be removed by itself.
-   *
-   * This can happen because only FINAL_OUT item insertion will trigger recycling
-   * but that is also the point, where prefetch can be suspended.
-   *
-   * We could use temp cache as a shield and later make it a non-temporary entry,
-   * but it is not worth of increasing system complexity.
-   */
-  if (scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE && seq_prefetch_job_is_running(scene)) {
-    int pfjob_start, pfjob_end;
-    seq_prefetch_get_time_range(scene, &pfjob_start, &pfjob_end);
-
-    if (lkey) {
-      if (lkey->timeline_frame < pfjob_start || lkey->timeline_frame > pfjob_end) {
-        return lkey;
-      }
-    }
-
-    if (rkey) {
-      if (rkey->timeline_frame < pfjob_start || rkey->timeline_frame > pfjob_end) {
-        return rkey;
-      }
-    }
-
-    return nullptr;
-  }
-
-  if (rkey && lkey) {
-    if (lkey->timeline_frame > rkey->timeline_frame) {
-      SeqCacheKey *swapkey = lkey;
-      lkey = rkey;
-      rkey = swapkey;
-    }
-
-    int l_diff = scene->r.cfra - lkey->timeline_frame;
-    int r_diff = rkey->timeline_frame - scene->r.cfra;
-
-    if (l_diff > r_diff) {
-      finalkey = lkey;
-    }
-    else {
-      finalkey = rkey;
-    }
-  }
-  else {
-    if (lkey) {
-      finalkey = lkey;
-    }
-    else {
-      finalkey = rkey;
-    }
-  }
-  return finalkey;
-}
-
 static void seq_cache_recycle_linked(Scene *scene, SeqCacheKey *base)
 {
   SeqCache *cache = seq_cache_get_from_scene(scene);
@@ -349,7 +594,7 @@ static void seq_cache_recycle_linked(Scene *scene, SeqCacheKey *base)
   SeqCacheKey *next = base->link_next;
 
   while (base) {
-    if (!BLI_ghash_haskey(cache->hash, base)) {
+    if (!seq_cache_haskey(cache, base)) {
       break; /* Key has already been removed from cache. */
     }
 
@@ -361,14 +606,14 @@ static void seq_cache_recycle_linked(Scene *scene, SeqCacheKey *base)
     }
 
     seq_cache_key_unlink(base);
-    BLI_ghash_remove(cache->hash, base, seq_cache_keyfree, seq_cache_valfree);
+    seq_cache_remove_key(cache, base);
     BLI_assert(base != cache->last_key);
     base = prev;
   }
 
   base = next;
   while (base) {
-    if (!BLI_ghash_haskey(cache->hash, base)) {
+    if (!seq_cache_haskey(cache, base)) {
       break; /* Key has already been removed from cache. */
     }
 
@@ -380,66 +625,93 @@ static void seq_cache_recycle_linked(Scene *scene, SeqCacheKey *base)
     }
 
     seq_cache_key_unlink(base);
-    BLI_ghash_remove(cache->hash, base, seq_cache_keyfree, seq_cache_valfree);
+    seq_cache_remove_key(cache, base);
     BLI_assert(base != cache->last_key);
     base = next;
   }
 }
 
+/**
+ * Choose the frame to free next. Frames are identified by their last key (the one stored last,
+ * with no link to a next key), frames that are not fully cached have no such key.
+ */
 static SeqCacheKey *seq_cache_get_item_for_removal(Scene *scene)
 {
   SeqCache *cache = seq_cache_get_from_scene(scene);
-  SeqCacheKey *finalkey = nullptr;
-  /* Leftmost key. */
-  SeqCacheKey *lkey = nullptr;
-  /* Rightmost key. */
-  SeqCacheKey *rkey = nullptr;
-  SeqCacheKey *key = nullptr;
-
-  GHashIterator gh_iter;
-  BLI_ghashIterator_init(&gh_iter, cache->hash);
-  int total_count = 0;
-
-  while (!BLI_ghashIterator_done(&gh_iter)) {
-    key = static_cast<SeqCacheKey *>(BLI_ghashIterator_getKey(&gh_iter));
-    SeqCacheItem *item = static_cast<SeqCacheItem *>(BLI_ghashIterator_getValue(&gh_iter));
-    BLI_ghashIterator_step(&gh_iter);
-    BLI_assert(key->cache_owner == cache);
-
-    /* This shouldn't happen, but better be safe than sorry. */
-    if (!item->ibuf) {
-      seq_cache_recycle_linked(scene, key);
-      /* Can not continue iterating after linked remove. */
-      BLI_ghashIterator_init(&gh_iter, cache->hash);
-      continue;
-    }
 
-    if (key->is_temp_cache || key->link_next != nullptr) {
-      continue;
-    }
+  /* Ideally, cache would not need to check the state of prefetching task
+   * that is tricky to do however, because prefetch would need to know,
+   * if a key, that is about to be created would be removed by itself.
+   *
+   * This can happen because only FINAL_OUT item insertion will trigger recycling
+   * but that is also the point, where prefetch can be suspended.
+   *
+   * We could use temp cache as a shield and later make it a non-temporary entry,
+   * but it is not worth of increasing system complexity.
+   */
+  const bool protect_prefetch_range = (scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE) &&
+                                      seq_prefetch_job_is_running(scene);
+  int pfjob_start = 0, pfjob_end = 0;
+  if (protect_prefetch_range) {
+    seq_prefetch_get_time_range(scene, &pfjob_start, &pfjob_end);
+  }
 
-    total_count++;
+  /* Least recently used frame of frames used once (recent) and used multiple times (frequent). */
+  SeqCacheKey *recent_key = nullptr, *frequent_key = nullptr;
+  uint64_t recent_access = UINT64_MAX, frequent_access = UINT64_MAX;
+  int recent_num = 0, frames_num = 0;
+
+  for (SeqCacheShard &shard : cache->shards) {
+    BLI_mutex_lock(&shard.mutex);
+    GHashIterator gh_iter;
+    GHASH_ITER (gh_iter, shard.hash) {
+      SeqCacheKey *key = static_cast<SeqCacheKey *>(BLI_ghashIterator_getKey(&gh_iter));
+      SeqCacheItem *item = static_cast<SeqCacheItem *>(BLI_ghashIterator_getValue(&gh_iter));
+      BLI_assert(key->cache_owner == cache);
+
+      /* This shouldn't happen, but better be safe than sorry. */
+      if (!item->ibuf) {
+        BLI_mutex_unlock(&shard.mutex);
+        return key;
+      }
 
-    if (lkey) {
-      if (key->timeline_frame < lkey->timeline_frame) {
-        lkey = key;
+      if (key->is_temp_cache || key->link_next != nullptr) {
+        continue;
       }
-    }
-    else {
-      lkey = key;
-    }
-    if (rkey) {
-      if (key->timeline_frame > rkey->timeline_frame) {
-        rkey = key;
+
+      frames_num++;
+      if (item->hits == 0) {
+        recent_num++;
+      }
+
+      if (protect_prefetch_range && key->timeline_frame >= pfjob_start &&
+          key->timeline_frame <= pfjob_end)
+      {
+        continue;
+      }
+
+      if (item->hits == 0 && item->last_access < recent_access) {
+        recent_key = key;
+        recent_access = item->last_access;
+      }
+      else if (item->hits > 0 && item->last_access < frequent_access) {
+        frequent_key = key;
+        frequent_access = item->last_access;
       }
     }
-    else {
-      rkey = key;
-    }
+    BLI_mutex_unlock(&shard.mutex);
   }
-  (void)total_count; /* Quiet set-but-unused warning (may be removed). */
 
-  finalkey = seq_cache_choose_key(scene, lkey, rkey);
+  cache->target_recent_num = std::min(cache->target_recent_num, frames_num);
+
+  const bool use_recent = recent_key &&
+                          (recent_num > cache->target_recent_num || frequent_key == nullptr);
+  SeqCacheKey *finalkey = use_recent ? recent_key : frequent_key;
+  if (finalkey) {
+    SeqCacheGhosts &ghosts = use_recent ? cache->ghost_recent : cache->ghost_frequent;
+    ghosts.add(seq_cache_hashhash(finalkey), frames_num);
+    cache->stat_recycled_frames++;
+  }
 
   return finalkey;
 }
@@ -496,10 +768,13 @@ static void seq_cache_create(Main *bmain, Scene *scene)
 {
   BLI_mutex_lock(&cache_create_lock);
   if (scene->ed->cache == nullptr) {
-    SeqCache *cache = static_cast<SeqCache *>(MEM_callocN(sizeof(SeqCache), "SeqCache"));
+    SeqCache *cache = MEM_new<SeqCache>("SeqCache");
     cache->keys_pool = BLI_mempool_create(sizeof(SeqCacheKey), 0, 64, BLI_MEMPOOL_NOP);
     cache->items_pool = BLI_mempool_create(sizeof(SeqCacheItem), 0, 64, BLI_MEMPOOL_NOP);
-    cache->hash = BLI_ghash_new(seq_cache_hashhash, seq_cache_hashcmp, "SeqCache hash");
+    for (SeqCacheShard &shard : cache->shards) {
+      shard.hash = BLI_ghash_new(seq_cache_hashhash, seq_cache_hashcmp, "SeqCache hash");
+      BLI_mutex_init(&shard.mutex);
+    }
     cache->last_key = nullptr;
     cache->bmain = bmain;
     cache->thumbnail_count = 0;
@@ -554,13 +829,7 @@ void seq_cache_free_temp_cache(Scene *scene, short id, int timeline_frame)
 
   seq_cache_lock(scene);
 
-  GHashIterator gh_iter;
-  BLI_ghashIterator_init(&gh_iter, cache->hash);
-  while (!BLI_ghashIterator_done(&gh_iter)) {
-    SeqCacheKey *key = static_cast<SeqCacheKey *>(BLI_ghashIterator_getKey(&gh_iter));
-    BLI_ghashIterator_step(&gh_iter);
-    BLI_assert(key->cache_owner == cache);
-
+  seq_cache_foreach_entry(cache, [&](SeqCacheKey *key, SeqCacheItem * /*item*/) {
     if (key->is_temp_cache && key->task_id == id && key->type != SEQ_CACHE_STORE_THUMBNAIL) {
       /* Use frame_index here to avoid freeing raw images if they are used for multiple frames. */
       float frame_index = seq_cache_timeline_frame_to_frame_index(
@@ -570,13 +839,13 @@ void seq_cache_free_temp_cache(Scene *scene, short id, int timeline_frame)
           timeline_frame < SEQ_time_left_handle_frame_get(scene, key->seq))
       {
         seq_cache_key_unlink(key);
-        BLI_ghash_remove(cache->hash, key, seq_cache_keyfree, seq_cache_valfree);
         if (key == cache->last_key) {
           cache->last_key = nullptr;
         }
+        seq_cache_remove_key(cache, key);
       }
     }
-  }
+  });
   seq_cache_unlock(scene);
 }
 
@@ -587,7 +856,11 @@ void seq_cache_destruct(Scene *scene)
     return;
   }
 
-  BLI_ghash_free(cache->hash, seq_cache_keyfree, seq_cache_valfree);
+  for (SeqCacheShard &shard : cache->shards) {
+    BLI_ghash_free(shard.hash, seq_cache_keyfree, seq_cache_valfree);
+    BLI_mutex_end(&shard.mutex);
+  }
+  BLI_assert(cache->contents.is_empty());
   BLI_mempool_destroy(cache->keys_pool);
   BLI_mempool_destroy(cache->items_pool);
   BLI_mutex_end(&cache->iterator_mutex);
@@ -596,7 +869,7 @@ void seq_cache_destruct(Scene *scene)
     seq_disk_cache_free(cache->disk_cache);
   }
 
-  MEM_freeN(cache);
+  MEM_delete(cache);
   scene->ed->cache = nullptr;
 }
 
@@ -619,19 +892,23 @@ void SEQ_cache_cleanup(Scene *scene)
 
   seq_cache_lock(scene);
 
-  GHashIterator gh_iter;
-  BLI_ghashIterator_init(&gh_iter, cache->hash);
-  while (!BLI_ghashIterator_done(&gh_iter)) {
-    SeqCacheKey *key = static_cast<SeqCacheKey *>(BLI_ghashIterator_getKey(&gh_iter));
-    BLI_assert(key->cache_owner == cache);
-
-    BLI_ghashIterator_step(&gh_iter);
-
+  for (SeqCacheShard &shard : cache->shards) {
     /* NOTE: no need to call #seq_cache_key_unlink as all keys are removed. */
-    BLI_ghash_remove(cache->hash, key, seq_cache_keyfree, seq_cache_valfree);
+    BLI_mutex_lock(&shard.mutex);
+    BLI_ghash_clear(shard.hash, seq_cache_keyfree, seq_cache_valfree);
+    BLI_mutex_unlock(&shard.mutex);
   }
+  BLI_assert(cache->contents.is_empty());
   cache->last_key = nullptr;
   cache->thumbnail_count = 0;
+  cache->ghost_recent.clear();
+  cache->ghost_frequent.clear();
+  cache->target_recent_num = 0;
+  cache->stat_hits = 0;
+  cache->stat_misses = 0;
+  cache->stat_disk_hits = 0;
+  cache->stat_recycled_frames = 0;
+  cache->stat_shared_images = 0;
   seq_cache_unlock(scene);
 }
 
@@ -674,28 +951,22 @@ void seq_cache_cleanup_sequence(Scene *scene,
   int invalidate_source = invalidate_types & (SEQ_CACHE_STORE_RAW | SEQ_CACHE_STORE_PREPROCESSED |
                                               SEQ_CACHE_STORE_COMPOSITE);
 
-  GHashIterator gh_iter;
-  BLI_ghashIterator_init(&gh_iter, cache->hash);
-  while (!BLI_ghashIterator_done(&gh_iter)) {
-    SeqCacheKey *key = static_cast<SeqCacheKey *>(BLI_ghashIterator_getKey(&gh_iter));
-    BLI_ghashIterator_step(&gh_iter);
-    BLI_assert(key->cache_owner == cache);
-
+  seq_cache_foreach_entry(cache, [&](SeqCacheKey *key, SeqCacheItem * /*item*/) {
     /* Clean all final and composite in intersection of seq and seq_changed. */
     if (key->type & invalidate_composite && key->frame_index >= range_start &&
         key->frame_index <= range_end)
     {
       seq_cache_key_unlink(key);
-      BLI_ghash_remove(cache->hash, key, seq_cache_keyfree, seq_cache_valfree);
+      seq_cache_remove_key(cache, key);
     }
     else if (key->type & invalidate_source && key->seq == seq &&
              key->frame_index >= range_start_seq_changed &&
              key->frame_index <= range_end_seq_changed)
     {
       seq_cache_key_unlink(key);
-      BLI_ghash_remove(cache->hash, key, seq_cache_keyfree, seq_cache_valfree);
+      seq_cache_remove_key(cache, key);
     }
-  }
+  });
   cache->last_key = nullptr;
   seq_cache_unlock(scene);
 }
@@ -713,13 +984,7 @@ void seq_cache_thumbnail_cleanup(Scene *scene, rctf *r_view_area_safe)
     return;
   }
 
-  GHashIterator gh_iter;
-  BLI_ghashIterator_init(&gh_iter, cache->hash);
-  while (!BLI_ghashIterator_done(&gh_iter)) {
-    SeqCacheKey *key = static_cast<SeqCacheKey *>(BLI_ghashIterator_getKey(&gh_iter));
-    BLI_ghashIterator_step(&gh_iter);
-    BLI_assert(key->cache_owner == cache);
-
+  seq_cache_foreach_entry(cache, [&](SeqCacheKey *key, SeqCacheItem * /*item*/) {
     const int frame_index = key->timeline_frame - SEQ_time_left_handle_frame_get(scene, key->seq);
     const int frame_step = SEQ_render_thumbnails_guaranteed_set_frame_step_get(scene, key->seq);
     const int relative_base_frame = round_fl_to_int(frame_index / float(frame_step)) * frame_step;
@@ -727,7 +992,7 @@ void seq_cache_thumbnail_cleanup(Scene *scene, rctf *r_view_area_safe)
                                                  SEQ_time_left_handle_frame_get(scene, key->seq);
 
     if (nearest_guaranted_absolute_frame == key->timeline_frame) {
-      continue;
+      return;
     }
 
     if ((key->type & SEQ_CACHE_STORE_THUMBNAIL) &&
@@ -736,16 +1001,19 @@ void seq_cache_thumbnail_cleanup(Scene *scene, rctf *r_view_area_safe)
          key->seq->machine > r_view_area_safe->ymax || key->seq->machine < r_view_area_safe->ymin))
     {
       seq_cache_key_unlink(key);
-      BLI_ghash_remove(cache->hash, key, seq_cache_keyfree, seq_cache_valfree);
+      seq_cache_remove_key(cache, key);
       cache->thumbnail_count--;
     }
-  }
+  });
   cache->last_key = nullptr;
 }
 
-ImBuf *seq_cache_get(const SeqRenderData *context, Sequence *seq, float timeline_frame, int type)
+static ImBuf *seq_cache_get_internal(const SeqRenderData *context,
+                                     Sequence *seq,
+                                     float timeline_frame,
+                                     int type,
+                                     const bool update_statistics)
 {
-
   if (context->skip_cache || context->is_proxy_render || context->for_render || !seq) {
     return nullptr;
   }
@@ -766,19 +1034,21 @@ ImBuf *seq_cache_get(const SeqRenderData *context, Sequence *seq, float timeline
     seq_cache_create(context->bmain, scene);
   }
 
-  seq_cache_lock(scene);
   SeqCache *cache = seq_cache_get_from_scene(scene);
   ImBuf *ibuf = nullptr;
   SeqCacheKey key;
 
-  /* Try RAM cache: */
-  if (cache && seq) {
-    seq_cache_populate_key(&key, context, seq, timeline_frame, type);
-    ibuf = seq_cache_get_ex(cache, &key);
-  }
-  seq_cache_unlock(scene);
+  /* Only frames of types that are stored are counted, other types always miss. */
+  const bool count_access = update_statistics && (get_stored_types_flag(scene, seq) & type);
+
+  /* Try RAM cache, only the shard of the key is locked: */
+  seq_cache_populate_key(&key, context, seq, timeline_frame, type);
+  ibuf = seq_cache_get_ex(cache, &key, update_statistics);
 
   if (ibuf) {
+    if (count_access) {
+      cache->stat_hits++;
+    }
     return ibuf;
   }
 
@@ -790,18 +1060,51 @@ ImBuf *seq_cache_get(const SeqRenderData *context, Sequence *seq, float timeline
 
     ibuf = seq_disk_cache_read_file(cache->disk_cache, &key);
 
-    if (ibuf == nullptr) {
-      return nullptr;
-    }
+    if (ibuf != nullptr) {
+      if (count_access) {
+        cache->stat_disk_hits++;
+      }
 
-    /* Store read image in RAM. Only recycle item for final type. */
-    if (key.type != SEQ_CACHE_STORE_FINAL_OUT || seq_cache_recycle_item(scene)) {
-      SeqCacheKey *new_key = seq_cache_allocate_key(cache, context, seq, timeline_frame, type);
-      seq_cache_put_ex(scene, new_key, ibuf);
+      /* Store read image in RAM. Only recycle item for final type. */
+      if (key.type != SEQ_CACHE_STORE_FINAL_OUT || seq_cache_recycle_item(scene)) {
+        seq_cache_lock(scene);
+        if (!seq_cache_haskey(cache, &key)) {
+          SeqCacheKey *new_key = seq_cache_allocate_key(cache, context, seq, timeline_frame, type);
+          seq_cache_put_ex(scene, new_key, ibuf);
+        }
+        seq_cache_unlock(scene);
+      }
+      return ibuf;
     }
   }
 
-  return ibuf;
+  if (count_access) {
+    cache->stat_misses++;
+  }
+  return nullptr;
+}
+
+ImBuf *seq_cache_get(const SeqRenderData *context, Sequence *seq, float timeline_frame, int type)
+{
+  return seq_cache_get_internal(context, seq, timeline_frame, type, true);
+}
+
+bool seq_cache_is_type_stored(const SeqRenderData *context, Sequence *seq, int type)
+{
+  if (context->skip_cache || context->is_proxy_render || context->for_render || !seq) {
+    return false;
+  }
+
+  Scene *scene = context->scene;
+
+  if (context->is_prefetch_render) {
+    context = seq_prefetch_get_original_context(context);
+    scene = context->scene;
+    seq = seq_prefetch_get_original_sequence(seq, scene);
+    BLI_assert(seq != nullptr);
+  }
+
+  return (get_stored_types_flag(scene, seq) & type) != 0;
 }
 
 bool seq_cache_put_if_possible(
@@ -850,7 +1153,8 @@ void seq_cache_thumbnail_put(const SeqRenderData *context,
       cache, context, seq, timeline_frame, SEQ_CACHE_STORE_THUMBNAIL);
 
   /* Prevent reinserting, it breaks cache key linking. */
-  if (BLI_ghash_haskey(cache->hash, key)) {
+  if (seq_cache_haskey(cache, key)) {
+    BLI_mempool_free(cache->keys_pool, key);
     seq_cache_unlock(scene);
     return;
   }
@@ -885,7 +1189,7 @@ void seq_cache_put(
   }
 
   /* Prevent reinserting, it breaks cache key linking. */
-  ImBuf *test = seq_cache_get(context, seq, timeline_frame, type);
+  ImBuf *test = seq_cache_get_internal(context, seq, timeline_frame, type, false);
   if (test) {
     IMB_freeImBuf(test);
     return;
@@ -904,11 +1208,11 @@ void seq_cache_put(
   if (!key->is_temp_cache) {
     if (seq_disk_cache_is_enabled(context->bmain)) {
       if (cache->disk_cache == nullptr) {
-        seq_disk_cache_create(context->bmain, context->scene);
+        cache->disk_cache = seq_disk_cache_create(context->bmain, context->scene);
       }
 
+      /* Queues the image, limits are enforced after it is written. */
       seq_disk_cache_write_file(cache->disk_cache, key, i);
-      seq_disk_cache_enforce_limits(cache->disk_cache);
     }
   }
 }
@@ -925,15 +1229,12 @@ void SEQ_cache_iterate(
   }
 
   seq_cache_lock(scene);
-  bool interrupt = callback_init(userdata, BLI_ghash_len(cache->hash));
-
-  GHashIterator gh_iter;
-  BLI_ghashIterator_init(&gh_iter, cache->hash);
+  bool interrupt = callback_init(userdata, size_t(seq_cache_entries_num(cache)));
 
-  while (!BLI_ghashIterator_done(&gh_iter) && !interrupt) {
-    SeqCacheKey *key = static_cast<SeqCacheKey *>(BLI_ghashIterator_getKey(&gh_iter));
-    BLI_ghashIterator_step(&gh_iter);
-    BLI_assert(key->cache_owner == cache);
+  seq_cache_foreach_entry(cache, [&](SeqCacheKey *key, SeqCacheItem * /*item*/) {
+    if (interrupt) {
+      return;
+    }
     int timeline_frame;
     if (key->type & SEQ_CACHE_STORE_FINAL_OUT) {
       timeline_frame = key->timeline_frame;
@@ -952,13 +1253,32 @@ void SEQ_cache_iterate(
     }
 
     interrupt = callback_iter(userdata, key->seq, timeline_frame, key->type);
-  }
+  });
 
   cache->last_key = nullptr;
   seq_cache_unlock(scene);
 }
 
+bool SEQ_cache_statistics_get(const Scene *scene, SeqCacheStatistics *r_stats)
+{
+  if (scene->ed == nullptr || scene->ed->cache == nullptr) {
+    return false;
+  }
+  /* Lock so the counters are not read while the cache is cleared or frames are recycled. */
+  SeqCache *cache = scene->ed->cache;
+  BLI_mutex_lock(&cache->iterator_mutex);
+  r_stats->hits = cache->stat_hits;
+  r_stats->misses = cache->stat_misses;
+  r_stats->disk_hits = cache->stat_disk_hits;
+  r_stats->recycled_frames = cache->stat_recycled_frames;
+  r_stats->shared_images = cache->stat_shared_images;
+  BLI_mutex_unlock(&cache->iterator_mutex);
+  return true;
+}
+
 bool seq_cache_is_full()
 {
+  /* Movie frames decoded ahead of playback are included in the memory in use, they don't decode
+   * more frames once this limit is reached. */
   return seq_cache_get_mem_total() < MEM_get_memory_in_use();
 }
@@ -41,6 +41,11 @@ void seq_cache_thumbnail_put(const SeqRenderData *context,
                              float timeline_frame,
                              ImBuf *i,
                              const rctf *view_area);
+/**
+ * Whether images of this type are kept in the cache for \a seq. Other images are only stored
+ * temporarily, until the current frame is rendered.
+ */
+bool seq_cache_is_type_stored(const SeqRenderData *context, Sequence *seq, int type);
 bool seq_cache_put_if_possible(
     const SeqRenderData *context, Sequence *seq, float timeline_frame, int type, ImBuf *ibuf);
 /**
@@ -58,4 +63,6 @@ void seq_cache_cleanup_sequence(Scene *scene,
                                 bool force_seq_changed_range);
 void seq_cache_thumbnail_cleanup(Scene *scene, rctf *r_view_area_safe);
 bool seq_cache_is_full();
+/** Memory limit of the cache in bytes. */
+size_t seq_cache_get_mem_total();
 float seq_cache_frame_index_to_timeline_frame(Sequence *seq, float frame_index);
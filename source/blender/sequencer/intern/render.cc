@@ -18,6 +18,7 @@
 #include "DNA_sequence_types.h"
 #include "DNA_space_types.h"
 
+#include "BLI_array.hh"
 #include "BLI_linklist.h"
 #include "BLI_listbase.h"
 #include "BLI_math_geom.h"
@@ -25,6 +26,7 @@
 #include "BLI_math_vector_types.hh"
 #include "BLI_path_util.h"
 #include "BLI_rect.h"
+#include "BLI_task.hh"
 
 #include "BKE_anim_data.hh"
 #include "BKE_animsys.h"
@@ -1994,6 +1996,112 @@ static bool is_opaque_alpha_over(const Sequence *seq)
   return true;
 }
 
+/** A rendered strip that still has to be blended onto the composite of the strips below it. */
+struct StripStackLayer {
+  Sequence *seq;
+  ImBuf *ibuf;
+};
+
+/**
+ * Check whether blending a strip onto the composite can be deferred, to blend it together with
+ * the strips above it in #seq_render_strip_stack_blend_fused. Because that only creates the
+ * final composite, the intermediate one must not be needed for the cache.
+ */
+static bool seq_render_strip_stack_can_defer_blend(const SeqRenderData *context,
+                                                   Sequence *seq,
+                                                   const ImBuf *composite,
+                                                   const Span<StripStackLayer> layers,
+                                                   ImBuf *ibuf)
+{
+  if (!seq_effect_blend_supports_rows(seq)) {
+    return false;
+  }
+  if (seq_cache_is_type_stored(context, seq, SEQ_CACHE_STORE_COMPOSITE)) {
+    return false;
+  }
+  const ImBuf *below = layers.is_empty() ? composite : layers.last().ibuf;
+  if (below->float_buffer.data == nullptr) {
+    /* Blending a float strip onto a byte composite converts the composite to float first. Leave
+     * that to the regular effect execution. */
+    return ibuf->float_buffer.data == nullptr;
+  }
+  if (ibuf->float_buffer.data == nullptr) {
+    /* Same conversion as in the effect execution. */
+    seq_imbuf_to_sequencer_space(context->scene, ibuf, true);
+  }
+  return true;
+}
+
+template<typename T> static T *imbuf_pixels(const ImBuf *ibuf)
+{
+  if constexpr (std::is_same_v<T, float>) {
+    return ibuf->float_buffer.data;
+  }
+  else {
+    return ibuf->byte_buffer.data;
+  }
+}
+
+template<typename T>
+static void seq_render_strip_stack_blend_fused(const int width,
+                                               const int height,
+                                               const ImBuf *composite,
+                                               const Span<StripStackLayer> layers,
+                                               ImBuf *out)
+{
+  /* Blend all layers onto a band of rows before moving on to the next band, so the intermediate
+   * results stay in the CPU cache instead of being written to full size images. */
+  const int band_rows = std::max(1, 16384 / width);
+  const int64_t band_size = int64_t(band_rows) * width * 4;
+  threading::parallel_for(IndexRange(height), band_rows, [&](const IndexRange range) {
+    Array<T> scratch(band_size * 2, NoInitialization());
+    for (int y = range.first(); y < range.one_after_last(); y += band_rows) {
+      const int rows = std::min<int>(band_rows, range.one_after_last() - y);
+      const int64_t offset = int64_t(y) * width * 4;
+      const T *below = imbuf_pixels<T>(composite) + offset;
+      for (const int64_t layer_i : layers.index_range()) {
+        const StripStackLayer &layer = layers[layer_i];
+        /* Alternate between the scratch buffers, because the inputs and output of the blend
+         * functions can't overlap. */
+        T *dst = layer_i == layers.size() - 1 ? imbuf_pixels<T>(out) + offset :
+                                                scratch.data() + (layer_i % 2) * band_size;
+        seq_effect_blend_rows(layer.seq,
+                              layer.seq->blend_opacity / 100.0f,
+                              width,
+                              rows,
+                              below,
+                              imbuf_pixels<T>(layer.ibuf) + offset,
+                              dst);
+        below = dst;
+      }
+    }
+  });
+}
+
+/**
+ * Blend multiple strips onto the composite of the strips below them in a single pass. The result
+ * is the same as applying the blend effect of every strip separately.
+ */
+static ImBuf *seq_render_strip_stack_blend_fused(const SeqRenderData *context,
+                                                 const ImBuf *composite,
+                                                 const Span<StripStackLayer> layers)
+{
+  const int width = context->rectx;
+  const int height = context->recty;
+  ImBuf *out;
+  if (composite->float_buffer.data) {
+    out = IMB_allocImBuf(width, height, 32, IB_rectfloat | IB_uninitialized_pixels);
+    IMB_colormanagement_assign_float_colorspace(
+        out, context->scene->sequencer_colorspace_settings.name);
+    seq_render_strip_stack_blend_fused<float>(width, height, composite, layers, out);
+  }
+  else {
+    out = IMB_allocImBuf(width, height, 32, IB_rect | IB_uninitialized_pixels);
+    seq_render_strip_stack_blend_fused<uchar>(width, height, composite, layers, out);
+  }
+  return out;
+}
+
 static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
                                      SeqRenderState *state,
                                      ListBase *channels,
@@ -2085,6 +2193,22 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
     }
   }
 
+  /* Strips that are blended onto the composite later, all at once. */
+  Vector<StripStackLayer> layers;
+  auto blend_layers = [&]() {
+    if (layers.is_empty()) {
+      return;
+    }
+    ImBuf *ibuf1 = out;
+    out = seq_render_strip_stack_blend_fused(context, ibuf1, layers);
+    seq_cache_put(context, layers.last().seq, timeline_frame, SEQ_CACHE_STORE_COMPOSITE, out);
+    IMB_freeImBuf(ibuf1);
+    for (const StripStackLayer &layer : layers) {
+      IMB_freeImBuf(layer.ibuf);
+    }
+    layers.clear();
+  };
+
   i++;
   for (; i < strips.size(); i++) {
     Sequence *seq = strips[i];
@@ -2094,17 +2218,26 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
     }
 
     if (seq_get_early_out_for_blend_mode(seq) == StripEarlyOut::DoEffect) {
-      ImBuf *ibuf1 = out;
       ImBuf *ibuf2 = seq_render_strip(context, state, seq, timeline_frame);
+      if (seq_render_strip_stack_can_defer_blend(context, seq, out, layers, ibuf2)) {
+        layers.append({seq, ibuf2});
+        continue;
+      }
+      blend_layers();
 
+      ImBuf *ibuf1 = out;
       out = seq_render_strip_stack_apply_effect(context, seq, timeline_frame, ibuf1, ibuf2);
 
       IMB_freeImBuf(ibuf1);
       IMB_freeImBuf(ibuf2);
     }
+    else {
+      blend_layers();
+    }
 
     seq_cache_put(context, strips[i], timeline_frame, SEQ_CACHE_STORE_COMPOSITE, out);
   }
+  blend_layers();
 
   return out;
 }
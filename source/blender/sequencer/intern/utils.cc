@@ -40,6 +40,7 @@
 #include "IMB_imbuf.hh"
 #include "IMB_imbuf_types.hh"
 
+#include "image_cache.hh"
 #include "multiview.hh"
 #include "proxy.hh"
 #include "sequencer.hh"
@@ -219,6 +220,12 @@ static void open_anim_filepath(Sequence *seq,
                                   seq->streamindex,
                                   seq->strip->colorspace_settings.name);
   }
+  if (sanim->anim) {
+    /* Decode the next frames during playback while the current one is composited, within the
+     * memory limit of the cache. */
+    IMB_anim_set_decode_ahead(sanim->anim, 2);
+    IMB_anim_decode_ahead_memory_limit_set(seq_cache_get_mem_total());
+  }
 }
 
 static bool use_proxy(Editing *ed, Sequence *seq)
@@ -16,6 +16,19 @@ def _run(args):
     scene.render.filepath = args['render_filepath']
     scene.render.image_settings.file_format = 'PNG'
     scene.cycles.device = 'CPU' if device_type == 'CPU' else 'GPU'
+    scene.cycles.texture_cache_size = args['texture_cache_size']
+
+    # Preferences changed for the test, restored with their previous values after rendering.
+    prefs_restore = []
+
+    if args['use_cpu_wavefront']:
+        # Debug flags are only synchronized with the developer extras and Cycles debug enabled.
+        prefs = bpy.context.preferences
+        prefs_restore += [(prefs.view, 'show_developer_ui', prefs.view.show_developer_ui),
+                          (prefs.experimental, 'use_cycles_debug', prefs.experimental.use_cycles_debug)]
+        prefs.view.show_developer_ui = True
+        prefs.experimental.use_cycles_debug = True
+        scene.cycles.debug_use_cpu_wavefront = True
 
     if scene.cycles.use_adaptive_sampling:
         # Render samples specified in file, no other way to measure
@@ -46,23 +59,34 @@ def _run(args):
                     index += 1
 
     # Render
-    bpy.ops.render.render(write_still=True)
+    try:
+        bpy.ops.render.render(write_still=True)
+    finally:
+        for data, prop, value in prefs_restore:
+            setattr(data, prop, value)
 
     return None
 
 
 class CyclesTest(api.Test):
-    def __init__(self, filepath):
+    def __init__(self, filepath, texture_cache_size=0, use_cpu_wavefront=False):
         self.filepath = filepath
+        self.texture_cache_size = texture_cache_size
+        self.use_cpu_wavefront = use_cpu_wavefront
 
     def name(self):
+        if self.texture_cache_size:
+            return f"{self.filepath.stem}_texture_cache"
+        if self.use_cpu_wavefront:
+            return f"{self.filepath.stem}_cpu_wavefront"
         return self.filepath.stem
 
     def category(self):
         return "cycles"
 
     def use_device(self):
-        return True
+        # Wavefront mode only exists for the CPU device.
+        return not self.use_cpu_wavefront
 
     def run(self, env, device_id):
         tokens = device_id.split('_')
@@ -70,23 +94,32 @@ class CyclesTest(api.Test):
         device_index = int(tokens[1]) if len(tokens) > 1 else 0
         args = {'device_type': device_type,
                 'device_index': device_index,
+                'texture_cache_size': self.texture_cache_size,
+                'use_cpu_wavefront': self.use_cpu_wavefront,
                 'render_filepath': str(env.log_file.parent / (env.log_file.stem + '.png'))}
 
         _, lines = env.run_in_blender(_run, args, ['--debug-cycles', '--verbose', '2', self.filepath])
 
         # Parse render time from output
         prefix_time = "Render time (without synchronization): "
+        prefix_total_time = "Total render time: "
         prefix_memory = "Peak: "
         prefix_time_per_sample = "Average time per sample: "
         time = None
+        render_time = None
+        total_time = None
         time_per_sample = None
         memory = None
         for line in lines:
             line = line.strip()
+            offset = line.find(prefix_total_time)
+            if offset != -1:
+                total_time = float(line[offset + len(prefix_total_time):])
             offset = line.find(prefix_time)
             if offset != -1:
                 time = line[offset + len(prefix_time):]
                 time = float(time)
+                render_time = time
             offset = line.find(prefix_time_per_sample)
             if offset != -1:
                 time_per_sample = line[offset + len(prefix_time_per_sample):]
@@ -104,9 +137,28 @@ class CyclesTest(api.Test):
         if not (time and memory):
             raise Exception("Error parsing render time output")
 
-        return {'time': time, 'peak_memory': memory}
+        result = {'time': time, 'peak_memory': memory}
+
+        # Synchronization and scene update before the first sample, which includes loading
+        # image textures unless they are loaded on demand.
+        if total_time is not None and render_time is not None:
+            result['time_to_first_sample'] = total_time - render_time
+
+        return result
 
 
 def generate(env):
     filepaths = env.find_blend_files('cycles/*')
-    return [CyclesTest(filepath) for filepath in filepaths]
+    tests = [CyclesTest(filepath) for filepath in filepaths]
+
+    # Compare the wavefront CPU mode with tracing each path to completion on the same scenes.
+    tests += [CyclesTest(filepath, use_cpu_wavefront=True) for filepath in filepaths]
+
+    # Scenes with tiled mipmapped .tx textures, rendered both with all textures loaded up front
+    # and with a texture cache that loads tiles on demand, to compare memory usage and the time
+    # to first sample.
+    texture_cache_size = 512
+    for filepath in env.find_blend_files('cycles_texture_cache/*'):
+        tests += [CyclesTest(filepath), CyclesTest(filepath, texture_cache_size)]
+
+    return tests
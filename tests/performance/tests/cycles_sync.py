@@ -0,0 +1,66 @@
+# SPDX-FileCopyrightText: 2024 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+import api
+
+
+def _run(args):
+    import bpy
+    import time
+
+    scene = bpy.context.scene
+    scene.render.engine = 'CYCLES'
+    scene.render.use_persistent_data = args['use_persistent_data']
+    scene.render.resolution_percentage = 10
+    scene.cycles.device = 'CPU'
+    scene.cycles.samples = 1
+    scene.cycles.use_adaptive_sampling = False
+    scene.cycles.use_denoising = False
+
+    # Render a single sample per frame, so the time is dominated by synchronizing the deformed
+    # geometry and updating the BVH. The first frame builds everything and is not counted.
+    frame_start = scene.frame_start
+    frame_end = min(scene.frame_end, frame_start + 10)
+    scene.frame_set(frame_start)
+    bpy.ops.render.render()
+
+    start_time = time.time()
+    for frame in range(frame_start + 1, frame_end + 1):
+        scene.frame_set(frame)
+        bpy.ops.render.render()
+    elapsed_time = time.time() - start_time
+
+    result = {'time': elapsed_time / max(frame_end - frame_start, 1)}
+    return result
+
+
+class CyclesSyncTest(api.Test):
+    """
+    Frame to frame scene synchronization time of animated, typically rigged characters. With
+    persistent data the BVH of deforming geometry is refit instead of rebuilt.
+    """
+
+    def __init__(self, filepath, use_persistent_data):
+        self.filepath = filepath
+        self.use_persistent_data = use_persistent_data
+
+    def name(self):
+        if self.use_persistent_data:
+            return f"{self.filepath.stem}_persistent_data"
+        return self.filepath.stem
+
+    def category(self):
+        return "cycles_sync"
+
+    def run(self, env, device_id):
+        args = {'use_persistent_data': self.use_persistent_data}
+        result, _ = env.run_in_blender(_run, args, [self.filepath])
+        return result
+
+
+def generate(env):
+    filepaths = env.find_blend_files('cycles_sync/*')
+    return [CyclesSyncTest(filepath, use_persistent_data)
+            for filepath in filepaths
+            for use_persistent_data in (False, True)]
@@ -0,0 +1,88 @@
+# SPDX-FileCopyrightText: 2024 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+import api
+
+
+def _run(args):
+    import bpy
+    import os
+    import tempfile
+    import time
+
+    scene = bpy.context.scene
+    scene.render.engine = 'CYCLES'
+    scene.cycles.samples = 1
+    scene.cycles.device = 'CPU'
+    scene.render.resolution_x = args['width']
+    scene.render.resolution_y = args['height']
+    scene.render.resolution_percentage = 100
+
+    # Enough passes to make writing the file take a noticeable amount of time.
+    view_layer = scene.view_layers[0]
+    view_layer.use_pass_z = True
+    view_layer.use_pass_mist = True
+    view_layer.use_pass_normal = True
+    view_layer.use_pass_diffuse_direct = True
+    view_layer.use_pass_diffuse_color = True
+    view_layer.use_pass_glossy_direct = True
+    view_layer.use_pass_emit = True
+
+    bpy.ops.render.render()
+    render_result = bpy.data.images['Render Result']
+
+    image_settings = scene.render.image_settings
+    image_settings.file_format = 'OPEN_EXR_MULTILAYER'
+    image_settings.color_depth = args['color_depth']
+    image_settings.exr_codec = args['codec']
+
+    num_writes = 5
+    with tempfile.TemporaryDirectory() as tempdir:
+        filepath = os.path.join(tempdir, "render.exr")
+
+        # Write once so the file system cache is warm.
+        render_result.save_render(filepath, scene=scene)
+
+        start_time = time.time()
+        for _ in range(num_writes):
+            render_result.save_render(filepath, scene=scene)
+        elapsed_time = (time.time() - start_time) / num_writes
+        file_size = os.path.getsize(filepath)
+
+    result = {'time': elapsed_time, 'megabytes': file_size / (1024 * 1024)}
+    return result
+
+
+class ExrWriteTest(api.Test):
+    """
+    Write a 4K multilayer OpenEXR file of a render with several passes, to measure the write
+    throughput of each compression codec. No .blend files are needed.
+    """
+
+    def __init__(self, codec, color_depth, width=3840, height=2160):
+        self.codec = codec
+        self.color_depth = color_depth
+        self.width = width
+        self.height = height
+
+    def name(self):
+        return f"multilayer_{self.codec.lower()}_{self.color_depth}"
+
+    def category(self):
+        return "exr_write"
+
+    def run(self, env, device_id):
+        args = {
+            'codec': self.codec,
+            'color_depth': self.color_depth,
+            'width': self.width,
+            'height': self.height,
+        }
+        result, _ = env.run_in_blender(_run, args)
+        return result
+
+
+def generate(env):
+    codecs = ['NONE', 'ZIP', 'ZIP_FAST', 'PIZ', 'DWAA']
+    return [ExrWriteTest(codec, color_depth) for codec in codecs for color_depth in ('16', '32')]
@@ -0,0 +1,73 @@
+# SPDX-FileCopyrightText: 2024 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+import api
+
+
+def _run(args):
+    import bpy
+    import numpy as np
+    import time
+
+    width, height = args['width'], args['height']
+    small_width, small_height = width // 2 + 7, height // 2 + 3
+
+    image = bpy.data.images.new("scale", width, height, alpha=True, float_buffer=args['use_float'])
+    rng = np.random.default_rng(0)
+    image.pixels.foreach_set(rng.random(width * height * 4, dtype=np.float32))
+
+    # Alternate between scaling down and up, only the requested direction is timed.
+    num_scales = 10
+    elapsed_time = 0.0
+    for _ in range(num_scales):
+        start_time = time.time()
+        image.scale(small_width, small_height)
+        if args['scale_down']:
+            elapsed_time += time.time() - start_time
+
+        start_time = time.time()
+        image.scale(width, height)
+        if not args['scale_down']:
+            elapsed_time += time.time() - start_time
+
+    bpy.data.images.remove(image)
+
+    result = {'time': elapsed_time / num_scales}
+    return result
+
+
+class ImageScaleTest(api.Test):
+    """
+    Scale a 4K image to about half its size or back, to measure the throughput of the image
+    scaling used for thumbnails, proxies and image editing. No .blend files are needed.
+    """
+
+    def __init__(self, use_float, scale_down, width=3840, height=2160):
+        self.use_float = use_float
+        self.scale_down = scale_down
+        self.width = width
+        self.height = height
+
+    def name(self):
+        direction = "down" if self.scale_down else "up"
+        return f"scale_{direction}_{'float' if self.use_float else 'byte'}"
+
+    def category(self):
+        return "image"
+
+    def run(self, env, device_id):
+        args = {
+            'use_float': self.use_float,
+            'scale_down': self.scale_down,
+            'width': self.width,
+            'height': self.height,
+        }
+        result, _ = env.run_in_blender(_run, args)
+        return result
+
+
+def generate(env):
+    return [ImageScaleTest(use_float, scale_down)
+            for use_float in (False, True)
+            for scale_down in (True, False)]
@@ -0,0 +1,104 @@
+# SPDX-FileCopyrightText: 2024 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+import api
+
+
+def _create_image_strips(scene, dirpath, use_float, num_strips, width, height):
+    import bpy
+    import numpy as np
+
+    blend_types = ['ALPHA_OVER', 'ADD', 'MULTIPLY', 'SCREEN', 'CROSS']
+    file_format, extension = ('OPEN_EXR', '.exr') if use_float else ('PNG', '.png')
+
+    rng = np.random.default_rng(0)
+    for i in range(num_strips):
+        image = bpy.data.images.new(f"strip_{i}", width, height, alpha=True, float_buffer=use_float)
+        # Horizontal gradients with partially transparent areas, so that alpha over has to blend.
+        pixels = np.empty((height, width, 4), dtype=np.float32)
+        pixels[..., :3] = np.linspace(0.0, 1.0, width, dtype=np.float32)[None, :, None]
+        pixels[..., :3] *= rng.random(3, dtype=np.float32)
+        pixels[..., 3] = np.linspace(1.0, 0.0, height, dtype=np.float32)[:, None]
+        image.pixels.foreach_set(pixels.ravel())
+
+        filepath = str(dirpath / (image.name + extension))
+        image.filepath_raw = filepath
+        image.file_format = file_format
+        image.save()
+        bpy.data.images.remove(image)
+
+        strip = scene.sequence_editor.sequences.new_image(
+            name=f"strip_{i}", filepath=filepath, channel=i + 1, frame_start=scene.frame_start)
+        strip.frame_final_duration = scene.frame_end - scene.frame_start + 1
+        strip.blend_type = blend_types[i % len(blend_types)] if i > 0 else 'REPLACE'
+        strip.blend_alpha = 0.75
+
+
+def _run(args):
+    import bpy
+    import pathlib
+    import tempfile
+    import time
+
+    scene = bpy.context.scene
+    scene.render.resolution_x = args['width']
+    scene.render.resolution_y = args['height']
+    scene.render.resolution_percentage = 100
+    scene.render.use_sequencer = True
+    scene.frame_start = 1
+    scene.frame_end = 10
+    scene.sequence_editor_create()
+
+    with tempfile.TemporaryDirectory() as tempdir:
+        _create_image_strips(scene,
+                             pathlib.Path(tempdir),
+                             args['use_float'],
+                             args['num_strips'],
+                             args['width'],
+                             args['height'])
+
+        # Render once to load the images from disk.
+        bpy.ops.render.render()
+
+        start_time = time.time()
+        for i in range(scene.frame_start, scene.frame_end + 1):
+            scene.frame_set(i)
+            bpy.ops.render.render()
+        elapsed_time = time.time() - start_time
+
+    result = {'time': elapsed_time / (scene.frame_end + 1 - scene.frame_start)}
+    return result
+
+
+class SequencerStackTest(api.Test):
+    """
+    Render a stack of 4K image strips with different blend modes, to measure compositing the
+    strips rather than decoding them. The image files are generated, no .blend files are needed.
+    """
+
+    def __init__(self, use_float, num_strips=8, width=3840, height=2160):
+        self.use_float = use_float
+        self.num_strips = num_strips
+        self.width = width
+        self.height = height
+
+    def name(self):
+        return f"stack_{self.num_strips}_strips_{'float' if self.use_float else 'byte'}"
+
+    def category(self):
+        return "sequencer"
+
+    def run(self, env, device_id):
+        args = {
+            'use_float': self.use_float,
+            'num_strips': self.num_strips,
+            'width': self.width,
+            'height': self.height,
+        }
+        result, _ = env.run_in_blender(_run, args)
+        return result
+
+
+def generate(env):
+    return [SequencerStackTest(use_float=False), SequencerStackTest(use_float=True)]